@@ -0,0 +1,39 @@
+#ifndef COMMAND_LINE_HPP
+#define COMMAND_LINE_HPP
+
+#include "Renderer/BlockCompression.hpp"
+
+#include <cstdint>
+
+namespace tnt
+{
+	namespace application
+	{
+		// Resolution of the window, the headless renderer defaults to it so both produce the same frames
+		const std::uint32_t FRAME_WIDTH = 1280;
+		const std::uint32_t FRAME_HEIGHT = 720;
+
+		// The scene is simulated at a fixed rate no matter how fast frames are rendered
+		const double SIMULATION_STEP = 1.0 / 60.0;
+
+		// Steps one frame may catch up on, a longer stall is dropped instead of simulated
+		const std::uint32_t MAX_SIMULATION_STEPS_PER_FRAME = 8;
+
+		// Cooked mip chains keyed by the hash of the source image, created on first run or with --cook-textures
+		// Kept in this subdirectory of the system temporary directory, see graphics::GetTemporaryCacheDirectory
+		const char* const TEXTURE_CACHE_NAME = "RayTracingTextureCache";
+
+		// BC7 keeps alpha and costs a quarter of the memory and upload bandwidth of RGBA8
+		const graphics::TextureFormat TEXTURE_CACHE_FORMAT = graphics::TextureFormat::BC7;
+
+		// Entry points that need neither a window nor a D3D12 device, they build on every platform
+		int RunHeadless(int argc, char* argv[]);
+		int RunBenchmark(int argc, char* argv[]);
+		int RunCookTextures(int argc, char* argv[]);
+
+		// Runs the command named by argv[1] when it is one of the above, returns false to leave the arguments to the caller
+		bool RunCommandLine(int argc, char* argv[], int& t_exit_code);
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,61 @@
+#ifndef BENCHMARKS_HPP
+#define BENCHMARKS_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace tnt
+{
+	namespace benchmark
+	{
+		// Random, incoherent rays through the tessellated triangle scene, once for every traversal kernel
+		void RunTraversalBenchmark(std::uint32_t t_tessellation, std::uint32_t t_ray_count);
+
+		// Samples a random RGBA8 texture with every filter, once in scanline order and once at random coordinates
+		void RunSamplerBenchmark(std::uint32_t t_texture_size, std::uint32_t t_sample_count);
+
+		// Converts a random RGBA8 texture into every texture layout and samples each at random, in clusters and down columns
+		void RunTextureLayoutBenchmark(std::uint32_t t_texture_size, std::uint32_t t_sample_count);
+
+		// Drives the upload ring with a fake fence, checks that no allocation overlaps a frame still in flight, then times it
+		void RunUploadRingBenchmark(std::uint32_t t_frame_count, std::uint32_t t_allocations_per_frame);
+
+		// Random allocations and frees of resource sized blocks in one TLSF heap, reports throughput, latency and fragmentation
+		void RunHeapAllocatorBenchmark(std::uint32_t t_operation_count);
+
+		// Random allocations and frees of single descriptors and table ranges in a TLSF heap of a million descriptors, checks overlaps and coalescing
+		void RunDescriptorAllocatorBenchmark(std::uint32_t t_operation_count);
+
+		// Streams textures in and out of a bindless table with frees retired two frames late, checks slot reuse and stale handle detection
+		void RunBindlessHandleBenchmark(std::uint32_t t_frame_count);
+
+		// Assembles per draw descriptor tables of random materials in a frame ring, compares cached and batched copies against a copy per draw
+		void RunDescriptorTableBenchmark(std::uint32_t t_frame_count);
+
+		// Paces frames against a simulated GPU and display with one to three frames in flight, checks that no wait was unnecessary
+		void RunFramePacingBenchmark(std::uint32_t t_frame_count);
+
+		// Drives the scene loop with a simulated clock at several frame rates, checks that the motion does not depend on the rate, reports loop iterations per second
+		void RunFixedTimestepBenchmark(std::uint32_t t_frame_count);
+
+		// Decodes the same image file over and over with a growing number of decode threads, reports MB/s of RGBA8 output
+		void RunImageDecodeBenchmark(const std::string& t_path, std::uint32_t t_image_count);
+
+		// Cooks the image once, then compares decoding it against mapping the cooked mip chain into a staging buffer
+		void RunTextureCacheBenchmark(const std::string& t_path, std::uint32_t t_load_count);
+
+		// Builds the mip chain of a random RGBA8 texture with every filter and kernel on a growing number of threads, reports MP/s
+		void RunMipGenerationBenchmark(std::uint32_t t_texture_size);
+
+		// Encodes and decodes the image with every block compressed format on a growing number of threads, reports MP/s and PSNR
+		void RunBlockCompressionBenchmark(const std::string& t_path);
+
+		// Checks the computed copy footprints, then copies random RGBA8 textures of growing size row by row, with streaming stores and with CopyRows, reports GB/s
+		void RunTextureCopyBenchmark(std::uint32_t t_texture_size);
+
+		// Records an upload and a draw list per frame for growing scenes, checks every barrier against a simulated queue, reports barriers and calls per frame
+		void RunResourceStateBenchmark(std::uint32_t t_frame_count);
+	}
+}
+
+#endif
\ No newline at end of file
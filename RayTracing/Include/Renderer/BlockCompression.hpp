@@ -0,0 +1,71 @@
+#ifndef BLOCK_COMPRESSION_HPP
+#define BLOCK_COMPRESSION_HPP
+
+#include "Renderer/MipGenerator.hpp"
+#include "Utility/ThreadPool.hpp"
+
+#include <cstdint>
+
+namespace tnt
+{
+	namespace graphics
+	{
+		// Stored in cooked textures, so the values must not change
+		enum class TextureFormat : std::uint32_t
+		{
+			RGBA8,
+			BC1,	// RGB 5:6:5 endpoints, 4 bits per texel, alpha is dropped
+			BC3,	// BC1 color with an 8 bit interpolated alpha block, 8 bits per texel
+			BC7		// Mode 6 only, RGBA 7:7:7:7 endpoints with 16 interpolation steps, 8 bits per texel
+		};
+
+		// Edge length of a block in texels
+		const std::uint32_t BLOCK_COMPRESSION_BLOCK_SIZE = 4;
+
+		const char* GetTextureFormatName(TextureFormat t_format);
+		bool IsBlockCompressed(TextureFormat t_format);
+
+		// Texels per block edge and bytes per block, a texel counts as a block for uncompressed formats
+		std::uint32_t GetFormatBlockSize(TextureFormat t_format);
+		std::uint32_t GetFormatBlockByteCount(TextureFormat t_format);
+
+		// D3D12 requires the top mip of a block compressed texture to be a whole number of blocks
+		TextureFormat ResolveTextureFormat(TextureFormat t_format, std::uint32_t t_width, std::uint32_t t_height);
+
+		// A block is 16 RGBA8 texels in row major order, red in the lowest byte
+		void EncodeBlockBC1(const std::uint8_t* t_texels, std::uint8_t* t_block);
+		void EncodeBlockBC3(const std::uint8_t* t_texels, std::uint8_t* t_block);
+		void EncodeBlockBC7(const std::uint8_t* t_texels, std::uint8_t* t_block);
+
+		void DecodeBlockBC1(const std::uint8_t* t_block, std::uint8_t* t_texels);
+		void DecodeBlockBC3(const std::uint8_t* t_block, std::uint8_t* t_texels);
+
+		// Blocks in any mode but 6 decode to opaque magenta, the encoder never writes them
+		void DecodeBlockBC7(const std::uint8_t* t_block, std::uint8_t* t_texels);
+
+		// Encodes and decodes whole mips, rows of blocks are spread over a thread pool
+		// Blocks that stick out of the mip are filled by repeating the last row and column
+		class BlockCompressor
+		{
+		public:
+			BlockCompressor();
+			~BlockCompressor();
+
+			// A thread count of zero uses every hardware thread, without Initialize everything runs on the calling thread
+			void Initialize(std::uint32_t t_thread_count = 0);
+			void Cleanup();
+
+			// The destination row pitch is the distance between two rows of blocks, throws for uncompressed formats
+			void Encode(TextureFormat t_format, const MipLevel& t_source, std::uint8_t* t_destination, std::uint32_t t_destination_row_pitch);
+			void Decode(TextureFormat t_format, const std::uint8_t* t_source, std::uint32_t t_source_row_pitch, const MipLevel& t_destination);
+
+			std::uint32_t GetThreadCount() const;
+
+		private:
+			utility::ThreadPool m_thread_pool;
+			bool m_is_initialized;
+		};
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,75 @@
+#ifndef ACCUMULATION_BUFFER_HPP
+#define ACCUMULATION_BUFFER_HPP
+
+#include "Renderer/CPU/Math.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace tnt
+{
+	namespace graphics
+	{
+		namespace cpu
+		{
+			struct AccumulationSettings
+			{
+				bool enabled = false;
+
+				// A pixel is converged once the standard error of its mean luminance drops below the threshold
+				// Half a step of the 8 bit framebuffer, more samples would not change the stored value
+				float error_threshold = 0.5f / 255.0f;
+				std::uint32_t min_sample_count = 8;		// Guards against a few samples agreeing by chance
+				std::uint32_t max_sample_count = 1024;	// Zero keeps sampling until the threshold is met
+			};
+
+			// Running mean and variance per pixel, updated with Welford's algorithm so long renders stay stable
+			class AccumulationBuffer
+			{
+			public:
+				AccumulationBuffer();
+				~AccumulationBuffer();
+
+				void Initialize(std::uint32_t t_width, std::uint32_t t_height);
+				void SetSettings(const AccumulationSettings& t_settings);
+				const AccumulationSettings& GetSettings() const;
+
+				// Drops every sample, the next frame starts from scratch
+				void Reset();
+
+				// Returns the new mean of the pixel
+				Float4 AddSample(std::uint32_t t_x, std::uint32_t t_y, const Float4& t_color);
+
+				bool IsConverged(std::uint32_t t_x, std::uint32_t t_y) const;
+				std::uint32_t GetSampleCount(std::uint32_t t_x, std::uint32_t t_y) const;
+				float GetVariance(std::uint32_t t_x, std::uint32_t t_y) const;
+
+				std::uint32_t GetWidth() const;
+				std::uint32_t GetHeight() const;
+				std::uint32_t GetConvergedPixelCount() const;
+				std::uint64_t GetTotalSampleCount() const;
+
+			private:
+				struct Pixel
+				{
+					Float4 mean;
+					float luminance_mean;
+					float luminance_m2;		// Sum of squared differences from the mean
+					std::uint32_t sample_count;
+					std::uint32_t converged;
+				};
+
+				const Pixel& GetPixel(std::uint32_t t_x, std::uint32_t t_y) const;
+
+			private:
+				std::uint32_t m_width;
+				std::uint32_t m_height;
+				AccumulationSettings m_settings;
+
+				std::vector<Pixel> m_pixels;
+			};
+		}
+	}
+}
+
+#endif
\ No newline at end of file
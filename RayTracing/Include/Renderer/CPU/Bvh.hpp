@@ -0,0 +1,131 @@
+#ifndef BVH_HPP
+#define BVH_HPP
+
+#include "Renderer/CPU/Math.hpp"
+#include "Renderer/CPU/TriangleBlocks.hpp"
+#include "Renderer/SceneData.hpp"
+#include "Utility/ThreadPool.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace tnt
+{
+	namespace graphics
+	{
+		namespace cpu
+		{
+			// Nodes this deep are never split, so traversal can use fixed size stacks
+			// Only reached by degenerate input, e.g. a very large number of nearly coincident triangles
+			const std::uint32_t MAX_BVH_DEPTH = 64;
+
+			// 32 bytes, so both children of a node share a cache line
+			struct BvhNode
+			{
+				Float3 bounds_min;
+				std::uint32_t left_first;		// Left child for interior nodes (right child is the next node), first triangle for leaves
+				Float3 bounds_max;
+				std::uint32_t triangle_count;	// Zero for interior nodes
+			};
+
+			struct BvhBuildSettings
+			{
+				std::uint32_t bin_count = 16;
+				std::uint32_t max_leaf_size = 4;
+				float traversal_cost = 1.0f;
+				float intersection_cost = 1.0f;
+
+				// Nodes with fewer triangles are built as independent subtree tasks, larger ones bin in parallel
+				// Neither value depends on the thread count, so the output is identical for any number of threads
+				std::uint32_t subtree_task_size = 16384;
+				std::uint32_t thread_count = 0;	// Zero uses every hardware thread
+			};
+
+			struct BvhBuildStatistics
+			{
+				double build_seconds;
+				std::uint32_t triangle_count;
+				std::uint32_t node_count;
+				std::uint32_t leaf_count;
+				std::uint32_t max_depth;
+				std::uint32_t thread_count;
+				std::uint32_t subtree_task_count;
+			};
+
+			struct BvhTriangle
+			{
+				Float3 v0;
+				Float3 v1;
+				Float3 v2;
+			};
+
+			// Binary bounding volume hierarchy built with binned surface area heuristic splits
+			class Bvh
+			{
+			public:
+				Bvh();
+				~Bvh();
+
+				// Every three vertices form a triangle, like a non-indexed triangle list
+				void Build(const std::vector<Vertex>& t_vertices, const BvhBuildSettings& t_settings);
+
+				// Hit::triangle_index refers to the triangle in the original vertex buffer
+				bool Intersect(const Ray& t_ray, Hit& t_hit) const;
+
+				const std::vector<BvhNode>& GetNodes() const;
+				const std::vector<BvhTriangle>& GetTriangles() const;
+				const std::vector<std::uint32_t>& GetTriangleIndices() const;
+				const TriangleBlocks<4>& GetTriangleBlocks() const;
+				const BvhBuildStatistics& GetBuildStatistics() const;
+
+			private:
+				struct SplitCandidate
+				{
+					bool is_valid;
+					int axis;
+					std::uint32_t bin;
+					float cost;
+					float centroid_min;
+					float bin_scale;
+				};
+
+				struct SubtreeTask
+				{
+					std::uint32_t root_index;
+					std::uint32_t depth;
+					BvhNode root;
+					std::vector<BvhNode> nodes;	// Child indices are local to this vector until the subtree is spliced in
+					std::uint32_t leaf_count;
+					std::uint32_t max_depth;
+				};
+
+				void BuildSubtree(SubtreeTask& t_task);
+				void SpliceSubtree(const SubtreeTask& t_task);
+
+				// Returns false when the node should stay a leaf
+				bool SplitNode(const BvhNode& t_node, std::uint32_t t_thread_count, BvhNode& t_left, BvhNode& t_right);
+
+				void UpdateNodeBounds(BvhNode& t_node) const;
+				SplitCandidate FindBestSplit(const BvhNode& t_node, std::uint32_t t_thread_count);
+				std::uint32_t Partition(const BvhNode& t_node, const SplitCandidate& t_split);
+				std::uint32_t GetBinIndex(const SplitCandidate& t_split, std::uint32_t t_triangle_index) const;
+
+			private:
+				BvhBuildSettings m_settings;
+				BvhBuildStatistics m_statistics;
+
+				std::vector<BvhNode> m_nodes;
+				std::vector<BvhTriangle> m_triangles;
+				std::vector<std::uint32_t> m_triangle_indices;	// Subtree tasks partition disjoint ranges of this array concurrently
+				TriangleBlocks<4> m_triangle_blocks;				// Same leaf order as m_triangles, tested at the leaves
+
+				// Only needed during the build
+				utility::ThreadPool m_thread_pool;
+				std::vector<Aabb> m_triangle_bounds;
+				std::vector<Float3> m_triangle_centroids;
+			};
+		}
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,45 @@
+#ifndef FRAMEBUFFER_HPP
+#define FRAMEBUFFER_HPP
+
+#include "Renderer/CPU/Math.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tnt
+{
+	namespace graphics
+	{
+		namespace cpu
+		{
+			// In-memory RGBA8 render target, same layout as DXGI_FORMAT_R8G8B8A8_UNORM
+			class Framebuffer
+			{
+			public:
+				Framebuffer();
+				~Framebuffer();
+
+				void Initialize(std::uint32_t t_width, std::uint32_t t_height);
+
+				void Clear(const Float4& t_color);
+				void SetPixel(std::uint32_t t_x, std::uint32_t t_y, const Float4& t_color);
+
+				// Binary PPM, the alpha channel is dropped
+				void SaveAsPPM(const std::string& t_path) const;
+
+				std::uint32_t GetWidth() const;
+				std::uint32_t GetHeight() const;
+				const std::uint8_t* GetPixelData() const;
+
+			private:
+				std::uint32_t m_width;
+				std::uint32_t m_height;
+
+				std::vector<std::uint8_t> m_pixels;
+			};
+		}
+	}
+}
+
+#endif
\ No newline at end of file
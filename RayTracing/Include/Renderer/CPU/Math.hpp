@@ -0,0 +1,145 @@
+#ifndef CPU_MATH_HPP
+#define CPU_MATH_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace tnt
+{
+	namespace graphics
+	{
+		namespace cpu
+		{
+			struct Float2
+			{
+				float x;
+				float y;
+			};
+
+			struct Float3
+			{
+				float x;
+				float y;
+				float z;
+
+				float& operator[](int t_axis) { return (&x)[t_axis]; }
+				float operator[](int t_axis) const { return (&x)[t_axis]; }
+			};
+
+			struct Float4
+			{
+				float x;
+				float y;
+				float z;
+				float w;
+			};
+
+			inline Float3 operator+(const Float3& t_a, const Float3& t_b) { return { t_a.x + t_b.x, t_a.y + t_b.y, t_a.z + t_b.z }; }
+			inline Float3 operator-(const Float3& t_a, const Float3& t_b) { return { t_a.x - t_b.x, t_a.y - t_b.y, t_a.z - t_b.z }; }
+			inline Float3 operator*(const Float3& t_a, float t_s) { return { t_a.x * t_s, t_a.y * t_s, t_a.z * t_s }; }
+
+			inline Float4 operator+(const Float4& t_a, const Float4& t_b) { return { t_a.x + t_b.x, t_a.y + t_b.y, t_a.z + t_b.z, t_a.w + t_b.w }; }
+			inline Float4 operator-(const Float4& t_a, const Float4& t_b) { return { t_a.x - t_b.x, t_a.y - t_b.y, t_a.z - t_b.z, t_a.w - t_b.w }; }
+			inline Float4 operator*(const Float4& t_a, float t_s) { return { t_a.x * t_s, t_a.y * t_s, t_a.z * t_s, t_a.w * t_s }; }
+
+			inline float Dot(const Float3& t_a, const Float3& t_b)
+			{
+				return t_a.x * t_b.x + t_a.y * t_b.y + t_a.z * t_b.z;
+			}
+
+			inline Float3 Cross(const Float3& t_a, const Float3& t_b)
+			{
+				return { t_a.y * t_b.z - t_a.z * t_b.y, t_a.z * t_b.x - t_a.x * t_b.z, t_a.x * t_b.y - t_a.y * t_b.x };
+			}
+
+			inline Float3 Min(const Float3& t_a, const Float3& t_b)
+			{
+				return { std::min(t_a.x, t_b.x), std::min(t_a.y, t_b.y), std::min(t_a.z, t_b.z) };
+			}
+
+			inline Float3 Max(const Float3& t_a, const Float3& t_b)
+			{
+				return { std::max(t_a.x, t_b.x), std::max(t_a.y, t_b.y), std::max(t_a.z, t_b.z) };
+			}
+
+			struct Aabb
+			{
+				Float3 min;
+				Float3 max;
+
+				void Grow(const Float3& t_point)
+				{
+					min = Min(min, t_point);
+					max = Max(max, t_point);
+				}
+
+				void Grow(const Aabb& t_other)
+				{
+					min = Min(min, t_other.min);
+					max = Max(max, t_other.max);
+				}
+
+				float GetSurfaceArea() const
+				{
+					Float3 extent = max - min;
+					return 2.0f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+				}
+			};
+
+			inline Aabb CreateEmptyAabb()
+			{
+				const float infinity = std::numeric_limits<float>::infinity();
+				return { { infinity, infinity, infinity }, { -infinity, -infinity, -infinity } };
+			}
+
+			// Avoids infinities in the slab test for axis aligned rays
+			inline Float3 ComputeInverseDirection(const Float3& t_direction)
+			{
+				const float tiny = 1e-20f;
+
+				Float3 inverse_direction = {};
+
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					float component = t_direction[axis];
+
+					if (std::fabs(component) < tiny)
+					{
+						component = (component < 0.0f) ? -tiny : tiny;
+					}
+
+					inverse_direction[axis] = 1.0f / component;
+				}
+
+				return inverse_direction;
+			}
+
+			struct Ray
+			{
+				Float3 origin;
+				Float3 direction;
+				float t_min;
+				float t_max;
+			};
+
+			struct Hit
+			{
+				float t;
+				float u;
+				float v;
+				std::uint32_t triangle_index;
+			};
+
+			const std::uint32_t INVALID_TRIANGLE_INDEX = 0xFFFFFFFF;
+
+			inline Hit CreateEmptyHit()
+			{
+				return { std::numeric_limits<float>::infinity(), 0.0f, 0.0f, INVALID_TRIANGLE_INDEX };
+			}
+		}
+	}
+}
+
+#endif
\ No newline at end of file
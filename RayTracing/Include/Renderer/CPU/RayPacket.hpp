@@ -0,0 +1,48 @@
+#ifndef RAY_PACKET_HPP
+#define RAY_PACKET_HPP
+
+#include "Renderer/CPU/Bvh.hpp"
+#include "Renderer/CPU/Math.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace tnt
+{
+	namespace graphics
+	{
+		namespace cpu
+		{
+			// Packets and streams only traverse the binary BVH and are only fed coherent primary rays, the stream sort is
+			// by direction octant alone, so it barely reorders them. Neither is faster than single rays on the wide BVHs,
+			// they are kept as a reference for coherent traversal, not as a speedup
+			enum class TraversalMode
+			{
+				SingleRay,	// Every ray traverses on its own using the selected traversal kernel
+				Packet,		// 4x4 pixel packets share one traversal, culled against the packet frustum
+				Stream		// Rays are sorted by direction octant and traced as packets
+			};
+
+			const char* GetTraversalModeName(TraversalMode t_mode);
+
+			const std::uint32_t RAY_PACKET_WIDTH = 4;
+			const std::uint32_t RAY_PACKET_HEIGHT = 4;
+			const std::uint32_t RAY_PACKET_SIZE = RAY_PACKET_WIDTH * RAY_PACKET_HEIGHT;
+
+			struct RayPacket
+			{
+				Ray rays[RAY_PACKET_SIZE];
+				std::uint32_t ray_count;
+			};
+
+			// Packets whose rays do not share one direction octant fall back to single ray traversal
+			void IntersectPacket(const Bvh& t_bvh, const RayPacket& t_packet, Hit* t_hits);
+
+			// Reorders the rays by direction octant, then traces every octant as a series of packets
+			// The hits are written in the original ray order
+			void IntersectStream(const Bvh& t_bvh, const std::vector<Ray>& t_rays, std::vector<Hit>& t_hits);
+		}
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,175 @@
+#ifndef RAY_TRACER_HPP
+#define RAY_TRACER_HPP
+
+#include "Renderer/CPU/AccumulationBuffer.hpp"
+#include "Renderer/CPU/Bvh.hpp"
+#include "Renderer/CPU/Framebuffer.hpp"
+#include "Renderer/CPU/Math.hpp"
+#include "Renderer/CPU/RayPacket.hpp"
+#include "Renderer/CPU/Sampler.hpp"
+#include "Renderer/CPU/Texture.hpp"
+#include "Renderer/CPU/WideBvh.hpp"
+#include "Renderer/SceneData.hpp"
+#include "Utility/ThreadPool.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tnt
+{
+	namespace graphics
+	{
+		namespace cpu
+		{
+			struct RenderStatistics
+			{
+				std::uint64_t ray_count;
+				double render_seconds;
+				std::uint32_t thread_count;
+				std::uint32_t tile_count;
+				std::uint32_t steal_count;
+				std::uint32_t sample_index;				// Samples per pixel accumulated before this frame
+				std::uint32_t converged_pixel_count;
+
+				double GetRaysPerSecond() const;
+				double GetRaysPerSecondPerCore() const;
+			};
+
+			// Timing of a single tile in the last frame, used to spot load imbalance
+			struct TileStatistics
+			{
+				std::uint32_t x;
+				std::uint32_t y;
+				std::uint32_t width;
+				std::uint32_t height;
+				double seconds;
+				std::uint32_t worker_index;
+				std::uint32_t ray_count;	// Lower than the pixel count once converged pixels are skipped
+			};
+
+			// Traces one primary ray per pixel through the clip space scene that Main.cpp rasterizes
+			// With accumulation enabled every frame adds a jittered sample to the pixels that have not converged yet
+			class RayTracer
+			{
+			public:
+				RayTracer();
+				~RayTracer();
+
+				// A thread count of zero uses every hardware thread
+				void Initialize(std::uint32_t t_thread_count = 0);
+				void Cleanup();
+
+				// Builds the acceleration structure, the vertices are not referenced afterwards
+				void SetScene(const std::vector<Vertex>& t_vertices, const BvhBuildSettings& t_bvh_settings);
+				// A mip count of zero builds the full chain, the same settings as the texture cache give the same mips
+				void LoadTexture(
+					const std::string& t_path,
+					std::uint32_t t_mip_count = 0,
+					TextureLayout t_layout = TextureLayout::Tiled,
+					const MipGeneratorSettings& t_mip_settings = MipGeneratorSettings(),
+					TextureFormat t_format = TextureFormat::RGBA8);
+				void SetSampler(const SamplerDesc& t_desc);
+				const SamplerDesc& GetSampler() const;
+				void SetClearColor(const Float4& t_clear_color);
+
+				// Can be switched between frames, wide BVHs are collapsed from the binary one on first use
+				void SetTraversalKernel(TraversalKernel t_kernel);
+				TraversalKernel GetTraversalKernel() const;
+
+				// Packet and stream traversal always use the binary BVH and ignore the kernel, single rays are the fast path
+				void SetTraversalMode(TraversalMode t_mode);
+				TraversalMode GetTraversalMode() const;
+
+				// Tiles are square, a multiple of the packet size keeps every packet full
+				void SetTileSize(std::uint32_t t_tile_size);
+				std::uint32_t GetTileSize() const;
+
+				// Samples are dropped whenever the scene, texture, sampler or scene constant buffer changes
+				void SetAccumulation(const AccumulationSettings& t_settings);
+				const AccumulationSettings& GetAccumulation() const;
+				void ResetAccumulation();
+				const AccumulationBuffer& GetAccumulationBuffer() const;
+
+				void Render(const SceneConstantBufferData& t_scene_data, Framebuffer& t_framebuffer);
+
+				const RenderStatistics& GetStatistics() const;
+				const std::vector<TileStatistics>& GetTileStatistics() const;
+				const BvhBuildStatistics& GetBvhBuildStatistics() const;
+
+			private:
+				// Texture coordinate change per unit of clip space x and y, constant over a triangle
+				struct TextureGradients
+				{
+					Float2 per_clip_x;
+					Float2 per_clip_y;
+				};
+
+				// Tiles are already clipped to the framebuffer, they add to the accumulation buffer so are not const
+				void RenderTile(
+					TileStatistics& t_tile,
+					const SceneConstantBufferData& t_scene_data,
+					Framebuffer& t_framebuffer);
+
+				std::uint32_t RenderPacket(
+					std::uint32_t t_x,
+					std::uint32_t t_y,
+					std::uint32_t t_end_x,
+					std::uint32_t t_end_y,
+					const SceneConstantBufferData& t_scene_data,
+					Framebuffer& t_framebuffer);
+
+				std::uint32_t RenderStream(
+					const TileStatistics& t_tile,
+					const SceneConstantBufferData& t_scene_data,
+					Framebuffer& t_framebuffer);
+
+				// Resets the accumulation buffer when anything that affects the image changed since the last frame
+				void BeginAccumulation(const SceneConstantBufferData& t_scene_data, std::uint32_t t_width, std::uint32_t t_height);
+
+				bool NeedsSample(std::uint32_t t_x, std::uint32_t t_y) const;
+				void StorePixel(std::uint32_t t_x, std::uint32_t t_y, const Float4& t_color, Framebuffer& t_framebuffer);
+
+				Ray CreatePrimaryRay(
+					std::uint32_t t_x,
+					std::uint32_t t_y,
+					std::uint32_t t_width,
+					std::uint32_t t_height,
+					const SceneConstantBufferData& t_scene_data) const;
+
+				bool IntersectScene(const Ray& t_ray, Hit& t_hit) const;
+				Float4 Shade(const Hit& t_hit) const;
+				Float4 ShadeOrClear(const Hit& t_hit) const;
+
+			private:
+				utility::ThreadPool m_thread_pool;
+				std::uint32_t m_tile_size;
+
+				Float4 m_clear_color;
+				Texture m_texture;
+				Sampler m_sampler;
+
+				TraversalKernel m_traversal_kernel;
+				TraversalMode m_traversal_mode;
+
+				Bvh m_bvh;
+				WideBvh<4> m_wide_bvh_4;
+				WideBvh<8> m_wide_bvh_8;
+				std::vector<Float2> m_texcoords;
+				std::vector<TextureGradients> m_texture_gradients;
+				Float2 m_pixel_size;	// In clip space units, set at the start of every frame
+				Float2 m_sample_offset;	// Position of the sample inside the pixel, the center unless accumulating
+
+				AccumulationBuffer m_accumulation_buffer;
+				SceneConstantBufferData m_accumulated_scene_data;
+				bool m_accumulation_valid;
+				std::uint32_t m_sample_index;
+
+				RenderStatistics m_statistics;
+				std::vector<TileStatistics> m_tile_statistics;
+			};
+		}
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,75 @@
+#ifndef SAMPLER_HPP
+#define SAMPLER_HPP
+
+#include "Renderer/CPU/Math.hpp"
+#include "Renderer/CPU/Texture.hpp"
+
+#include <cstdint>
+#include <limits>
+
+namespace tnt
+{
+	namespace graphics
+	{
+		namespace cpu
+		{
+			// D3D12_FILTER_MIN_MAG_MIP_POINT, D3D12_FILTER_MIN_MAG_LINEAR_MIP_POINT and D3D12_FILTER_MIN_MAG_MIP_LINEAR
+			enum class SamplerFilter
+			{
+				Point,
+				Bilinear,
+				Trilinear
+			};
+
+			// Same behaviour as the D3D12_TEXTURE_ADDRESS_MODE values with the same name
+			enum class TextureAddressMode
+			{
+				Wrap,
+				Mirror,
+				Clamp,
+				Border
+			};
+
+			const char* GetSamplerFilterName(SamplerFilter t_filter);
+			const char* GetTextureAddressModeName(TextureAddressMode t_mode);
+
+			// Defaults match the static sampler that Main.cpp binds for g_texture
+			struct SamplerDesc
+			{
+				SamplerFilter filter = SamplerFilter::Point;
+				TextureAddressMode address_u = TextureAddressMode::Border;
+				TextureAddressMode address_v = TextureAddressMode::Border;
+				Float4 border_color = { 0.0f, 0.0f, 0.0f, 0.0f };
+				float mip_lod_bias = 0.0f;
+				float min_lod = 0.0f;
+				float max_lod = std::numeric_limits<float>::max();
+			};
+
+			// CPU version of a D3D12 sampler, follows the filtering rules of the D3D11.3 functional specification
+			class Sampler
+			{
+			public:
+				Sampler();
+				~Sampler();
+
+				void Initialize(const SamplerDesc& t_desc);
+
+				// The derivatives are ddx(uv) and ddy(uv) of a pixel shader, the result includes the bias and LOD clamps
+				float ComputeLod(const Texture& t_texture, const Float2& t_ddx, const Float2& t_ddy) const;
+
+				Float4 Sample(const Texture& t_texture, const Float2& t_uv, float t_lod) const;
+
+				const SamplerDesc& GetDesc() const;
+
+			private:
+				Float4 SampleMip(const Texture& t_texture, std::uint32_t t_mip, const Float2& t_uv) const;
+				Float4 LoadTexel(const Texture& t_texture, std::uint32_t t_mip, std::int32_t t_x, std::int32_t t_y) const;
+
+			private:
+				SamplerDesc m_desc;
+			};
+		}
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,92 @@
+#ifndef CPU_TEXTURE_HPP
+#define CPU_TEXTURE_HPP
+
+#include "Renderer/BlockCompression.hpp"
+#include "Renderer/CPU/Math.hpp"
+#include "Renderer/MipGenerator.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tnt
+{
+	namespace graphics
+	{
+		namespace cpu
+		{
+			// One tile of RGBA8 texels fills a 64 byte cache line
+			const std::uint32_t TEXTURE_TILE_SIZE = 4;
+
+			// One Morton block of RGBA8 texels fills a 4 KB page
+			const std::uint32_t TEXTURE_MORTON_BLOCK_SIZE = 32;
+
+			enum class TextureLayout
+			{
+				Linear,		// Row major, as returned by stb_image
+				Tiled,		// Row major 4x4 tiles, row major texels inside a tile
+				Morton		// Row major 32x32 blocks, Z order texels inside a block
+			};
+
+			const char* GetTextureLayoutName(TextureLayout t_layout);
+
+			struct TextureMip
+			{
+				std::uint32_t width;
+				std::uint32_t height;
+				std::uint32_t block_count_x;
+				size_t first_texel;
+			};
+
+			// RGBA8 texture with a mip chain, kept in system memory for the CPU ray tracer
+			class Texture
+			{
+			public:
+				Texture();
+				~Texture();
+
+				// A mip count of zero builds the full chain down to 1x1, mips are built by the mip generator
+				// Texels stay RGBA8, a block compressed format only passes every mip through its encoder and decoder
+				void LoadFromFile(
+					const std::string& t_path,
+					std::uint32_t t_mip_count = 0,
+					TextureLayout t_layout = TextureLayout::Tiled,
+					const MipGeneratorSettings& t_mip_settings = MipGeneratorSettings(),
+					TextureFormat t_format = TextureFormat::RGBA8);
+				void Initialize(
+					std::uint32_t t_width,
+					std::uint32_t t_height,
+					const std::uint8_t* t_rgba_data,
+					std::uint32_t t_mip_count = 0,
+					TextureLayout t_layout = TextureLayout::Tiled,
+					const MipGeneratorSettings& t_mip_settings = MipGeneratorSettings(),
+					TextureFormat t_format = TextureFormat::RGBA8);
+
+				// Packed RGBA8 with red in the lowest byte, coordinates have to be inside the mip
+				std::uint32_t LoadTexel(std::uint32_t t_mip, std::uint32_t t_x, std::uint32_t t_y) const;
+
+				// Texels (x, y), (x + 1, y), (x, y + 1) and (x + 1, y + 1), all four have to be inside the mip
+				void LoadTexelQuad(std::uint32_t t_mip, std::uint32_t t_x, std::uint32_t t_y, std::uint32_t* t_texels) const;
+
+				TextureLayout GetLayout() const;
+				std::uint32_t GetMipCount() const;
+				std::uint32_t GetWidth(std::uint32_t t_mip = 0) const;
+				std::uint32_t GetHeight(std::uint32_t t_mip = 0) const;
+
+			private:
+				// Copies a row major mip into the texture layout
+				void StoreMip(std::uint32_t t_level, const std::uint8_t* t_rgba_data, size_t t_row_pitch);
+
+				size_t GetTexelIndex(const TextureMip& t_mip, std::uint32_t t_x, std::uint32_t t_y) const;
+
+			private:
+				TextureLayout m_layout;
+				std::vector<TextureMip> m_mips;
+				std::vector<std::uint32_t> m_texels;
+			};
+		}
+	}
+}
+
+#endif
\ No newline at end of file
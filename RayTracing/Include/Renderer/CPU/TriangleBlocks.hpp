@@ -0,0 +1,68 @@
+#ifndef TRIANGLE_BLOCKS_HPP
+#define TRIANGLE_BLOCKS_HPP
+
+#include "Renderer/CPU/Math.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace tnt
+{
+	namespace graphics
+	{
+		namespace cpu
+		{
+			struct BvhTriangle;
+
+			// Per ray setup of the watertight test, the ray is sheared so it points down the local +z axis
+			struct WatertightRay
+			{
+				Ray ray;
+				int axis_x;
+				int axis_y;
+				int axis_z;			// Dominant axis of the direction
+				float shear_x;
+				float shear_y;
+			};
+
+			WatertightRay CreateWatertightRay(const Ray& t_ray);
+
+			// Structure of arrays, indexed as component[axis][lane], one SIMD register per component
+			template<std::uint32_t Width>
+			struct TriangleBlock
+			{
+				float v0[3][Width];
+				float v1[3][Width];
+				float v2[3][Width];
+				float normal[3][Width];					// Cross(v1 - v0, v2 - v0), not normalized
+				std::uint32_t triangle_indices[Width];	// Triangle in the original vertex buffer
+			};
+
+			// Triangles packed Width at a time in BVH leaf order, leaves are not padded to a block boundary unless they are appended one by one
+			template<std::uint32_t Width>
+			class TriangleBlocks
+			{
+			public:
+				TriangleBlocks();
+				~TriangleBlocks();
+
+				// Triangles are in leaf order, t_triangle_indices maps them back to the vertex buffer
+				void Build(const BvhTriangle* t_triangles, const std::uint32_t* t_triangle_indices, std::uint32_t t_triangle_count);
+
+				// Starts a new block, a leaf of up to Width triangles is then a single SIMD test
+				// Returns the position of its first triangle, the one Intersect takes as t_first
+				std::uint32_t Append(const BvhTriangle* t_triangles, const std::uint32_t* t_triangle_indices, std::uint32_t t_triangle_count);
+
+				// Tests the triangles [t_first, t_first + t_count), only updates the hit if one is closer or wins a tie
+				bool Intersect(const WatertightRay& t_ray, std::uint32_t t_first, std::uint32_t t_count, Hit& t_hit) const;
+
+				const std::vector<TriangleBlock<Width>>& GetBlocks() const;
+
+			private:
+				std::vector<TriangleBlock<Width>> m_blocks;
+			};
+		}
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,83 @@
+#ifndef WIDE_BVH_HPP
+#define WIDE_BVH_HPP
+
+#include "Renderer/CPU/Bvh.hpp"
+#include "Renderer/CPU/Math.hpp"
+#include "Renderer/CPU/TriangleBlocks.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace tnt
+{
+	namespace graphics
+	{
+		namespace cpu
+		{
+			enum class TraversalKernel
+			{
+				Automatic,	// Widest kernel the CPU supports
+				Binary,
+				Wide4Sse,
+				Wide8Avx2
+			};
+
+			// Falls back to a kernel the CPU can run when the requested one is not supported
+			TraversalKernel ResolveTraversalKernel(TraversalKernel t_kernel);
+			const char* GetTraversalKernelName(TraversalKernel t_kernel);
+
+			// Bounds of all children are stored as structure of arrays, one SIMD register per component
+			template<std::uint32_t Width>
+			struct WideBvhNode
+			{
+				float bounds_min_x[Width];
+				float bounds_min_y[Width];
+				float bounds_min_z[Width];
+				float bounds_max_x[Width];
+				float bounds_max_y[Width];
+				float bounds_max_z[Width];
+				std::uint32_t children[Width];			// Wide node index, or first triangle for leaves, always at the start of a block
+				std::uint32_t triangle_counts[Width];	// Non-zero for leaves
+			};
+
+			const std::uint32_t EMPTY_WIDE_BVH_CHILD = 0xFFFFFFFF;
+
+			// 4-wide or 8-wide BVH, collapsed from a binary BVH whose triangles it shares
+			template<std::uint32_t Width>
+			class WideBvh
+			{
+			public:
+				WideBvh();
+				~WideBvh();
+
+				// Binary subtrees of up to Width triangles collapse into one leaf, packed into a block of its own
+				// so every leaf is a single SIMD test of the same width as the nodes
+				void Build(const Bvh& t_bvh);
+
+				bool Intersect(const Ray& t_ray, Hit& t_hit) const;
+
+				const std::vector<WideBvhNode<Width>>& GetNodes() const;
+
+			private:
+				void CollapseNode(std::uint32_t t_wide_node_index, std::uint32_t t_binary_node_index);
+
+				std::uint32_t CountTriangles(std::uint32_t t_binary_node_index);
+				void GatherTriangles(std::uint32_t t_binary_node_index);
+				bool IsLeaf(std::uint32_t t_binary_node_index) const;
+
+			private:
+				const Bvh* m_bvh;
+
+				std::vector<WideBvhNode<Width>> m_nodes;
+				TriangleBlocks<Width> m_triangle_blocks;
+
+				// Only needed during the build
+				std::vector<std::uint32_t> m_subtree_triangle_counts;
+				std::vector<BvhTriangle> m_leaf_triangles;
+				std::vector<std::uint32_t> m_leaf_triangle_indices;
+			};
+		}
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,80 @@
+#ifndef MIP_GENERATOR_HPP
+#define MIP_GENERATOR_HPP
+
+#include "Utility/ThreadPool.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace tnt
+{
+	namespace graphics
+	{
+		// Stored in cooked textures, so the values must not change
+		enum class MipFilter : std::uint32_t
+		{
+			Box,		// 2x2 average
+			Kaiser		// Kaiser windowed sinc over 12x12 source texels, keeps small mips sharper
+		};
+
+		enum class MipKernel
+		{
+			Automatic,	// Widest kernel the CPU supports
+			Scalar,
+			Sse2,
+			Avx2
+		};
+
+		// Falls back to a kernel the CPU can run when the requested one is not supported
+		MipKernel ResolveMipKernel(MipKernel t_kernel);
+		const char* GetMipFilterName(MipFilter t_filter);
+		const char* GetMipKernelName(MipKernel t_kernel);
+
+		struct MipGeneratorSettings
+		{
+			MipFilter filter = MipFilter::Box;
+			bool srgb = true;	// Color is averaged in linear light and stored as sRGB again, alpha is always linear
+			MipKernel kernel = MipKernel::Automatic;
+		};
+
+		// RGBA8 texels with red in the lowest byte, rows may be padded
+		struct MipLevel
+		{
+			std::uint8_t* data;
+			std::uint32_t width;
+			std::uint32_t height;
+			std::uint32_t row_pitch;
+		};
+
+		// Downsamples RGBA8 images on a thread pool, bands of rows are spread over the workers
+		// Every kernel produces the same bytes: linear box filtering is exact integer math, and the float filters
+		// do the same operations in the same order without fused multiply and add
+		class MipGenerator
+		{
+		public:
+			MipGenerator();
+			~MipGenerator();
+
+			// A thread count of zero uses every hardware thread
+			void Initialize(std::uint32_t t_thread_count = 0);
+			void Cleanup();
+
+			// Every level is built from the one above it, level zero holds the source image
+			void GenerateChain(const MipGeneratorSettings& t_settings, const MipLevel* t_levels, std::uint32_t t_level_count);
+
+			// The destination has to be half the source size, rounded down but at least one texel
+			void GenerateMip(const MipGeneratorSettings& t_settings, const MipLevel& t_source, const MipLevel& t_destination);
+
+			std::uint32_t GetThreadCount() const;
+
+		private:
+			utility::ThreadPool m_thread_pool;
+			bool m_is_initialized;
+
+			// One buffer per worker for decoded and filtered rows
+			std::vector<std::vector<float>> m_scratch;
+		};
+	}
+}
+
+#endif
\ No newline at end of file
@@ -1,20 +1,67 @@
 #ifndef RENDERER_HPP
 #define RENDERER_HPP
 
+#include "Renderer/CPU/Framebuffer.hpp"
+#include "Renderer/CPU/RayTracer.hpp"
+#include "Renderer/SceneData.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
 namespace tnt
 {
 	namespace graphics
 	{
+		struct RendererSettings
+		{
+			std::uint32_t width = 1280;
+			std::uint32_t height = 720;
+			std::uint32_t thread_count = 0;	// Zero uses every hardware thread
+			cpu::BvhBuildSettings bvh_build_settings;
+			cpu::TraversalKernel traversal_kernel = cpu::TraversalKernel::Automatic;
+			cpu::TraversalMode traversal_mode = cpu::TraversalMode::SingleRay;
+			std::uint32_t tile_size = 32;
+			cpu::SamplerDesc sampler;
+			std::uint32_t texture_mip_count = 0;	// Zero builds the full chain, like the texture cache Main.cpp uploads from
+			cpu::TextureLayout texture_layout = cpu::TextureLayout::Tiled;
+			MipGeneratorSettings texture_mip_settings;
+			TextureFormat texture_format = TextureFormat::RGBA8;	// Main.cpp streams BC7 from the texture cache
+			cpu::AccumulationSettings accumulation;
+		};
+
+		// Headless renderer, ray traces the scene on the CPU into an in-memory framebuffer
 		class Renderer
 		{
 		public:
 			Renderer();
 			~Renderer();
 
-			void Initialize();
+			void Initialize(
+				const RendererSettings& t_settings,
+				const std::vector<Vertex>& t_vertices,
+				const std::string& t_texture_path);
 			void Cleanup();
 
+			// With accumulation enabled the framebuffer holds the mean of every frame since the last change
+			void Render(const SceneConstantBufferData& t_scene_data);
+			void ResetAccumulation();
+
+			void SetTraversalKernel(cpu::TraversalKernel t_kernel);
+			cpu::TraversalKernel GetTraversalKernel() const;
+
+			void SetTraversalMode(cpu::TraversalMode t_mode);
+			cpu::TraversalMode GetTraversalMode() const;
+
+			const cpu::Framebuffer& GetFramebuffer() const;
+			const cpu::AccumulationBuffer& GetAccumulationBuffer() const;
+			const cpu::RenderStatistics& GetStatistics() const;
+			const std::vector<cpu::TileStatistics>& GetTileStatistics() const;
+			const cpu::BvhBuildStatistics& GetBvhBuildStatistics() const;
+
 		private:
+			cpu::RayTracer m_ray_tracer;
+			cpu::Framebuffer m_framebuffer;
 		};
 	}
 }
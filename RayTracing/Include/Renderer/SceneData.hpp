@@ -0,0 +1,46 @@
+#ifndef SCENE_DATA_HPP
+#define SCENE_DATA_HPP
+
+#include "Renderer/CPU/Math.hpp"
+#include "Utility/FixedTimestep.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace tnt
+{
+	namespace graphics
+	{
+		// Plain floats laid out like the DirectXMath types the shaders expect, so the scene builds without the Windows SDK
+		struct Vertex
+		{
+			cpu::Float4 position;
+			cpu::Float2 texcoord;
+		};
+
+		struct SceneConstantBufferData
+		{
+			cpu::Float2 positionOffset;
+		};
+
+		// The textured triangle, shared by the D3D12 and the CPU renderer
+		std::vector<Vertex> CreateTriangleScene();
+
+		// Same triangle split into t_subdivisions^2 smaller triangles, used to stress the CPU acceleration structures
+		std::vector<Vertex> CreateTessellatedTriangleScene(std::uint32_t t_subdivisions);
+
+		// Merges bit identical vertices of a triangle list, the indices rebuild the list in its original order
+		void IndexVertices(const std::vector<Vertex>& t_vertices, std::vector<Vertex>& t_unique_vertices, std::vector<std::uint32_t>& t_indices);
+
+		// Moves the triangle across the screen by t_step seconds worth of motion, wraps around once it leaves the viewport
+		void AdvanceScene(SceneConstantBufferData& t_scene_data, float t_step);
+
+		// State shown t_alpha of the way from the previous to the current simulation step, keeps moving the same way across the wrap
+		SceneConstantBufferData InterpolateScene(const SceneConstantBufferData& t_previous, const SceneConstantBufferData& t_current, float t_alpha);
+
+		// Runs the steps that are due at t_time on the last two states and returns the state to render, one loop iteration of the simulation
+		SceneConstantBufferData SimulateScene(utility::FixedTimestep& t_timestep, double t_time, SceneConstantBufferData& t_previous, SceneConstantBufferData& t_current);
+	}
+}
+
+#endif
\ No newline at end of file
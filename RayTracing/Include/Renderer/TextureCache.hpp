@@ -0,0 +1,113 @@
+#ifndef TEXTURE_CACHE_HPP
+#define TEXTURE_CACHE_HPP
+
+#include "Renderer/BlockCompression.hpp"
+#include "Renderer/MipGenerator.hpp"
+#include "Renderer/TextureFootprint.hpp"
+#include "Utility/MappedFile.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace tnt
+{
+	namespace graphics
+	{
+		const std::uint32_t TEXTURE_CACHE_MAGIC = 0x58544E54;	// "TNTX"
+		const std::uint32_t TEXTURE_CACHE_VERSION = 4;	// Bumped whenever cooked bytes change: header layout, mip filters or block compressor
+		const std::uint32_t TEXTURE_CACHE_MAX_MIP_COUNT = 16;
+
+		// Written as is at the start of a cache file, the mip data follows right after it
+		struct TextureCacheHeader
+		{
+			std::uint32_t magic;
+			std::uint32_t version;
+			std::uint64_t source_hash;
+			TextureFormat format;
+			std::uint32_t width;
+			std::uint32_t height;
+			std::uint32_t mip_count;
+			std::uint64_t data_size;	// Matches the total size GetCopyableFootprints reports for the whole chain
+			MipFilter mip_filter;
+			std::uint32_t is_srgb;		// Mips were averaged in linear light
+			SubresourceFootprint mips[TEXTURE_CACHE_MAX_MIP_COUNT];
+		};
+
+		// Subdirectory of the system temporary directory, so cooked files never land in the source tree or the working directory
+		std::string GetTemporaryCacheDirectory(const std::string& t_name);
+
+		// 64 bit FNV-1a over the source file, cache files are named after it
+		std::uint64_t HashTextureSource(const std::uint8_t* t_data, std::uint64_t t_size);
+
+		// A mip count of zero is the full chain down to 1x1, capped at the header size, returns the mip count actually used
+		std::uint32_t ComputeCachedMipFootprints(
+			TextureFormat t_format,
+			std::uint32_t t_width,
+			std::uint32_t t_height,
+			std::uint32_t t_mip_count,
+			SubresourceFootprint* t_footprints,
+			std::uint64_t& t_data_size);
+
+		// Memory mapped cache file, the data can be copied straight into an upload buffer
+		class CachedTexture
+		{
+		public:
+			CachedTexture();
+			~CachedTexture();
+
+			// Returns false when the file is missing, truncated or was written by a different cache version
+			bool Open(const std::string& t_path);
+			void Close();
+
+			const TextureCacheHeader& GetHeader() const;
+			const std::uint8_t* GetData() const;
+
+		private:
+			utility::MappedFile m_file;
+			const TextureCacheHeader* m_header;
+		};
+
+		// Cooks images into mip chains laid out in D3D12 copy footprints, once per distinct source file
+		class TextureCache
+		{
+		public:
+			TextureCache();
+			~TextureCache();
+
+			// The directory is created when missing, a mip count of zero stores the full chain
+			// Files cooked with other settings are cooked again, mip generation and block compression use every hardware thread
+			// Images that are not a whole number of blocks are stored as RGBA8 whatever the format
+			void Initialize(
+				const std::string& t_directory,
+				std::uint32_t t_mip_count = 0,
+				const MipGeneratorSettings& t_mip_settings = MipGeneratorSettings(),
+				TextureFormat t_format = TextureFormat::RGBA8);
+
+			// Maps the cooked texture for the current contents of the source file, cooking it first on a miss
+			// Throws when the source cannot be decoded or the cache file cannot be written
+			void Load(const std::string& t_source_path, CachedTexture& t_texture);
+
+			// Decodes the source, builds the mips and writes the cache file, returns its path
+			std::string Cook(const std::string& t_source_path);
+
+			std::string GetCachePath(std::uint64_t t_source_hash) const;
+			std::uint32_t GetHitCount() const;
+			std::uint32_t GetMissCount() const;
+
+		private:
+			std::string CookSource(const std::string& t_source_path, const utility::MappedFile& t_source, std::uint64_t t_source_hash);
+
+		private:
+			std::string m_directory;
+			std::uint32_t m_mip_count;
+			MipGeneratorSettings m_mip_settings;
+			MipGenerator m_mip_generator;
+			TextureFormat m_format;
+			BlockCompressor m_block_compressor;
+			std::uint32_t m_hit_count;
+			std::uint32_t m_miss_count;
+		};
+	}
+}
+
+#endif
\ No newline at end of file
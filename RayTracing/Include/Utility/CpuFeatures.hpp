@@ -0,0 +1,37 @@
+#ifndef CPU_FEATURES_HPP
+#define CPU_FEATURES_HPP
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define TNT_X86 1
+#endif
+
+// GCC and Clang only allow AVX2 intrinsics in functions compiled for AVX2, MSVC allows them anywhere
+// FMA is a separate target, kernels that must match the scalar results bit for bit stay on plain AVX2
+#if defined(TNT_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TNT_TARGET_AVX2_FMA __attribute__((target("avx2,fma")))
+#define TNT_TARGET_AVX2 __attribute__((target("avx2")))
+#define TNT_TARGET_AVX __attribute__((target("avx")))
+#else
+#define TNT_TARGET_AVX2_FMA
+#define TNT_TARGET_AVX2
+#define TNT_TARGET_AVX
+#endif
+
+namespace tnt
+{
+	namespace utility
+	{
+		struct CpuFeatures
+		{
+			bool sse41;
+			bool avx;
+			bool avx2;
+			bool fma;
+		};
+
+		// Queried once, also checks that the operating system saves the AVX registers
+		const CpuFeatures& GetCpuFeatures();
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,76 @@
+#ifndef DESCRIPTOR_TABLE_CACHE_HPP
+#define DESCRIPTOR_TABLE_CACHE_HPP
+
+#include "Utility/RingAllocator.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace tnt
+{
+	namespace utility
+	{
+		// Consecutive descriptors, sources are CPU handle values in a staging heap and destinations are ring offsets
+		struct DescriptorRange
+		{
+			std::uint64_t start;
+			std::uint32_t count;
+		};
+
+		// Places descriptor tables in a ring of shader visible descriptors and collects the copies that fill them
+		// A table with the same sources as one placed earlier in the frame is handed out again instead of being copied twice
+		class DescriptorTableCache
+		{
+		public:
+			DescriptorTableCache();
+			~DescriptorTableCache();
+
+			// The descriptor size is the handle increment of the staging heap, it tells which sources are next to each other
+			void Initialize(std::uint64_t t_capacity, std::uint64_t t_descriptor_size);
+
+			// Returns the ring offset of the first descriptor, INVALID_RING_OFFSET when the ring is full
+			std::uint64_t Allocate(const std::uint64_t* t_sources, std::uint32_t t_count);
+
+			// Copies that were not flushed yet, neighbouring ranges are merged on both sides independently
+			// Both lists cover the same number of descriptors, in the same order
+			const std::vector<DescriptorRange>& GetDestinationRanges() const;
+			const std::vector<DescriptorRange>& GetSourceRanges() const;
+			std::uint32_t GetPendingCount() const;
+			void ClearPending();
+
+			// Tables are only shared within a frame, the ring releases them a frame at a time
+			void FinishFrame(std::uint64_t t_fence_value);
+			void Retire(std::uint64_t t_completed_fence_value);
+
+			std::uint64_t GetCapacity() const;
+			std::uint64_t GetUsedCount() const;
+
+		private:
+			struct Table
+			{
+				std::uint64_t offset;
+				std::uint32_t first_source;		// Into m_table_sources, to tell tables with the same hash apart
+				std::uint32_t count;
+			};
+
+		private:
+			std::uint64_t HashSources(const std::uint64_t* t_sources, std::uint32_t t_count) const;
+			bool HasSources(const Table& t_table, const std::uint64_t* t_sources, std::uint32_t t_count) const;
+			void AddCopy(std::uint64_t t_destination, std::uint64_t t_source);
+
+		private:
+			RingAllocator m_ring;
+			std::uint64_t m_descriptor_size;
+
+			std::unordered_map<std::uint64_t, Table> m_tables;
+			std::vector<std::uint64_t> m_table_sources;
+
+			std::vector<DescriptorRange> m_destination_ranges;
+			std::vector<DescriptorRange> m_source_ranges;
+			std::uint32_t m_pending_count;
+		};
+	}
+}
+
+#endif
\ No newline at end of file
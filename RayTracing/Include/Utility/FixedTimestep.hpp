@@ -0,0 +1,52 @@
+#ifndef FIXED_TIMESTEP_HPP
+#define FIXED_TIMESTEP_HPP
+
+#include <cstdint>
+
+namespace tnt
+{
+	namespace utility
+	{
+		// Splits the time between frames into simulation steps of a fixed length, so the simulation does not depend on the frame rate
+		// Driven with the time of any clock, the window uses the wall clock and the headless paths a simulated one
+		// Time left over after the steps is returned as the interpolation factor between the last two simulated states
+		class FixedTimestep
+		{
+		public:
+			FixedTimestep();
+			~FixedTimestep();
+
+			// A frame never runs more than t_max_steps_per_frame steps, time beyond that is dropped so a long stall cannot snowball
+			void Initialize(double t_step, std::uint32_t t_max_steps_per_frame);
+
+			// Returns the number of steps to simulate this frame, the first call only starts the clock
+			std::uint32_t Advance(double t_time);
+
+			// Fraction of a step between the previous and the current simulated state, in [0, 1]
+			double GetAlpha() const;
+			double GetStep() const;
+
+			// Simulated time of the current state, the rendered state trails it by one step minus the alpha
+			double GetSimulationTime() const;
+			std::uint64_t GetStepCount() const;
+			std::uint64_t GetFrameCount() const;
+
+			// Time that was not simulated because a frame hit the step limit
+			double GetDroppedTime() const;
+
+		private:
+			double m_step;
+			std::uint32_t m_max_steps_per_frame;
+
+			bool m_started;
+			double m_last_time;
+			double m_accumulated_time;
+			double m_dropped_time;
+
+			std::uint64_t m_step_count;
+			std::uint64_t m_frame_count;
+		};
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,89 @@
+#ifndef FRAME_PACER_HPP
+#define FRAME_PACER_HPP
+
+#include <cstdint>
+#include <deque>
+#include <ostream>
+#include <vector>
+
+namespace tnt
+{
+	namespace utility
+	{
+		// One frame on the CPU and GPU timelines, in seconds of the clock the pacer is driven with
+		struct FrameTiming
+		{
+			std::uint64_t frame;
+			std::uint64_t fence_value;
+			double begin_time;
+			double latency_wait_end_time;	// The swap chain let the frame start
+			double record_time;				// The fence wait is over, recording starts
+			double submit_time;
+			double complete_time;			// First time the fence was seen at the frame's value, negative until then
+		};
+
+		// Decides what the CPU waits for before recording a frame, no waiting is done here so a simulated GPU can drive it as well
+		// Frame F only waits for the fence of frame F - N, so up to N frames are queued no matter how many back buffers there are
+		// Fence values go up by one for every frame and flush, they double as the frame values of the upload rings
+		class FramePacer
+		{
+		public:
+			FramePacer();
+			~FramePacer();
+
+			// The timeline keeps the most recent t_timeline_length frames
+			void Initialize(std::uint32_t t_frames_in_flight, std::uint32_t t_timeline_length);
+
+			void BeginFrame(double t_time);
+
+			// Called once the swap chain lets the frame start, right after BeginFrame without a swap chain
+			// Returns the fence value the CPU has to wait for before recording, zero when the frame can start right away
+			std::uint64_t EndLatencyWait(std::uint64_t t_completed_fence_value, double t_time);
+			void BeginRecording(std::uint64_t t_completed_fence_value, double t_time);
+
+			// Returns the value to signal once the command lists of the frame are submitted
+			std::uint64_t EndFrame(double t_time);
+
+			// Value for a signal outside of a frame, the caller waits for it right away
+			std::uint64_t Flush();
+
+			// Fills in the completion times of the timeline, the fence is only read now and then so they are upper bounds
+			void UpdateCompletedValue(std::uint64_t t_completed_fence_value, double t_time);
+
+			// Resources that exist once per frame in flight, like command allocators, are indexed with the slot
+			std::uint32_t GetFrameSlot() const;
+			std::uint32_t GetFramesInFlight() const;
+			std::uint64_t GetFrameCount() const;
+			std::uint64_t GetLastSignaledValue() const;
+
+			// Frames that had to wait for the fence, and for how long in total
+			std::uint64_t GetFenceStallCount() const;
+			double GetFenceStallTime() const;
+
+			const std::deque<FrameTiming>& GetTimeline() const;
+
+			// One line per frame, times relative to the first frame in the timeline
+			void WriteTimeline(std::ostream& t_stream) const;
+
+		private:
+			std::uint32_t m_frames_in_flight;
+			std::uint32_t m_timeline_length;
+
+			// Fence value of the last frame recorded in every slot
+			std::vector<std::uint64_t> m_slot_fence_values;
+
+			std::uint64_t m_frame_count;
+			std::uint64_t m_wait_value;		// Of the frame being recorded
+			std::uint64_t m_last_signaled_value;
+			std::uint64_t m_completed_value;
+
+			std::uint64_t m_fence_stall_count;
+			double m_fence_stall_time;
+
+			std::deque<FrameTiming> m_timeline;
+			size_t m_incomplete_count;		// Entries at the back of the timeline without a completion time, including the frame being recorded
+		};
+	}
+}
+
+#endif
\ No newline at end of file
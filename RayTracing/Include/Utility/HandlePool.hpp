@@ -0,0 +1,74 @@
+#ifndef HANDLE_POOL_HPP
+#define HANDLE_POOL_HPP
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace tnt
+{
+	namespace utility
+	{
+		// The low bits are the slot index, enough for the largest descriptor heap, the high bits count how often the slot was freed
+		const std::uint32_t HANDLE_INDEX_BITS = 20;
+		const std::uint32_t HANDLE_INDEX_MASK = (1u << HANDLE_INDEX_BITS) - 1;
+		const std::uint32_t HANDLE_GENERATION_MASK = (1u << (32 - HANDLE_INDEX_BITS)) - 1;
+		const std::uint32_t MAX_HANDLE_POOL_CAPACITY = 1u << HANDLE_INDEX_BITS;
+
+		// Generations start at one, so a zero handle is never valid
+		const std::uint32_t INVALID_POOL_HANDLE = 0;
+
+		// Hands out slot indices wrapped in 32 bit handles, a freed handle stops being valid right away
+		// The slot itself is only reused once every frame that was recorded before the free has completed
+		class HandlePool
+		{
+		public:
+			HandlePool();
+			~HandlePool();
+
+			void Initialize(std::uint32_t t_capacity);
+
+			// Returns INVALID_POOL_HANDLE when every slot is in use or waiting for its frame
+			std::uint32_t Allocate();
+
+			// Throws for handles that are not allocated, a second free of the same handle included
+			void Free(std::uint32_t t_handle);
+
+			bool IsValid(std::uint32_t t_handle) const;
+
+			// Throws for stale handles, so a use after free shows up on the CPU instead of as a wrong texture
+			std::uint32_t GetIndex(std::uint32_t t_handle) const;
+
+			// Same contract as the upload ring, call after signaling the fence for the frame and again once it has progressed
+			// Retire appends the slots that became free again, for callers that reset what the slot points at
+			void FinishFrame(std::uint64_t t_fence_value);
+			void Retire(std::uint64_t t_completed_fence_value, std::vector<std::uint32_t>* t_retired_indices = nullptr);
+
+			std::uint32_t GetCapacity() const;
+			std::uint32_t GetAllocatedCount() const;
+			std::uint32_t GetPendingFreeCount() const;
+
+		private:
+			struct PendingFree
+			{
+				std::uint32_t index;
+				std::uint64_t fence_value;
+			};
+
+		private:
+			// Generation of every slot, a handle is valid while its generation matches and the slot is allocated
+			std::vector<std::uint32_t> m_generations;
+			std::vector<bool> m_is_allocated;
+
+			// Slots are reused oldest first, so a generation takes as long as possible to come around again
+			std::deque<std::uint32_t> m_free_indices;
+
+			std::vector<std::uint32_t> m_freed_indices;		// Not stamped with a fence value yet
+			std::deque<PendingFree> m_pending_frees;
+
+			std::uint32_t m_allocated_count;
+		};
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,93 @@
+#ifndef IMAGE_DECODE_POOL_HPP
+#define IMAGE_DECODE_POOL_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tnt
+{
+	namespace utility
+	{
+		// Images that are decoded but not freed yet, plus the files being decoded, stay below this many bytes
+		const std::uint64_t DEFAULT_DECODE_MEMORY_BUDGET = 256 * 1024 * 1024;
+
+		// RGBA8 pixels, a null pointer means the file could not be read or decoded
+		struct DecodedImage
+		{
+			std::string path;
+			std::uint64_t tag;
+			std::uint32_t width;
+			std::uint32_t height;
+			std::uint8_t* rgba;
+			std::uint64_t encoded_size;
+		};
+
+		// Worker threads that map image files and decode them with stb_image, results come back in completion order
+		// A worker waits before decoding when the image would push the memory in flight over the budget,
+		// unless nothing else is in flight, so a single image larger than the budget still gets through
+		class ImageDecodePool
+		{
+		public:
+			ImageDecodePool();
+			~ImageDecodePool();
+
+			// A thread count of zero uses every hardware thread, the calling thread is not one of the workers
+			void Initialize(std::uint32_t t_thread_count = 0, std::uint64_t t_memory_budget = DEFAULT_DECODE_MEMORY_BUDGET);
+			void Cleanup();
+
+			// The tag is handed back with the image, to match results to requests
+			void Request(const std::string& t_path, std::uint64_t t_tag = 0);
+
+			// Decoded images count against the budget until they are freed, also for failed decodes
+			bool TryPop(DecodedImage& t_image);
+
+			// Blocks until an image is decoded, returns false right away when no request is outstanding
+			bool WaitAndPop(DecodedImage& t_image);
+
+			void Free(DecodedImage& t_image);
+
+			// Requested but not popped yet
+			std::uint32_t GetPendingCount() const;
+			std::uint32_t GetThreadCount() const;
+			std::uint64_t GetMemoryInFlight() const;
+			std::uint64_t GetPeakMemoryInFlight() const;
+
+		private:
+			struct DecodeRequest
+			{
+				std::string path;
+				std::uint64_t tag;
+			};
+
+			void WorkerLoop();
+			void Decode(const DecodeRequest& t_request, DecodedImage& t_image);
+
+			// Both expect m_mutex to be held by the lock
+			void AcquireMemory(std::unique_lock<std::mutex>& t_lock, std::uint64_t t_size);
+			void ReleaseMemory(std::uint64_t t_size);
+
+		private:
+			std::vector<std::thread> m_workers;
+			std::uint64_t m_memory_budget;
+
+			mutable std::mutex m_mutex;
+			std::condition_variable m_request_condition;
+			std::condition_variable m_result_condition;
+			std::condition_variable m_memory_condition;
+
+			std::deque<DecodeRequest> m_requests;
+			std::deque<DecodedImage> m_results;
+			std::uint32_t m_pending_count;
+			std::uint64_t m_memory_in_flight;
+			std::uint64_t m_peak_memory_in_flight;
+			bool m_is_stopping;
+		};
+	}
+}
+
+#endif
\ No newline at end of file
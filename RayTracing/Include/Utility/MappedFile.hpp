@@ -0,0 +1,42 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace tnt
+{
+	namespace utility
+	{
+		// Read only view of a whole file, pages are loaded by the OS on first access instead of copied into a buffer
+		class MappedFile
+		{
+		public:
+			MappedFile();
+			~MappedFile();
+
+			MappedFile(const MappedFile&) = delete;
+			MappedFile& operator=(const MappedFile&) = delete;
+
+			// Returns false when the file cannot be opened or is empty
+			bool Open(const std::string& t_path);
+			void Close();
+
+			const std::uint8_t* GetData() const;
+			std::uint64_t GetSize() const;
+
+		private:
+			const std::uint8_t* m_data;
+			std::uint64_t m_size;
+
+#if defined(_WIN32)
+			void* m_file;		// HANDLE, kept opaque so this header does not pull in Windows.h
+			void* m_mapping;
+#else
+			int m_file;
+#endif
+		};
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,139 @@
+#ifndef RESOURCE_STATE_TRACKER_HPP
+#define RESOURCE_STATE_TRACKER_HPP
+
+#include <cstdint>
+#include <vector>
+
+namespace tnt
+{
+	namespace utility
+	{
+		// Same value as D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES
+		const std::uint32_t ALL_SUBRESOURCES = 0xFFFFFFFF;
+
+		const std::uint32_t INVALID_RESOURCE_ID = 0xFFFFFFFF;
+		const std::uint32_t UNKNOWN_RESOURCE_STATE = 0xFFFFFFFF;
+
+		enum class BarrierSplit : std::uint32_t
+		{
+			None,
+			Begin,
+			End
+		};
+
+		// States are bit masks, the tracker only knows which bits are read only, so the same logic drives any API
+		struct StateTransition
+		{
+			std::uint32_t resource;
+			std::uint32_t subresource;
+			std::uint32_t state_before;
+			std::uint32_t state_after;
+			BarrierSplit split;
+		};
+
+		// Zero, the state buffers are promoted out of and decay back to
+		const std::uint32_t COMMON_RESOURCE_STATE = 0;
+
+		// State of every subresource as of the end of the last command list resolved against it
+		class ResourceStateRegistry
+		{
+		public:
+			ResourceStateRegistry();
+			~ResourceStateRegistry();
+
+			// Ids of unregistered resources are reused
+			// Promotable resources, buffers and simultaneous access textures, leave the common state on their first use without a barrier
+			std::uint32_t Register(std::uint32_t t_subresource_count, std::uint32_t t_initial_state, bool t_is_promotable = false);
+			void Unregister(std::uint32_t t_resource);
+
+			std::uint32_t GetState(std::uint32_t t_resource, std::uint32_t t_subresource) const;
+			void SetState(std::uint32_t t_resource, std::uint32_t t_subresource, std::uint32_t t_state);
+
+			bool IsPromotable(std::uint32_t t_resource) const;
+
+			// Call after every ExecuteCommandLists, promotable resources are back in the common state once it has finished
+			void DecayPromotedStates();
+
+			std::uint32_t GetSubresourceCount(std::uint32_t t_resource) const;
+
+			// One past the largest id handed out so far
+			std::uint32_t GetIdRange() const;
+
+		private:
+			std::vector<std::vector<std::uint32_t>> m_states;
+			std::vector<bool> m_promotable;
+			std::vector<std::uint32_t> m_promoted_resources;	// Left the common state since the last decay
+			std::vector<std::uint32_t> m_unused_ids;
+		};
+
+		// Records the states one command list needs, without looking at the global states while recording
+		// The first state a subresource is used in is resolved against the registry when the list is submitted, so lists can be recorded in parallel
+		// Barriers wait in a batch until FlushBarriers, a transition that undoes a waiting one cancels it instead of adding another
+		// Promotable resources that are in the common state on submit need no barrier into their first state
+		class ResourceStateTracker
+		{
+		public:
+			ResourceStateTracker();
+			~ResourceStateTracker();
+
+			// Read only states combine, a subresource that is already in a superset of the requested read state stays where it is
+			void Initialize(const ResourceStateRegistry* t_registry, std::uint32_t t_read_only_states);
+
+			// Forgets everything recorded, call when the command list is reset
+			void Reset();
+
+			void Transition(std::uint32_t t_resource, std::uint32_t t_state, std::uint32_t t_subresource = ALL_SUBRESOURCES);
+
+			// Starts a split barrier, the GPU may overlap it with other work until the next transition of the subresource ends it
+			// Behaves like Transition the first time the subresource is used in the list
+			void BeginTransition(std::uint32_t t_resource, std::uint32_t t_state, std::uint32_t t_subresource = ALL_SUBRESOURCES);
+
+			// Appends the waiting barriers in the order they were requested, they have to be recorded before the work that needs the states
+			void FlushBarriers(std::vector<StateTransition>& t_barriers);
+
+			// Ends every split barrier that is still open and flushes, call right before closing the command list
+			void FinishRecording(std::vector<StateTransition>& t_barriers);
+
+			// Call in submission order, appends the barriers that have to run before the list and stores its final states in the registry
+			void Resolve(ResourceStateRegistry& t_registry, std::vector<StateTransition>& t_barriers);
+
+			// State the list leaves the subresource in, UNKNOWN_RESOURCE_STATE when it was not used
+			std::uint32_t GetState(std::uint32_t t_resource, std::uint32_t t_subresource) const;
+
+		private:
+			struct TrackedResource
+			{
+				std::vector<std::uint32_t> first_states;		// Resolved against the registry on submit
+				std::vector<std::uint32_t> current_states;
+				std::vector<std::uint32_t> split_states;		// Target of an open split barrier
+				std::vector<std::uint32_t> split_subresources;	// Subresource the split was started for, it has to end with the same one
+				std::vector<std::uint32_t> pending_barriers;	// Index of the waiting barrier that last changed the subresource
+				std::vector<std::uint64_t> first_flushes;		// Flush count at the first use, nothing used the first state while it is unchanged
+				std::uint64_t generation;
+				bool is_promotable;
+			};
+
+			TrackedResource& Track(std::uint32_t t_resource);
+			void Apply(std::uint32_t t_resource, std::uint32_t t_state, std::uint32_t t_subresource, BarrierSplit t_split);
+			void ApplySubresource(TrackedResource& t_tracked, std::uint32_t t_resource, std::uint32_t t_index, std::uint32_t t_subresource, std::uint32_t t_state, BarrierSplit t_split);
+			void PushBarrier(TrackedResource& t_tracked, std::uint32_t t_index, const StateTransition& t_barrier);
+
+			bool IsUniform(const TrackedResource& t_tracked) const;
+			bool IsSatisfied(std::uint32_t t_current_state, std::uint32_t t_state) const;
+
+		private:
+			const ResourceStateRegistry* m_registry;
+			std::uint32_t m_read_only_states;
+
+			// Indexed by resource id, entries from an older generation count as untouched so Reset does not have to clear them
+			std::vector<TrackedResource> m_resources;
+			std::vector<std::uint32_t> m_touched_resources;
+			std::uint64_t m_generation;
+
+			std::vector<StateTransition> m_pending_barriers;
+			std::uint64_t m_flush_count;
+		};
+	}
+}
+
+#endif
\ No newline at end of file
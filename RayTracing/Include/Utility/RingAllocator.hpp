@@ -0,0 +1,54 @@
+#ifndef RING_ALLOCATOR_HPP
+#define RING_ALLOCATOR_HPP
+
+#include <cstdint>
+#include <deque>
+
+namespace tnt
+{
+	namespace utility
+	{
+		const std::uint64_t INVALID_RING_OFFSET = 0xFFFFFFFFFFFFFFFF;
+
+		// Hands out offsets into a fixed size ring, no memory is owned so the same logic drives CPU and GPU buffers
+		// Allocations are freed a whole frame at a time, once the fence value that frame was submitted with has completed
+		class RingAllocator
+		{
+		public:
+			RingAllocator();
+			~RingAllocator();
+
+			void Initialize(std::uint64_t t_capacity);
+
+			// Returns INVALID_RING_OFFSET when the ring is full, allocations never wrap around the end
+			std::uint64_t Allocate(std::uint64_t t_size, std::uint64_t t_alignment);
+
+			// Everything allocated since the previous call is released once t_fence_value has completed
+			void FinishFrame(std::uint64_t t_fence_value);
+			void Retire(std::uint64_t t_completed_fence_value);
+
+			std::uint64_t GetCapacity() const;
+			std::uint64_t GetUsedSize() const;
+
+			// Frames finished but not yet retired
+			std::uint32_t GetFrameCount() const;
+
+		private:
+			struct Frame
+			{
+				std::uint64_t fence_value;
+				std::uint64_t size;		// Includes alignment padding and the skipped space at the end of the ring
+			};
+
+		private:
+			std::uint64_t m_capacity;
+			std::uint64_t m_head;		// Next free byte
+			std::uint64_t m_used_size;
+			std::uint64_t m_frame_size;	// Allocated since the last FinishFrame
+
+			std::deque<Frame> m_frames;
+		};
+	}
+}
+
+#endif
\ No newline at end of file
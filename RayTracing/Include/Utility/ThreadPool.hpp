@@ -0,0 +1,76 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tnt
+{
+	namespace utility
+	{
+		// Called with the task index and the index of the worker that runs it
+		using ThreadPoolTask = std::function<void(std::uint32_t, std::uint32_t)>;
+
+		// Persistent workers that each own a task queue, idle workers steal from the back of other queues
+		class ThreadPool
+		{
+		public:
+			ThreadPool();
+			~ThreadPool();
+
+			// A thread count of zero uses every hardware thread, the calling thread counts as worker zero
+			void Initialize(std::uint32_t t_thread_count = 0);
+			void Cleanup();
+
+			// Blocks until every task has run, tasks are handed out to the workers in contiguous ranges
+			void Run(std::uint32_t t_task_count, const ThreadPoolTask& t_task);
+
+			std::uint32_t GetThreadCount() const;
+
+			// Number of tasks that were stolen during the last call to Run
+			std::uint32_t GetStealCount() const;
+
+		private:
+			// Every worker locks only its own queue, or the queue it steals from
+			struct WorkQueue
+			{
+				std::mutex mutex;
+				std::deque<std::uint32_t> tasks;
+			};
+
+			void WorkerLoop(std::uint32_t t_worker_index);
+			void RunTasks(std::uint32_t t_worker_index);
+
+			bool PopTask(std::uint32_t t_worker_index, std::uint32_t& t_task_index);
+			bool StealTask(std::uint32_t t_worker_index, std::uint32_t& t_task_index);
+
+		private:
+			std::uint32_t m_thread_count;
+			std::vector<std::thread> m_workers;
+			std::vector<std::unique_ptr<WorkQueue>> m_queues;
+
+			// Wakes the workers when a new batch of tasks is queued
+			std::mutex m_wake_mutex;
+			std::condition_variable m_wake_condition;
+			std::uint64_t m_batch_index;
+			bool m_is_stopping;
+
+			// Signals the calling thread once the last task of a batch is done
+			std::mutex m_done_mutex;
+			std::condition_variable m_done_condition;
+
+			const ThreadPoolTask* m_task;
+			std::atomic<std::uint32_t> m_remaining_task_count;
+			std::atomic<std::uint32_t> m_steal_count;
+		};
+	}
+}
+
+#endif
\ No newline at end of file
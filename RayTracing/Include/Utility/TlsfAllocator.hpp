@@ -0,0 +1,90 @@
+#ifndef TLSF_ALLOCATOR_HPP
+#define TLSF_ALLOCATOR_HPP
+
+#include <cstdint>
+#include <vector>
+
+namespace tnt
+{
+	namespace utility
+	{
+		const std::uint32_t INVALID_TLSF_HANDLE = 0xFFFFFFFF;
+
+		// Default granularity, sizes and offsets are multiples of it, it matches the constant buffer placement alignment
+		const std::uint64_t TLSF_GRANULARITY = 256;
+
+		// Every free size class splits into this many linear subclasses, so a good fit wastes at most 1/16th
+		const std::uint32_t TLSF_SECOND_LEVEL_COUNT = 16;
+		const std::uint32_t TLSF_FIRST_LEVEL_COUNT = 53;
+
+		// Two level segregated fit allocator, O(1) allocation and free with immediate coalescing
+		// Only offsets are tracked, so it can place GPU resources in memory the CPU never sees
+		class TlsfAllocator
+		{
+		public:
+			TlsfAllocator();
+			~TlsfAllocator();
+
+			// The granularity has to be a power of two, a granularity of one hands out single units such as descriptors
+			void Initialize(std::uint64_t t_capacity, std::uint64_t t_granularity = TLSF_GRANULARITY);
+
+			// Alignment has to be a power of two and is at least the granularity, returns INVALID_TLSF_HANDLE when no free block is large enough
+			std::uint32_t Allocate(std::uint64_t t_size, std::uint64_t t_alignment = TLSF_GRANULARITY);
+			void Free(std::uint32_t t_handle);
+
+			std::uint64_t GetOffset(std::uint32_t t_handle) const;
+			std::uint64_t GetSize(std::uint32_t t_handle) const;
+
+			std::uint64_t GetCapacity() const;
+			std::uint64_t GetFreeSize() const;
+			std::uint32_t GetAllocationCount() const;
+
+			// Walks one free list, used to measure external fragmentation
+			std::uint64_t GetLargestFreeBlockSize() const;
+
+		private:
+			struct Block
+			{
+				std::uint64_t offset;
+				std::uint64_t size;
+
+				// Neighbours in memory, used to coalesce on free
+				std::uint32_t previous_physical;
+				std::uint32_t next_physical;
+
+				// Neighbours in the free list of the size class, only valid while the block is free
+				std::uint32_t previous_free;
+				std::uint32_t next_free;
+
+				bool is_free;
+			};
+
+			std::uint32_t CreateBlock(std::uint64_t t_offset, std::uint64_t t_size);
+			void DestroyBlock(std::uint32_t t_block_index);
+
+			void InsertFreeBlock(std::uint32_t t_block_index);
+			void RemoveFreeBlock(std::uint32_t t_block_index);
+			std::uint32_t FindFreeBlock(std::uint64_t t_size) const;
+
+			// Cuts t_size bytes off the front of a block, the front part keeps the block index
+			std::uint32_t SplitBlock(std::uint32_t t_block_index, std::uint64_t t_size);
+
+		private:
+			std::uint64_t m_capacity;
+			std::uint64_t m_granularity;
+			std::uint32_t m_granularity_log2;
+			std::uint64_t m_free_size;
+			std::uint32_t m_allocation_count;
+
+			// Block nodes are recycled through an index list, handles stay stable while the vector grows
+			std::vector<Block> m_blocks;
+			std::vector<std::uint32_t> m_unused_blocks;
+
+			std::uint64_t m_first_level_bitmap;
+			std::uint32_t m_second_level_bitmaps[TLSF_FIRST_LEVEL_COUNT];
+			std::uint32_t m_free_lists[TLSF_FIRST_LEVEL_COUNT][TLSF_SECOND_LEVEL_COUNT];
+		};
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,77 @@
+#ifndef BINDLESS_TABLE_HPP
+#define BINDLESS_TABLE_HPP
+
+#include "Utility/HandlePool.hpp"
+#include "Wrapper/DX12/DescriptorHeap.hpp"
+
+#include <wrl.h>
+#include <d3d12.h>
+
+#include <vector>
+
+namespace tnt
+{
+	namespace wrapper
+	{
+		namespace dx12
+		{
+			using BindlessHandle = UINT32;
+
+			const BindlessHandle INVALID_BINDLESS_HANDLE = utility::INVALID_POOL_HANDLE;
+
+			// A range of a shader visible heap that shaders index into directly, the table is bound once per command list
+			// Draws pass the index of their texture as a root constant instead of binding a descriptor table of their own
+			class BindlessTable
+			{
+			public:
+				BindlessTable();
+				~BindlessTable();
+
+				// The range is allocated from the heap, which has to be a shader visible CBV/SRV/UAV heap
+				// Views are written to a range of the same size in the staging heap and copied over, the shader visible heap is never written directly
+				// Every slot starts out as a null texture view, tier 1 hardware needs the whole bound table to be valid
+				void Initialize(ID3D12Device* t_device, DescriptorHeap* t_heap, DescriptorHeap* t_staging_heap, UINT t_capacity);
+				void Cleanup();
+
+				// Throws when every slot is in use or still referenced by a frame in flight
+				BindlessHandle CreateShaderResourceView(ID3D12Resource* t_resource, const D3D12_SHADER_RESOURCE_VIEW_DESC& t_desc);
+
+				// The handle is stale right away, the slot is reset to a null view and reused once the frames recorded up to now have completed
+				void Free(BindlessHandle t_handle);
+
+				bool IsValid(BindlessHandle t_handle) const;
+
+				// Index for the shader, throws for stale handles
+				UINT GetIndex(BindlessHandle t_handle) const;
+
+				// Same contract as the upload ring, call after signaling the fence for the frame and again once it has progressed
+				void FinishFrame(UINT64 t_fence_value);
+				void Retire(UINT64 t_completed_fence_value);
+
+				// First descriptor of the table, for SetGraphicsRootDescriptorTable
+				D3D12_GPU_DESCRIPTOR_HANDLE GetGpuHandle() const;
+
+				// Staging copy of the view, a source for descriptor tables assembled in a DescriptorTableRing
+				D3D12_CPU_DESCRIPTOR_HANDLE GetStagingHandle(BindlessHandle t_handle) const;
+				UINT GetCapacity() const;
+				UINT GetAllocatedCount() const;
+
+			private:
+				void CreateNullView(UINT t_index);
+				void CopyToTable(UINT t_index, UINT t_count);
+
+			private:
+				ID3D12Device* m_device;
+				DescriptorHeap* m_heap;
+				DescriptorHeap* m_staging_heap;
+				DescriptorAllocation m_range;
+				DescriptorAllocation m_staging_range;
+
+				utility::HandlePool m_handles;
+				std::vector<std::uint32_t> m_retired_indices;
+			};
+		}
+	}
+}
+
+#endif
\ No newline at end of file
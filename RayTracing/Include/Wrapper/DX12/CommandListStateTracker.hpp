@@ -0,0 +1,91 @@
+#ifndef COMMAND_LIST_STATE_TRACKER_HPP
+#define COMMAND_LIST_STATE_TRACKER_HPP
+
+#include "Utility/ResourceStateTracker.hpp"
+
+#include <wrl.h>
+#include <d3d12.h>
+
+#include <vector>
+
+namespace tnt
+{
+	namespace wrapper
+	{
+		namespace dx12
+		{
+			// Resources whose states are tracked, with the state each one is left in by the command lists submitted so far
+			class TrackedResources
+			{
+			public:
+				TrackedResources();
+				~TrackedResources();
+
+				// Every mip and array slice is tracked on its own, buffers have a single subresource
+				// Buffers and simultaneous access textures are promoted out of D3D12_RESOURCE_STATE_COMMON by their first use
+				UINT Register(ID3D12Resource* t_resource, D3D12_RESOURCE_STATES t_initial_state);
+				void Unregister(UINT t_resource);
+
+				// Call after every ExecuteCommandLists on a queue whose lists use tracked resources
+				void DecayPromotedStates();
+
+				ID3D12Resource* GetResourcePointer(UINT t_resource) const;
+				D3D12_RESOURCE_STATES GetState(UINT t_resource, UINT t_subresource = 0) const;
+
+				utility::ResourceStateRegistry& GetRegistry();
+
+			private:
+				utility::ResourceStateRegistry m_registry;
+				std::vector<ID3D12Resource*> m_resources;
+			};
+
+			// Replaces hand written transition barriers, one tracker per command list that is recorded at the same time
+			// Transitions wait until FlushBarriers, which records all of them with a single ResourceBarrier call
+			class CommandListStateTracker
+			{
+			public:
+				CommandListStateTracker();
+				~CommandListStateTracker();
+
+				void Initialize(TrackedResources* t_resources);
+
+				// Call whenever the command list is reset
+				void Reset();
+
+				void Transition(UINT t_resource, D3D12_RESOURCE_STATES t_state, UINT t_subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+
+				// Split barrier, the transition ends with the next Transition of the resource or when the recording finishes
+				void BeginTransition(UINT t_resource, D3D12_RESOURCE_STATES t_state, UINT t_subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+
+				// Has to be called before recording work that depends on the requested states
+				void FlushBarriers(ID3D12GraphicsCommandList* t_command_list);
+
+				// Ends open split barriers and flushes, call right before closing the command list
+				void FinishRecording(ID3D12GraphicsCommandList* t_command_list);
+
+				// Call in submission order, records the barriers that bring the resources into the states the list starts with
+				// Returns false when there were none, the fix up list then does not have to be submitted ahead of the command list
+				bool Resolve(ID3D12GraphicsCommandList* t_fixup_command_list);
+
+				// Barriers recorded since the last Reset, fix ups included, and the ResourceBarrier calls it took
+				UINT GetBarrierCount() const;
+				UINT GetBarrierCallCount() const;
+
+			private:
+				void RecordBarriers(ID3D12GraphicsCommandList* t_command_list);
+
+			private:
+				TrackedResources* m_resources;
+				utility::ResourceStateTracker m_tracker;
+
+				std::vector<utility::StateTransition> m_transitions;
+				std::vector<D3D12_RESOURCE_BARRIER> m_barriers;
+
+				UINT m_barrier_count;
+				UINT m_barrier_call_count;
+			};
+		}
+	}
+}
+
+#endif
\ No newline at end of file
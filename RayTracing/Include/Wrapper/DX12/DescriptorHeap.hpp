@@ -1,6 +1,8 @@
 #ifndef DESCRIPTOR_HEAP_HPP
 #define DESCRIPTOR_HEAP_HPP
 
+#include "Utility/TlsfAllocator.hpp"
+
 #include <wrl.h>
 #include <d3d12.h>
 
@@ -10,6 +12,19 @@ namespace tnt
 	{
 		namespace dx12
 		{
+			// A contiguous range of descriptors, the handles point at the first one
+			struct DescriptorAllocation
+			{
+				D3D12_CPU_DESCRIPTOR_HANDLE cpu_handle;
+				D3D12_GPU_DESCRIPTOR_HANDLE gpu_handle;		// Zero when the heap is not shader visible
+				UINT index;
+				UINT count;
+				UINT32 handle;
+			};
+
+			// Descriptors are handed out by a TLSF allocator with a granularity of one descriptor
+			// Single descriptors and ranges both allocate and free in O(1), freed ranges merge with their free neighbours
+			// Heaps without the shader visible flag live in CPU memory, views are created there and copied into the shader visible heap
 			class DescriptorHeap
 			{
 			public:
@@ -22,7 +37,21 @@ namespace tnt
 					D3D12_DESCRIPTOR_HEAP_TYPE t_heap_type,
 					D3D12_DESCRIPTOR_HEAP_FLAGS t_flags);
 
+				// Throws when no free range is large enough
+				DescriptorAllocation Allocate(UINT t_count = 1);
+
+				// The GPU has to be done with the descriptors before they are freed
+				void Free(DescriptorAllocation& t_allocation);
+
+				D3D12_CPU_DESCRIPTOR_HANDLE GetCpuHandle(const DescriptorAllocation& t_allocation, UINT t_offset) const;
+				D3D12_GPU_DESCRIPTOR_HANDLE GetGpuHandle(const DescriptorAllocation& t_allocation, UINT t_offset) const;
+
 				ID3D12DescriptorHeap* const GetDescriptorHeapPointer() const;
+				UINT GetDescriptorSize() const;
+				UINT GetDescriptorCount() const;
+				UINT GetFreeCount() const;
+				D3D12_DESCRIPTOR_HEAP_TYPE GetHeapType() const;
+				bool IsShaderVisible() const;
 
 			private:
 				D3D12_DESCRIPTOR_HEAP_DESC CreateDescriptorHeapDescription(
@@ -32,6 +61,13 @@ namespace tnt
 
 			private:
 				Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_descriptor_heap;
+				utility::TlsfAllocator m_allocator;
+
+				D3D12_CPU_DESCRIPTOR_HANDLE m_cpu_start;
+				D3D12_GPU_DESCRIPTOR_HANDLE m_gpu_start;
+				UINT m_descriptor_size;
+				UINT m_descriptor_count;
+				D3D12_DESCRIPTOR_HEAP_TYPE m_heap_type;
 			};
 		}
 	}
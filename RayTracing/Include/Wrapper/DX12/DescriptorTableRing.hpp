@@ -0,0 +1,62 @@
+#ifndef DESCRIPTOR_TABLE_RING_HPP
+#define DESCRIPTOR_TABLE_RING_HPP
+
+#include "Utility/DescriptorTableCache.hpp"
+#include "Wrapper/DX12/DescriptorHeap.hpp"
+
+#include <wrl.h>
+#include <d3d12.h>
+
+#include <vector>
+
+namespace tnt
+{
+	namespace wrapper
+	{
+		namespace dx12
+		{
+			// Per frame region of a shader visible heap, descriptor tables are assembled in it from views in a staging heap
+			// The copies of a whole frame go out in one CopyDescriptors call, and identical tables within a frame are only copied once
+			class DescriptorTableRing
+			{
+			public:
+				DescriptorTableRing();
+				~DescriptorTableRing();
+
+				// The region is allocated from the shader visible heap, sources have to come from a staging heap of the same type
+				void Initialize(ID3D12Device* t_device, DescriptorHeap* t_heap, UINT t_capacity, UINT t_staging_descriptor_size);
+				void Cleanup();
+
+				// The handle can be bound right away, the descriptors are written by the next FlushCopies
+				// Throws when the frames in flight use up the whole region
+				D3D12_GPU_DESCRIPTOR_HANDLE AllocateTable(const D3D12_CPU_DESCRIPTOR_HANDLE* t_sources, UINT t_count);
+
+				// Has to be called before the command lists that bind the tables are executed, the staging views have to be alive until then
+				void FlushCopies();
+
+				// Same contract as the upload ring, call after signaling the fence for the frame and again once it has progressed
+				void FinishFrame(UINT64 t_fence_value);
+				void Retire(UINT64 t_completed_fence_value);
+
+				UINT GetCapacity() const;
+				UINT GetUsedCount() const;
+
+			private:
+				ID3D12Device* m_device;
+				DescriptorHeap* m_heap;
+				DescriptorAllocation m_range;
+
+				utility::DescriptorTableCache m_tables;
+				std::vector<std::uint64_t> m_source_values;
+
+				// Kept around so flushing does not allocate
+				std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> m_destination_starts;
+				std::vector<UINT> m_destination_sizes;
+				std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> m_source_starts;
+				std::vector<UINT> m_source_sizes;
+			};
+		}
+	}
+}
+
+#endif
\ No newline at end of file
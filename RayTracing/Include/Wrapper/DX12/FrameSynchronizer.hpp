@@ -0,0 +1,67 @@
+#ifndef FRAME_SYNCHRONIZER_HPP
+#define FRAME_SYNCHRONIZER_HPP
+
+#include "Utility/FramePacer.hpp"
+
+#include <wrl.h>
+#include <d3d12.h>
+#include <dxgi1_4.h>
+
+#include <chrono>
+
+namespace tnt
+{
+	namespace wrapper
+	{
+		namespace dx12
+		{
+			// Owns the frame fence of a queue and does the waiting the frame pacer asks for
+			// With a swap chain, frames also wait on its frame latency waitable object, so the CPU never runs ahead of the display
+			class FrameSynchronizer
+			{
+			public:
+				FrameSynchronizer();
+				~FrameSynchronizer();
+
+				// The swap chain is optional, it has to be created with DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT
+				void Initialize(
+					ID3D12Device* t_device,
+					ID3D12CommandQueue* t_command_queue,
+					IDXGISwapChain2* t_swap_chain,
+					UINT t_frames_in_flight,
+					UINT t_timeline_length);
+				void Cleanup();
+
+				// Blocks until the swap chain takes another frame and the frame in the same slot has completed
+				void BeginFrame();
+
+				// Signals the fence behind the submitted command lists, returns the value for FinishFrame of the rings
+				UINT64 EndFrame();
+
+				// Signals and waits until the queue is idle, for setup and shutdown
+				UINT64 Flush();
+
+				// Also fills in the GPU side of the timeline
+				UINT64 GetCompletedValue();
+
+				UINT GetFrameSlot() const;
+				const utility::FramePacer& GetPacer() const;
+
+			private:
+				void WaitForFenceValue(UINT64 t_fence_value);
+				double GetTime() const;
+
+			private:
+				ID3D12CommandQueue* m_command_queue;
+				Microsoft::WRL::ComPtr<ID3D12Fence> m_fence;
+				HANDLE m_fence_event;
+				HANDLE m_frame_latency_waitable;
+
+				utility::FramePacer m_pacer;
+				std::chrono::steady_clock::time_point m_start_time;
+			};
+		}
+	}
+}
+
+#endif
\ No newline at end of file
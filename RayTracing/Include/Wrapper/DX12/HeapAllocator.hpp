@@ -0,0 +1,69 @@
+#ifndef HEAP_ALLOCATOR_HPP
+#define HEAP_ALLOCATOR_HPP
+
+#include "Utility/TlsfAllocator.hpp"
+
+#include <wrl.h>
+#include <d3d12.h>
+
+#include <vector>
+
+namespace tnt
+{
+	namespace wrapper
+	{
+		namespace dx12
+		{
+			struct HeapAllocation
+			{
+				UINT heap_index;
+				UINT32 handle;
+			};
+
+			// Places resources in large ID3D12Heap blocks instead of giving every resource its own committed allocation
+			// Resource heap tier 1 cannot mix buffers and textures in a heap, so every allocator serves a single heap flag category
+			class HeapAllocator
+			{
+			public:
+				HeapAllocator();
+				~HeapAllocator();
+
+				// Heap sizes are rounded up to 64 KB, resources larger than a heap get a dedicated heap of their own
+				void Initialize(ID3D12Device* t_device, D3D12_HEAP_TYPE t_heap_type, D3D12_HEAP_FLAGS t_heap_flags, UINT64 t_heap_size);
+
+				// Small textures are placed with 4 KB alignment when the device allows it
+				HeapAllocation CreateResource(
+					const D3D12_RESOURCE_DESC& t_desc,
+					D3D12_RESOURCE_STATES t_initial_state,
+					const D3D12_CLEAR_VALUE* t_clear_value,
+					REFIID t_riid,
+					void** t_resource);
+
+				// The resource has to be released, and the GPU done with it, before its memory is reused
+				void Free(const HeapAllocation& t_allocation);
+
+				UINT GetHeapCount() const;
+				UINT64 GetAllocatedSize() const;
+
+			private:
+				struct Heap
+				{
+					Microsoft::WRL::ComPtr<ID3D12Heap> heap;
+					utility::TlsfAllocator allocator;
+				};
+
+				UINT CreateHeap(UINT64 t_size);
+
+			private:
+				ID3D12Device* m_device;
+				D3D12_HEAP_TYPE m_heap_type;
+				D3D12_HEAP_FLAGS m_heap_flags;
+				UINT64 m_heap_size;
+
+				std::vector<Heap> m_heaps;
+			};
+		}
+	}
+}
+
+#endif
\ No newline at end of file
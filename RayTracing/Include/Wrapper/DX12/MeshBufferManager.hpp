@@ -0,0 +1,148 @@
+#ifndef MESH_BUFFER_MANAGER_HPP
+#define MESH_BUFFER_MANAGER_HPP
+
+#include "Utility/TlsfAllocator.hpp"
+#include "Wrapper/DX12/CommandListStateTracker.hpp"
+#include "Wrapper/DX12/HeapAllocator.hpp"
+#include "Wrapper/DX12/UploadRing.hpp"
+
+#include <wrl.h>
+#include <d3d12.h>
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace tnt
+{
+	namespace wrapper
+	{
+		namespace dx12
+		{
+			using MeshHandle = UINT32;
+
+			const MeshHandle INVALID_MESH_HANDLE = 0xFFFFFFFF;
+
+			// Keeps the vertices and indices of every mesh in two large default heap buffers, each mesh is a range with its own views
+			// Uploads are staged in a persistent upload ring and copied in batches on the direct queue, so draws only read GPU local memory
+			class MeshBufferManager
+			{
+			public:
+				MeshBufferManager();
+				~MeshBufferManager();
+
+				// The heap allocator has to place buffers in a default heap, the staging ring has to fit the largest mesh
+				// Both buffers are registered with the tracked resources, the command list trackers move them between copy and draw states
+				void Initialize(
+					ID3D12Device* t_device,
+					HeapAllocator* t_buffer_heap_allocator,
+					TrackedResources* t_tracked_resources,
+					UINT64 t_vertex_buffer_size,
+					UINT64 t_index_buffer_size,
+					UINT64 t_staging_ring_size);
+				void Cleanup();
+
+				// The data is copied right away, indices are stored as 16 bit whenever the vertex count allows it
+				// Throws when either buffer has no room left for the mesh
+				MeshHandle AddMesh(const void* t_vertices, UINT t_vertex_count, UINT t_vertex_stride, const std::uint32_t* t_indices, UINT t_index_count);
+
+				// The ranges are reused once every frame recorded up to now has completed
+				void RemoveMesh(MeshHandle t_mesh);
+
+				// Copies as many waiting meshes as fit in the staging ring, adjacent ranges go over in a single copy
+				// Has to be recorded before the draws of the frame, on a command list of the direct queue
+				void RecordUploads(ID3D12GraphicsCommandList* t_command_list, CommandListStateTracker& t_state_tracker);
+
+				// Requests the vertex and index buffer states, they are recorded with the next flush of the tracker
+				void PrepareForDraw(CommandListStateTracker& t_state_tracker);
+
+				// Same contract as the upload ring, call after signaling the fence for the frame and again once it has progressed
+				void FinishFrame(UINT64 t_fence_value);
+				void Retire(UINT64 t_completed_fence_value);
+
+				// Only resident meshes may be drawn, the copy of any other one may still be in flight or not even recorded
+				bool IsResident(MeshHandle t_mesh) const;
+				UINT GetPendingCount() const;
+
+				D3D12_VERTEX_BUFFER_VIEW GetVertexBufferView(MeshHandle t_mesh) const;
+				D3D12_INDEX_BUFFER_VIEW GetIndexBufferView(MeshHandle t_mesh) const;
+				UINT GetIndexCount(MeshHandle t_mesh) const;
+
+			private:
+				enum class MeshState
+				{
+					Free,
+					Waiting,	// Data is in system memory, no copy recorded yet
+					Recorded,	// Copy recorded in the current frame
+					Uploading,	// Copy submitted, resident once the fence value is reached
+					Resident
+				};
+
+				struct Mesh
+				{
+					MeshState state;
+					UINT64 fence_value;
+					std::uint32_t vertex_handle;
+					std::uint32_t index_handle;
+					UINT vertex_size;
+					UINT vertex_stride;
+					UINT index_size;
+					UINT index_count;
+					DXGI_FORMAT index_format;
+					std::vector<std::uint8_t> data;	// Vertices followed by indices until the copy is recorded
+				};
+
+				// A mesh range freed while frames that may draw it are in flight
+				struct PendingFree
+				{
+					std::uint32_t vertex_handle;
+					std::uint32_t index_handle;
+					UINT64 fence_value;
+				};
+
+				// Source and destination ranges of one CopyBufferRegion
+				struct BufferCopy
+				{
+					UINT64 source_offset;
+					UINT64 destination_offset;
+					UINT64 size;
+				};
+
+				// Lays the ranges out in staging memory the way they are laid out in the buffer, so neighbours merge into one copy
+				static void AppendCopy(std::vector<BufferCopy>& t_copies, UINT64 t_destination_offset, UINT64 t_range_size, UINT64& t_staging_size);
+
+			private:
+				Microsoft::WRL::ComPtr<ID3D12Resource> m_vertex_buffer;
+				Microsoft::WRL::ComPtr<ID3D12Resource> m_index_buffer;
+				HeapAllocation m_vertex_allocation;
+				HeapAllocation m_index_allocation;
+				HeapAllocator* m_buffer_heap_allocator;
+
+				TrackedResources* m_tracked_resources;
+				UINT m_vertex_buffer_id;
+				UINT m_index_buffer_id;
+
+				utility::TlsfAllocator m_vertex_allocator;
+				utility::TlsfAllocator m_index_allocator;
+
+				UploadRing m_staging_ring;
+
+				std::vector<Mesh> m_meshes;
+				std::vector<MeshHandle> m_unused_meshes;
+
+				// Meshes keep the order they were added in, one that does not fit in the ring holds back the ones behind it
+				std::deque<MeshHandle> m_waiting_meshes;
+				std::vector<MeshHandle> m_recorded_meshes;
+				std::deque<MeshHandle> m_uploading_meshes;
+
+				std::vector<PendingFree> m_removed_meshes;	// Not stamped with a fence value yet
+				std::deque<PendingFree> m_pending_frees;
+
+				std::vector<BufferCopy> m_vertex_copies;
+				std::vector<BufferCopy> m_index_copies;
+			};
+		}
+	}
+}
+
+#endif
\ No newline at end of file
@@ -28,7 +28,8 @@ namespace tnt
 					BOOL t_allow_alt_enter = FALSE,
 					UINT t_number_of_back_buffers = 2,
 					DXGI_FORMAT t_format = DXGI_FORMAT_R8G8B8A8_UNORM,
-					DXGI_SWAP_EFFECT t_swap_effect = DXGI_SWAP_EFFECT_FLIP_DISCARD);
+					DXGI_SWAP_EFFECT t_swap_effect = DXGI_SWAP_EFFECT_FLIP_DISCARD,
+					UINT t_flags = 0);
 
 				IDXGISwapChain3* const GetSwapChainPointer() const;
 
@@ -42,7 +43,8 @@ namespace tnt
 					UINT t_height,
 					DXGI_FORMAT t_format,
 					DXGI_SWAP_EFFECT t_swap_effect,
-					const DXGI_SAMPLE_DESC& t_sampler_description);
+					const DXGI_SAMPLE_DESC& t_sampler_description,
+					UINT t_flags);
 
 			private:
 				Microsoft::WRL::ComPtr<IDXGISwapChain3> m_swap_chain;
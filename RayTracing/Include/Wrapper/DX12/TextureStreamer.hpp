@@ -0,0 +1,131 @@
+#ifndef TEXTURE_STREAMER_HPP
+#define TEXTURE_STREAMER_HPP
+
+#include "Renderer/MipGenerator.hpp"
+#include "Renderer/TextureCache.hpp"
+#include "Utility/ImageDecodePool.hpp"
+#include "Wrapper/DX12/HeapAllocator.hpp"
+#include "Wrapper/DX12/UploadRing.hpp"
+
+#include <wrl.h>
+#include <d3d12.h>
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tnt
+{
+	namespace wrapper
+	{
+		namespace dx12
+		{
+			// The resource is in the common state, the direct queue promotes it to a shader resource on first use
+			struct StreamedTexture
+			{
+				std::string path;
+				Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+				HeapAllocation allocation;
+			};
+
+			using TextureReadyCallback = std::function<void(const StreamedTexture&)>;
+
+			// Decodes images on a decode pool and uploads them on a dedicated copy queue while the application keeps rendering
+			// Staging memory comes from a persistent upload ring that is recycled as the copy fence progresses
+			class TextureStreamer
+			{
+			public:
+				TextureStreamer();
+				~TextureStreamer();
+
+				// Textures are placed with the heap allocator, it has to allow non render target textures in a default heap
+				// Decoded images waiting for room in the upload ring count against the decode memory budget
+				void Initialize(
+					ID3D12Device* t_device,
+					HeapAllocator* t_texture_heap_allocator,
+					UINT64 t_upload_ring_size,
+					UINT64 t_decode_memory_budget = utility::DEFAULT_DECODE_MEMORY_BUDGET,
+					UINT t_decode_thread_count = 0);
+				void Cleanup();
+
+				// With a cache set, requests map the cooked mip chain instead of decoding, a cache miss cooks on the calling thread
+				void SetTextureCache(graphics::TextureCache* t_texture_cache);
+
+				// Decoded images get their full mip chain built in Update and stay RGBA8, the cache applies its own settings and format
+				void SetMipSettings(const graphics::MipGeneratorSettings& t_settings);
+
+				// Returns right away, the callback runs from Update on the calling thread once the copy has completed
+				void RequestTexture(const std::string& t_path, const TextureReadyCallback& t_callback);
+
+				// Submits decoded images to the copy queue and runs the callbacks of finished copies, never waits on the GPU
+				// Throws when an image could not be decoded or does not fit in the upload ring at all
+				void Update();
+
+				// Blocks until every requested texture is resident and its callback has run
+				void Flush();
+
+				UINT GetPendingCount() const;
+				ID3D12CommandQueue* const GetCopyQueuePointer() const;
+
+			private:
+				// Either a decoded image that still needs its mips, or a cached texture with its whole chain
+				struct ReadyImage
+				{
+					utility::DecodedImage image;
+					std::shared_ptr<graphics::CachedTexture> cached_texture;
+					TextureReadyCallback callback;
+				};
+
+				struct PendingCopy
+				{
+					StreamedTexture texture;
+					TextureReadyCallback callback;
+					UINT64 fence_value;
+				};
+
+				// Returns false when the upload ring has no room for the image until earlier copies complete
+				bool RecordCopy(const ReadyImage& t_ready_image);
+				void PushReadyImage(const utility::DecodedImage& t_image);
+				void Submit();
+				void RunCompletedCallbacks();
+
+			private:
+				ID3D12Device* m_device;
+				HeapAllocator* m_texture_heap_allocator;
+				graphics::TextureCache* m_texture_cache;
+
+				Microsoft::WRL::ComPtr<ID3D12CommandQueue> m_copy_queue;
+				std::vector<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>> m_command_allocators;
+				std::vector<UINT64> m_command_allocator_fence_values;
+				Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> m_command_list;
+				bool m_is_recording;
+				UINT m_command_allocator_index;
+
+				Microsoft::WRL::ComPtr<ID3D12Fence> m_fence;
+				HANDLE m_fence_event;
+				UINT64 m_next_fence_value;
+
+				UploadRing m_upload_ring;
+
+				utility::ImageDecodePool m_decode_pool;
+
+				graphics::MipGenerator m_mip_generator;
+				graphics::MipGeneratorSettings m_mip_settings;
+				std::vector<std::uint8_t> m_mip_scratch;	// Mips are built in system memory, the upload ring is write combined
+
+				// Callbacks are looked up by the tag their request was given to the decode pool
+				std::unordered_map<std::uint64_t, TextureReadyCallback> m_callbacks;
+				std::uint64_t m_next_request_tag;
+
+				std::deque<ReadyImage> m_ready_images;
+				std::deque<PendingCopy> m_pending_copies;
+			};
+		}
+	}
+}
+
+#endif
\ No newline at end of file
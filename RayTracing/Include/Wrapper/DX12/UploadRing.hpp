@@ -0,0 +1,56 @@
+#ifndef UPLOAD_RING_HPP
+#define UPLOAD_RING_HPP
+
+#include "Utility/RingAllocator.hpp"
+
+#include <wrl.h>
+#include <d3d12.h>
+
+namespace tnt
+{
+	namespace wrapper
+	{
+		namespace dx12
+		{
+			struct UploadAllocation
+			{
+				void* cpu_address;
+				D3D12_GPU_VIRTUAL_ADDRESS gpu_address;
+				UINT64 offset;
+			};
+
+			// One persistently mapped upload buffer shared by every frame in flight
+			// Memory written in a frame stays untouched until the fence value of that frame has completed
+			class UploadRing
+			{
+			public:
+				UploadRing();
+				~UploadRing();
+
+				void Initialize(ID3D12Device* t_device, UINT64 t_size);
+
+				// Constant buffer views need 256 byte aligned addresses, throws when the frames in flight fill the ring
+				UploadAllocation Allocate(UINT64 t_size, UINT64 t_alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+
+				// Returns false instead of throwing, for callers that can wait for a later frame
+				bool TryAllocate(UINT64 t_size, UINT64 t_alignment, UploadAllocation& t_allocation);
+
+				// Call after signaling the fence for the frame, and again once the fence has progressed
+				void FinishFrame(UINT64 t_fence_value);
+				void Retire(UINT64 t_completed_fence_value);
+
+				ID3D12Resource* const GetResourcePointer() const;
+				const utility::RingAllocator& GetAllocator() const;
+
+			private:
+				Microsoft::WRL::ComPtr<ID3D12Resource> m_buffer;
+				UINT8* m_cpu_address;
+				D3D12_GPU_VIRTUAL_ADDRESS m_gpu_address;
+
+				utility::RingAllocator m_allocator;
+			};
+		}
+	}
+}
+
+#endif
\ No newline at end of file
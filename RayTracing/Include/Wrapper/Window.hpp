@@ -17,7 +17,10 @@ namespace tnt
 				template<typename Functor>
 				void Create(const WCHAR* t_window_title, HINSTANCE t_hinstance, UINT t_width, UINT t_height, Functor t_window_proc);
 				void Show() const;
-				void MainLoop();
+
+				// Calls t_frame whenever no message is waiting, so frames no longer depend on WM_PAINT
+				template<typename Functor>
+				void MainLoop(Functor t_frame);
 	
 				HWND GetWindowHandle() const;
 	
@@ -53,6 +56,25 @@ namespace tnt
 					t_hinstance,
 					nullptr);	// No additional command-line arguments
 			}
+
+			template<typename Functor>
+			inline void Window::MainLoop(Functor t_frame)
+			{
+				MSG msg = {};
+
+				while (msg.message != WM_QUIT)
+				{
+					if (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
+					{
+						TranslateMessage(&msg);
+						DispatchMessage(&msg);
+					}
+					else
+					{
+						t_frame();
+					}
+				}
+			}
 	}
 }
 
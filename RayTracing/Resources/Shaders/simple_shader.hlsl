@@ -1,4 +1,9 @@
-Texture2D g_texture : register(t0);
+// Defined by the application to the size of its bindless table
+#ifndef BINDLESS_TEXTURE_COUNT
+#define BINDLESS_TEXTURE_COUNT 1
+#endif
+
+Texture2D g_textures[BINDLESS_TEXTURE_COUNT] : register(t0);
 SamplerState g_sampler : register(s0);
 
 cbuffer SceneConstantBuffer : register(b0)
@@ -6,6 +11,11 @@ cbuffer SceneConstantBuffer : register(b0)
 	float2 positionOffset;
 };
 
+cbuffer DrawConstants : register(b1)
+{
+	uint textureIndex;
+};
+
 struct VSOutput
 {
 	float4 position : SV_POSITION;
@@ -24,5 +34,5 @@ VSOutput vs_main(float4 position : POSITION, float2 uv : TEXCOORD)
 
 float4 ps_main(VSOutput input) : SV_TARGET
 {
-	return g_texture.Sample(g_sampler, input.uv);
+	return g_textures[textureIndex].Sample(g_sampler, input.uv);
 }
\ No newline at end of file
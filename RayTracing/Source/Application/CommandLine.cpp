@@ -0,0 +1,633 @@
+#include "Application/CommandLine.hpp"
+
+#include "Renderer/Renderer.hpp"
+#include "Renderer/SceneData.hpp"
+#include "Renderer/TextureCache.hpp"
+#include "Benchmark/Benchmarks.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	tnt::graphics::cpu::TraversalKernel ParseTraversalKernel(const std::string& name)
+	{
+		const tnt::graphics::cpu::TraversalKernel kernels[] =
+		{
+			tnt::graphics::cpu::TraversalKernel::Automatic,
+			tnt::graphics::cpu::TraversalKernel::Binary,
+			tnt::graphics::cpu::TraversalKernel::Wide4Sse,
+			tnt::graphics::cpu::TraversalKernel::Wide8Avx2
+		};
+
+		for (tnt::graphics::cpu::TraversalKernel kernel : kernels)
+		{
+			if (name == tnt::graphics::cpu::GetTraversalKernelName(kernel))
+			{
+				return kernel;
+			}
+		}
+
+		return tnt::graphics::cpu::TraversalKernel::Automatic;
+	}
+
+	tnt::graphics::cpu::TraversalMode ParseTraversalMode(const std::string& name)
+	{
+		const tnt::graphics::cpu::TraversalMode modes[] =
+		{
+			tnt::graphics::cpu::TraversalMode::SingleRay,
+			tnt::graphics::cpu::TraversalMode::Packet,
+			tnt::graphics::cpu::TraversalMode::Stream
+		};
+
+		for (tnt::graphics::cpu::TraversalMode mode : modes)
+		{
+			if (name == tnt::graphics::cpu::GetTraversalModeName(mode))
+			{
+				return mode;
+			}
+		}
+
+		return tnt::graphics::cpu::TraversalMode::SingleRay;
+	}
+
+	tnt::graphics::cpu::SamplerFilter ParseSamplerFilter(const std::string& name)
+	{
+		const tnt::graphics::cpu::SamplerFilter filters[] =
+		{
+			tnt::graphics::cpu::SamplerFilter::Point,
+			tnt::graphics::cpu::SamplerFilter::Bilinear,
+			tnt::graphics::cpu::SamplerFilter::Trilinear
+		};
+
+		for (tnt::graphics::cpu::SamplerFilter filter : filters)
+		{
+			if (name == tnt::graphics::cpu::GetSamplerFilterName(filter))
+			{
+				return filter;
+			}
+		}
+
+		return tnt::graphics::cpu::SamplerFilter::Point;
+	}
+
+	tnt::graphics::cpu::TextureAddressMode ParseTextureAddressMode(const std::string& name)
+	{
+		const tnt::graphics::cpu::TextureAddressMode modes[] =
+		{
+			tnt::graphics::cpu::TextureAddressMode::Wrap,
+			tnt::graphics::cpu::TextureAddressMode::Mirror,
+			tnt::graphics::cpu::TextureAddressMode::Clamp,
+			tnt::graphics::cpu::TextureAddressMode::Border
+		};
+
+		for (tnt::graphics::cpu::TextureAddressMode mode : modes)
+		{
+			if (name == tnt::graphics::cpu::GetTextureAddressModeName(mode))
+			{
+				return mode;
+			}
+		}
+
+		return tnt::graphics::cpu::TextureAddressMode::Border;
+	}
+
+	tnt::graphics::cpu::TextureLayout ParseTextureLayout(const std::string& name)
+	{
+		const tnt::graphics::cpu::TextureLayout layouts[] =
+		{
+			tnt::graphics::cpu::TextureLayout::Linear,
+			tnt::graphics::cpu::TextureLayout::Tiled,
+			tnt::graphics::cpu::TextureLayout::Morton
+		};
+
+		for (tnt::graphics::cpu::TextureLayout layout : layouts)
+		{
+			if (name == tnt::graphics::cpu::GetTextureLayoutName(layout))
+			{
+				return layout;
+			}
+		}
+
+		return tnt::graphics::cpu::TextureLayout::Tiled;
+	}
+
+	tnt::graphics::TextureFormat ParseTextureFormat(const std::string& name)
+	{
+		const tnt::graphics::TextureFormat formats[] =
+		{
+			tnt::graphics::TextureFormat::RGBA8,
+			tnt::graphics::TextureFormat::BC1,
+			tnt::graphics::TextureFormat::BC3,
+			tnt::graphics::TextureFormat::BC7
+		};
+
+		for (tnt::graphics::TextureFormat format : formats)
+		{
+			if (name == tnt::graphics::GetTextureFormatName(format))
+			{
+				return format;
+			}
+		}
+
+		return tnt::graphics::TextureFormat::RGBA8;
+	}
+
+	tnt::graphics::MipFilter ParseMipFilter(const std::string& name)
+	{
+		if (name == tnt::graphics::GetMipFilterName(tnt::graphics::MipFilter::Kaiser))
+		{
+			return tnt::graphics::MipFilter::Kaiser;
+		}
+
+		return tnt::graphics::MipFilter::Box;
+	}
+
+	// Prints how evenly the tiles of the last frame were spread over the workers
+	void PrintTileStatistics(const tnt::graphics::Renderer& renderer)
+	{
+		const std::vector<tnt::graphics::cpu::TileStatistics>& tiles = renderer.GetTileStatistics();
+		const tnt::graphics::cpu::RenderStatistics& statistics = renderer.GetStatistics();
+
+		if (tiles.empty())
+		{
+			return;
+		}
+
+		std::vector<double> workerSeconds(statistics.thread_count, 0.0);
+		const tnt::graphics::cpu::TileStatistics* slowestTile = &tiles[0];
+		double totalSeconds = 0.0;
+
+		for (const tnt::graphics::cpu::TileStatistics& tile : tiles)
+		{
+			workerSeconds[tile.worker_index] += tile.seconds;
+			totalSeconds += tile.seconds;
+
+			if (tile.seconds > slowestTile->seconds)
+			{
+				slowestTile = &tile;
+			}
+		}
+
+		double busiestWorkerSeconds = 0.0;
+
+		for (double seconds : workerSeconds)
+		{
+			if (seconds > busiestWorkerSeconds)
+			{
+				busiestWorkerSeconds = seconds;
+			}
+		}
+
+		const double averageTileSeconds = totalSeconds / tiles.size();
+		const double averageWorkerSeconds = totalSeconds / statistics.thread_count;
+
+		std::cout << "Tiles: " << statistics.tile_count << ", " << statistics.steal_count << " stolen\n";
+		std::cout << "Tile time: " << averageTileSeconds * 1000.0 << " ms average, " << slowestTile->seconds * 1000.0 << " ms slowest at (";
+		std::cout << slowestTile->x << ", " << slowestTile->y << ")\n";
+		std::cout << "Worker imbalance: " << ((averageWorkerSeconds > 0.0) ? busiestWorkerSeconds / averageWorkerSeconds : 1.0) << " (busiest / average)\n";
+	}
+
+	// Brighter tiles took longer to render in the last frame
+	void SaveTileHeatmap(const tnt::graphics::Renderer& renderer, const std::string& path)
+	{
+		const std::vector<tnt::graphics::cpu::TileStatistics>& tiles = renderer.GetTileStatistics();
+		double slowestSeconds = 0.0;
+
+		for (const tnt::graphics::cpu::TileStatistics& tile : tiles)
+		{
+			if (tile.seconds > slowestSeconds)
+			{
+				slowestSeconds = tile.seconds;
+			}
+		}
+
+		tnt::graphics::cpu::Framebuffer heatmap;
+		heatmap.Initialize(renderer.GetFramebuffer().GetWidth(), renderer.GetFramebuffer().GetHeight());
+
+		for (const tnt::graphics::cpu::TileStatistics& tile : tiles)
+		{
+			const float heat = (slowestSeconds > 0.0) ? static_cast<float>(tile.seconds / slowestSeconds) : 0.0f;
+
+			for (std::uint32_t y = tile.y; y < tile.y + tile.height; ++y)
+			{
+				for (std::uint32_t x = tile.x; x < tile.x + tile.width; ++x)
+				{
+					heatmap.SetPixel(x, y, { heat, heat * heat, 0.0f, 1.0f });
+				}
+			}
+		}
+
+		heatmap.SaveAsPPM(path);
+	}
+}
+
+// Renders frames on the CPU without creating a window or a D3D12 device
+// Usage: --headless [--frames N] [--threads N] [--tessellation N] [--bins N] [--build-threads N] [--leaf-size N] [--kernel name] [--mode single|packet|stream] [--tile-size N] [--filter point|bilinear|trilinear] [--address wrap|mirror|clamp|border] [--mips N] [--mip-filter box|kaiser] [--mip-srgb 0|1] [--texture-format rgba8|bc1|bc3|bc7] [--texture-layout linear|tiled|morton]
+//        [--animate 0|1] [--frame-time SECONDS] [--accumulate 0|1] [--error-threshold F] [--min-samples N] [--max-samples N] [--output file.ppm] [--tile-heatmap file.ppm]
+int tnt::application::RunHeadless(int argc, char* argv[])
+{
+	int frameCount = 100;
+	std::uint32_t tessellation = 1;
+	std::string outputPath;
+	std::string heatmapPath;
+	bool animate = true;
+	double frameTime = SIMULATION_STEP;
+
+	tnt::graphics::RendererSettings settings;
+	settings.width = FRAME_WIDTH;
+	settings.height = FRAME_HEIGHT;
+
+	for (int index = 2; index + 1 < argc; index += 2)
+	{
+		const std::string option = argv[index];
+		const std::string value = argv[index + 1];
+
+		if (option == "--frames")
+		{
+			frameCount = std::stoi(value);
+		}
+		else if (option == "--threads")
+		{
+			settings.thread_count = std::stoul(value);
+		}
+		else if (option == "--tessellation")
+		{
+			tessellation = std::stoul(value);
+		}
+		else if (option == "--bins")
+		{
+			settings.bvh_build_settings.bin_count = std::stoul(value);
+		}
+		else if (option == "--build-threads")
+		{
+			settings.bvh_build_settings.thread_count = std::stoul(value);
+		}
+		else if (option == "--leaf-size")
+		{
+			settings.bvh_build_settings.max_leaf_size = std::stoul(value);
+		}
+		else if (option == "--kernel")
+		{
+			settings.traversal_kernel = ParseTraversalKernel(value);
+		}
+		else if (option == "--mode")
+		{
+			settings.traversal_mode = ParseTraversalMode(value);
+		}
+		else if (option == "--tile-size")
+		{
+			settings.tile_size = std::stoul(value);
+		}
+		else if (option == "--filter")
+		{
+			settings.sampler.filter = ParseSamplerFilter(value);
+		}
+		else if (option == "--address")
+		{
+			settings.sampler.address_u = ParseTextureAddressMode(value);
+			settings.sampler.address_v = settings.sampler.address_u;
+		}
+		else if (option == "--mips")
+		{
+			settings.texture_mip_count = std::stoul(value);
+		}
+		else if (option == "--mip-filter")
+		{
+			settings.texture_mip_settings.filter = ParseMipFilter(value);
+		}
+		else if (option == "--mip-srgb")
+		{
+			settings.texture_mip_settings.srgb = std::stoul(value) != 0;
+		}
+		else if (option == "--texture-format")
+		{
+			settings.texture_format = ParseTextureFormat(value);
+		}
+		else if (option == "--texture-layout")
+		{
+			settings.texture_layout = ParseTextureLayout(value);
+		}
+		else if (option == "--animate")
+		{
+			animate = std::stoul(value) != 0;
+		}
+		else if (option == "--frame-time")
+		{
+			frameTime = std::stod(value);
+		}
+		else if (option == "--accumulate")
+		{
+			settings.accumulation.enabled = std::stoul(value) != 0;
+		}
+		else if (option == "--error-threshold")
+		{
+			settings.accumulation.error_threshold = std::stof(value);
+		}
+		else if (option == "--min-samples")
+		{
+			settings.accumulation.min_sample_count = std::stoul(value);
+		}
+		else if (option == "--max-samples")
+		{
+			settings.accumulation.max_sample_count = std::stoul(value);
+		}
+		else if (option == "--output")
+		{
+			outputPath = value;
+		}
+		else if (option == "--tile-heatmap")
+		{
+			heatmapPath = value;
+		}
+	}
+
+	tnt::graphics::Renderer renderer;
+	renderer.Initialize(settings, tnt::graphics::CreateTessellatedTriangleScene(tessellation), "./Resources/Textures/basic_test_texture.png");
+
+	const tnt::graphics::cpu::BvhBuildStatistics& bvhStatistics = renderer.GetBvhBuildStatistics();
+
+	std::cout << "BVH: " << bvhStatistics.triangle_count << " triangles, " << bvhStatistics.node_count << " nodes, ";
+	std::cout << bvhStatistics.leaf_count << " leaves, depth " << bvhStatistics.max_depth << "\n";
+	// Packets and streams ignore the kernel, report the binary BVH they actually traverse
+	const bool isSingleRay = renderer.GetTraversalMode() == tnt::graphics::cpu::TraversalMode::SingleRay;
+	const tnt::graphics::cpu::TraversalKernel usedKernel = isSingleRay ? renderer.GetTraversalKernel() : tnt::graphics::cpu::TraversalKernel::Binary;
+	std::cout << "Traversal kernel: " << tnt::graphics::cpu::GetTraversalKernelName(usedKernel) << "\n";
+	std::cout << "Traversal mode: " << tnt::graphics::cpu::GetTraversalModeName(renderer.GetTraversalMode()) << "\n";
+	std::cout << "BVH build time: " << bvhStatistics.build_seconds * 1000.0 << " ms (" << settings.bvh_build_settings.bin_count << " bins, ";
+	std::cout << bvhStatistics.thread_count << " threads, " << bvhStatistics.subtree_task_count << " subtree tasks)\n";
+
+	// Frames are spaced frameTime apart on a simulated clock, the scene still moves at the rate of the window
+	tnt::utility::FixedTimestep timestep;
+	timestep.Initialize(SIMULATION_STEP, MAX_SIMULATION_STEPS_PER_FRAME);
+
+	tnt::graphics::SceneConstantBufferData previousStep = {};
+	tnt::graphics::SceneConstantBufferData currentStep = {};
+	tnt::graphics::SceneConstantBufferData sceneData = {};
+	std::uint64_t totalRayCount = 0;
+	double totalSeconds = 0.0;
+
+	for (int frame = 0; frame < frameCount; ++frame)
+	{
+		// A moving scene resets the accumulation every frame
+		if (animate)
+		{
+			sceneData = tnt::graphics::SimulateScene(timestep, frame * frameTime, previousStep, currentStep);
+		}
+
+		renderer.Render(sceneData);
+
+		totalRayCount += renderer.GetStatistics().ray_count;
+		totalSeconds += renderer.GetStatistics().render_seconds;
+	}
+
+	const std::uint32_t threadCount = renderer.GetStatistics().thread_count;
+	const double raysPerSecond = (totalSeconds > 0.0) ? totalRayCount / totalSeconds : 0.0;
+
+	std::cout << "Trace time: " << totalSeconds * 1000.0 << " ms for " << frameCount << " frames on " << threadCount << " threads\n";
+	std::cout << "Rays / second: " << raysPerSecond << "\n";
+	std::cout << "Rays / second / core: " << raysPerSecond / threadCount << "\n";
+
+	PrintTileStatistics(renderer);
+
+	if (settings.accumulation.enabled)
+	{
+		const tnt::graphics::cpu::AccumulationBuffer& accumulationBuffer = renderer.GetAccumulationBuffer();
+		const std::uint64_t pixelCount = static_cast<std::uint64_t>(settings.width) * settings.height;
+		const std::uint64_t sampleCount = accumulationBuffer.GetTotalSampleCount();
+		const std::uint32_t sampleIndex = renderer.GetStatistics().sample_index + 1;
+
+		std::cout << "Accumulated samples: " << sampleCount << ", " << static_cast<double>(sampleCount) / pixelCount << " per pixel on average, ";
+		std::cout << sampleIndex << " at most\n";
+		std::cout << "Converged pixels: " << accumulationBuffer.GetConvergedPixelCount() << " of " << pixelCount << "\n";
+		std::cout << "Rays saved by adaptive sampling: " << 100.0 - 100.0 * sampleCount / (static_cast<double>(pixelCount) * sampleIndex) << "%\n";
+	}
+
+	if (!outputPath.empty())
+	{
+		renderer.GetFramebuffer().SaveAsPPM(outputPath);
+	}
+
+	if (!heatmapPath.empty())
+	{
+		SaveTileHeatmap(renderer, heatmapPath);
+	}
+
+	renderer.Cleanup();
+
+	return 0;
+}
+
+// Runs one of the CPU side benchmarks, no window or D3D12 device is created
+// Usage: --benchmark traversal [--tessellation N] [--rays N]
+//        --benchmark sampler [--size N] [--samples N]
+//        --benchmark texture-layout [--size N] [--samples N]
+//        --benchmark upload-ring [--frames N] [--allocations N]
+//        --benchmark heap-allocator [--operations N]
+//        --benchmark descriptor-allocator [--operations N]
+//        --benchmark bindless-handles [--frames N]
+//        --benchmark descriptor-tables [--frames N]
+//        --benchmark frame-pacing [--frames N]
+//        --benchmark fixed-timestep [--frames N]
+//        --benchmark image-decode [--images N] [--image PATH]
+//        --benchmark texture-cache [--images N] [--image PATH]
+//        --benchmark mip-generation [--size N]
+//        --benchmark block-compression [--image PATH]
+//        --benchmark texture-copy [--size N]
+//        --benchmark resource-states [--frames N]
+int tnt::application::RunBenchmark(int argc, char* argv[])
+{
+	const std::string name = (argc > 2) ? argv[2] : "";
+
+	std::uint32_t tessellation = 1000;
+	std::uint32_t rayCount = 1000000;
+	std::uint32_t textureSize = 2048;
+	std::uint32_t sampleCount = 4000000;
+	std::uint32_t frameCount = 10000;
+	std::uint32_t allocationCount = 64;
+	std::uint32_t operationCount = 5000000;
+	std::uint32_t imageCount = 512;
+	std::string imagePath = "./Resources/Textures/basic_test_texture.png";
+
+	for (int index = 3; index + 1 < argc; index += 2)
+	{
+		const std::string option = argv[index];
+		const std::string value = argv[index + 1];
+
+		if (option == "--tessellation")
+		{
+			tessellation = std::stoul(value);
+		}
+		else if (option == "--rays")
+		{
+			rayCount = std::stoul(value);
+		}
+		else if (option == "--size")
+		{
+			textureSize = std::stoul(value);
+		}
+		else if (option == "--samples")
+		{
+			sampleCount = std::stoul(value);
+		}
+		else if (option == "--frames")
+		{
+			frameCount = std::stoul(value);
+		}
+		else if (option == "--allocations")
+		{
+			allocationCount = std::stoul(value);
+		}
+		else if (option == "--operations")
+		{
+			operationCount = std::stoul(value);
+		}
+		else if (option == "--images")
+		{
+			imageCount = std::stoul(value);
+		}
+		else if (option == "--image")
+		{
+			imagePath = value;
+		}
+	}
+
+	if (name == "traversal")
+	{
+		tnt::benchmark::RunTraversalBenchmark(tessellation, rayCount);
+		return 0;
+	}
+
+	if (name == "sampler")
+	{
+		tnt::benchmark::RunSamplerBenchmark(textureSize, sampleCount);
+		return 0;
+	}
+
+	if (name == "texture-layout")
+	{
+		tnt::benchmark::RunTextureLayoutBenchmark(textureSize, sampleCount);
+		return 0;
+	}
+
+	if (name == "upload-ring")
+	{
+		tnt::benchmark::RunUploadRingBenchmark(frameCount, allocationCount);
+		return 0;
+	}
+
+	if (name == "heap-allocator")
+	{
+		tnt::benchmark::RunHeapAllocatorBenchmark(operationCount);
+		return 0;
+	}
+
+	if (name == "descriptor-allocator")
+	{
+		tnt::benchmark::RunDescriptorAllocatorBenchmark(operationCount);
+		return 0;
+	}
+
+	if (name == "bindless-handles")
+	{
+		tnt::benchmark::RunBindlessHandleBenchmark(frameCount);
+		return 0;
+	}
+
+	if (name == "descriptor-tables")
+	{
+		tnt::benchmark::RunDescriptorTableBenchmark(frameCount);
+		return 0;
+	}
+
+	if (name == "frame-pacing")
+	{
+		tnt::benchmark::RunFramePacingBenchmark(frameCount);
+		return 0;
+	}
+
+	if (name == "fixed-timestep")
+	{
+		tnt::benchmark::RunFixedTimestepBenchmark(frameCount);
+		return 0;
+	}
+
+	if (name == "image-decode")
+	{
+		tnt::benchmark::RunImageDecodeBenchmark(imagePath, imageCount);
+		return 0;
+	}
+
+	if (name == "texture-cache")
+	{
+		tnt::benchmark::RunTextureCacheBenchmark(imagePath, imageCount);
+		return 0;
+	}
+
+	if (name == "mip-generation")
+	{
+		tnt::benchmark::RunMipGenerationBenchmark(textureSize);
+		return 0;
+	}
+
+	if (name == "block-compression")
+	{
+		tnt::benchmark::RunBlockCompressionBenchmark(imagePath);
+		return 0;
+	}
+
+	if (name == "texture-copy")
+	{
+		tnt::benchmark::RunTextureCopyBenchmark(textureSize);
+		return 0;
+	}
+
+	if (name == "resource-states")
+	{
+		tnt::benchmark::RunResourceStateBenchmark(frameCount);
+		return 0;
+	}
+
+	std::cout << "Unknown benchmark: " << name << "\n";
+	return 1;
+}
+
+// Cooks every listed image into the texture cache ahead of time, so the first run does not have to
+// Usage: --cook-textures PATH...
+int tnt::application::RunCookTextures(int argc, char* argv[])
+{
+	tnt::graphics::TextureCache cache;
+	cache.Initialize(tnt::graphics::GetTemporaryCacheDirectory(TEXTURE_CACHE_NAME), 0, tnt::graphics::MipGeneratorSettings(), TEXTURE_CACHE_FORMAT);
+
+	for (int index = 2; index < argc; ++index)
+	{
+		std::cout << argv[index] << " -> " << cache.Cook(argv[index]) << "\n";
+	}
+
+	return 0;
+}
+
+bool tnt::application::RunCommandLine(int argc, char* argv[], int& t_exit_code)
+{
+	if (argc > 1 && std::strcmp(argv[1], "--headless") == 0)
+	{
+		t_exit_code = RunHeadless(argc, argv);
+		return true;
+	}
+
+	if (argc > 1 && std::strcmp(argv[1], "--benchmark") == 0)
+	{
+		t_exit_code = RunBenchmark(argc, argv);
+		return true;
+	}
+
+	if (argc > 1 && std::strcmp(argv[1], "--cook-textures") == 0)
+	{
+		t_exit_code = RunCookTextures(argc, argv);
+		return true;
+	}
+
+	return false;
+}
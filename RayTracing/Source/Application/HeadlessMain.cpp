@@ -0,0 +1,19 @@
+#include "Application/CommandLine.hpp"
+
+#include <iostream>
+
+// Entry point of the portable build, everything Main.cpp offers except the D3D12 window
+int main(int argc, char* argv[])
+{
+	int exit_code = 0;
+
+	if (tnt::application::RunCommandLine(argc, argv, exit_code))
+	{
+		return exit_code;
+	}
+
+	std::cout << "Usage: --headless [options] | --benchmark name [options] | --cook-textures PATH...\n";
+	std::cout << "The D3D12 window is only part of the Windows build\n";
+
+	return 1;
+}
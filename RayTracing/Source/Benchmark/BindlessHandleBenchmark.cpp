@@ -0,0 +1,170 @@
+#include "Benchmark/Benchmarks.hpp"
+
+#include "Utility/HandlePool.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+	using namespace tnt::utility;
+
+	// Same size as the bindless texture table in Main.cpp
+	const std::uint32_t TABLE_CAPACITY = 16384;
+
+	// The GPU completes a frame this many frames after it was recorded, like with three back buffers
+	const std::uint64_t FRAME_LATENCY = 2;
+
+	// Freed handles kept around to check that they stay stale
+	const size_t STALE_HANDLE_COUNT = 4096;
+
+	struct Statistics
+	{
+		std::uint64_t allocation_count;
+		std::uint64_t free_count;
+		std::uint64_t lookup_count;
+		std::uint64_t failed_count;				// Every slot in use or waiting for its frame
+		std::uint64_t early_reuse_count;		// A slot handed out while a frame that sampled it was in flight
+		std::uint64_t stale_check_count;
+		std::uint64_t undetected_stale_count;	// Freed handles that still passed, only possible once a generation comes around again
+	};
+
+	// Every frame streams some textures out and others in, then draws sample a few hundred of the live ones
+	// With t_validate set, the frame that last sampled every slot is tracked and freed handles are checked for staleness
+	Statistics RunFrames(std::uint32_t t_frame_count, std::uint32_t t_changes_per_frame, bool t_validate)
+	{
+		std::mt19937 generator(1234);
+
+		HandlePool pool;
+		pool.Initialize(TABLE_CAPACITY);
+
+		std::vector<std::uint32_t> live_handles;
+		std::vector<std::uint64_t> last_use_fences(TABLE_CAPACITY, 0);
+		std::vector<std::uint32_t> stale_handles;
+		size_t stale_cursor = 0;
+
+		Statistics statistics = {};
+
+		// Starts out full, so every slot is handed out again as soon as its frame has completed
+		while (live_handles.size() < TABLE_CAPACITY)
+		{
+			live_handles.push_back(pool.Allocate());
+		}
+
+		for (std::uint32_t frame = 1; frame <= t_frame_count; ++frame)
+		{
+			const std::uint64_t fence_value = frame;
+			const std::uint64_t completed_fence_value = (fence_value > FRAME_LATENCY) ? fence_value - FRAME_LATENCY : 0;
+
+			pool.Retire(completed_fence_value);
+
+			// Allocations fail while every free slot is still waiting for its frame
+			for (std::uint32_t change = 0; change < t_changes_per_frame; ++change)
+			{
+				const bool allocate = live_handles.empty() || (generator() & 1) != 0;
+
+				if (allocate)
+				{
+					const std::uint32_t handle = pool.Allocate();
+
+					if (handle == INVALID_POOL_HANDLE)
+					{
+						statistics.failed_count++;
+						continue;
+					}
+
+					if (t_validate && last_use_fences[pool.GetIndex(handle)] > completed_fence_value)
+					{
+						statistics.early_reuse_count++;
+					}
+
+					live_handles.push_back(handle);
+					statistics.allocation_count++;
+				}
+				else
+				{
+					const size_t index = generator() % live_handles.size();
+					const std::uint32_t handle = live_handles[index];
+					const std::uint32_t pool_index = pool.GetIndex(handle);
+
+					pool.Free(handle);
+
+					if (t_validate)
+					{
+						// Draws of this frame may have been recorded with the handle before it was freed
+						last_use_fences[pool_index] = fence_value;
+
+						if (stale_handles.size() < STALE_HANDLE_COUNT)
+						{
+							stale_handles.push_back(handle);
+						}
+						else
+						{
+							stale_handles[stale_cursor++ % STALE_HANDLE_COUNT] = handle;
+						}
+					}
+
+					live_handles[index] = live_handles.back();
+					live_handles.pop_back();
+					statistics.free_count++;
+				}
+			}
+
+			// Draws look their texture index up every frame, which is where a stale handle would be caught
+			for (std::uint32_t draw = 0; draw < 256 && !live_handles.empty(); ++draw)
+			{
+				const std::uint32_t index = pool.GetIndex(live_handles[generator() % live_handles.size()]);
+				statistics.lookup_count++;
+
+				if (t_validate)
+				{
+					last_use_fences[index] = fence_value;
+				}
+			}
+
+			if (t_validate)
+			{
+				for (std::uint32_t handle : stale_handles)
+				{
+					statistics.undetected_stale_count += pool.IsValid(handle) ? 1 : 0;
+					statistics.stale_check_count++;
+				}
+			}
+
+			pool.FinishFrame(fence_value);
+		}
+
+		return statistics;
+	}
+}
+
+void tnt::benchmark::RunBindlessHandleBenchmark(std::uint32_t t_frame_count)
+{
+	const std::uint32_t change_counts[] = { 16, 256, 4096 };
+
+	std::cout << "Bindless table of " << TABLE_CAPACITY << " slots, " << t_frame_count << " frames, frees retire " << FRAME_LATENCY << " frames later\n";
+
+	for (std::uint32_t change_count : change_counts)
+	{
+		const Statistics validation = RunFrames(t_frame_count, change_count, true);
+
+		auto start_time = std::chrono::high_resolution_clock::now();
+		const Statistics statistics = RunFrames(t_frame_count, change_count, false);
+		const double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count();
+
+		const std::uint64_t operation_count = statistics.allocation_count + statistics.free_count + statistics.lookup_count;
+
+		std::cout << change_count << " changes per frame: " << operation_count / seconds / 1e6 << " M operations / second, ";
+		std::cout << validation.early_reuse_count << " slots reused too early, ";
+		std::cout << validation.stale_check_count - validation.undetected_stale_count << " of " << validation.stale_check_count << " stale handle checks caught, ";
+		std::cout << validation.failed_count << " allocations waited for a frame\n";
+
+		if (validation.early_reuse_count != 0)
+		{
+			throw std::runtime_error("A bindless slot was reused while a frame in flight could still sample it");
+		}
+	}
+}
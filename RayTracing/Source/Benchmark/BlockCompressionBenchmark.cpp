@@ -0,0 +1,137 @@
+#include "Benchmark/Benchmarks.hpp"
+
+#include "Renderer/BlockCompression.hpp"
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	using namespace tnt::graphics;
+
+	// Repeated until at least this long has passed, a single BC1 pass over a small image is too short to time
+	const double MIN_MEASURE_SECONDS = 0.5;
+
+	// Peak signal to noise ratio in dB over the given channels, identical images report infinity
+	double ComputePsnr(const std::vector<std::uint8_t>& t_source, const std::vector<std::uint8_t>& t_decoded, std::uint32_t t_first_channel, std::uint32_t t_channel_count)
+	{
+		double squared_error = 0.0;
+		std::uint64_t sample_count = 0;
+
+		for (size_t texel = 0; texel < t_source.size(); texel += 4)
+		{
+			for (std::uint32_t channel = t_first_channel; channel < t_first_channel + t_channel_count; ++channel)
+			{
+				const double difference = static_cast<double>(t_source[texel + channel]) - t_decoded[texel + channel];
+				squared_error += difference * difference;
+				++sample_count;
+			}
+		}
+
+		const double mean_squared_error = squared_error / sample_count;
+
+		return 10.0 * std::log10(255.0 * 255.0 / mean_squared_error);
+	}
+
+	// Runs the task until the minimum time has passed, returns the seconds per run
+	template <typename Task>
+	double MeasureSeconds(const Task& t_task)
+	{
+		std::uint32_t run_count = 0;
+		double seconds = 0.0;
+
+		auto start_time = std::chrono::high_resolution_clock::now();
+
+		while (seconds < MIN_MEASURE_SECONDS)
+		{
+			t_task();
+			++run_count;
+
+			seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count();
+		}
+
+		return seconds / run_count;
+	}
+}
+
+void tnt::benchmark::RunBlockCompressionBenchmark(const std::string& t_path)
+{
+	int width = 0;
+	int height = 0;
+	int channel_count = 0;
+	std::uint8_t* rgba = stbi_load(t_path.c_str(), &width, &height, &channel_count, STBI_rgb_alpha);
+
+	if (rgba == nullptr)
+	{
+		throw std::runtime_error("Could not load " + t_path);
+	}
+
+	std::vector<std::uint8_t> source(rgba, rgba + static_cast<size_t>(width) * height * 4);
+	stbi_image_free(rgba);
+
+	const MipLevel source_level = { source.data(), static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height), static_cast<std::uint32_t>(width) * 4 };
+	const TextureFormat formats[] = { TextureFormat::BC1, TextureFormat::BC3, TextureFormat::BC7 };
+
+	std::vector<std::uint32_t> thread_counts;
+	const std::uint32_t hardware_thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+
+	for (std::uint32_t thread_count = 1; thread_count < hardware_thread_count; thread_count *= 2)
+	{
+		thread_counts.push_back(thread_count);
+	}
+
+	thread_counts.push_back(hardware_thread_count);
+
+	const double megapixels = static_cast<double>(width) * height / 1e6;
+
+	std::cout << t_path << ": " << width << "x" << height << ", " << channel_count << " channels\n";
+
+	for (TextureFormat format : formats)
+	{
+		const std::uint32_t block_row_size = (source_level.width + BLOCK_COMPRESSION_BLOCK_SIZE - 1) / BLOCK_COMPRESSION_BLOCK_SIZE * GetFormatBlockByteCount(format);
+		const std::uint32_t block_row_count = (source_level.height + BLOCK_COMPRESSION_BLOCK_SIZE - 1) / BLOCK_COMPRESSION_BLOCK_SIZE;
+
+		std::vector<std::uint8_t> blocks(static_cast<size_t>(block_row_size) * block_row_count);
+		std::vector<std::uint8_t> decoded(source.size());
+		const MipLevel decoded_level = { decoded.data(), source_level.width, source_level.height, source_level.row_pitch };
+
+		for (std::uint32_t thread_count : thread_counts)
+		{
+			BlockCompressor compressor;
+			compressor.Initialize(thread_count);
+
+			const double encode_seconds = MeasureSeconds([&]()
+			{
+				compressor.Encode(format, source_level, blocks.data(), block_row_size);
+			});
+
+			const double decode_seconds = MeasureSeconds([&]()
+			{
+				compressor.Decode(format, blocks.data(), block_row_size, decoded_level);
+			});
+
+			compressor.Cleanup();
+
+			std::cout << GetTextureFormatName(format) << " " << thread_count << " threads: encode " << megapixels / encode_seconds << " MP/s, ";
+			std::cout << "decode " << megapixels / decode_seconds << " MP/s\n";
+		}
+
+		// BC1 drops alpha, so only the color is compared for it
+		std::cout << GetTextureFormatName(format) << ": " << static_cast<double>(source.size()) / blocks.size() << "x smaller, ";
+		std::cout << "RGB PSNR " << ComputePsnr(source, decoded, 0, 3) << " dB";
+
+		if (format != TextureFormat::BC1)
+		{
+			std::cout << ", alpha PSNR " << ComputePsnr(source, decoded, 3, 1) << " dB";
+		}
+
+		std::cout << "\n";
+	}
+}
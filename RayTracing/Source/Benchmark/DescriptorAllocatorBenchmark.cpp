@@ -0,0 +1,201 @@
+#include "Benchmark/Benchmarks.hpp"
+
+#include "Utility/TlsfAllocator.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+	// Largest shader visible CBV/SRV/UAV heap that resource binding tiers 1 and 2 allow
+	const std::uint32_t DESCRIPTOR_COUNT = 1000000;
+
+	// Allocations stop being made above this fill rate, and frees stop below half of it
+	const double TARGET_OCCUPANCY = 0.9;
+
+	// Root tables hold up to this many descriptors, everything else is a single view
+	const std::uint32_t MAX_RANGE_SIZE = 64;
+
+	struct Statistics
+	{
+		std::uint64_t allocation_count;
+		std::uint64_t free_count;
+		std::uint64_t failed_count;
+		std::uint64_t allocated_descriptor_count;
+	};
+
+	// Three in four requests are single descriptors, the others are table sized ranges
+	std::vector<std::uint32_t> CreateRequests(std::uint32_t t_count)
+	{
+		std::mt19937 generator(1234);
+		std::uniform_int_distribution<std::uint32_t> range_distribution(2, MAX_RANGE_SIZE);
+
+		std::vector<std::uint32_t> requests(t_count);
+
+		for (std::uint32_t& request : requests)
+		{
+			request = (generator() % 4 == 0) ? range_distribution(generator) : 1;
+		}
+
+		return requests;
+	}
+
+	// With t_occupancy set, every descriptor handed out is checked against the ones still in use
+	Statistics RunOperations(std::uint64_t t_operation_count, const std::vector<std::uint32_t>& t_requests, std::vector<std::uint8_t>* t_occupancy)
+	{
+		std::mt19937 generator(5678);
+		size_t request_index = 0;
+
+		tnt::utility::TlsfAllocator allocator;
+		allocator.Initialize(DESCRIPTOR_COUNT, 1);
+
+		std::vector<std::uint32_t> live_handles;
+		Statistics statistics = {};
+
+		for (std::uint64_t operation = 0; operation < t_operation_count; ++operation)
+		{
+			const double occupancy = 1.0 - static_cast<double>(allocator.GetFreeSize()) / DESCRIPTOR_COUNT;
+			const bool allocate = live_handles.empty() || (occupancy < TARGET_OCCUPANCY * 0.5) || (occupancy < TARGET_OCCUPANCY && (generator() & 1) != 0);
+
+			if (allocate)
+			{
+				const std::uint32_t count = t_requests[request_index++ % t_requests.size()];
+				const std::uint32_t handle = allocator.Allocate(count, 1);
+
+				if (handle == tnt::utility::INVALID_TLSF_HANDLE)
+				{
+					statistics.failed_count++;
+					continue;
+				}
+
+				if (t_occupancy != nullptr)
+				{
+					const std::uint64_t first = allocator.GetOffset(handle);
+
+					if (allocator.GetSize(handle) != count || first + count > DESCRIPTOR_COUNT)
+					{
+						throw std::runtime_error("Descriptor range has the wrong size or is out of range");
+					}
+
+					for (std::uint64_t index = first; index < first + count; ++index)
+					{
+						if ((*t_occupancy)[index] != 0)
+						{
+							throw std::runtime_error("Descriptor range overlaps a live range");
+						}
+
+						(*t_occupancy)[index] = 1;
+					}
+				}
+
+				live_handles.push_back(handle);
+				statistics.allocation_count++;
+				statistics.allocated_descriptor_count += count;
+			}
+			else
+			{
+				// Random order, so frees punch holes all over the heap
+				const size_t index = generator() % live_handles.size();
+				const std::uint32_t handle = live_handles[index];
+
+				if (t_occupancy != nullptr)
+				{
+					const std::uint64_t first = allocator.GetOffset(handle);
+					std::fill(t_occupancy->begin() + first, t_occupancy->begin() + first + allocator.GetSize(handle), 0);
+				}
+
+				allocator.Free(handle);
+
+				live_handles[index] = live_handles.back();
+				live_handles.pop_back();
+				statistics.free_count++;
+			}
+		}
+
+		if (t_occupancy != nullptr)
+		{
+			// Every range has to merge back into a single free block once everything is freed
+			for (std::uint32_t handle : live_handles)
+			{
+				allocator.Free(handle);
+			}
+
+			if (allocator.GetAllocationCount() != 0 || allocator.GetLargestFreeBlockSize() != DESCRIPTOR_COUNT)
+			{
+				throw std::runtime_error("Freed descriptor ranges did not coalesce");
+			}
+		}
+
+		return statistics;
+	}
+
+	// Free list of single descriptors, what a heap without ranges would use, for comparison
+	double MeasureSingleFreeList(std::uint64_t t_operation_count)
+	{
+		std::mt19937 generator(5678);
+
+		std::vector<std::uint32_t> free_indices(DESCRIPTOR_COUNT);
+
+		for (std::uint32_t index = 0; index < DESCRIPTOR_COUNT; ++index)
+		{
+			free_indices[index] = DESCRIPTOR_COUNT - 1 - index;
+		}
+
+		std::vector<std::uint32_t> live_indices;
+
+		auto start_time = std::chrono::high_resolution_clock::now();
+
+		for (std::uint64_t operation = 0; operation < t_operation_count; ++operation)
+		{
+			const double occupancy = static_cast<double>(live_indices.size()) / DESCRIPTOR_COUNT;
+			const bool allocate = live_indices.empty() || (occupancy < TARGET_OCCUPANCY * 0.5) || (occupancy < TARGET_OCCUPANCY && (generator() & 1) != 0);
+
+			if (allocate)
+			{
+				live_indices.push_back(free_indices.back());
+				free_indices.pop_back();
+			}
+			else
+			{
+				const size_t index = generator() % live_indices.size();
+
+				free_indices.push_back(live_indices[index]);
+				live_indices[index] = live_indices.back();
+				live_indices.pop_back();
+			}
+		}
+
+		return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count();
+	}
+}
+
+void tnt::benchmark::RunDescriptorAllocatorBenchmark(std::uint32_t t_operation_count)
+{
+	std::cout << "TLSF over " << DESCRIPTOR_COUNT << " descriptors, " << t_operation_count << " random allocations and frees of single descriptors and ranges\n";
+
+	const std::vector<std::uint32_t> requests = CreateRequests(1 << 20);
+
+	// Checked on a shorter run, clearing the occupancy of large ranges is slower than the allocator
+	std::vector<std::uint8_t> occupancy(DESCRIPTOR_COUNT, 0);
+	RunOperations(std::min<std::uint64_t>(t_operation_count, 1000000), requests, &occupancy);
+
+	std::cout << "Ranges validated, no overlaps, everything coalesced after freeing\n";
+
+	auto start_time = std::chrono::high_resolution_clock::now();
+	const Statistics statistics = RunOperations(t_operation_count, requests, nullptr);
+	const double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count();
+
+	const std::uint64_t operation_count = statistics.allocation_count + statistics.free_count + statistics.failed_count;
+
+	std::cout << "Throughput: " << operation_count / seconds / 1e6 << " M operations / second, ";
+	std::cout << statistics.allocated_descriptor_count / static_cast<double>(statistics.allocation_count) << " descriptors per allocation, ";
+	std::cout << statistics.failed_count << " failed\n";
+
+	const double free_list_seconds = MeasureSingleFreeList(t_operation_count);
+
+	std::cout << "Single descriptor free list: " << t_operation_count / free_list_seconds / 1e6 << " M operations / second\n";
+}
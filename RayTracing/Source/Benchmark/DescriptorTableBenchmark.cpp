@@ -0,0 +1,267 @@
+#include "Benchmark/Benchmarks.hpp"
+
+#include "Utility/DescriptorTableCache.hpp"
+#include "Utility/RingAllocator.hpp"
+
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+	using namespace tnt::utility;
+
+	// Same size as the per frame table region in Main.cpp
+	const std::uint32_t TABLE_RING_CAPACITY = 8192;
+
+	// Handle increment of a CBV/SRV/UAV heap on most hardware, the handles only have to look like real ones
+	const std::uint64_t DESCRIPTOR_SIZE = 32;
+	const std::uint64_t STAGING_HEAP_START = 0x10000;
+	const std::uint32_t STAGING_DESCRIPTOR_COUNT = 4096;
+
+	// Every material samples four textures that were loaded together, plus a shadow map shared by all of them
+	const std::uint32_t MATERIAL_COUNT = 512;
+	const std::uint32_t MATERIAL_TEXTURE_COUNT = 4;
+	const std::uint32_t TABLE_SIZE = MATERIAL_TEXTURE_COUNT + 1;
+	const std::uint32_t SHADOW_MAP_INDEX = STAGING_DESCRIPTOR_COUNT - 1;
+
+	// The GPU completes a frame this many frames after it was recorded, like with three back buffers
+	const std::uint64_t FRAME_LATENCY = 2;
+
+	struct Statistics
+	{
+		std::uint64_t table_count;
+		std::uint64_t copied_descriptor_count;
+		std::uint64_t copy_call_count;
+		std::uint64_t source_range_count;
+		std::uint64_t destination_range_count;
+	};
+
+	// Descriptor contents stand in for views, every staging slot holds a value of its own
+	struct Heaps
+	{
+		std::vector<std::uint64_t> staging;
+		std::vector<std::uint64_t> shader_visible;
+	};
+
+	std::uint64_t GetStagingHandle(std::uint32_t t_index)
+	{
+		return STAGING_HEAP_START + t_index * DESCRIPTOR_SIZE;
+	}
+
+	void GetMaterialSources(std::uint32_t t_material, std::uint64_t* t_sources)
+	{
+		for (std::uint32_t index = 0; index < MATERIAL_TEXTURE_COUNT; ++index)
+		{
+			t_sources[index] = GetStagingHandle(t_material * MATERIAL_TEXTURE_COUNT + index);
+		}
+
+		t_sources[MATERIAL_TEXTURE_COUNT] = GetStagingHandle(SHADOW_MAP_INDEX);
+	}
+
+	// What a single CopyDescriptors call does with its two range lists
+	void CopyRanges(Heaps& t_heaps, const std::vector<DescriptorRange>& t_destinations, const std::vector<DescriptorRange>& t_sources)
+	{
+		size_t source_range = 0;
+		std::uint32_t source_offset = 0;
+
+		for (const DescriptorRange& destination : t_destinations)
+		{
+			for (std::uint32_t index = 0; index < destination.count; ++index)
+			{
+				if (source_offset == t_sources[source_range].count)
+				{
+					source_range++;
+					source_offset = 0;
+				}
+
+				const std::uint64_t source_index = (t_sources[source_range].start - STAGING_HEAP_START) / DESCRIPTOR_SIZE + source_offset++;
+				t_heaps.shader_visible[destination.start + index] = t_heaps.staging[source_index];
+			}
+		}
+	}
+
+	struct Draw
+	{
+		std::uint64_t table_offset;
+		std::uint32_t material;
+	};
+
+	void ValidateDraws(const Heaps& t_heaps, const std::vector<Draw>& t_draws)
+	{
+		std::uint64_t sources[TABLE_SIZE];
+
+		for (const Draw& draw : t_draws)
+		{
+			GetMaterialSources(draw.material, sources);
+
+			for (std::uint32_t index = 0; index < TABLE_SIZE; ++index)
+			{
+				const std::uint64_t expected = t_heaps.staging[(sources[index] - STAGING_HEAP_START) / DESCRIPTOR_SIZE];
+
+				if (t_heaps.shader_visible[draw.table_offset + index] != expected)
+				{
+					throw std::runtime_error("Descriptor table does not hold the views of its material");
+				}
+			}
+		}
+	}
+
+	// Draws pick their material at random, so most materials come up many times per frame at the higher draw counts
+	// With t_validate set, the tables of every frame in flight are checked once the copies of the newest frame have been made
+	Statistics RunCachedFrames(std::uint32_t t_frame_count, std::uint32_t t_draw_count, Heaps& t_heaps, bool t_validate)
+	{
+		std::mt19937 generator(1234);
+
+		DescriptorTableCache tables;
+		tables.Initialize(TABLE_RING_CAPACITY, DESCRIPTOR_SIZE);
+
+		std::deque<std::vector<Draw>> frames_in_flight;
+		std::vector<Draw> draws(t_draw_count);
+		std::uint64_t sources[TABLE_SIZE];
+
+		Statistics statistics = {};
+
+		for (std::uint32_t frame = 1; frame <= t_frame_count; ++frame)
+		{
+			const std::uint64_t fence_value = frame;
+			const std::uint64_t completed_fence_value = (fence_value > FRAME_LATENCY) ? fence_value - FRAME_LATENCY : 0;
+
+			tables.Retire(completed_fence_value);
+
+			// Frames up to the completed one are no longer read by the GPU
+			while (frames_in_flight.size() > fence_value - 1 - completed_fence_value)
+			{
+				frames_in_flight.pop_front();
+			}
+
+			for (Draw& draw : draws)
+			{
+				draw.material = generator() % MATERIAL_COUNT;
+				GetMaterialSources(draw.material, sources);
+
+				draw.table_offset = tables.Allocate(sources, TABLE_SIZE);
+
+				if (draw.table_offset == INVALID_RING_OFFSET)
+				{
+					throw std::runtime_error("Descriptor table ring is full");
+				}
+			}
+
+			statistics.table_count += t_draw_count;
+			statistics.copied_descriptor_count += tables.GetPendingCount();
+			statistics.copy_call_count++;
+			statistics.source_range_count += tables.GetSourceRanges().size();
+			statistics.destination_range_count += tables.GetDestinationRanges().size();
+
+			CopyRanges(t_heaps, tables.GetDestinationRanges(), tables.GetSourceRanges());
+			tables.ClearPending();
+
+			if (t_validate)
+			{
+				frames_in_flight.push_back(draws);
+
+				// Copies of the new frame must not have landed in tables that older frames still read
+				for (const std::vector<Draw>& frame_draws : frames_in_flight)
+				{
+					ValidateDraws(t_heaps, frame_draws);
+				}
+			}
+
+			tables.FinishFrame(fence_value);
+		}
+
+		return statistics;
+	}
+
+	// Every draw copies its own table with a call of its own, what binding without the cache looks like
+	Statistics RunUncachedFrames(std::uint32_t t_frame_count, std::uint32_t t_draw_count, Heaps& t_heaps)
+	{
+		std::mt19937 generator(1234);
+
+		RingAllocator ring;
+		ring.Initialize(static_cast<std::uint64_t>(t_draw_count) * TABLE_SIZE * (FRAME_LATENCY + 1));
+
+		std::vector<DescriptorRange> destinations(1);
+		std::vector<DescriptorRange> source_ranges(1);
+		std::uint64_t sources[TABLE_SIZE];
+
+		Statistics statistics = {};
+
+		for (std::uint32_t frame = 1; frame <= t_frame_count; ++frame)
+		{
+			const std::uint64_t fence_value = frame;
+			ring.Retire((fence_value > FRAME_LATENCY) ? fence_value - FRAME_LATENCY : 0);
+
+			for (std::uint32_t draw = 0; draw < t_draw_count; ++draw)
+			{
+				GetMaterialSources(generator() % MATERIAL_COUNT, sources);
+
+				const std::uint64_t offset = ring.Allocate(TABLE_SIZE, 1);
+
+				// One range per descriptor, the table has no idea its sources are neighbours
+				destinations[0] = { offset, TABLE_SIZE };
+				source_ranges.resize(TABLE_SIZE);
+
+				for (std::uint32_t index = 0; index < TABLE_SIZE; ++index)
+				{
+					source_ranges[index] = { sources[index], 1 };
+				}
+
+				CopyRanges(t_heaps, destinations, source_ranges);
+
+				statistics.copied_descriptor_count += TABLE_SIZE;
+				statistics.copy_call_count++;
+				statistics.source_range_count += TABLE_SIZE;
+				statistics.destination_range_count++;
+			}
+
+			statistics.table_count += t_draw_count;
+			ring.FinishFrame(fence_value);
+		}
+
+		return statistics;
+	}
+}
+
+void tnt::benchmark::RunDescriptorTableBenchmark(std::uint32_t t_frame_count)
+{
+	const std::uint32_t draw_counts[] = { 256, 4096, 16384 };
+
+	std::cout << MATERIAL_COUNT << " materials with tables of " << TABLE_SIZE << " descriptors, " << t_frame_count << " frames, table region of " << TABLE_RING_CAPACITY << " descriptors\n";
+
+	Heaps heaps;
+	heaps.staging.resize(STAGING_DESCRIPTOR_COUNT);
+
+	for (std::uint32_t index = 0; index < STAGING_DESCRIPTOR_COUNT; ++index)
+	{
+		heaps.staging[index] = 0x9E3779B97F4A7C15ull * (index + 1);
+	}
+
+	for (std::uint32_t draw_count : draw_counts)
+	{
+		heaps.shader_visible.assign(TABLE_RING_CAPACITY, 0);
+		RunCachedFrames(t_frame_count, draw_count, heaps, true);
+
+		// Copies only store the fake contents, so the time is mostly the hashing and batching
+		auto start_time = std::chrono::high_resolution_clock::now();
+		const Statistics cached = RunCachedFrames(t_frame_count, draw_count, heaps, false);
+		const double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count();
+
+		heaps.shader_visible.assign(static_cast<size_t>(draw_count) * TABLE_SIZE * (FRAME_LATENCY + 1), 0);
+		const Statistics uncached = RunUncachedFrames(t_frame_count, draw_count, heaps);
+
+		const double copied_tables = static_cast<double>(cached.copied_descriptor_count) / TABLE_SIZE / t_frame_count;
+
+		std::cout << draw_count << " draws per frame: " << copied_tables << " tables copied (" << 100.0 * (1.0 - copied_tables / draw_count) << "% cache hits), ";
+		std::cout << cached.copied_descriptor_count / t_frame_count << " descriptors in " << cached.source_range_count / t_frame_count << " source and ";
+		std::cout << cached.destination_range_count / t_frame_count << " destination ranges with " << cached.copy_call_count / t_frame_count << " call, ";
+		std::cout << seconds / cached.table_count * 1e9 << " ns per table\n";
+		std::cout << "    copy per draw: " << uncached.copied_descriptor_count / t_frame_count << " descriptors with " << uncached.copy_call_count / t_frame_count << " calls\n";
+	}
+
+	std::cout << "Tables validated, every draw read the views of its material\n";
+}
@@ -0,0 +1,219 @@
+#include "Benchmark/Benchmarks.hpp"
+
+#include "Renderer/SceneData.hpp"
+#include "Utility/FixedTimestep.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+	using namespace tnt::graphics;
+	using namespace tnt::utility;
+
+	const double SIMULATION_STEP = 1.0 / 60.0;
+	const std::uint32_t MAX_STEPS_PER_FRAME = 8;
+
+	struct Scenario
+	{
+		const char* name;
+		double frame_time;
+		double jitter;				// Fraction of the frame time a frame may be shorter or longer
+		std::uint32_t hitch_interval;	// Every this many frames one frame stalls for half a second, zero for never
+	};
+
+	struct Statistics
+	{
+		std::uint64_t frame_count;
+		std::uint64_t step_count;
+		double dropped_time;
+		double speed;				// Average of the rendered motion, viewport units per second
+		double max_speed_error;		// Largest deviation of one frame from the average, relative
+		double max_time_error;		// Of the rendered state against the clock, seconds
+		float final_offset;
+	};
+
+	// The scroll speed is private to the scene, a single second long step from the origin does not wrap and reveals it
+	float GetReferenceSpeed()
+	{
+		SceneConstantBufferData scene_data = {};
+		AdvanceScene(scene_data, 1.0f);
+
+		return scene_data.positionOffset.x;
+	}
+
+	// With t_fixed_step unset the scene moves one step per frame, like it did when it was advanced from WM_PAINT
+	Statistics RunFrames(const Scenario& t_scenario, double t_duration, bool t_fixed_step)
+	{
+		std::mt19937 generator(1234);
+		std::uniform_real_distribution<double> jitter(1.0 - t_scenario.jitter, 1.0 + t_scenario.jitter);
+
+		FixedTimestep timestep;
+		timestep.Initialize(SIMULATION_STEP, MAX_STEPS_PER_FRAME);
+
+		SceneConstantBufferData previous = {};
+		SceneConstantBufferData current = {};
+		SceneConstantBufferData rendered = {};
+
+		Statistics statistics = {};
+		std::vector<double> frame_speeds;
+
+		double time = 0.0;
+		double last_time = 0.0;
+		float last_offset = 0.0f;
+		bool last_moving = false;
+
+		while (time < t_duration)
+		{
+			const double dropped_time = timestep.GetDroppedTime();
+
+			if (t_fixed_step)
+			{
+				rendered = SimulateScene(timestep, time, previous, current);
+
+				// The rendered state trails the clock by one step, minus whatever was dropped
+				if (timestep.GetStepCount() > 0)
+				{
+					const double rendered_time = timestep.GetSimulationTime() - timestep.GetStep() * (1.0 - timestep.GetAlpha());
+					const double expected_time = time - timestep.GetDroppedTime() - timestep.GetStep();
+
+					statistics.max_time_error = std::max(statistics.max_time_error, std::abs(rendered_time - expected_time));
+				}
+			}
+			else
+			{
+				AdvanceScene(rendered, static_cast<float>(SIMULATION_STEP));
+			}
+
+			// The rendered state trails by a step, so the scene only starts moving once the first one was simulated
+			const float offset = rendered.positionOffset.x;
+			const bool moving = !t_fixed_step || timestep.GetStepCount() > 0;
+
+			// Frames that wrapped around or dropped time do not show the speed
+			if (last_moving && offset > last_offset && timestep.GetDroppedTime() == dropped_time)
+			{
+				frame_speeds.push_back((offset - last_offset) / (time - last_time));
+			}
+
+			last_time = time;
+			last_offset = offset;
+			last_moving = moving;
+			statistics.frame_count++;
+
+			const bool hitch = t_scenario.hitch_interval != 0 && statistics.frame_count % t_scenario.hitch_interval == 0;
+			time += hitch ? 0.5 : t_scenario.frame_time * jitter(generator);
+		}
+
+		double total_speed = 0.0;
+
+		for (double speed : frame_speeds)
+		{
+			total_speed += speed;
+		}
+
+		statistics.speed = frame_speeds.empty() ? 0.0 : total_speed / frame_speeds.size();
+
+		for (double speed : frame_speeds)
+		{
+			statistics.max_speed_error = std::max(statistics.max_speed_error, std::abs(speed - statistics.speed) / statistics.speed);
+		}
+
+		statistics.step_count = timestep.GetStepCount();
+		statistics.dropped_time = timestep.GetDroppedTime();
+		statistics.final_offset = current.positionOffset.x;
+
+		return statistics;
+	}
+
+	// The simulation only depends on the number of steps, so any frame rate has to end up in the same state
+	float SimulateSteps(std::uint64_t t_step_count)
+	{
+		SceneConstantBufferData scene_data = {};
+
+		for (std::uint64_t index = 0; index < t_step_count; ++index)
+		{
+			AdvanceScene(scene_data, static_cast<float>(SIMULATION_STEP));
+		}
+
+		return scene_data.positionOffset.x;
+	}
+}
+
+void tnt::benchmark::RunFixedTimestepBenchmark(std::uint32_t t_frame_count)
+{
+	const Scenario scenarios[] =
+	{
+		{ "30 Hz", 1.0 / 30.0, 0.0, 0 },
+		{ "60 Hz", 1.0 / 60.0, 0.0, 0 },
+		{ "144 Hz", 1.0 / 144.0, 0.0, 0 },
+		{ "1000 Hz", 1.0 / 1000.0, 0.0, 0 },
+		{ "60 Hz, 50% jitter", 1.0 / 60.0, 0.5, 0 },
+		{ "144 Hz, hitch every 500 frames", 1.0 / 144.0, 0.0, 500 }
+	};
+
+	// As long as t_frame_count frames take at the fastest rate
+	const double duration = t_frame_count / 1000.0;
+	const double reference_speed = GetReferenceSpeed();
+
+	std::cout << "Simulated clock, " << duration << " s per run, " << SIMULATION_STEP * 1000.0 << " ms steps, scene speed " << reference_speed << " / s\n";
+
+	bool frame_rate_independent = true;
+	std::uint64_t simulated_frame_count = 0;
+
+	auto start_time = std::chrono::high_resolution_clock::now();
+
+	for (const Scenario& scenario : scenarios)
+	{
+		const Statistics per_frame = RunFrames(scenario, duration, false);
+		const Statistics fixed = RunFrames(scenario, duration, true);
+
+		std::cout << scenario.name << " (" << fixed.frame_count << " frames)\n";
+		std::cout << "    step per frame: " << per_frame.speed << " / s, " << 100.0 * per_frame.max_speed_error << "% frame to frame variation\n";
+		std::cout << "    fixed step: " << fixed.speed << " / s, " << 100.0 * fixed.max_speed_error << "% frame to frame variation, ";
+		std::cout << fixed.step_count << " steps, " << fixed.dropped_time * 1000.0 << " ms dropped, ";
+		std::cout << fixed.max_time_error * 1e6 << " us largest clock error\n";
+
+		// Time that was neither simulated nor dropped is less than a step, plus the one the rendered state trails by
+		const double simulated_time = fixed.step_count * SIMULATION_STEP + fixed.dropped_time;
+
+		frame_rate_independent &= std::abs(fixed.speed - reference_speed) < 0.01 * reference_speed;
+		frame_rate_independent &= fixed.max_speed_error < 0.01;
+		frame_rate_independent &= fixed.max_time_error < 1e-6;
+		frame_rate_independent &= simulated_time <= duration + SIMULATION_STEP && simulated_time > duration - 2.0 * SIMULATION_STEP - scenario.frame_time * (1.0 + scenario.jitter);
+		frame_rate_independent &= fixed.final_offset == SimulateSteps(fixed.step_count);
+
+		simulated_frame_count += per_frame.frame_count + fixed.frame_count;
+	}
+
+	const double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count();
+
+	// The loop alone, as fast as a headless driver can run it
+	FixedTimestep timestep;
+	timestep.Initialize(SIMULATION_STEP, MAX_STEPS_PER_FRAME);
+
+	SceneConstantBufferData previous = {};
+	SceneConstantBufferData current = {};
+	float checksum = 0.0f;
+
+	auto loop_start_time = std::chrono::high_resolution_clock::now();
+
+	for (std::uint32_t frame = 0; frame < t_frame_count * 100; ++frame)
+	{
+		checksum += SimulateScene(timestep, frame * 0.001, previous, current).positionOffset.x;
+	}
+
+	const double loop_seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - loop_start_time).count();
+
+	std::cout << simulated_frame_count / seconds / 1e6 << " M simulated frames / second with statistics, ";
+	std::cout << t_frame_count * 100.0 / loop_seconds / 1e6 << " M loop iterations / second (checksum " << checksum << ")\n";
+
+	if (!frame_rate_independent)
+	{
+		throw std::runtime_error("Fixed timestep simulation depends on the frame rate");
+	}
+}
@@ -0,0 +1,274 @@
+#include "Benchmark/Benchmarks.hpp"
+
+#include "Utility/FramePacer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+	using namespace tnt::utility;
+
+	struct Scenario
+	{
+		const char* name;
+		double cpu_time;
+		double gpu_time;
+		double refresh_interval;	// Zero presents right away
+	};
+
+	// Executes frames back to back in submission order, like a single queue
+	class SimulatedGpu
+	{
+	public:
+		SimulatedGpu()
+			: m_busy_until(0.0)
+		{
+		}
+
+		void Submit(std::uint64_t t_fence_value, double t_time, double t_duration)
+		{
+			m_busy_until = std::max(m_busy_until, t_time) + t_duration;
+			m_completions.push_back({ t_fence_value, m_busy_until });
+		}
+
+		std::uint64_t GetCompletedValue(double t_time) const
+		{
+			std::uint64_t completed_fence_value = 0;
+
+			for (const Completion& completion : m_completions)
+			{
+				if (completion.time > t_time)
+				{
+					break;
+				}
+
+				completed_fence_value = completion.fence_value;
+			}
+
+			return completed_fence_value;
+		}
+
+		double GetCompletionTime(std::uint64_t t_fence_value) const
+		{
+			for (const Completion& completion : m_completions)
+			{
+				if (completion.fence_value >= t_fence_value)
+				{
+					return completion.time;
+				}
+			}
+
+			throw std::runtime_error("Waiting for a fence value that was never signaled");
+		}
+
+		// Frames that were submitted but have not completed at t_time
+		std::uint32_t GetQueuedCount(double t_time) const
+		{
+			std::uint32_t queued_count = 0;
+
+			for (const Completion& completion : m_completions)
+			{
+				queued_count += (completion.time > t_time) ? 1 : 0;
+			}
+
+			return queued_count;
+		}
+
+		// Completions long in the past do not matter to any wait, keeps the lookups short
+		void Trim(double t_time)
+		{
+			while (m_completions.size() > 1 && m_completions[1].time <= t_time)
+			{
+				m_completions.pop_front();
+			}
+		}
+
+	private:
+		struct Completion
+		{
+			std::uint64_t fence_value;
+			double time;
+		};
+
+	private:
+		std::deque<Completion> m_completions;
+		double m_busy_until;
+	};
+
+	struct Statistics
+	{
+		double frames_per_second;
+		double fence_stall_time;		// Per frame
+		double latency;					// From the start of a frame to its first v-blank or its completion
+		std::uint64_t fence_stall_count;
+		std::uint64_t unnecessary_stall_count;	// Waits while fewer than N frames were queued
+		std::uint64_t overrun_count;			// Recording while N frames were queued
+	};
+
+	// With t_flush_every_frame set, the CPU waits for the GPU to go idle after every frame, like a single WaitForGPU per frame
+	// The swap chain waitable lets frame F start once frame F - N has left the present queue at its v-blank
+	Statistics RunFrames(const Scenario& t_scenario, std::uint32_t t_frames_in_flight, bool t_flush_every_frame, std::uint32_t t_frame_count)
+	{
+		std::mt19937 generator(1234);
+		std::uniform_real_distribution<double> jitter(0.8, 1.2);
+
+		FramePacer pacer;
+		pacer.Initialize(t_frames_in_flight, 64);
+
+		SimulatedGpu gpu;
+		std::vector<double> display_times;
+		display_times.reserve(t_frame_count);
+
+		Statistics statistics = {};
+		double time = 0.0;
+		double total_latency = 0.0;
+
+		// The pacer only sees the waits of the frames, waiting for idle is counted here
+		double flush_stall_time = 0.0;
+		std::uint64_t flush_stall_count = 0;
+
+		for (std::uint32_t frame = 0; frame < t_frame_count; ++frame)
+		{
+			const double begin_time = time;
+			pacer.BeginFrame(time);
+
+			if (t_scenario.refresh_interval > 0.0 && frame >= t_frames_in_flight)
+			{
+				time = std::max(time, display_times[frame - t_frames_in_flight]);
+			}
+
+			const std::uint64_t wait_value = pacer.EndLatencyWait(gpu.GetCompletedValue(time), time);
+			const std::uint32_t queued_count = gpu.GetQueuedCount(time);
+
+			if (wait_value != 0 && queued_count < t_frames_in_flight)
+			{
+				statistics.unnecessary_stall_count++;
+			}
+
+			if (wait_value != 0)
+			{
+				time = std::max(time, gpu.GetCompletionTime(wait_value));
+			}
+
+			pacer.BeginRecording(gpu.GetCompletedValue(time), time);
+
+			if (gpu.GetQueuedCount(time) >= t_frames_in_flight)
+			{
+				statistics.overrun_count++;
+			}
+
+			time += t_scenario.cpu_time * jitter(generator);
+
+			const std::uint64_t fence_value = pacer.EndFrame(time);
+			gpu.Submit(fence_value, time, t_scenario.gpu_time * jitter(generator));
+
+			// Shown at the first free v-blank after the GPU is done, one frame per v-blank
+			double display_time = gpu.GetCompletionTime(fence_value);
+
+			if (t_scenario.refresh_interval > 0.0)
+			{
+				display_time = std::ceil(display_time / t_scenario.refresh_interval) * t_scenario.refresh_interval;
+
+				if (!display_times.empty())
+				{
+					display_time = std::max(display_time, display_times.back() + t_scenario.refresh_interval);
+				}
+			}
+
+			display_times.push_back(display_time);
+			total_latency += display_time - begin_time;
+
+			if (t_flush_every_frame)
+			{
+				const std::uint64_t flush_value = pacer.Flush();
+				gpu.Submit(flush_value, time, 0.0);
+
+				const double idle_time = gpu.GetCompletionTime(flush_value);
+
+				if (idle_time > time)
+				{
+					flush_stall_time += idle_time - time;
+					flush_stall_count++;
+					time = idle_time;
+				}
+			}
+
+			gpu.Trim(time);
+		}
+
+		const double elapsed_time = std::max(time, display_times.back());
+
+		statistics.frames_per_second = t_frame_count / elapsed_time;
+		statistics.fence_stall_time = (pacer.GetFenceStallTime() + flush_stall_time) / t_frame_count;
+		statistics.latency = total_latency / t_frame_count;
+		statistics.fence_stall_count = pacer.GetFenceStallCount() + flush_stall_count;
+
+		return statistics;
+	}
+
+	void PrintStatistics(const char* t_label, const Statistics& t_statistics, std::uint32_t t_frame_count)
+	{
+		std::cout << "    " << t_label << ": " << t_statistics.frames_per_second << " fps, ";
+		std::cout << t_statistics.fence_stall_time * 1000.0 << " ms fence wait per frame (" << 100.0 * t_statistics.fence_stall_count / t_frame_count << "% of frames), ";
+		std::cout << t_statistics.latency * 1000.0 << " ms latency\n";
+	}
+}
+
+void tnt::benchmark::RunFramePacingBenchmark(std::uint32_t t_frame_count)
+{
+	const Scenario scenarios[] =
+	{
+		{ "CPU bound", 0.008, 0.004, 0.0 },
+		{ "GPU bound", 0.004, 0.008, 0.0 },
+		{ "Balanced", 0.006, 0.006, 0.0 },
+		{ "GPU bound, 60 Hz v-sync", 0.004, 0.012, 1.0 / 60.0 },
+		{ "Light, 60 Hz v-sync", 0.002, 0.003, 1.0 / 60.0 }
+	};
+
+	std::cout << "Simulated CPU and GPU with 20% jitter, " << t_frame_count << " frames per run\n";
+
+	std::uint64_t unnecessary_stall_count = 0;
+	std::uint64_t overrun_count = 0;
+
+	auto start_time = std::chrono::high_resolution_clock::now();
+	std::uint64_t simulated_frame_count = 0;
+
+	for (const Scenario& scenario : scenarios)
+	{
+		std::cout << scenario.name << " (CPU " << scenario.cpu_time * 1000.0 << " ms, GPU " << scenario.gpu_time * 1000.0 << " ms)\n";
+
+		const Statistics flushed = RunFrames(scenario, 1, true, t_frame_count);
+		PrintStatistics("wait for idle", flushed, t_frame_count);
+		simulated_frame_count += t_frame_count;
+
+		for (std::uint32_t frames_in_flight = 1; frames_in_flight <= 3; ++frames_in_flight)
+		{
+			const Statistics statistics = RunFrames(scenario, frames_in_flight, false, t_frame_count);
+
+			const std::string label = std::to_string(frames_in_flight) + " in flight";
+			PrintStatistics(label.c_str(), statistics, t_frame_count);
+
+			unnecessary_stall_count += statistics.unnecessary_stall_count;
+			overrun_count += statistics.overrun_count;
+			simulated_frame_count += t_frame_count;
+		}
+	}
+
+	const double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count();
+
+	std::cout << unnecessary_stall_count << " waits with fewer frames queued than allowed, " << overrun_count << " frames recorded with too many queued\n";
+	std::cout << simulated_frame_count / seconds / 1e6 << " M simulated frames / second\n";
+
+	if (unnecessary_stall_count != 0 || overrun_count != 0)
+	{
+		throw std::runtime_error("Frame pacer waited without a reason or let too many frames queue up");
+	}
+}
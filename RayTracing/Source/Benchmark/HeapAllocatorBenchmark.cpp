@@ -0,0 +1,221 @@
+#include "Benchmark/Benchmarks.hpp"
+
+#include "Utility/TlsfAllocator.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+	// Same size as the heap blocks Main.cpp places its resources in
+	const std::uint64_t HEAP_SIZE = 256ull * 1024 * 1024;
+
+	// Allocations stop being made above this fill rate, and frees stop below half of it
+	const double TARGET_OCCUPANCY = 0.75;
+
+	struct Request
+	{
+		std::uint64_t size;
+		std::uint64_t alignment;
+	};
+
+	// Mix of what a D3D12 renderer places: small buffers, 4 KB aligned small textures and 64 KB aligned resources
+	Request CreateRequest(std::mt19937& t_generator)
+	{
+		std::uniform_real_distribution<double> log_distribution(0.0, 1.0);
+		const std::uint32_t kind = t_generator() % 8;
+
+		if (kind < 4)
+		{
+			return { static_cast<std::uint64_t>(256.0 * std::pow(4096.0, log_distribution(t_generator))), 256 };
+		}
+
+		if (kind < 6)
+		{
+			return { static_cast<std::uint64_t>(std::pow(16.0, log_distribution(t_generator))) * 4096, 4096 };
+		}
+
+		return { static_cast<std::uint64_t>(std::pow(128.0, log_distribution(t_generator))) * 65536, 65536 };
+	}
+
+	struct Statistics
+	{
+		std::uint64_t allocation_count;
+		std::uint64_t free_count;
+		std::uint64_t failed_count;			// No room at all
+		std::uint64_t fragmented_count;		// Enough free bytes in total, but no block large enough
+		double peak_occupancy;
+		double fragmentation_sum;			// 1 - largest free block / free size, sampled every 1024 operations
+		std::uint64_t fragmentation_samples;
+		std::vector<float> latencies;		// Nanoseconds per operation, only filled when measuring latency
+	};
+
+	// With t_placements set, every allocation is checked against the live ranges for overlap and alignment
+	Statistics RunOperations(
+		std::uint64_t t_operation_count,
+		const std::vector<Request>& t_requests,
+		bool t_measure_latency,
+		std::map<std::uint64_t, std::uint64_t>* t_placements)
+	{
+		std::mt19937 generator(5678);
+		size_t request_index = 0;
+
+		tnt::utility::TlsfAllocator allocator;
+		allocator.Initialize(HEAP_SIZE);
+
+		std::vector<std::uint32_t> live_handles;
+		Statistics statistics = {};
+
+		if (t_measure_latency)
+		{
+			statistics.latencies.reserve(static_cast<size_t>(t_operation_count));
+		}
+
+		for (std::uint64_t operation = 0; operation < t_operation_count; ++operation)
+		{
+			const double occupancy = 1.0 - static_cast<double>(allocator.GetFreeSize()) / HEAP_SIZE;
+			const bool allocate = live_handles.empty() || (occupancy < TARGET_OCCUPANCY * 0.5) || (occupancy < TARGET_OCCUPANCY && (generator() & 1) != 0);
+
+			statistics.peak_occupancy = std::max(statistics.peak_occupancy, occupancy);
+
+			auto start_time = std::chrono::high_resolution_clock::now();
+
+			if (allocate)
+			{
+				const Request& request = t_requests[request_index++ % t_requests.size()];
+				const std::uint32_t handle = allocator.Allocate(request.size, request.alignment);
+
+				if (t_measure_latency)
+				{
+					statistics.latencies.push_back(std::chrono::duration<float, std::nano>(std::chrono::high_resolution_clock::now() - start_time).count());
+				}
+
+				if (handle == tnt::utility::INVALID_TLSF_HANDLE)
+				{
+					if (allocator.GetFreeSize() >= request.size)
+					{
+						statistics.fragmented_count++;
+					}
+					else
+					{
+						statistics.failed_count++;
+					}
+
+					continue;
+				}
+
+				if (t_placements != nullptr)
+				{
+					const std::uint64_t offset = allocator.GetOffset(handle);
+					const std::uint64_t end = offset + allocator.GetSize(handle);
+
+					if (offset % request.alignment != 0 || end > HEAP_SIZE || allocator.GetSize(handle) < request.size)
+					{
+						throw std::runtime_error("TLSF allocation is misaligned or out of range");
+					}
+
+					auto next = t_placements->lower_bound(offset);
+
+					if ((next != t_placements->end() && next->first < end) || (next != t_placements->begin() && std::prev(next)->second > offset))
+					{
+						throw std::runtime_error("TLSF allocation overlaps a live allocation");
+					}
+
+					(*t_placements)[offset] = end;
+				}
+
+				live_handles.push_back(handle);
+				statistics.allocation_count++;
+			}
+			else
+			{
+				// Random order, so frees punch holes all over the heap
+				const size_t index = generator() % live_handles.size();
+				const std::uint32_t handle = live_handles[index];
+
+				if (t_placements != nullptr)
+				{
+					t_placements->erase(allocator.GetOffset(handle));
+				}
+
+				start_time = std::chrono::high_resolution_clock::now();
+				allocator.Free(handle);
+
+				if (t_measure_latency)
+				{
+					statistics.latencies.push_back(std::chrono::duration<float, std::nano>(std::chrono::high_resolution_clock::now() - start_time).count());
+				}
+
+				live_handles[index] = live_handles.back();
+				live_handles.pop_back();
+				statistics.free_count++;
+			}
+
+			if (operation % 1024 == 0 && allocator.GetFreeSize() > 0)
+			{
+				statistics.fragmentation_sum += 1.0 - static_cast<double>(allocator.GetLargestFreeBlockSize()) / allocator.GetFreeSize();
+				statistics.fragmentation_samples++;
+			}
+		}
+
+		if (t_placements != nullptr && t_placements->size() != allocator.GetAllocationCount())
+		{
+			throw std::runtime_error("TLSF allocation count does not match the live allocations");
+		}
+
+		return statistics;
+	}
+}
+
+void tnt::benchmark::RunHeapAllocatorBenchmark(std::uint32_t t_operation_count)
+{
+	std::cout << "TLSF in a " << HEAP_SIZE / (1024 * 1024) << " MB heap, " << t_operation_count << " random allocations and frees\n";
+
+	// Generated up front, the size distribution costs more than the allocator itself
+	std::mt19937 generator(1234);
+	std::vector<Request> requests(1 << 20);
+
+	for (Request& request : requests)
+	{
+		request = CreateRequest(generator);
+	}
+
+	// Checked on a shorter run, the overlap test is far slower than the allocator
+	std::map<std::uint64_t, std::uint64_t> placements;
+	RunOperations(std::min<std::uint64_t>(t_operation_count, 1000000), requests, false, &placements);
+
+	std::cout << "Placements validated, no overlaps or misaligned offsets\n";
+
+	auto start_time = std::chrono::high_resolution_clock::now();
+	const Statistics statistics = RunOperations(t_operation_count, requests, false, nullptr);
+	auto end_time = std::chrono::high_resolution_clock::now();
+
+	const double seconds = std::chrono::duration<double>(end_time - start_time).count();
+	const std::uint64_t operation_count = statistics.allocation_count + statistics.free_count + statistics.failed_count + statistics.fragmented_count;
+
+	std::cout << "Throughput: " << operation_count / seconds / 1e6 << " M operations / second\n";
+	std::cout << "Allocations: " << statistics.allocation_count << ", frees: " << statistics.free_count << ", out of memory: " << statistics.failed_count;
+	std::cout << ", failed due to fragmentation: " << statistics.fragmented_count << "\n";
+	std::cout << "Peak occupancy: " << statistics.peak_occupancy * 100.0 << "%, average external fragmentation: ";
+	std::cout << (statistics.fragmentation_samples > 0 ? statistics.fragmentation_sum / statistics.fragmentation_samples * 100.0 : 0.0) << "%\n";
+
+	Statistics latency_statistics = RunOperations(t_operation_count, requests, true, nullptr);
+	std::vector<float>& latencies = latency_statistics.latencies;
+
+	if (!latencies.empty())
+	{
+		std::sort(latencies.begin(), latencies.end());
+
+		std::cout << "Latency (ns, includes the timer): median " << latencies[latencies.size() / 2];
+		std::cout << ", 99th percentile " << latencies[latencies.size() * 99 / 100];
+		std::cout << ", 99.9th percentile " << latencies[latencies.size() * 999 / 1000];
+		std::cout << ", max " << latencies.back() << "\n";
+	}
+}
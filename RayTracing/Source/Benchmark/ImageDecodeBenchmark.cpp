@@ -0,0 +1,97 @@
+#include "Benchmark/Benchmarks.hpp"
+
+#include "Utility/ImageDecodePool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	// Room for a handful of decoded 1280x720 images, small enough that the budget actually throttles the workers
+	const std::uint64_t BENCHMARK_MEMORY_BUDGET = 32 * 1024 * 1024;
+
+	struct DecodeResult
+	{
+		double seconds;
+		std::uint64_t encoded_bytes;
+		std::uint64_t decoded_bytes;
+		std::uint64_t peak_memory_in_flight;
+	};
+
+	// Queues every request up front and frees each image as soon as it is popped, like a streamer that uploads right away
+	DecodeResult DecodeAll(const std::string& t_path, std::uint32_t t_image_count, std::uint32_t t_thread_count)
+	{
+		tnt::utility::ImageDecodePool pool;
+		pool.Initialize(t_thread_count, BENCHMARK_MEMORY_BUDGET);
+
+		DecodeResult result = {};
+		auto start_time = std::chrono::high_resolution_clock::now();
+
+		for (std::uint32_t index = 0; index < t_image_count; ++index)
+		{
+			pool.Request(t_path, index);
+		}
+
+		tnt::utility::DecodedImage image;
+
+		while (pool.WaitAndPop(image))
+		{
+			if (image.rgba == nullptr)
+			{
+				throw std::runtime_error("Could not decode " + t_path);
+			}
+
+			result.encoded_bytes += image.encoded_size;
+			result.decoded_bytes += static_cast<std::uint64_t>(image.width) * image.height * 4;
+
+			pool.Free(image);
+		}
+
+		result.seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count();
+		result.peak_memory_in_flight = pool.GetPeakMemoryInFlight();
+
+		pool.Cleanup();
+
+		return result;
+	}
+}
+
+void tnt::benchmark::RunImageDecodeBenchmark(const std::string& t_path, std::uint32_t t_image_count)
+{
+	const std::uint32_t hardware_thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+
+	// One, two, four... workers, and every hardware thread when that is not a power of two
+	std::vector<std::uint32_t> thread_counts;
+
+	for (std::uint32_t thread_count = 1; thread_count < hardware_thread_count; thread_count *= 2)
+	{
+		thread_counts.push_back(thread_count);
+	}
+
+	thread_counts.push_back(hardware_thread_count);
+
+	std::cout << t_image_count << " decodes of " << t_path << ", " << BENCHMARK_MEMORY_BUDGET / (1024 * 1024) << " MB memory budget\n";
+
+	double single_thread_seconds = 0.0;
+
+	for (std::uint32_t thread_count : thread_counts)
+	{
+		const DecodeResult result = DecodeAll(t_path, t_image_count, thread_count);
+
+		if (thread_count == 1)
+		{
+			single_thread_seconds = result.seconds;
+		}
+
+		std::cout << thread_count << " threads: "
+			<< result.decoded_bytes / (1024.0 * 1024.0) / result.seconds << " MB/s decoded, "
+			<< result.encoded_bytes / (1024.0 * 1024.0) / result.seconds << " MB/s read, "
+			<< t_image_count / result.seconds << " images/s, "
+			<< single_thread_seconds / result.seconds << "x, peak "
+			<< result.peak_memory_in_flight / (1024.0 * 1024.0) << " MB in flight\n";
+	}
+}
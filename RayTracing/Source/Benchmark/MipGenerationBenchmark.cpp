@@ -0,0 +1,155 @@
+#include "Benchmark/Benchmarks.hpp"
+
+#include "Renderer/MipGenerator.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	using namespace tnt::graphics;
+
+	// Repeated until at least this long has passed, small textures finish far quicker than the timer resolution
+	const double MIN_MEASURE_SECONDS = 0.5;
+
+	// Tightly packed chain, level zero holds the source texels
+	struct MipChain
+	{
+		std::vector<std::uint8_t> texels;
+		std::vector<MipLevel> levels;
+	};
+
+	MipChain CreateMipChain(std::uint32_t t_size)
+	{
+		MipChain chain;
+		size_t texel_count = 0;
+
+		for (std::uint32_t size = t_size; size > 0; size /= 2)
+		{
+			texel_count += static_cast<size_t>(size) * size;
+		}
+
+		chain.texels.resize(texel_count * 4);
+		size_t offset = 0;
+
+		for (std::uint32_t size = t_size; size > 0; size /= 2)
+		{
+			chain.levels.push_back({ chain.texels.data() + offset, size, size, size * 4 });
+			offset += static_cast<size_t>(size) * size * 4;
+		}
+
+		return chain;
+	}
+
+	// The levels point into the texel buffer, so copies get their own chain
+	MipChain CopyMipChain(const MipChain& t_chain)
+	{
+		MipChain chain = CreateMipChain(t_chain.levels[0].width);
+		std::copy(t_chain.texels.begin(), t_chain.texels.end(), chain.texels.begin());
+
+		return chain;
+	}
+
+	// Largest difference of any channel in any mip below the top one
+	std::uint32_t CompareMips(const MipChain& t_chain, const MipChain& t_reference)
+	{
+		const size_t first_byte = static_cast<size_t>(t_chain.levels[0].row_pitch) * t_chain.levels[0].height;
+		std::uint32_t max_difference = 0;
+
+		for (size_t index = first_byte; index < t_chain.texels.size(); ++index)
+		{
+			max_difference = std::max(max_difference, static_cast<std::uint32_t>(std::abs(t_chain.texels[index] - t_reference.texels[index])));
+		}
+
+		return max_difference;
+	}
+}
+
+void tnt::benchmark::RunMipGenerationBenchmark(std::uint32_t t_texture_size)
+{
+	// Random texels are the worst case for the sRGB encode, every channel lands on a different table entry
+	MipChain source = CreateMipChain(t_texture_size);
+	std::mt19937 generator(1234);
+
+	for (size_t index = 0; index < static_cast<size_t>(t_texture_size) * t_texture_size * 4; ++index)
+	{
+		source.texels[index] = static_cast<std::uint8_t>(generator() & 0xFF);
+	}
+
+	const MipFilter filters[] = { MipFilter::Box, MipFilter::Kaiser };
+	const MipKernel kernels[] = { MipKernel::Scalar, MipKernel::Sse2, MipKernel::Avx2 };
+
+	std::vector<std::uint32_t> thread_counts;
+	const std::uint32_t hardware_thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+
+	for (std::uint32_t thread_count = 1; thread_count < hardware_thread_count; thread_count *= 2)
+	{
+		thread_counts.push_back(thread_count);
+	}
+
+	thread_counts.push_back(hardware_thread_count);
+
+	// Only the source texels count, like the MP/s a texture tool reports
+	const double source_megapixels = static_cast<double>(t_texture_size) * t_texture_size / 1e6;
+
+	std::cout << "Mip chain of a " << t_texture_size << "x" << t_texture_size << " texture, " << source.levels.size() << " levels\n";
+
+	for (MipFilter filter : filters)
+	{
+		for (std::uint32_t srgb = 0; srgb < 2; ++srgb)
+		{
+			MipChain reference = CopyMipChain(source);
+
+			MipGeneratorSettings settings;
+			settings.filter = filter;
+			settings.srgb = srgb != 0;
+			settings.kernel = MipKernel::Scalar;
+
+			MipGenerator reference_generator;
+			reference_generator.GenerateChain(settings, reference.levels.data(), static_cast<std::uint32_t>(reference.levels.size()));
+
+			for (MipKernel kernel : kernels)
+			{
+				// Kernels the CPU cannot run fall back to a narrower one, which was measured already
+				if (ResolveMipKernel(kernel) != kernel)
+				{
+					continue;
+				}
+
+				settings.kernel = kernel;
+
+				for (std::uint32_t thread_count : thread_counts)
+				{
+					MipChain chain = CopyMipChain(source);
+
+					MipGenerator mip_generator;
+					mip_generator.Initialize(thread_count);
+
+					std::uint32_t chain_count = 0;
+					double seconds = 0.0;
+
+					auto start_time = std::chrono::high_resolution_clock::now();
+
+					while (seconds < MIN_MEASURE_SECONDS)
+					{
+						mip_generator.GenerateChain(settings, chain.levels.data(), static_cast<std::uint32_t>(chain.levels.size()));
+						++chain_count;
+
+						seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count();
+					}
+
+					mip_generator.Cleanup();
+
+					std::cout << GetMipFilterName(filter) << (settings.srgb ? " srgb " : " linear ") << GetMipKernelName(kernel) << " " << thread_count << " threads: ";
+					std::cout << source_megapixels * chain_count / seconds << " MP/s, ";
+					std::cout << seconds * 1000.0 / chain_count << " ms per chain, max difference to scalar " << CompareMips(chain, reference) << "\n";
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,433 @@
+#include "Benchmark/Benchmarks.hpp"
+
+#include "Utility/ResourceStateTracker.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+	using namespace tnt::utility;
+
+	// Same values as the D3D12_RESOURCE_STATES the renderer uses
+	const std::uint32_t STATE_COMMON = 0x0;
+	const std::uint32_t STATE_PRESENT = 0x0;
+	const std::uint32_t STATE_VERTEX_AND_CONSTANT_BUFFER = 0x1;
+	const std::uint32_t STATE_RENDER_TARGET = 0x4;
+	const std::uint32_t STATE_DEPTH_WRITE = 0x10;
+	const std::uint32_t STATE_PIXEL_SHADER_RESOURCE = 0x80;
+	const std::uint32_t STATE_COPY_DEST = 0x400;
+	const std::uint32_t READ_ONLY_STATES = 0xAC3 | 0x20;
+
+	const std::uint32_t TEXTURE_MIP_COUNT = 8;
+
+	// One in this many meshes gets new vertices every frame, as many textures stream in a mip
+	const std::uint32_t UPDATE_INTERVAL = 8;
+
+	enum class CommandType
+	{
+		Barrier,
+		Use
+	};
+
+	// A use carries the state it needs in state_after
+	struct Command
+	{
+		CommandType type;
+		StateTransition transition;
+	};
+
+	struct Scene
+	{
+		std::uint32_t back_buffer;
+		std::uint32_t shadow_map;
+		std::vector<std::uint32_t> vertex_buffers;
+		std::vector<std::uint32_t> textures;
+	};
+
+	struct FrameStats
+	{
+		std::uint64_t barrier_count;
+		std::uint64_t barrier_call_count;
+		std::uint64_t naive_barrier_count;
+		std::uint64_t failure_count;
+	};
+
+	// Plays the recorded commands back on its own copy of every state, the way the debug layer would
+	class SimulatedQueue
+	{
+	public:
+		void Add(std::uint32_t t_subresource_count, std::uint32_t t_state, bool t_is_promotable = false)
+		{
+			m_states.push_back(std::vector<std::uint32_t>(t_subresource_count, t_state));
+			m_split_states.push_back(std::vector<std::uint32_t>(t_subresource_count, UNKNOWN_RESOURCE_STATE));
+			m_promotable.push_back(t_is_promotable);
+		}
+
+		// Returns the number of commands that found a subresource in the wrong state
+		std::uint64_t Execute(const std::vector<Command>& t_commands)
+		{
+			std::uint64_t failure_count = 0;
+
+			for (const Command& command : t_commands)
+			{
+				const StateTransition& transition = command.transition;
+				std::vector<std::uint32_t>& states = m_states[transition.resource];
+				std::vector<std::uint32_t>& split_states = m_split_states[transition.resource];
+
+				const std::uint32_t first = (transition.subresource == ALL_SUBRESOURCES) ? 0 : transition.subresource;
+				const std::uint32_t last = (transition.subresource == ALL_SUBRESOURCES) ? static_cast<std::uint32_t>(states.size()) : transition.subresource + 1;
+
+				bool is_valid = true;
+
+				for (std::uint32_t subresource = first; subresource < last; ++subresource)
+				{
+					if (command.type == CommandType::Use)
+					{
+						// Only an access promotes, a barrier out of the common state has to say so
+						if (m_promotable[transition.resource] && states[subresource] == STATE_COMMON)
+						{
+							states[subresource] = transition.state_after;
+						}
+
+						is_valid &= split_states[subresource] == UNKNOWN_RESOURCE_STATE && IsCompatible(states[subresource], transition.state_after);
+						continue;
+					}
+
+					is_valid &= states[subresource] == transition.state_before;
+
+					if (transition.split == BarrierSplit::Begin)
+					{
+						is_valid &= split_states[subresource] == UNKNOWN_RESOURCE_STATE;
+						split_states[subresource] = transition.state_after;
+					}
+					else
+					{
+						is_valid &= split_states[subresource] == ((transition.split == BarrierSplit::End) ? transition.state_after : UNKNOWN_RESOURCE_STATE);
+						split_states[subresource] = UNKNOWN_RESOURCE_STATE;
+						states[subresource] = transition.state_after;
+					}
+				}
+
+				failure_count += is_valid ? 0 : 1;
+			}
+
+			return failure_count;
+		}
+
+		// End of an ExecuteCommandLists
+		void Decay()
+		{
+			for (std::uint32_t resource = 0; resource < m_states.size(); ++resource)
+			{
+				if (m_promotable[resource])
+				{
+					m_states[resource].assign(m_states[resource].size(), STATE_COMMON);
+				}
+			}
+		}
+
+		// Returns the number of subresources the registry disagrees about
+		std::uint64_t Compare(const ResourceStateRegistry& t_registry) const
+		{
+			std::uint64_t failure_count = 0;
+
+			for (std::uint32_t resource = 0; resource < m_states.size(); ++resource)
+			{
+				for (std::uint32_t subresource = 0; subresource < m_states[resource].size(); ++subresource)
+				{
+					failure_count += (t_registry.GetState(resource, subresource) == m_states[resource][subresource]) ? 0 : 1;
+				}
+			}
+
+			return failure_count;
+		}
+
+	private:
+		static bool IsCompatible(std::uint32_t t_state, std::uint32_t t_required_state)
+		{
+			if ((t_required_state & READ_ONLY_STATES) == t_required_state && t_required_state != 0)
+			{
+				return (t_state & t_required_state) == t_required_state && (t_state & ~READ_ONLY_STATES) == 0;
+			}
+
+			return t_state == t_required_state;
+		}
+
+	private:
+		std::vector<std::vector<std::uint32_t>> m_states;
+		std::vector<std::vector<std::uint32_t>> m_split_states;
+		std::vector<bool> m_promotable;
+	};
+
+	// Records one command list, validation is optional so the tracker can be timed on its own
+	class Recorder
+	{
+	public:
+		Recorder(ResourceStateTracker& t_tracker, FrameStats& t_stats, bool t_validate)
+			: m_tracker(t_tracker)
+			, m_stats(t_stats)
+			, m_validate(t_validate)
+		{
+			m_tracker.Reset();
+			m_commands.clear();
+		}
+
+		void Flush()
+		{
+			m_barriers.clear();
+			m_tracker.FlushBarriers(m_barriers);
+			Record(m_barriers);
+		}
+
+		void Finish()
+		{
+			m_barriers.clear();
+			m_tracker.FinishRecording(m_barriers);
+			Record(m_barriers);
+		}
+
+		const std::vector<Command>& GetCommands() const
+		{
+			return m_commands;
+		}
+
+		void Use(std::uint32_t t_resource, std::uint32_t t_state, std::uint32_t t_subresource = ALL_SUBRESOURCES)
+		{
+			if (m_validate)
+			{
+				m_commands.push_back({ CommandType::Use, { t_resource, t_subresource, t_state, t_state, BarrierSplit::None } });
+			}
+		}
+
+	private:
+		void Record(const std::vector<StateTransition>& t_barriers)
+		{
+			if (t_barriers.empty())
+			{
+				return;
+			}
+
+			// One ResourceBarrier call per batch
+			m_stats.barrier_count += t_barriers.size();
+			++m_stats.barrier_call_count;
+
+			if (m_validate)
+			{
+				for (const StateTransition& barrier : t_barriers)
+				{
+					m_commands.push_back({ CommandType::Barrier, barrier });
+				}
+			}
+		}
+
+	private:
+		ResourceStateTracker& m_tracker;
+		FrameStats& m_stats;
+		bool m_validate;
+		std::vector<Command> m_commands;
+		std::vector<StateTransition> m_barriers;
+	};
+
+	Scene CreateScene(ResourceStateRegistry& t_registry, SimulatedQueue& t_queue, std::uint32_t t_mesh_count)
+	{
+		Scene scene;
+
+		scene.back_buffer = t_registry.Register(1, STATE_PRESENT);
+		t_queue.Add(1, STATE_PRESENT);
+
+		scene.shadow_map = t_registry.Register(1, STATE_PIXEL_SHADER_RESOURCE);
+		t_queue.Add(1, STATE_PIXEL_SHADER_RESOURCE);
+
+		// Buffers are created in the common state and promoted by every list that uses them
+		for (std::uint32_t mesh = 0; mesh < t_mesh_count; ++mesh)
+		{
+			scene.vertex_buffers.push_back(t_registry.Register(1, STATE_COMMON, true));
+			t_queue.Add(1, STATE_COMMON, true);
+
+			scene.textures.push_back(t_registry.Register(TEXTURE_MIP_COUNT, STATE_PIXEL_SHADER_RESOURCE));
+			t_queue.Add(TEXTURE_MIP_COUNT, STATE_PIXEL_SHADER_RESOURCE);
+		}
+
+		return scene;
+	}
+
+	// An upload list and a draw list per frame, recorded on their own trackers and resolved in submission order
+	FrameStats SimulateFrames(std::uint32_t t_mesh_count, std::uint32_t t_frame_count, bool t_validate)
+	{
+		FrameStats stats = {};
+
+		ResourceStateRegistry registry;
+		SimulatedQueue queue;
+		const Scene scene = CreateScene(registry, queue, t_mesh_count);
+
+		ResourceStateTracker upload_tracker;
+		ResourceStateTracker draw_tracker;
+		upload_tracker.Initialize(&registry, READ_ONLY_STATES);
+		draw_tracker.Initialize(&registry, READ_ONLY_STATES);
+
+		std::mt19937 generator(1);
+		std::uniform_int_distribution<std::uint32_t> mesh_distribution(0, t_mesh_count - 1);
+		std::uniform_int_distribution<std::uint32_t> mip_distribution(0, TEXTURE_MIP_COUNT - 1);
+
+		std::vector<std::uint32_t> updated_meshes;
+		std::vector<std::uint32_t> updated_textures;
+		std::vector<std::uint32_t> updated_mips;
+		std::vector<StateTransition> fixups;
+
+		const std::uint32_t update_count = (t_mesh_count + UPDATE_INTERVAL - 1) / UPDATE_INTERVAL;
+
+		for (std::uint32_t frame = 0; frame < t_frame_count; ++frame)
+		{
+			updated_meshes.clear();
+			updated_textures.clear();
+			updated_mips.clear();
+
+			for (std::uint32_t update = 0; update < update_count; ++update)
+			{
+				updated_meshes.push_back(scene.vertex_buffers[mesh_distribution(generator)]);
+				updated_textures.push_back(scene.textures[mesh_distribution(generator)]);
+				updated_mips.push_back(mip_distribution(generator));
+			}
+
+			// Without the tracker every update is a barrier there and one back, each in its own call, and so are the back buffer and shadow map
+			stats.naive_barrier_count += 4 * update_count + 4;
+
+			Recorder upload_list(upload_tracker, stats, t_validate);
+
+			// Textures are requested in their draw state first, so the copy barriers are recorded in the list instead of in a fix up
+			// The vertex buffers are promoted to the copy destination state instead
+			for (std::uint32_t update = 0; update < update_count; ++update)
+			{
+				upload_tracker.Transition(updated_textures[update], STATE_PIXEL_SHADER_RESOURCE);
+			}
+
+			for (std::uint32_t update = 0; update < update_count; ++update)
+			{
+				upload_tracker.Transition(updated_meshes[update], STATE_COPY_DEST);
+				upload_tracker.Transition(updated_textures[update], STATE_COPY_DEST, updated_mips[update]);
+			}
+
+			upload_list.Flush();
+
+			for (std::uint32_t update = 0; update < update_count; ++update)
+			{
+				upload_list.Use(updated_meshes[update], STATE_COPY_DEST);
+				upload_list.Use(updated_textures[update], STATE_COPY_DEST, updated_mips[update]);
+			}
+
+			// The vertex buffers decay to the common state when the list has finished, the draw list promotes them again
+			for (std::uint32_t update = 0; update < update_count; ++update)
+			{
+				upload_tracker.Transition(updated_textures[update], STATE_PIXEL_SHADER_RESOURCE, updated_mips[update]);
+			}
+
+			upload_list.Finish();
+
+			Recorder draw_list(draw_tracker, stats, t_validate);
+
+			// Shadow pass
+			draw_tracker.Transition(scene.shadow_map, STATE_DEPTH_WRITE);
+
+			for (std::uint32_t vertex_buffer : scene.vertex_buffers)
+			{
+				draw_tracker.Transition(vertex_buffer, STATE_VERTEX_AND_CONSTANT_BUFFER);
+			}
+
+			draw_list.Flush();
+
+			for (std::uint32_t vertex_buffer : scene.vertex_buffers)
+			{
+				draw_list.Use(vertex_buffer, STATE_VERTEX_AND_CONSTANT_BUFFER);
+				draw_list.Use(scene.shadow_map, STATE_DEPTH_WRITE);
+			}
+
+			// The shadow map turns into a shader resource while the back buffer is cleared
+			draw_tracker.BeginTransition(scene.shadow_map, STATE_PIXEL_SHADER_RESOURCE);
+			draw_tracker.Transition(scene.back_buffer, STATE_RENDER_TARGET);
+			draw_list.Flush();
+			draw_list.Use(scene.back_buffer, STATE_RENDER_TARGET);
+
+			// Main pass
+			draw_tracker.Transition(scene.shadow_map, STATE_PIXEL_SHADER_RESOURCE);
+
+			for (std::uint32_t mesh = 0; mesh < t_mesh_count; ++mesh)
+			{
+				draw_tracker.Transition(scene.vertex_buffers[mesh], STATE_VERTEX_AND_CONSTANT_BUFFER);
+				draw_tracker.Transition(scene.textures[mesh], STATE_PIXEL_SHADER_RESOURCE);
+			}
+
+			draw_list.Flush();
+
+			for (std::uint32_t mesh = 0; mesh < t_mesh_count; ++mesh)
+			{
+				draw_list.Use(scene.vertex_buffers[mesh], STATE_VERTEX_AND_CONSTANT_BUFFER);
+				draw_list.Use(scene.textures[mesh], STATE_PIXEL_SHADER_RESOURCE);
+				draw_list.Use(scene.shadow_map, STATE_PIXEL_SHADER_RESOURCE);
+				draw_list.Use(scene.back_buffer, STATE_RENDER_TARGET);
+			}
+
+			draw_tracker.Transition(scene.back_buffer, STATE_PRESENT);
+			draw_list.Finish();
+
+			// Submission, each list is preceded by the barriers into the states it starts with
+			for (Recorder* list : { &upload_list, &draw_list })
+			{
+				ResourceStateTracker& tracker = (list == &upload_list) ? upload_tracker : draw_tracker;
+
+				fixups.clear();
+				tracker.Resolve(registry, fixups);
+
+				// The fix ups go into a list of their own, recorded with a single call
+				stats.barrier_count += fixups.size();
+				stats.barrier_call_count += fixups.empty() ? 0 : 1;
+
+				if (t_validate)
+				{
+					std::vector<Command> fixup_commands;
+
+					for (const StateTransition& fixup : fixups)
+					{
+						fixup_commands.push_back({ CommandType::Barrier, fixup });
+					}
+
+					stats.failure_count += queue.Execute(fixup_commands);
+					stats.failure_count += queue.Execute(list->GetCommands());
+					queue.Decay();
+				}
+
+				// Both lists go out in one ExecuteCommandLists
+				registry.DecayPromotedStates();
+			}
+		}
+
+		if (t_validate)
+		{
+			stats.failure_count += queue.Compare(registry);
+		}
+
+		return stats;
+	}
+}
+
+void tnt::benchmark::RunResourceStateBenchmark(std::uint32_t t_frame_count)
+{
+	const std::uint32_t mesh_counts[] = { 16, 64, 256, 1024, 4096 };
+
+	for (std::uint32_t mesh_count : mesh_counts)
+	{
+		const FrameStats stats = SimulateFrames(mesh_count, t_frame_count, true);
+
+		auto start_time = std::chrono::high_resolution_clock::now();
+		SimulateFrames(mesh_count, t_frame_count, false);
+		const double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count();
+
+		const double frame_count = static_cast<double>(t_frame_count);
+
+		std::cout << mesh_count << " meshes: naive " << stats.naive_barrier_count / frame_count << " barriers in as many calls per frame, ";
+		std::cout << "tracked " << stats.barrier_count / frame_count << " barriers in " << stats.barrier_call_count / frame_count << " calls per frame, ";
+		std::cout << seconds / t_frame_count * 1e6 << " us per frame, " << stats.failure_count << " state mismatches\n";
+	}
+}
@@ -0,0 +1,92 @@
+#include "Benchmark/Benchmarks.hpp"
+
+#include "Renderer/CPU/Sampler.hpp"
+#include "Renderer/CPU/Texture.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+	using namespace tnt::graphics::cpu;
+
+	void MeasureSampler(const char* t_pattern, const Texture& t_texture, const SamplerDesc& t_desc, const std::vector<Float2>& t_uvs, float t_lod)
+	{
+		Sampler sampler;
+		sampler.Initialize(t_desc);
+
+		// Summed so the compiler cannot drop the samples
+		Float4 sum = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+		auto start_time = std::chrono::high_resolution_clock::now();
+
+		for (const Float2& uv : t_uvs)
+		{
+			sum = sum + sampler.Sample(t_texture, uv, t_lod);
+		}
+
+		auto end_time = std::chrono::high_resolution_clock::now();
+		const double seconds = std::chrono::duration<double>(end_time - start_time).count();
+
+		const std::uint32_t taps_per_sample = (t_desc.filter == SamplerFilter::Point) ? 1 : (t_desc.filter == SamplerFilter::Bilinear) ? 4 : 8;
+		const double samples_per_second = t_uvs.size() / seconds;
+
+		std::cout << GetSamplerFilterName(t_desc.filter) << " " << t_pattern << ": " << samples_per_second / 1e6 << " Msamples/s, ";
+		std::cout << samples_per_second * taps_per_sample * 4.0 / 1e9 << " GB/s of texels (checksum " << sum.x + sum.y + sum.z + sum.w << ")\n";
+	}
+}
+
+void tnt::benchmark::RunSamplerBenchmark(std::uint32_t t_texture_size, std::uint32_t t_sample_count)
+{
+	// Random texels, so the mip chain is not trivially uniform
+	std::mt19937 generator(1234);
+	std::vector<std::uint8_t> texels(static_cast<size_t>(t_texture_size) * t_texture_size * 4);
+
+	for (std::uint8_t& texel : texels)
+	{
+		texel = static_cast<std::uint8_t>(generator() & 0xFF);
+	}
+
+	Texture texture;
+	texture.Initialize(t_texture_size, t_texture_size, texels.data());
+
+	// Coherent: rows of neighbouring pixels walking across the texture at roughly one texel per sample
+	std::vector<Float2> coherent_uvs(t_sample_count);
+	const float texel_size = 1.0f / static_cast<float>(t_texture_size);
+
+	for (std::uint32_t index = 0; index < t_sample_count; ++index)
+	{
+		const std::uint32_t x = index % t_texture_size;
+		const std::uint32_t y = (index / t_texture_size) % t_texture_size;
+
+		coherent_uvs[index] = { (x + 0.3f) * texel_size, (y + 0.6f) * texel_size };
+	}
+
+	std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+	std::vector<Float2> random_uvs(t_sample_count);
+
+	for (Float2& uv : random_uvs)
+	{
+		uv = { distribution(generator), distribution(generator) };
+	}
+
+	std::cout << t_texture_size << "x" << t_texture_size << " texture, " << texture.GetMipCount() << " mips, " << t_sample_count << " samples\n";
+
+	const SamplerFilter filters[] = { SamplerFilter::Point, SamplerFilter::Bilinear, SamplerFilter::Trilinear };
+
+	for (SamplerFilter filter : filters)
+	{
+		SamplerDesc desc;
+		desc.filter = filter;
+		desc.address_u = TextureAddressMode::Wrap;
+		desc.address_v = TextureAddressMode::Wrap;
+
+		// Trilinear sits between the two largest mips, the other filters read the top level
+		const float lod = (filter == SamplerFilter::Trilinear) ? 0.5f : 0.0f;
+
+		MeasureSampler("coherent", texture, desc, coherent_uvs, lod);
+		MeasureSampler("random", texture, desc, random_uvs, lod);
+	}
+}
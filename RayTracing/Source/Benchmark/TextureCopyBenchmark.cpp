@@ -0,0 +1,159 @@
+#include "Benchmark/Benchmarks.hpp"
+
+#include "Renderer/TextureFootprint.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+	using namespace tnt::graphics;
+
+	// Repeated until at least this long has passed, a single copy of a small texture is too short to time
+	const double MIN_MEASURE_SECONDS = 0.5;
+
+	// Upload heap allocations are at least placement aligned, the staging buffer is aligned the same way
+	std::uint8_t* AlignPointer(std::vector<std::uint8_t>& t_buffer)
+	{
+		const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(t_buffer.data());
+
+		return t_buffer.data() + (TEXTURE_PLACEMENT_ALIGNMENT - address % TEXTURE_PLACEMENT_ALIGNMENT) % TEXTURE_PLACEMENT_ALIGNMENT;
+	}
+
+	// Runs the task until the minimum time has passed, returns the seconds per run
+	template <typename Task>
+	double MeasureSeconds(const Task& t_task)
+	{
+		std::uint32_t run_count = 0;
+		double seconds = 0.0;
+
+		auto start_time = std::chrono::high_resolution_clock::now();
+
+		while (seconds < MIN_MEASURE_SECONDS)
+		{
+			t_task();
+			++run_count;
+
+			seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count();
+		}
+
+		return seconds / run_count;
+	}
+
+	// Alignment, ordering and size rules the copy engine relies on, returns the number of broken rules
+	std::uint32_t CheckFootprints(TextureFormat t_format, std::uint32_t t_width, std::uint32_t t_height, std::uint32_t t_array_size)
+	{
+		std::vector<SubresourceFootprint> footprints(GetFullMipCount(t_width, t_height) * t_array_size);
+		std::uint64_t total_size = 0;
+		const std::uint32_t mip_count = ComputeSubresourceFootprints(t_format, t_width, t_height, 0, t_array_size, footprints.data(), total_size);
+
+		const std::uint32_t block_size = GetFormatBlockSize(t_format);
+		std::uint32_t failure_count = 0;
+		std::uint64_t end = 0;
+
+		for (std::uint32_t slice = 0; slice < t_array_size; ++slice)
+		{
+			for (std::uint32_t mip = 0; mip < mip_count; ++mip)
+			{
+				const SubresourceFootprint& footprint = footprints[slice * mip_count + mip];
+				const std::uint32_t row_size = GetRowSize(t_format, footprint.width);
+
+				failure_count += (footprint.offset % TEXTURE_PLACEMENT_ALIGNMENT != 0) ? 1 : 0;
+				failure_count += (footprint.row_pitch % TEXTURE_ROW_PITCH_ALIGNMENT != 0 || footprint.row_pitch < row_size) ? 1 : 0;
+				failure_count += (footprint.offset < end) ? 1 : 0;
+				failure_count += (footprint.width != std::max(t_width >> mip, 1u) || footprint.height != std::max(t_height >> mip, 1u)) ? 1 : 0;
+				failure_count += (footprint.row_count != (footprint.height + block_size - 1) / block_size) ? 1 : 0;
+
+				end = footprint.offset + static_cast<std::uint64_t>(footprint.row_pitch) * (footprint.row_count - 1) + row_size;
+			}
+		}
+
+		failure_count += (end != total_size) ? 1 : 0;
+
+		return failure_count;
+	}
+}
+
+void tnt::benchmark::RunTextureCopyBenchmark(std::uint32_t t_texture_size)
+{
+	const TextureFormat formats[] = { TextureFormat::RGBA8, TextureFormat::BC1, TextureFormat::BC7 };
+	const std::uint32_t sizes[][2] = { { 1, 1 }, { 3, 5 }, { 64, 64 }, { 100, 37 }, { 1000, 1 }, { 4096, 2048 } };
+
+	std::uint32_t footprint_failure_count = 0;
+
+	for (TextureFormat format : formats)
+	{
+		for (const auto& size : sizes)
+		{
+			footprint_failure_count += CheckFootprints(format, size[0], size[1], 1);
+			footprint_failure_count += CheckFootprints(format, size[0], size[1], 6);
+		}
+	}
+
+	std::cout << "Footprint checks: " << footprint_failure_count << " failures\n";
+
+	// Sizes on both sides of STREAMING_COPY_MIN_SIZE, every second width has rows that are not a multiple of the pitch alignment
+	for (std::uint32_t size = std::min(256u, t_texture_size); size <= t_texture_size; size *= 2)
+	{
+		const std::uint32_t widths[] = { size, std::max(size - 20, 1u) };
+
+		for (std::uint32_t width : widths)
+		{
+			const std::uint32_t height = size;
+			const size_t source_row_pitch = static_cast<size_t>(width) * 4;
+
+			std::vector<std::uint8_t> source(source_row_pitch * height);
+			std::mt19937 generator(1234);
+
+			for (std::uint8_t& value : source)
+			{
+				value = static_cast<std::uint8_t>(generator() & 0xFF);
+			}
+
+			SubresourceFootprint footprint = {};
+			std::uint64_t staging_size = 0;
+			ComputeSubresourceFootprints(TextureFormat::RGBA8, width, height, 1, 1, &footprint, staging_size);
+
+			std::vector<std::uint8_t> reference_buffer(static_cast<size_t>(staging_size) + TEXTURE_PLACEMENT_ALIGNMENT, 0);
+			std::vector<std::uint8_t> streamed_buffer(static_cast<size_t>(staging_size) + TEXTURE_PLACEMENT_ALIGNMENT, 0);
+			std::vector<std::uint8_t> staging_buffer(static_cast<size_t>(staging_size) + TEXTURE_PLACEMENT_ALIGNMENT, 0);
+			std::uint8_t* reference = AlignPointer(reference_buffer);
+			std::uint8_t* streamed = AlignPointer(streamed_buffer);
+			std::uint8_t* staging = AlignPointer(staging_buffer);
+
+			// What the streamer did before, one memcpy per row
+			const double row_seconds = MeasureSeconds([&]()
+			{
+				for (std::uint32_t row = 0; row < footprint.row_count; ++row)
+				{
+					memcpy(reference + footprint.offset + row * footprint.row_pitch, source.data() + row * source_row_pitch, source_row_pitch);
+				}
+			});
+
+			// Streaming stores no matter the size
+			const double stream_seconds = MeasureSeconds([&]()
+			{
+				CopyRows(source.data(), source_row_pitch, streamed + footprint.offset, footprint.row_pitch, source_row_pitch, footprint.row_count, 0);
+			});
+
+			const double copy_seconds = MeasureSeconds([&]()
+			{
+				CopySubresource(TextureFormat::RGBA8, source.data(), source_row_pitch, footprint, staging);
+			});
+
+			const bool is_matching = memcmp(reference, staging, static_cast<size_t>(staging_size)) == 0 && memcmp(reference, streamed, static_cast<size_t>(staging_size)) == 0;
+			const bool is_streamed = source.size() >= STREAMING_COPY_MIN_SIZE;
+			const double gigabytes = static_cast<double>(source.size()) / 1e9;
+
+			std::cout << width << "x" << height << " RGBA8, row pitch " << footprint.row_pitch << ": ";
+			std::cout << "memcpy per row " << gigabytes / row_seconds << " GB/s, ";
+			std::cout << "streaming stores " << gigabytes / stream_seconds << " GB/s, ";
+			std::cout << "CopyRows " << gigabytes / copy_seconds << " GB/s (" << (is_streamed ? "streamed" : "memcpy") << "), ";
+			std::cout << (is_matching ? "identical" : "MISMATCH") << "\n";
+		}
+	}
+}
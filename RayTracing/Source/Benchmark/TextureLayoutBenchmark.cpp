@@ -0,0 +1,129 @@
+#include "Benchmark/Benchmarks.hpp"
+
+#include "Renderer/CPU/Sampler.hpp"
+#include "Renderer/CPU/Texture.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+	using namespace tnt::graphics::cpu;
+
+	double MeasureSamples(const Texture& t_texture, SamplerFilter t_filter, const std::vector<Float2>& t_uvs, float& t_checksum)
+	{
+		SamplerDesc desc;
+		desc.filter = t_filter;
+		desc.address_u = TextureAddressMode::Wrap;
+		desc.address_v = TextureAddressMode::Wrap;
+
+		Sampler sampler;
+		sampler.Initialize(desc);
+
+		// Summed so the compiler cannot drop the samples
+		Float4 sum = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+		auto start_time = std::chrono::high_resolution_clock::now();
+
+		for (const Float2& uv : t_uvs)
+		{
+			sum = sum + sampler.Sample(t_texture, uv, 0.0f);
+		}
+
+		auto end_time = std::chrono::high_resolution_clock::now();
+
+		t_checksum = sum.x + sum.y + sum.z + sum.w;
+
+		return t_uvs.size() / std::chrono::duration<double>(end_time - start_time).count();
+	}
+}
+
+void tnt::benchmark::RunTextureLayoutBenchmark(std::uint32_t t_texture_size, std::uint32_t t_sample_count)
+{
+	std::mt19937 generator(1234);
+	std::vector<std::uint8_t> texels(static_cast<size_t>(t_texture_size) * t_texture_size * 4);
+
+	for (std::uint8_t& texel : texels)
+	{
+		texel = static_cast<std::uint8_t>(generator() & 0xFF);
+	}
+
+	std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+	const float texel_size = 1.0f / static_cast<float>(t_texture_size);
+
+	// Random coordinates over the whole texture, every sample misses the cache whatever the layout
+	std::vector<Float2> random_uvs(t_sample_count);
+
+	for (Float2& uv : random_uvs)
+	{
+		uv = { distribution(generator), distribution(generator) };
+	}
+
+	// Groups of 64 random coordinates inside a 32x32 texel window, like incoherent rays hitting one surface patch
+	std::vector<Float2> clustered_uvs(t_sample_count);
+	Float2 window = {};
+
+	for (std::uint32_t index = 0; index < t_sample_count; ++index)
+	{
+		if (index % 64 == 0)
+		{
+			window = { distribution(generator), distribution(generator) };
+		}
+
+		clustered_uvs[index] = { window.x + distribution(generator) * 32.0f * texel_size, window.y + distribution(generator) * 32.0f * texel_size };
+	}
+
+	// Columns walking down the texture, the worst case for the row major layout
+	std::vector<Float2> column_uvs(t_sample_count);
+
+	for (std::uint32_t index = 0; index < t_sample_count; ++index)
+	{
+		const std::uint32_t x = (index / t_texture_size) % t_texture_size;
+		const std::uint32_t y = index % t_texture_size;
+
+		column_uvs[index] = { (x + 0.3f) * texel_size, (y + 0.6f) * texel_size };
+	}
+
+	struct Pattern
+	{
+		const char* name;
+		const std::vector<Float2>* uvs;
+	};
+
+	const Pattern patterns[] = { { "random", &random_uvs }, { "clustered", &clustered_uvs }, { "column", &column_uvs } };
+
+	std::cout << t_texture_size << "x" << t_texture_size << " texture, " << t_sample_count << " samples, Msamples/s\n";
+
+	const TextureLayout layouts[] = { TextureLayout::Linear, TextureLayout::Tiled, TextureLayout::Morton };
+	const SamplerFilter filters[] = { SamplerFilter::Point, SamplerFilter::Bilinear };
+
+	for (TextureLayout layout : layouts)
+	{
+		// A single mip, so only the conversion from the row major source is timed
+		Texture texture;
+
+		auto start_time = std::chrono::high_resolution_clock::now();
+		texture.Initialize(t_texture_size, t_texture_size, texels.data(), 1, layout);
+		auto end_time = std::chrono::high_resolution_clock::now();
+
+		const double conversion_seconds = std::chrono::duration<double>(end_time - start_time).count();
+
+		std::cout << GetTextureLayoutName(layout) << ": conversion " << texels.size() / conversion_seconds / 1e9 << " GB/s";
+
+		float checksum = 0.0f;
+
+		for (SamplerFilter filter : filters)
+		{
+			std::cout << ", " << GetSamplerFilterName(filter);
+
+			for (const Pattern& pattern : patterns)
+			{
+				std::cout << " " << pattern.name << " " << MeasureSamples(texture, filter, *pattern.uvs, checksum) / 1e6;
+			}
+		}
+
+		std::cout << " (checksum " << checksum << ")\n";
+	}
+}
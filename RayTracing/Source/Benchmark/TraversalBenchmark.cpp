@@ -0,0 +1,81 @@
+#include "Benchmark/Benchmarks.hpp"
+
+#include "Renderer/CPU/Bvh.hpp"
+#include "Renderer/CPU/WideBvh.hpp"
+#include "Renderer/SceneData.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+	using namespace tnt::graphics::cpu;
+
+	template<typename Accelerator>
+	void MeasureThroughput(const char* t_name, const Accelerator& t_accelerator, const std::vector<Ray>& t_rays)
+	{
+		std::uint64_t hit_count = 0;
+
+		auto start_time = std::chrono::high_resolution_clock::now();
+
+		for (const Ray& ray : t_rays)
+		{
+			Hit hit = CreateEmptyHit();
+
+			if (t_accelerator.Intersect(ray, hit))
+			{
+				++hit_count;
+			}
+		}
+
+		auto end_time = std::chrono::high_resolution_clock::now();
+		const double seconds = std::chrono::duration<double>(end_time - start_time).count();
+
+		std::cout << t_name << ": " << (t_rays.size() / seconds) / 1e6 << " Mrays/s (" << hit_count << " hits)\n";
+	}
+}
+
+void tnt::benchmark::RunTraversalBenchmark(std::uint32_t t_tessellation, std::uint32_t t_ray_count)
+{
+	const std::vector<graphics::Vertex> vertices = graphics::CreateTessellatedTriangleScene(t_tessellation);
+
+	BvhBuildSettings settings;
+	Bvh bvh;
+	bvh.Build(vertices, settings);
+
+	WideBvh<4> wide_bvh_4;
+	wide_bvh_4.Build(bvh);
+
+	WideBvh<8> wide_bvh_8;
+	wide_bvh_8.Build(bvh);
+
+	// Fixed seed, every run traces the same rays
+	std::mt19937 generator(1234);
+	std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+	std::vector<Ray> rays(t_ray_count);
+
+	for (Ray& ray : rays)
+	{
+		const Float3 origin = { distribution(generator), distribution(generator), -1.0f };
+		const Float3 target = { distribution(generator) * 0.6f, distribution(generator) * 0.6f, 0.0f };
+
+		ray = { origin, target - origin, 0.0f, std::numeric_limits<float>::infinity() };
+	}
+
+	std::cout << bvh.GetBuildStatistics().triangle_count << " triangles, " << t_ray_count << " incoherent rays\n";
+
+	MeasureThroughput(GetTraversalKernelName(TraversalKernel::Binary), bvh, rays);
+
+	if (ResolveTraversalKernel(TraversalKernel::Wide4Sse) == TraversalKernel::Wide4Sse)
+	{
+		MeasureThroughput(GetTraversalKernelName(TraversalKernel::Wide4Sse), wide_bvh_4, rays);
+	}
+
+	if (ResolveTraversalKernel(TraversalKernel::Wide8Avx2) == TraversalKernel::Wide8Avx2)
+	{
+		MeasureThroughput(GetTraversalKernelName(TraversalKernel::Wide8Avx2), wide_bvh_8, rays);
+	}
+}
@@ -0,0 +1,138 @@
+#include "Benchmark/Benchmarks.hpp"
+
+#include "Utility/RingAllocator.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+	const std::uint32_t FRAMES_IN_FLIGHT = 3;
+	const std::uint64_t CONSTANT_BUFFER_ALIGNMENT = 256;
+
+	// Stands in for ID3D12Fence, the simulated GPU finishes frames in order but at a random pace
+	class FakeFence
+	{
+	public:
+		FakeFence()
+			: m_completed_value(0)
+		{
+		}
+
+		std::uint64_t GetCompletedValue() const
+		{
+			return m_completed_value;
+		}
+
+		// Returns once the GPU reached at least t_value, possibly finishing more frames on the way
+		void WaitFor(std::uint64_t t_value, std::uint64_t t_submitted_value, std::mt19937& t_generator)
+		{
+			if (m_completed_value < t_value)
+			{
+				m_completed_value = t_value;
+			}
+
+			if (m_completed_value < t_submitted_value && (t_generator() & 1) != 0)
+			{
+				m_completed_value += t_generator() % (t_submitted_value - m_completed_value + 1);
+			}
+		}
+
+	private:
+		std::uint64_t m_completed_value;
+	};
+
+	// Same frame loop as Main.cpp: record with the ring, signal, wait for the frame that reuses the back buffer, retire
+	// With t_owners set, every byte remembers the fence value of the frame that wrote it
+	std::uint64_t SimulateFrames(
+		tnt::utility::RingAllocator& t_allocator,
+		std::uint32_t t_frame_count,
+		std::uint32_t t_allocations_per_frame,
+		std::vector<std::uint64_t>* t_owners)
+	{
+		std::mt19937 generator(1234);
+		std::uniform_int_distribution<std::uint64_t> size_distribution(16, 4096);
+
+		FakeFence fence;
+		std::uint64_t fence_values[FRAMES_IN_FLIGHT] = { 1, 0, 0 };
+		std::uint32_t frame_index = 0;
+		std::uint64_t allocation_count = 0;
+
+		for (std::uint32_t frame = 0; frame < t_frame_count; ++frame)
+		{
+			const std::uint64_t frame_fence_value = fence_values[frame_index];
+
+			for (std::uint32_t allocation = 0; allocation < t_allocations_per_frame; ++allocation)
+			{
+				const std::uint64_t size = size_distribution(generator);
+				const std::uint64_t offset = t_allocator.Allocate(size, CONSTANT_BUFFER_ALIGNMENT);
+
+				if (offset == tnt::utility::INVALID_RING_OFFSET)
+				{
+					throw std::runtime_error("Upload ring ran out of space");
+				}
+
+				if (offset % CONSTANT_BUFFER_ALIGNMENT != 0 || offset + size > t_allocator.GetCapacity())
+				{
+					throw std::runtime_error("Upload ring returned a misplaced allocation");
+				}
+
+				if (t_owners != nullptr)
+				{
+					for (std::uint64_t byte = offset; byte < offset + size; ++byte)
+					{
+						// Zero is never written, any other owner has to be a frame the GPU is done with
+						const std::uint64_t owner = (*t_owners)[byte];
+
+						if (owner != 0 && (owner == frame_fence_value || owner > fence.GetCompletedValue()))
+						{
+							throw std::runtime_error("Upload ring handed out memory that is still in use");
+						}
+
+						(*t_owners)[byte] = frame_fence_value;
+					}
+				}
+
+				++allocation_count;
+			}
+
+			t_allocator.FinishFrame(frame_fence_value);
+
+			frame_index = (frame_index + 1) % FRAMES_IN_FLIGHT;
+			fence.WaitFor(fence_values[frame_index], frame_fence_value, generator);
+			t_allocator.Retire(fence.GetCompletedValue());
+
+			fence_values[frame_index] = frame_fence_value + 1;
+		}
+
+		return allocation_count;
+	}
+}
+
+void tnt::benchmark::RunUploadRingBenchmark(std::uint32_t t_frame_count, std::uint32_t t_allocations_per_frame)
+{
+	// Room for every frame in flight at the largest allocation size plus alignment padding
+	const std::uint64_t capacity = static_cast<std::uint64_t>(FRAMES_IN_FLIGHT + 1) * t_allocations_per_frame * (4096 + CONSTANT_BUFFER_ALIGNMENT);
+
+	tnt::utility::RingAllocator allocator;
+	std::vector<std::uint64_t> owners(capacity, 0);
+
+	allocator.Initialize(capacity);
+	SimulateFrames(allocator, t_frame_count, t_allocations_per_frame, &owners);
+
+	std::cout << "Validated " << t_frame_count << " frames of " << t_allocations_per_frame << " allocations against a fake fence, ";
+	std::cout << capacity / 1024 << " KB ring, " << allocator.GetFrameCount() << " frames still in flight\n";
+
+	allocator.Initialize(capacity);
+
+	auto start_time = std::chrono::high_resolution_clock::now();
+	const std::uint64_t allocation_count = SimulateFrames(allocator, t_frame_count, t_allocations_per_frame, nullptr);
+	auto end_time = std::chrono::high_resolution_clock::now();
+
+	const double seconds = std::chrono::duration<double>(end_time - start_time).count();
+
+	std::cout << "Allocations / second: " << allocation_count / seconds / 1e6 << " M (" << seconds * 1e9 / allocation_count << " ns each)\n";
+}
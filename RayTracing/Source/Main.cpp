@@ -1,8 +1,5 @@
 #include <Windows.h>
 
-// Image loading
-#include <stb_image.h>
-
 // DX12
 #include <d3d12.h>
 #include <dxgi1_4.h>
@@ -15,6 +12,13 @@ using namespace DirectX;
 #include "Wrapper/DX12/Device.hpp"
 #include "Wrapper/DX12/SwapChain.hpp"
 #include "Wrapper/DX12/DescriptorHeap.hpp"
+#include "Wrapper/DX12/BindlessTable.hpp"
+#include "Wrapper/DX12/UploadRing.hpp"
+#include "Wrapper/DX12/HeapAllocator.hpp"
+#include "Wrapper/DX12/CommandListStateTracker.hpp"
+#include "Wrapper/DX12/MeshBufferManager.hpp"
+#include "Wrapper/DX12/TextureStreamer.hpp"
+#include "Wrapper/DX12/FrameSynchronizer.hpp"
 
 // Need the ComPtr<t> for this application
 #include <wrl.h>
@@ -24,37 +28,84 @@ using namespace Microsoft::WRL;
 #include <d3dx12.h>
 
 #include "Utility/CheckHResult.hpp"
+#include "Utility/FixedTimestep.hpp"
 
-struct Vertex
-{
-	XMFLOAT4 position;
-	XMFLOAT2 texcoord;
-};
+// Scene shared with the CPU renderer
+#include "Renderer/SceneData.hpp"
+#include "Renderer/TextureCache.hpp"
+#include "Application/CommandLine.hpp"
 
-struct SceneConstantBufferData
-{
-	XMFLOAT2 positionOffset;
-};
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using tnt::graphics::Vertex;
+using tnt::graphics::SceneConstantBufferData;
 
 SceneConstantBufferData constantBufferData;
 
 HWND window_handle = nullptr;
 
 const UINT BACK_BUFFER_COUNT = 3;
-const UINT WINDOW_WIDTH = 1280;
-const UINT WINDOW_HEIGHT = 720;
+const UINT WINDOW_WIDTH = tnt::application::FRAME_WIDTH;
+const UINT WINDOW_HEIGHT = tnt::application::FRAME_HEIGHT;
+
+// Frames the CPU may queue ahead of the GPU, independent of the back buffer count, --frames-in-flight picks one up to this
+// 16 is the highest frame latency DXGI accepts
+const UINT MAX_FRAMES_IN_FLIGHT = 16;
+
+// Present accepts sync intervals up to this
+const UINT MAX_SYNC_INTERVAL = 4;
+
+// Frames kept for --frame-timeline
+const UINT FRAME_TIMELINE_LENGTH = 1024;
+
+// Holds the per draw constants of every frame in flight
+const UINT64 UPLOAD_RING_SIZE = 1024 * 1024;
+
+// Placed resources are suballocated from heaps of this size, larger resources get a heap of their own
+const UINT64 RESOURCE_HEAP_SIZE = 16 * 1024 * 1024;
+
+// Vertices and indices of every mesh share two default heap buffers, uploads are staged through a ring of their own
+const UINT64 MESH_VERTEX_BUFFER_SIZE = 4 * 1024 * 1024;
+const UINT64 MESH_INDEX_BUFFER_SIZE = 2 * 1024 * 1024;
+const UINT64 MESH_STAGING_RING_SIZE = 2 * 1024 * 1024;
+
+// Shader visible descriptors, most of them make up the bindless texture table
+const UINT CBV_SRV_UAV_DESCRIPTOR_COUNT = 65536;
+const UINT BINDLESS_TEXTURE_COUNT = 16384;
+
+// Resource binding tier 1 allows no more shader resource views than this per shader stage
+const UINT TIER_1_BINDLESS_TEXTURE_COUNT = 128;
+
+// Views are created in CPU memory and copied into the shader visible heap, writing the shader visible heap directly is slow
+const UINT STAGING_DESCRIPTOR_COUNT = 65536;
+
+// Staging memory for the copy queue, a texture has to fit in it as a whole
+const UINT64 TEXTURE_STREAMING_RING_SIZE = 32 * 1024 * 1024;
 
 const FLOAT BACK_BUFFER_CLEAR_COLOR[] = { 0.392f, 0.584f, 0.929f, 0.0f };
 
-UINT frameIndex = 0;
-UINT rtvDescriptorSize = 0;
-UINT cbvSrvDescriptorSize = 0;
+UINT backBufferIndex = 0;
 
-UINT8* p_cbvDataBegin = nullptr;
+// Frame pacing options of the window, set from the command line
+UINT framesInFlight = 2;
+UINT presentSyncInterval = 1;
+std::string frameTimelinePath;
 
-UINT64 fenceValues[BACK_BUFFER_COUNT] = {};
+// Waits for frame slots and the swap chain, and hands out the fence values of the rings
+tnt::wrapper::dx12::FrameSynchronizer frameSync;
 
-HANDLE fenceEvent = nullptr;
+// The last two simulation steps, constantBufferData is blended from them every frame
+tnt::utility::FixedTimestep simulationTimestep;
+SceneConstantBufferData previousSceneData = {};
+SceneConstantBufferData currentSceneData = {};
+std::chrono::steady_clock::time_point simulationStartTime;
 
 // DX12 objects
 IDXGISwapChain3* swap_chain_pointer = nullptr;
@@ -62,91 +113,152 @@ IDXGISwapChain3* swap_chain_pointer = nullptr;
 CD3DX12_VIEWPORT viewport(0.0f, 0.0f, static_cast<FLOAT>(WINDOW_WIDTH), static_cast<FLOAT>(WINDOW_HEIGHT));
 CD3DX12_RECT scissorRect(0, 0, static_cast<LONG>(WINDOW_WIDTH), static_cast<LONG>(WINDOW_HEIGHT));
 
-D3D12_VERTEX_BUFFER_VIEW vertexBufferView = {};
-
 tnt::wrapper::dx12::DescriptorHeap rtvHeap;
 tnt::wrapper::dx12::DescriptorHeap cbvSrvHeap;
+tnt::wrapper::dx12::DescriptorHeap stagingSrvHeap;
+tnt::wrapper::dx12::DescriptorAllocation renderTargetDescriptors = {};
+
+// Textures are sampled through a single table, a null texture is sampled until the streamed texture is resident
+tnt::wrapper::dx12::BindlessTable bindlessTextures;
+tnt::wrapper::dx12::BindlessHandle sceneTexture = tnt::wrapper::dx12::INVALID_BINDLESS_HANDLE;
+tnt::wrapper::dx12::UploadRing uploadRing;
+
+// Declared before the resources so the heaps outlive the resources placed in them
+tnt::wrapper::dx12::HeapAllocator bufferHeapAllocator;
+tnt::wrapper::dx12::HeapAllocator textureHeapAllocator;
 
 ComPtr<ID3D12Resource> renderTargets[BACK_BUFFER_COUNT];
+UINT renderTargetIds[BACK_BUFFER_COUNT] = {};
 ComPtr<ID3D12CommandQueue> graphicsCommandQueue;
-ComPtr<ID3D12CommandAllocator> graphicsCommandAllocators[BACK_BUFFER_COUNT];
+ComPtr<ID3D12CommandAllocator> graphicsCommandAllocators[MAX_FRAMES_IN_FLIGHT];
 ComPtr<ID3D12CommandAllocator> bundleCommandAllocator;
 ComPtr<ID3D12GraphicsCommandList> graphicsCommandList;
 ComPtr<ID3D12GraphicsCommandList> bundleCommandList;
-ComPtr<ID3D12Fence> fence;
+ComPtr<ID3D12GraphicsCommandList> fixupCommandList;
 ComPtr<ID3D12PipelineState> graphicsPipelineStateObject;
 ComPtr<ID3D12RootSignature> rootSignature;
-ComPtr<ID3D12Resource> vertexBuffer;
-ComPtr<ID3D12Resource> texture;
-ComPtr<ID3D12Resource> constantBuffer;
 
-void WaitForGPU()
+// The streamed texture and its place in the texture heap, both go back to the allocator before it is destroyed
+struct PlacedTexture
+{
+	ComPtr<ID3D12Resource> resource;
+	tnt::wrapper::dx12::HeapAllocation allocation;
+	UINT64 fenceValue;	// Zero until the frame that last used it has been submitted
+};
+
+PlacedTexture texture = {};
+
+// Replaced textures may still be sampled by frames in flight
+std::deque<PlacedTexture> retiredTextures;
+
+// Barriers of the graphics command list are derived from the states it requests
+tnt::wrapper::dx12::TrackedResources trackedResources;
+tnt::wrapper::dx12::CommandListStateTracker graphicsStateTracker;
+
+// Holds the placed vertex and index buffers, so it is declared after the heap allocators
+tnt::wrapper::dx12::MeshBufferManager meshBuffers;
+tnt::wrapper::dx12::MeshHandle sceneMesh = tnt::wrapper::dx12::INVALID_MESH_HANDLE;
+
+// Holds placed textures until their copy completes, so it is declared after the heap allocators as well
+tnt::graphics::TextureCache textureCache;
+tnt::wrapper::dx12::TextureStreamer textureStreamer;
+
+void ReleaseTexture(PlacedTexture& t_texture)
 {
-	// Schedule a signal in the queue
-	ThrowIfFailed(graphicsCommandQueue->Signal(fence.Get(), fenceValues[frameIndex]));
+	if (t_texture.resource)
+	{
+		t_texture.resource.Reset();
+		textureHeapAllocator.Free(t_texture.allocation);
+	}
+}
+
+// Barriers into the states the list starts with go into a small list of their own, submitted right before it
+void ExecuteGraphicsCommandList()
+{
+	ThrowIfFailed(fixupCommandList->Reset(graphicsCommandAllocators[frameSync.GetFrameSlot()].Get(), nullptr));
+	const bool hasFixups = graphicsStateTracker.Resolve(fixupCommandList.Get());
+	ThrowIfFailed(fixupCommandList->Close());
 
-	// Wait until the fence has been processed
-	ThrowIfFailed(fence->SetEventOnCompletion(fenceValues[frameIndex], fenceEvent));
-	WaitForSingleObjectEx(fenceEvent, INFINITE, FALSE);
+	ID3D12CommandList* ppCommandLists[] = { fixupCommandList.Get(), graphicsCommandList.Get() };
+	graphicsCommandQueue->ExecuteCommandLists(hasFixups ? 2 : 1, hasFixups ? ppCommandLists : ppCommandLists + 1);
 
-	++fenceValues[frameIndex];
+	// The mesh buffers are back in the common state for the next list
+	trackedResources.DecayPromotedStates();
 }
 
-void PrepareNextFrame()
+// Only waits when the frame that last used this slot is still queued, or when the swap chain already holds enough frames
+void WaitForFrameSlot()
 {
-	// Schedule a command in the queue
-	const UINT64 currentFenceValue = fenceValues[frameIndex];
-	ThrowIfFailed(graphicsCommandQueue->Signal(fence.Get(), currentFenceValue));
+	frameSync.BeginFrame();
+
+	const UINT64 completedFenceValue = frameSync.GetCompletedValue();
+	uploadRing.Retire(completedFenceValue);
+	meshBuffers.Retire(completedFenceValue);
+	bindlessTextures.Retire(completedFenceValue);
+
+	while (!retiredTextures.empty() && retiredTextures.front().fenceValue != 0 && retiredTextures.front().fenceValue <= completedFenceValue)
+	{
+		ReleaseTexture(retiredTextures.front());
+		retiredTextures.pop_front();
+	}
+}
 
-	frameIndex = swap_chain_pointer->GetCurrentBackBufferIndex();
+void PrepareNextFrame()
+{
+	// Upload memory of this frame is reused once the GPU reaches the signal
+	const UINT64 fenceValue = frameSync.EndFrame();
+	uploadRing.FinishFrame(fenceValue);
+	meshBuffers.FinishFrame(fenceValue);
+	bindlessTextures.FinishFrame(fenceValue);
 
-	// If the next frame is not ready to b erendered yet, wait for it
-	if (fence->GetCompletedValue() < fenceValues[frameIndex])
+	for (PlacedTexture& retiredTexture : retiredTextures)
 	{
-		ThrowIfFailed(fence->SetEventOnCompletion(fenceValues[frameIndex], fenceEvent));
-		WaitForSingleObjectEx(fenceEvent, INFINITE, FALSE);
+		if (retiredTexture.fenceValue == 0)
+		{
+			retiredTexture.fenceValue = fenceValue;
+		}
 	}
 
-	// Set the fence value for the next frame
-	fenceValues[frameIndex] = currentFenceValue + 1;
+	backBufferIndex = swap_chain_pointer->GetCurrentBackBufferIndex();
 }
 
 void PopulateCommandList()
 {
 	// This can only happen when the associated command lists have finished execution on the GPU
-	ThrowIfFailed(graphicsCommandAllocators[frameIndex]->Reset());
+	ThrowIfFailed(graphicsCommandAllocators[frameSync.GetFrameSlot()]->Reset());
 
 	// Command lists can be reset at any time as long as execute has been called on it
-	ThrowIfFailed(graphicsCommandList->Reset(graphicsCommandAllocators[frameIndex].Get(), graphicsPipelineStateObject.Get()));
+	ThrowIfFailed(graphicsCommandList->Reset(graphicsCommandAllocators[frameSync.GetFrameSlot()].Get(), graphicsPipelineStateObject.Get()));
+	graphicsStateTracker.Reset();
 
 	// All descriptor heaps needed for the graphics command list
 	ID3D12DescriptorHeap* ppDescriptorheaps[] = { cbvSrvHeap.GetDescriptorHeapPointer() };
 
-	CD3DX12_GPU_DESCRIPTOR_HANDLE cbvSrvHeapHandle(cbvSrvHeap.GetDescriptorHeapPointer()->GetGPUDescriptorHandleForHeapStart());
-
 	// Set the correct states
 	graphicsCommandList->SetGraphicsRootSignature(rootSignature.Get());
 	graphicsCommandList->SetDescriptorHeaps(_countof(ppDescriptorheaps), ppDescriptorheaps);
-	graphicsCommandList->SetGraphicsRootDescriptorTable(0, cbvSrvHeapHandle);
+	graphicsCommandList->SetGraphicsRootDescriptorTable(0, bindlessTextures.GetGpuHandle());
+	graphicsCommandList->SetGraphicsRoot32BitConstant(2, bindlessTextures.GetIndex(sceneTexture), 0);
 
-	cbvSrvHeapHandle.Offset(1, cbvSrvDescriptorSize);
+	// Every frame gets its own copy of the constants, earlier frames may still be reading theirs
+	tnt::wrapper::dx12::UploadAllocation constants = uploadRing.Allocate(sizeof(constantBufferData));
+	memcpy(constants.cpu_address, &constantBufferData, sizeof(constantBufferData));
 
-	graphicsCommandList->SetGraphicsRootDescriptorTable(1, cbvSrvHeapHandle);
+	graphicsCommandList->SetGraphicsRootConstantBufferView(1, constants.gpu_address);
 	graphicsCommandList->RSSetViewports(1, &viewport);
 	graphicsCommandList->RSSetScissorRects(1, &scissorRect);
 
-	// Indicate that the back buffer will be used as a render target
-	graphicsCommandList->ResourceBarrier(
-		1,
-		&CD3DX12_RESOURCE_BARRIER::Transition(
-			renderTargets[frameIndex].Get(),
-			D3D12_RESOURCE_STATE_PRESENT,
-			D3D12_RESOURCE_STATE_RENDER_TARGET
-		)
-	);
+	// The back buffer is requested in the present state first, so its barrier is recorded here instead of in a fix up list
+	graphicsStateTracker.Transition(renderTargetIds[backBufferIndex], D3D12_RESOURCE_STATE_PRESENT);
+	graphicsStateTracker.Transition(renderTargetIds[backBufferIndex], D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+	// Mesh copies have to land before the draws that read them, their barriers go out together with the one of the back buffer
+	meshBuffers.RecordUploads(graphicsCommandList.Get(), graphicsStateTracker);
+	meshBuffers.PrepareForDraw(graphicsStateTracker);
+	graphicsStateTracker.FlushBarriers(graphicsCommandList.Get());
 
 	// Handle to the current back buffer of the swap chain
-	CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle(rtvHeap.GetDescriptorHeapPointer()->GetCPUDescriptorHandleForHeapStart(), frameIndex, rtvDescriptorSize);
+	D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = rtvHeap.GetCpuHandle(renderTargetDescriptors, backBufferIndex);
 
 	// Set the current back buffer as the render target
 	graphicsCommandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
@@ -154,18 +266,15 @@ void PopulateCommandList()
 	// Record commands
 	graphicsCommandList->ClearRenderTargetView(rtvHandle, BACK_BUFFER_CLEAR_COLOR, 0, nullptr);
 
-	// Execute commands stored in the bundle
-	graphicsCommandList->ExecuteBundle(bundleCommandList.Get());
+	// Execute commands stored in the bundle, the frames before the scene mesh is resident only show the clear color
+	if (meshBuffers.IsResident(sceneMesh))
+	{
+		graphicsCommandList->ExecuteBundle(bundleCommandList.Get());
+	}
 
 	// Indicate that the back buffer will now be used to present
-	graphicsCommandList->ResourceBarrier(
-		1,
-		&CD3DX12_RESOURCE_BARRIER::Transition(
-			renderTargets[frameIndex].Get(),
-			D3D12_RESOURCE_STATE_RENDER_TARGET,
-			D3D12_RESOURCE_STATE_PRESENT
-		)
-	);
+	graphicsStateTracker.Transition(renderTargetIds[backBufferIndex], D3D12_RESOURCE_STATE_PRESENT);
+	graphicsStateTracker.FinishRecording(graphicsCommandList.Get());
 
 	// Done recording commands
 	ThrowIfFailed(graphicsCommandList->Close());
@@ -210,10 +319,16 @@ void Initialize()
 			WINDOW_HEIGHT, 
 			sampler_desc,
 			FALSE,
-			BACK_BUFFER_COUNT);
+			BACK_BUFFER_COUNT,
+			DXGI_FORMAT_R8G8B8A8_UNORM,
+			DXGI_SWAP_EFFECT_FLIP_DISCARD,
+			DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT);
 
 		swap_chain_pointer = swap_chain.GetSwapChainPointer();
-		frameIndex = swap_chain_pointer->GetCurrentBackBufferIndex();
+		backBufferIndex = swap_chain_pointer->GetCurrentBackBufferIndex();
+
+		// The setup command list below is recorded into the allocator of the first frame slot
+		frameSync.Initialize(device_pointer, graphicsCommandQueue.Get(), swap_chain_pointer, framesInFlight, FRAME_TIMELINE_LENGTH);
 
 		// === ================ ===
 		// === DESCRIPTOR HEAPS ===
@@ -227,29 +342,45 @@ void Initialize()
 
 			cbvSrvHeap.Initialize(
 				device_pointer,
-				2,
+				CBV_SRV_UAV_DESCRIPTOR_COUNT,
 				D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
 				D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE);
 
-			rtvDescriptorSize = device_pointer->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
-			cbvSrvDescriptorSize = device_pointer->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+			stagingSrvHeap.Initialize(
+				device_pointer,
+				STAGING_DESCRIPTOR_COUNT,
+				D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
+				D3D12_DESCRIPTOR_HEAP_FLAG_NONE);
+
+			renderTargetDescriptors = rtvHeap.Allocate(BACK_BUFFER_COUNT);
+
+			// The root signature and the pixel shader are built for the size of the table
+			D3D12_FEATURE_DATA_D3D12_OPTIONS options = {};
+			ThrowIfFailed(device_pointer->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options)));
+
+			bindlessTextures.Initialize(
+				device_pointer,
+				&cbvSrvHeap,
+				&stagingSrvHeap,
+				(options.ResourceBindingTier == D3D12_RESOURCE_BINDING_TIER_1) ? TIER_1_BINDLESS_TEXTURE_COUNT : BINDLESS_TEXTURE_COUNT);
 		}
 
 		// === =============== ===
 		// === FRAME RESOURCES ===
 		// === =============== ===
 		{
-			CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle(rtvHeap.GetDescriptorHeapPointer()->GetCPUDescriptorHandleForHeapStart());
-
 			// Create a new render target view for each frame
 			for (UINT n = 0; n < BACK_BUFFER_COUNT; ++n)
 			{
 				ThrowIfFailed(swap_chain_pointer->GetBuffer(n, IID_PPV_ARGS(&renderTargets[n])));
 
-				device_pointer->CreateRenderTargetView(renderTargets[n].Get(), nullptr, rtvHandle);
-				rtvHandle.Offset(1, rtvDescriptorSize);
+				device_pointer->CreateRenderTargetView(renderTargets[n].Get(), nullptr, rtvHeap.GetCpuHandle(renderTargetDescriptors, n));
+				renderTargetIds[n] = trackedResources.Register(renderTargets[n].Get(), D3D12_RESOURCE_STATE_PRESENT);
+			}
 
-				// Also create a command allocator per frame
+			// A command allocator per frame in flight, a slot is only reset once its previous frame has completed
+			for (UINT n = 0; n < framesInFlight; ++n)
+			{
 				ThrowIfFailed(device_pointer->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&graphicsCommandAllocators[n])));
 			}
 		}
@@ -273,13 +404,16 @@ void Initialize()
 				featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
 			}
 
-			CD3DX12_DESCRIPTOR_RANGE1 ranges[2];
-			ranges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0, 0, D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC);
-			ranges[1].Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 0, 0, D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC);
+			// Views are created and freed in the bindless table while command lists that bind it are in flight
+			CD3DX12_DESCRIPTOR_RANGE1 ranges[1];
+			ranges[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, bindlessTextures.GetCapacity(), 0, 0, D3D12_DESCRIPTOR_RANGE_FLAG_DESCRIPTORS_VOLATILE | D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC_WHILE_SET_AT_EXECUTE);
 
-			CD3DX12_ROOT_PARAMETER1 rootParameters[2];
+			// The constants live in the upload ring, a root CBV points straight at them without a descriptor
+			// The index of the texture to sample is a root constant, so switching textures does not rebind the table
+			CD3DX12_ROOT_PARAMETER1 rootParameters[3];
 			rootParameters[0].InitAsDescriptorTable(1, &ranges[0], D3D12_SHADER_VISIBILITY_PIXEL);
-			rootParameters[1].InitAsDescriptorTable(1, &ranges[1], D3D12_SHADER_VISIBILITY_VERTEX);
+			rootParameters[1].InitAsConstantBufferView(0, 0, D3D12_ROOT_DESCRIPTOR_FLAG_DATA_STATIC_WHILE_SET_AT_EXECUTE, D3D12_SHADER_VISIBILITY_VERTEX);
+			rootParameters[2].InitAsConstants(1, 1, 0, D3D12_SHADER_VISIBILITY_PIXEL);
 
 			D3D12_ROOT_SIGNATURE_FLAGS rootSignatureFlags =
 				D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT |
@@ -323,9 +457,12 @@ void Initialize()
 			compileFlags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
 #endif
 
-			// Compile the shaders
-			ThrowIfFailed(D3DCompileFromFile(L"./Resources/Shaders/simple_shader.hlsl", nullptr, nullptr, "vs_main", "vs_5_0", compileFlags, 0, &vertexShader, nullptr));
-			ThrowIfFailed(D3DCompileFromFile(L"./Resources/Shaders/simple_shader.hlsl", nullptr, nullptr, "ps_main", "ps_5_0", compileFlags, 0, &pixelShader, nullptr));
+			// Compile the shaders, indexing into the texture array needs shader model 5.1
+			const std::string bindlessTextureCount = std::to_string(bindlessTextures.GetCapacity());
+			const D3D_SHADER_MACRO defines[] = { { "BINDLESS_TEXTURE_COUNT", bindlessTextureCount.c_str() }, { nullptr, nullptr } };
+
+			ThrowIfFailed(D3DCompileFromFile(L"./Resources/Shaders/simple_shader.hlsl", defines, nullptr, "vs_main", "vs_5_1", compileFlags, 0, &vertexShader, nullptr));
+			ThrowIfFailed(D3DCompileFromFile(L"./Resources/Shaders/simple_shader.hlsl", defines, nullptr, "ps_main", "ps_5_1", compileFlags, 0, &pixelShader, nullptr));
 
 			// Define the vertex input layout
 			D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
@@ -354,148 +491,80 @@ void Initialize()
 		}
 
 		// Defaults to a recording state
-		ThrowIfFailed(device_pointer->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, graphicsCommandAllocators[frameIndex].Get(), nullptr, IID_PPV_ARGS(&graphicsCommandList)));
+		ThrowIfFailed(device_pointer->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, graphicsCommandAllocators[frameSync.GetFrameSlot()].Get(), nullptr, IID_PPV_ARGS(&graphicsCommandList)));
+		graphicsStateTracker.Initialize(&trackedResources);
 
-		// === ============= ===
-		// === VERTEX BUFFER ===
-		// === ============= ===
+		// Only records barriers, it is reset right before every submission of the graphics command list
+		ThrowIfFailed(device_pointer->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, graphicsCommandAllocators[frameSync.GetFrameSlot()].Get(), nullptr, IID_PPV_ARGS(&fixupCommandList)));
+		ThrowIfFailed(fixupCommandList->Close());
+
+		// Resource heap tier 1 hardware cannot mix buffers and textures in one heap
+		bufferHeapAllocator.Initialize(device_pointer, D3D12_HEAP_TYPE_DEFAULT, D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS, RESOURCE_HEAP_SIZE);
+		textureHeapAllocator.Initialize(device_pointer, D3D12_HEAP_TYPE_DEFAULT, D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES, RESOURCE_HEAP_SIZE);
+
+		// === ====== ===
+		// === MESHES ===
+		// === ====== ===
 		{
-			Vertex vertices[] =
-			{
-				{ {  0.0f,  0.5f, 0.0f, 1.0f }, { 0.5f, 0.0f } },
-				{ {  0.5f, -0.5f, 0.0f, 1.0f }, { 1.0f, 1.0f } },
-				{ { -0.5f, -0.5f, 0.0f, 1.0f }, { 0.0f, 1.0f } }
-			};
+			meshBuffers.Initialize(device_pointer, &bufferHeapAllocator, &trackedResources, MESH_VERTEX_BUFFER_SIZE, MESH_INDEX_BUFFER_SIZE, MESH_STAGING_RING_SIZE);
 
-			const UINT vertexBufferSize = sizeof(vertices);
+			std::vector<Vertex> vertices;
+			std::vector<std::uint32_t> indices;
+			tnt::graphics::IndexVertices(tnt::graphics::CreateTriangleScene(), vertices, indices);
 
-			// TODO: read on default heap usage
-			ThrowIfFailed(device_pointer->CreateCommittedResource(
-				&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-				D3D12_HEAP_FLAG_NONE,
-				&CD3DX12_RESOURCE_DESC::Buffer(vertexBufferSize),
-				D3D12_RESOURCE_STATE_GENERIC_READ,
-				nullptr,
-				IID_PPV_ARGS(&vertexBuffer)
-			));
+			sceneMesh = meshBuffers.AddMesh(vertices.data(), static_cast<UINT>(vertices.size()), sizeof(Vertex), indices.data(), static_cast<UINT>(indices.size()));
 
-			// Copy the data to the vertex buffer
-			UINT8* pVertexDataBegin = nullptr;
-			CD3DX12_RANGE readRange(0, 0);	// Do not intend to read from this resource on the CPU
-			ThrowIfFailed(vertexBuffer->Map(0, &readRange, reinterpret_cast<void**>(&pVertexDataBegin)));
-			memcpy(pVertexDataBegin, vertices, vertexBufferSize);
-			vertexBuffer->Unmap(0, nullptr);
-
-			// Initialize the vertex buffer view
-			vertexBufferView.BufferLocation = vertexBuffer->GetGPUVirtualAddress();
-			vertexBufferView.StrideInBytes = sizeof(Vertex);
-			vertexBufferView.SizeInBytes = vertexBufferSize;
+			// Copied into the default heap by the setup command list, resident once the setup has completed
+			meshBuffers.RecordUploads(graphicsCommandList.Get(), graphicsStateTracker);
 		}
 
-		// Pointer to the start of the CBV / SRV heap
-		CD3DX12_CPU_DESCRIPTOR_HANDLE cbvSrvHandle(cbvSrvHeap.GetDescriptorHeapPointer()->GetCPUDescriptorHandleForHeapStart());
-
 		// === ======== ===
 		// === TEXTURES ===
 		// === ======== ===
-
-		ComPtr<ID3D12Resource> textureUploadHeap;
-
-		// Load the texture
 		{
-			int width, height, channelCount;
-			unsigned char* imageData = stbi_load("./Resources/Textures/basic_test_texture.png", &width, &height, &channelCount, STBI_rgb_alpha);
-
-			D3D12_RESOURCE_DESC textureDesc = {};
-			textureDesc.MipLevels = 1;
-			textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-			textureDesc.Width = width;
-			textureDesc.Height = height;
-			textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-			textureDesc.DepthOrArraySize = 1;
-			textureDesc.SampleDesc.Count = 1;
-			textureDesc.SampleDesc.Quality = 0;
-			textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-
-			ThrowIfFailed(device_pointer->CreateCommittedResource(
-				&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
-				D3D12_HEAP_FLAG_NONE,
-				&textureDesc,
-				D3D12_RESOURCE_STATE_COPY_DEST,
-				nullptr,
-				IID_PPV_ARGS(&texture)
-			));
-
-			const UINT64 uploadBufferSize = GetRequiredIntermediateSize(texture.Get(), 0, 1);
-
-			// Create the GPU upload buffer
-			ThrowIfFailed(device_pointer->CreateCommittedResource(
-				&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-				D3D12_HEAP_FLAG_NONE,
-				&CD3DX12_RESOURCE_DESC::Buffer(uploadBufferSize),
-				D3D12_RESOURCE_STATE_GENERIC_READ,
-				nullptr,
-				IID_PPV_ARGS(&textureUploadHeap)
-			));
+			textureCache.Initialize(tnt::graphics::GetTemporaryCacheDirectory(tnt::application::TEXTURE_CACHE_NAME), 0, tnt::graphics::MipGeneratorSettings(), tnt::application::TEXTURE_CACHE_FORMAT);
+			textureStreamer.Initialize(device_pointer, &textureHeapAllocator, TEXTURE_STREAMING_RING_SIZE);
+			textureStreamer.SetTextureCache(&textureCache);
 
-			// Copy the data to the intermediate upload heap and schedule a copy from the upload heap to the Texture2D
-			D3D12_SUBRESOURCE_DATA textureSubresouceData = {};
-			textureSubresouceData.pData = imageData;
-			textureSubresouceData.RowPitch = width * STBI_rgb_alpha;	// Number of rows * number of bytes per pixel
-			textureSubresouceData.SlicePitch = textureSubresouceData.RowPitch * height;
-
-			UpdateSubresources(graphicsCommandList.Get(), texture.Get(), textureUploadHeap.Get(), 0, 0, 1, &textureSubresouceData);
-			graphicsCommandList->ResourceBarrier(
-				1,
-				&CD3DX12_RESOURCE_BARRIER::Transition(
-					texture.Get(),
-					D3D12_RESOURCE_STATE_COPY_DEST,
-					D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE)
-			);
-
-			stbi_image_free(imageData);
-
-			// Describe and create a SRV for the texture
 			D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
 			srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-			srvDesc.Format = textureDesc.Format;
+			srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
 			srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
 			srvDesc.Texture2D.MipLevels = 1;
 
-			device_pointer->CreateShaderResourceView(texture.Get(), &srvDesc, cbvSrvHandle);	// Resource 0
-			cbvSrvHandle.Offset(1, cbvSrvDescriptorSize);
-		}
+			// A null view samples as zero, the frames rendered before the texture arrives show a black triangle
+			sceneTexture = bindlessTextures.CreateShaderResourceView(nullptr, srvDesc);
 
-		// Close the command list and execute the commands
-		ThrowIfFailed(graphicsCommandList->Close());
-		ID3D12CommandList* ppCommandLists[] = { graphicsCommandList.Get() };
-		graphicsCommandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+			// Descriptors referenced by frames in flight must not change, so the streamed texture gets a slot of its own
+			textureStreamer.RequestTexture("./Resources/Textures/basic_test_texture.png", [srvDesc](const tnt::wrapper::dx12::StreamedTexture& t_texture)
+			{
+				if (texture.resource)
+				{
+					retiredTextures.push_back(texture);
+				}
 
-		// Create the constant buffer
-		{
-			ThrowIfFailed(device_pointer->CreateCommittedResource(
-				&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-				D3D12_HEAP_FLAG_NONE,
-				&CD3DX12_RESOURCE_DESC::Buffer(1024 * 64),
-				D3D12_RESOURCE_STATE_GENERIC_READ,
-				nullptr,
-				IID_PPV_ARGS(&constantBuffer)
-			));
+				texture = { t_texture.resource, t_texture.allocation, 0 };
 
-			D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc = {};
-			cbvDesc.BufferLocation = constantBuffer->GetGPUVirtualAddress();
-			cbvDesc.SizeInBytes = (sizeof(SceneConstantBufferData) + 255) & ~255;	// Align the constant buffer to 256 bytes
+				D3D12_SHADER_RESOURCE_VIEW_DESC textureSrvDesc = srvDesc;
+				textureSrvDesc.Format = texture.resource->GetDesc().Format;
+				textureSrvDesc.Texture2D.MipLevels = texture.resource->GetDesc().MipLevels;
 
-			device_pointer->CreateConstantBufferView(&cbvDesc, cbvSrvHandle);	// Resource 1
-			cbvSrvHandle.Offset(1, cbvSrvDescriptorSize);
+				const tnt::wrapper::dx12::BindlessHandle streamedTexture = bindlessTextures.CreateShaderResourceView(texture.resource.Get(), textureSrvDesc);
 
-			// Keep it mapped until the application closes
-			// It is okay to keep things mapped for the lifetime of the resource
-			CD3DX12_RANGE readRange(0, 0);
-			ThrowIfFailed(constantBuffer->Map(0, &readRange, reinterpret_cast<void**>(&p_cbvDataBegin)));
-			memcpy(p_cbvDataBegin, &constantBufferData, sizeof(constantBufferData));
+				// Frames in flight may still sample the null texture, its slot is only reused once they have completed
+				bindlessTextures.Free(sceneTexture);
+				sceneTexture = streamedTexture;
+			});
 		}
 
+		// Close the command list and execute the commands
+		graphicsStateTracker.FinishRecording(graphicsCommandList.Get());
+		ThrowIfFailed(graphicsCommandList->Close());
+		ExecuteGraphicsCommandList();
+
+		// Create the upload ring for the constant buffers
+		uploadRing.Initialize(device_pointer, UPLOAD_RING_SIZE);
+
 		// Create and record the bundle
 		{
 			ThrowIfFailed(device_pointer->CreateCommandList(
@@ -508,27 +577,25 @@ void Initialize()
 
 			bundleCommandList->SetGraphicsRootSignature(rootSignature.Get());
 			bundleCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+			// Views point into the shared buffers, they stay valid for as long as the mesh is not removed
+			const D3D12_VERTEX_BUFFER_VIEW vertexBufferView = meshBuffers.GetVertexBufferView(sceneMesh);
+			const D3D12_INDEX_BUFFER_VIEW indexBufferView = meshBuffers.GetIndexBufferView(sceneMesh);
+
 			bundleCommandList->IASetVertexBuffers(0, 1, &vertexBufferView);
-			bundleCommandList->DrawInstanced(3, 1, 0, 0);
+			bundleCommandList->IASetIndexBuffer(&indexBufferView);
+			bundleCommandList->DrawIndexedInstanced(meshBuffers.GetIndexCount(sceneMesh), 1, 0, 0, 0);
 
 			ThrowIfFailed(bundleCommandList->Close());
 		}
 
-		// Synchronization objects
+		// Wait for the setup to complete...
 		{
-			ThrowIfFailed(device_pointer->CreateFence(fenceValues[frameIndex], D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence)));
-			++fenceValues[frameIndex];
-
-			// Even handle for frame synchronization
-			fenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
-
-			if (fenceEvent == nullptr)
-			{
-				ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
-			}
+			const UINT64 setupFenceValue = frameSync.Flush();
+			meshBuffers.FinishFrame(setupFenceValue);
+			bindlessTextures.FinishFrame(setupFenceValue);
 
-			// Wait for the setup to complete...
-			WaitForGPU();
+			meshBuffers.Retire(frameSync.GetCompletedValue());
+			bindlessTextures.Retire(frameSync.GetCompletedValue());
 		}
 	}
 #pragma endregion
@@ -536,18 +603,12 @@ void Initialize()
 
 void Update()
 {
-	const float scrollSpeed = 0.0075f;
-	const float offsetBounds = 1.5f;
+	// Finished texture copies become visible to the frames recorded from here on
+	textureStreamer.Update();
 
-	constantBufferData.positionOffset.x += scrollSpeed;
-
-	if (constantBufferData.positionOffset.x > offsetBounds)
-	{
-		constantBufferData.positionOffset.x = -offsetBounds;
-	}
-
-	// Update the data in the constant buffer
-	memcpy(p_cbvDataBegin, &constantBufferData, sizeof(constantBufferData));
+	// Catches up to the wall clock, the constants are copied into the upload ring while recording the frame
+	const double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - simulationStartTime).count();
+	constantBufferData = tnt::graphics::SimulateScene(simulationTimestep, time, previousSceneData, currentSceneData);
 }
 
 void Render()
@@ -556,21 +617,47 @@ void Render()
 	PopulateCommandList();
 
 	// Execute said commands
-	ID3D12CommandList* ppCommandLists[] = { graphicsCommandList.Get() };
-	graphicsCommandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+	ExecuteGraphicsCommandList();
 
-	// Present the frame (using v-sync)
-	ThrowIfFailed(swap_chain_pointer->Present(1, 0));
+	// Present the frame, a sync interval of zero presents right away instead of on the next v-blank
+	ThrowIfFailed(swap_chain_pointer->Present(presentSyncInterval, 0));
 	
 	PrepareNextFrame();
 }
 
+// One iteration of the main loop, runs as often as the frame pacing lets it
+void Frame()
+{
+	// Resources of the frame slot are reused from here on, simulating after the wait keeps the shown state recent
+	WaitForFrameSlot();
+
+	Update();
+	Render();
+}
+
 void Destroy()
 {
 	// Make sure that the GPU is no longer using any of the resources that are about to be deallocated
-	WaitForGPU();
+	frameSync.Flush();
+	textureStreamer.Cleanup();
+	meshBuffers.Cleanup();
+	bindlessTextures.Cleanup();
+
+	for (PlacedTexture& retiredTexture : retiredTextures)
+	{
+		ReleaseTexture(retiredTexture);
+	}
+
+	retiredTextures.clear();
+	ReleaseTexture(texture);
 
-	CloseHandle(fenceEvent);
+	if (!frameTimelinePath.empty())
+	{
+		std::ofstream timeline(frameTimelinePath);
+		frameSync.GetPacer().WriteTimeline(timeline);
+	}
+
+	frameSync.Cleanup();
 }
 
 LRESULT CALLBACK WindowProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
@@ -578,8 +665,8 @@ LRESULT CALLBACK WindowProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lPara
 	switch (message)
 	{
 	case WM_PAINT:
-		Update();
-		Render();
+		// Frames are driven by the main loop, the window only has to be marked as painted
+		ValidateRect(hWnd, nullptr);
 		return 0;
 
 	case WM_DESTROY:
@@ -591,8 +678,86 @@ LRESULT CALLBACK WindowProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lPara
 	return DefWindowProc(hWnd, message, wParam, lParam);
 }
 
+// Returns false unless the whole value is a number in [t_min, t_max]
+bool ParseUnsignedOption(const std::string& t_value, UINT t_min, UINT t_max, UINT& t_result)
+{
+	try
+	{
+		std::size_t parsedLength = 0;
+		const unsigned long value = std::stoul(t_value, &parsedLength);
+
+		if (parsedLength != t_value.size() || value < t_min || value > t_max)
+		{
+			return false;
+		}
+
+		t_result = static_cast<UINT>(value);
+		return true;
+	}
+	catch (const std::exception&)
+	{
+		return false;
+	}
+}
+
+void PrintUsage()
+{
+	std::cout << "Usage: [--frames-in-flight 1-" << MAX_FRAMES_IN_FLIGHT << "] [--sync-interval 0-" << MAX_SYNC_INTERVAL << "] [--frame-timeline file.csv]\n";
+}
+
 int main(int argc, char* argv[])
 {
+	// Headless rendering, benchmarks and texture cooking run without a window
+	int exitCode = 0;
+
+	if (tnt::application::RunCommandLine(argc, argv, exitCode))
+	{
+		return exitCode;
+	}
+
+	// Frame pacing of the window, anything that does not parse prints the usage instead of opening the window
+	// Usage: [--frames-in-flight 1-16] [--sync-interval 0-4] [--frame-timeline file.csv]
+	for (int index = 1; index < argc; index += 2)
+	{
+		const std::string option = argv[index];
+
+		if (index + 1 == argc)
+		{
+			std::cout << "Missing value for " << option << "\n";
+			PrintUsage();
+			return 1;
+		}
+
+		const std::string value = argv[index + 1];
+		bool isValid = true;
+
+		if (option == "--frames-in-flight")
+		{
+			isValid = ParseUnsignedOption(value, 1, MAX_FRAMES_IN_FLIGHT, framesInFlight);
+		}
+		else if (option == "--sync-interval")
+		{
+			isValid = ParseUnsignedOption(value, 0, MAX_SYNC_INTERVAL, presentSyncInterval);
+		}
+		else if (option == "--frame-timeline")
+		{
+			frameTimelinePath = value;
+		}
+		else
+		{
+			std::cout << "Unknown option: " << option << "\n";
+			PrintUsage();
+			return 1;
+		}
+
+		if (!isValid)
+		{
+			std::cout << "Invalid value for " << option << ": " << value << "\n";
+			PrintUsage();
+			return 1;
+		}
+	}
+
 	HINSTANCE hinstance = GetModuleHandle(nullptr);
 
 	tnt::wrapper::Window window;
@@ -603,8 +768,11 @@ int main(int argc, char* argv[])
 	// Initialize the DX12 application itself, not the window
 	Initialize();
 
+	simulationTimestep.Initialize(tnt::application::SIMULATION_STEP, tnt::application::MAX_SIMULATION_STEPS_PER_FRAME);
+	simulationStartTime = std::chrono::steady_clock::now();
+
 	window.Show();
-	window.MainLoop();
+	window.MainLoop(Frame);
 
 	// Clean up all resources used by the application
 	Destroy();
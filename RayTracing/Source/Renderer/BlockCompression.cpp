@@ -0,0 +1,946 @@
+#include "Renderer/BlockCompression.hpp"
+
+#include "Utility/CpuFeatures.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#if defined(TNT_X86)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	using namespace tnt::graphics;
+
+	const std::uint32_t BLOCK_TEXEL_COUNT = 16;
+
+	// Refinement passes after the principal axis guess, each one refits the endpoints to the chosen indices
+	const std::uint32_t ENDPOINT_REFINE_COUNT = 2;
+
+	// Interpolation weights of 4 bit BC7 indices, in 64ths
+	const std::uint32_t BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	// One array per channel, so four texels fill an SSE register
+	struct BlockTexels
+	{
+		alignas(16) float channels[4][BLOCK_TEXEL_COUNT];
+	};
+
+	// Colors the indices of a block can pick from, as the decoder reconstructs them
+	struct Palette
+	{
+		float colors[16][4];
+		std::uint32_t count;
+	};
+
+	// Packs bits from the lowest bit of the first byte up, like every BC format
+	class BlockBitWriter
+	{
+	public:
+		explicit BlockBitWriter(std::uint8_t* t_block)
+			: m_block(t_block)
+			, m_position(0)
+		{
+		}
+
+		void Write(std::uint32_t t_value, std::uint32_t t_bit_count)
+		{
+			for (std::uint32_t bit = 0; bit < t_bit_count; ++bit, ++m_position)
+			{
+				m_block[m_position / 8] |= static_cast<std::uint8_t>(((t_value >> bit) & 1) << (m_position % 8));
+			}
+		}
+
+	private:
+		std::uint8_t* m_block;
+		std::uint32_t m_position;
+	};
+
+	class BlockBitReader
+	{
+	public:
+		explicit BlockBitReader(const std::uint8_t* t_block)
+			: m_block(t_block)
+			, m_position(0)
+		{
+		}
+
+		std::uint32_t Read(std::uint32_t t_bit_count)
+		{
+			std::uint32_t value = 0;
+
+			for (std::uint32_t bit = 0; bit < t_bit_count; ++bit, ++m_position)
+			{
+				value |= ((m_block[m_position / 8] >> (m_position % 8)) & 1u) << bit;
+			}
+
+			return value;
+		}
+
+	private:
+		const std::uint8_t* m_block;
+		std::uint32_t m_position;
+	};
+
+	BlockTexels LoadBlockTexels(const std::uint8_t* t_texels)
+	{
+		BlockTexels texels;
+
+		for (std::uint32_t texel = 0; texel < BLOCK_TEXEL_COUNT; ++texel)
+		{
+			for (std::uint32_t channel = 0; channel < 4; ++channel)
+			{
+				texels.channels[channel][texel] = t_texels[texel * 4 + channel];
+			}
+		}
+
+		return texels;
+	}
+
+	// Picks the closest palette entry for every texel over the given channels, returns the summed squared error
+	float FindIndices(const BlockTexels& t_texels, const Palette& t_palette, std::uint32_t t_first_channel, std::uint32_t t_channel_count, std::uint8_t* t_indices)
+	{
+		const std::uint32_t end_channel = t_first_channel + t_channel_count;
+		float error = 0.0f;
+
+#if defined(TNT_X86)
+		// Four texels at a time against every palette entry
+		for (std::uint32_t first_texel = 0; first_texel < BLOCK_TEXEL_COUNT; first_texel += 4)
+		{
+			__m128 best_distance = _mm_set1_ps(std::numeric_limits<float>::max());
+			__m128i best_index = _mm_setzero_si128();
+
+			for (std::uint32_t entry = 0; entry < t_palette.count; ++entry)
+			{
+				__m128 distance = _mm_setzero_ps();
+
+				for (std::uint32_t channel = t_first_channel; channel < end_channel; ++channel)
+				{
+					const __m128 difference = _mm_sub_ps(_mm_load_ps(&t_texels.channels[channel][first_texel]), _mm_set1_ps(t_palette.colors[entry][channel]));
+					distance = _mm_add_ps(distance, _mm_mul_ps(difference, difference));
+				}
+
+				const __m128i is_closer = _mm_castps_si128(_mm_cmplt_ps(distance, best_distance));
+
+				best_distance = _mm_min_ps(distance, best_distance);
+				best_index = _mm_or_si128(_mm_and_si128(is_closer, _mm_set1_epi32(static_cast<int>(entry))), _mm_andnot_si128(is_closer, best_index));
+			}
+
+			alignas(16) std::int32_t indices[4];
+			alignas(16) float distances[4];
+			_mm_store_si128(reinterpret_cast<__m128i*>(indices), best_index);
+			_mm_store_ps(distances, best_distance);
+
+			for (std::uint32_t texel = 0; texel < 4; ++texel)
+			{
+				t_indices[first_texel + texel] = static_cast<std::uint8_t>(indices[texel]);
+				error += distances[texel];
+			}
+		}
+#else
+		for (std::uint32_t texel = 0; texel < BLOCK_TEXEL_COUNT; ++texel)
+		{
+			float best_distance = std::numeric_limits<float>::max();
+
+			for (std::uint32_t entry = 0; entry < t_palette.count; ++entry)
+			{
+				float distance = 0.0f;
+
+				for (std::uint32_t channel = t_first_channel; channel < end_channel; ++channel)
+				{
+					const float difference = t_texels.channels[channel][texel] - t_palette.colors[entry][channel];
+					distance += difference * difference;
+				}
+
+				if (distance < best_distance)
+				{
+					best_distance = distance;
+					t_indices[texel] = static_cast<std::uint8_t>(entry);
+				}
+			}
+
+			error += best_distance;
+		}
+#endif
+
+		return error;
+	}
+
+	// Endpoints at the extremes of the block along its principal axis, found with a few rounds of power iteration
+	void FindAxisEndpoints(const BlockTexels& t_texels, std::uint32_t t_channel_count, float* t_low, float* t_high)
+	{
+		float mean[4] = {};
+		float minimum[4];
+		float maximum[4];
+
+		for (std::uint32_t channel = 0; channel < t_channel_count; ++channel)
+		{
+			minimum[channel] = t_texels.channels[channel][0];
+			maximum[channel] = t_texels.channels[channel][0];
+
+			for (std::uint32_t texel = 0; texel < BLOCK_TEXEL_COUNT; ++texel)
+			{
+				const float value = t_texels.channels[channel][texel];
+
+				mean[channel] += value;
+				minimum[channel] = std::min(minimum[channel], value);
+				maximum[channel] = std::max(maximum[channel], value);
+			}
+
+			mean[channel] /= BLOCK_TEXEL_COUNT;
+		}
+
+		float covariance[4][4] = {};
+
+		for (std::uint32_t texel = 0; texel < BLOCK_TEXEL_COUNT; ++texel)
+		{
+			for (std::uint32_t row = 0; row < t_channel_count; ++row)
+			{
+				for (std::uint32_t column = 0; column < t_channel_count; ++column)
+				{
+					covariance[row][column] += (t_texels.channels[row][texel] - mean[row]) * (t_texels.channels[column][texel] - mean[column]);
+				}
+			}
+		}
+
+		// The bounding box diagonal is a good first guess and keeps the iteration away from a zero vector
+		float axis[4];
+
+		for (std::uint32_t channel = 0; channel < t_channel_count; ++channel)
+		{
+			axis[channel] = maximum[channel] - minimum[channel];
+		}
+
+		for (std::uint32_t iteration = 0; iteration < 8; ++iteration)
+		{
+			float next_axis[4] = {};
+			float length = 0.0f;
+
+			for (std::uint32_t row = 0; row < t_channel_count; ++row)
+			{
+				for (std::uint32_t column = 0; column < t_channel_count; ++column)
+				{
+					next_axis[row] += covariance[row][column] * axis[column];
+				}
+
+				length = std::max(length, std::abs(next_axis[row]));
+			}
+
+			if (length <= 0.0f)
+			{
+				break;
+			}
+
+			for (std::uint32_t channel = 0; channel < t_channel_count; ++channel)
+			{
+				axis[channel] = next_axis[channel] / length;
+			}
+		}
+
+		float low_projection = std::numeric_limits<float>::max();
+		float high_projection = -std::numeric_limits<float>::max();
+		float length_squared = 0.0f;
+
+		for (std::uint32_t channel = 0; channel < t_channel_count; ++channel)
+		{
+			length_squared += axis[channel] * axis[channel];
+		}
+
+		// A flat block has no axis, both endpoints are its color
+		if (length_squared <= 0.0f)
+		{
+			std::copy(mean, mean + t_channel_count, t_low);
+			std::copy(mean, mean + t_channel_count, t_high);
+			return;
+		}
+
+		for (std::uint32_t texel = 0; texel < BLOCK_TEXEL_COUNT; ++texel)
+		{
+			float projection = 0.0f;
+
+			for (std::uint32_t channel = 0; channel < t_channel_count; ++channel)
+			{
+				projection += (t_texels.channels[channel][texel] - mean[channel]) * axis[channel];
+			}
+
+			low_projection = std::min(low_projection, projection);
+			high_projection = std::max(high_projection, projection);
+		}
+
+		for (std::uint32_t channel = 0; channel < t_channel_count; ++channel)
+		{
+			t_low[channel] = mean[channel] + axis[channel] * low_projection / length_squared;
+			t_high[channel] = mean[channel] + axis[channel] * high_projection / length_squared;
+		}
+	}
+
+	// Least squares endpoints for the chosen indices, the weight of an index is how far it sits towards the second endpoint
+	// Returns false when every texel uses the same weight, then the system has no unique solution
+	bool RefitEndpoints(
+		const BlockTexels& t_texels,
+		std::uint32_t t_channel_count,
+		const std::uint8_t* t_indices,
+		const float* t_weights,
+		float* t_first,
+		float* t_second)
+	{
+		float first_first = 0.0f;
+		float first_second = 0.0f;
+		float second_second = 0.0f;
+		float first_sums[4] = {};
+		float second_sums[4] = {};
+
+		for (std::uint32_t texel = 0; texel < BLOCK_TEXEL_COUNT; ++texel)
+		{
+			const float second_weight = t_weights[t_indices[texel]];
+			const float first_weight = 1.0f - second_weight;
+
+			first_first += first_weight * first_weight;
+			first_second += first_weight * second_weight;
+			second_second += second_weight * second_weight;
+
+			for (std::uint32_t channel = 0; channel < t_channel_count; ++channel)
+			{
+				first_sums[channel] += first_weight * t_texels.channels[channel][texel];
+				second_sums[channel] += second_weight * t_texels.channels[channel][texel];
+			}
+		}
+
+		const float determinant = first_first * second_second - first_second * first_second;
+
+		if (std::abs(determinant) < 1e-6f)
+		{
+			return false;
+		}
+
+		for (std::uint32_t channel = 0; channel < t_channel_count; ++channel)
+		{
+			t_first[channel] = std::min(std::max((second_second * first_sums[channel] - first_second * second_sums[channel]) / determinant, 0.0f), 255.0f);
+			t_second[channel] = std::min(std::max((first_first * second_sums[channel] - first_second * first_sums[channel]) / determinant, 0.0f), 255.0f);
+		}
+
+		return true;
+	}
+
+	std::uint32_t QuantizeChannel(float t_value, std::uint32_t t_maximum)
+	{
+		return static_cast<std::uint32_t>(std::min(std::max(t_value, 0.0f), 255.0f) * t_maximum / 255.0f + 0.5f);
+	}
+
+	std::uint16_t PackRgb565(const float* t_color)
+	{
+		return static_cast<std::uint16_t>((QuantizeChannel(t_color[0], 31) << 11) | (QuantizeChannel(t_color[1], 63) << 5) | QuantizeChannel(t_color[2], 31));
+	}
+
+	// Bit replication, the same expansion the hardware uses
+	void UnpackRgb565(std::uint16_t t_color, std::uint32_t* t_rgb)
+	{
+		const std::uint32_t red = (t_color >> 11) & 0x1F;
+		const std::uint32_t green = (t_color >> 5) & 0x3F;
+		const std::uint32_t blue = t_color & 0x1F;
+
+		t_rgb[0] = (red << 3) | (red >> 2);
+		t_rgb[1] = (green << 2) | (green >> 4);
+		t_rgb[2] = (blue << 3) | (blue >> 2);
+	}
+
+	// Colors 2 and 3 are a third of the way between the endpoints, BC1 switches to three colors and black when the first is not larger
+	void BuildColorPalette(std::uint16_t t_color0, std::uint16_t t_color1, bool t_allow_three_colors, std::uint32_t t_palette[4][4])
+	{
+		UnpackRgb565(t_color0, t_palette[0]);
+		UnpackRgb565(t_color1, t_palette[1]);
+
+		const bool is_four_colors = !t_allow_three_colors || t_color0 > t_color1;
+
+		for (std::uint32_t channel = 0; channel < 3; ++channel)
+		{
+			const std::uint32_t first = t_palette[0][channel];
+			const std::uint32_t second = t_palette[1][channel];
+
+			t_palette[2][channel] = is_four_colors ? (2 * first + second) / 3 : (first + second) / 2;
+			t_palette[3][channel] = is_four_colors ? (first + 2 * second) / 3 : 0;
+		}
+
+		t_palette[0][3] = 255;
+		t_palette[1][3] = 255;
+		t_palette[2][3] = 255;
+		t_palette[3][3] = is_four_colors ? 255 : 0;
+	}
+
+	// Always four colors, so BC1 and BC3 share it
+	void EncodeColorBlock(const BlockTexels& t_texels, std::uint8_t* t_block)
+	{
+		const float weights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+		float low[3];
+		float high[3];
+		FindAxisEndpoints(t_texels, 3, low, high);
+
+		float best_error = std::numeric_limits<float>::max();
+		std::uint16_t best_colors[2] = {};
+		std::uint8_t best_indices[BLOCK_TEXEL_COUNT] = {};
+
+		for (std::uint32_t pass = 0; pass <= ENDPOINT_REFINE_COUNT; ++pass)
+		{
+			std::uint16_t color0 = PackRgb565(high);
+			std::uint16_t color1 = PackRgb565(low);
+
+			// The first color has to be the larger one for the four color mode
+			if (color0 < color1)
+			{
+				std::swap(color0, color1);
+				std::swap(low, high);
+			}
+
+			std::uint32_t colors[4][4];
+			BuildColorPalette(color0, color1, true, colors);
+
+			// Equal colors decode in the three color mode, only the first entry is safe to use
+			Palette palette;
+			palette.count = (color0 == color1) ? 1 : 4;
+
+			for (std::uint32_t entry = 0; entry < 4; ++entry)
+			{
+				for (std::uint32_t channel = 0; channel < 4; ++channel)
+				{
+					palette.colors[entry][channel] = static_cast<float>(colors[entry][channel]);
+				}
+			}
+
+			std::uint8_t indices[BLOCK_TEXEL_COUNT];
+			const float error = FindIndices(t_texels, palette, 0, 3, indices);
+
+			if (error < best_error)
+			{
+				best_error = error;
+				best_colors[0] = color0;
+				best_colors[1] = color1;
+				std::copy(indices, indices + BLOCK_TEXEL_COUNT, best_indices);
+			}
+
+			if (error == 0.0f || !RefitEndpoints(t_texels, 3, indices, weights, high, low))
+			{
+				break;
+			}
+		}
+
+		t_block[0] = static_cast<std::uint8_t>(best_colors[0] & 0xFF);
+		t_block[1] = static_cast<std::uint8_t>(best_colors[0] >> 8);
+		t_block[2] = static_cast<std::uint8_t>(best_colors[1] & 0xFF);
+		t_block[3] = static_cast<std::uint8_t>(best_colors[1] >> 8);
+
+		std::uint32_t packed_indices = 0;
+
+		for (std::uint32_t texel = 0; texel < BLOCK_TEXEL_COUNT; ++texel)
+		{
+			packed_indices |= static_cast<std::uint32_t>(best_indices[texel]) << (texel * 2);
+		}
+
+		memcpy(t_block + 4, &packed_indices, sizeof(packed_indices));
+	}
+
+	void DecodeColorBlock(const std::uint8_t* t_block, bool t_allow_three_colors, std::uint8_t* t_texels)
+	{
+		const std::uint16_t color0 = static_cast<std::uint16_t>(t_block[0] | (t_block[1] << 8));
+		const std::uint16_t color1 = static_cast<std::uint16_t>(t_block[2] | (t_block[3] << 8));
+
+		std::uint32_t palette[4][4];
+		BuildColorPalette(color0, color1, t_allow_three_colors, palette);
+
+		std::uint32_t packed_indices = 0;
+		memcpy(&packed_indices, t_block + 4, sizeof(packed_indices));
+
+		for (std::uint32_t texel = 0; texel < BLOCK_TEXEL_COUNT; ++texel)
+		{
+			const std::uint32_t* color = palette[(packed_indices >> (texel * 2)) & 3];
+
+			for (std::uint32_t channel = 0; channel < 4; ++channel)
+			{
+				t_texels[texel * 4 + channel] = static_cast<std::uint8_t>(color[channel]);
+			}
+		}
+	}
+
+	// Entries 2 to 7 step from the first alpha to the second, or 2 to 5 plus 0 and 255 when the first is not larger
+	void BuildAlphaPalette(std::uint32_t t_alpha0, std::uint32_t t_alpha1, std::uint32_t t_palette[8])
+	{
+		t_palette[0] = t_alpha0;
+		t_palette[1] = t_alpha1;
+
+		if (t_alpha0 > t_alpha1)
+		{
+			for (std::uint32_t step = 1; step < 7; ++step)
+			{
+				t_palette[step + 1] = ((7 - step) * t_alpha0 + step * t_alpha1) / 7;
+			}
+
+			return;
+		}
+
+		for (std::uint32_t step = 1; step < 5; ++step)
+		{
+			t_palette[step + 1] = ((5 - step) * t_alpha0 + step * t_alpha1) / 5;
+		}
+
+		t_palette[6] = 0;
+		t_palette[7] = 255;
+	}
+
+	void EncodeAlphaBlock(const BlockTexels& t_texels, std::uint8_t* t_block)
+	{
+		const float* alpha = t_texels.channels[3];
+		const std::uint32_t alpha0 = static_cast<std::uint32_t>(*std::max_element(alpha, alpha + BLOCK_TEXEL_COUNT));
+		const std::uint32_t alpha1 = static_cast<std::uint32_t>(*std::min_element(alpha, alpha + BLOCK_TEXEL_COUNT));
+
+		std::uint32_t alphas[8];
+		BuildAlphaPalette(alpha0, alpha1, alphas);
+
+		// Equal alphas fall into the six value mode, the first entry covers the whole block
+		Palette palette;
+		palette.count = (alpha0 == alpha1) ? 1 : 8;
+
+		for (std::uint32_t entry = 0; entry < 8; ++entry)
+		{
+			palette.colors[entry][3] = static_cast<float>(alphas[entry]);
+		}
+
+		std::uint8_t indices[BLOCK_TEXEL_COUNT];
+		FindIndices(t_texels, palette, 3, 1, indices);
+
+		memset(t_block, 0, 8);
+
+		BlockBitWriter writer(t_block);
+		writer.Write(alpha0, 8);
+		writer.Write(alpha1, 8);
+
+		for (std::uint32_t texel = 0; texel < BLOCK_TEXEL_COUNT; ++texel)
+		{
+			writer.Write(indices[texel], 3);
+		}
+	}
+
+	void DecodeAlphaBlock(const std::uint8_t* t_block, std::uint8_t* t_texels)
+	{
+		BlockBitReader reader(t_block);
+
+		const std::uint32_t alpha0 = reader.Read(8);
+		const std::uint32_t alpha1 = reader.Read(8);
+
+		std::uint32_t palette[8];
+		BuildAlphaPalette(alpha0, alpha1, palette);
+
+		for (std::uint32_t texel = 0; texel < BLOCK_TEXEL_COUNT; ++texel)
+		{
+			t_texels[texel * 4 + 3] = static_cast<std::uint8_t>(palette[reader.Read(3)]);
+		}
+	}
+
+	// Mode 6 endpoints are 7 bits per channel plus a shared lowest bit per endpoint
+	struct Bc7Endpoints
+	{
+		std::uint32_t colors[2][4];
+		std::uint32_t p_bits[2];
+	};
+
+	void QuantizeBc7Endpoint(const float* t_color, std::uint32_t t_p_bit, std::uint32_t* t_quantized)
+	{
+		for (std::uint32_t channel = 0; channel < 4; ++channel)
+		{
+			const float value = (std::min(std::max(t_color[channel], 0.0f), 255.0f) - t_p_bit) / 2.0f;
+			t_quantized[channel] = std::min(static_cast<std::uint32_t>(std::max(value, 0.0f) + 0.5f), 127u);
+		}
+	}
+
+	void BuildBc7Palette(const Bc7Endpoints& t_endpoints, std::uint32_t t_palette[16][4])
+	{
+		for (std::uint32_t channel = 0; channel < 4; ++channel)
+		{
+			const std::uint32_t first = (t_endpoints.colors[0][channel] << 1) | t_endpoints.p_bits[0];
+			const std::uint32_t second = (t_endpoints.colors[1][channel] << 1) | t_endpoints.p_bits[1];
+
+			for (std::uint32_t entry = 0; entry < 16; ++entry)
+			{
+				t_palette[entry][channel] = ((64 - BC7_WEIGHTS[entry]) * first + BC7_WEIGHTS[entry] * second + 32) >> 6;
+			}
+		}
+	}
+}
+
+const char* tnt::graphics::GetTextureFormatName(TextureFormat t_format)
+{
+	switch (t_format)
+	{
+	case TextureFormat::RGBA8:
+		return "rgba8";
+
+	case TextureFormat::BC1:
+		return "bc1";
+
+	case TextureFormat::BC3:
+		return "bc3";
+
+	case TextureFormat::BC7:
+		return "bc7";
+	}
+
+	return "unknown";
+}
+
+bool tnt::graphics::IsBlockCompressed(TextureFormat t_format)
+{
+	return t_format != TextureFormat::RGBA8;
+}
+
+std::uint32_t tnt::graphics::GetFormatBlockSize(TextureFormat t_format)
+{
+	return IsBlockCompressed(t_format) ? BLOCK_COMPRESSION_BLOCK_SIZE : 1;
+}
+
+std::uint32_t tnt::graphics::GetFormatBlockByteCount(TextureFormat t_format)
+{
+	switch (t_format)
+	{
+	case TextureFormat::BC1:
+		return 8;
+
+	case TextureFormat::BC3:
+	case TextureFormat::BC7:
+		return 16;
+
+	default:
+		return 4;
+	}
+}
+
+tnt::graphics::TextureFormat tnt::graphics::ResolveTextureFormat(TextureFormat t_format, std::uint32_t t_width, std::uint32_t t_height)
+{
+	if (t_width % BLOCK_COMPRESSION_BLOCK_SIZE != 0 || t_height % BLOCK_COMPRESSION_BLOCK_SIZE != 0)
+	{
+		return TextureFormat::RGBA8;
+	}
+
+	return t_format;
+}
+
+void tnt::graphics::EncodeBlockBC1(const std::uint8_t* t_texels, std::uint8_t* t_block)
+{
+	EncodeColorBlock(LoadBlockTexels(t_texels), t_block);
+}
+
+void tnt::graphics::EncodeBlockBC3(const std::uint8_t* t_texels, std::uint8_t* t_block)
+{
+	const BlockTexels texels = LoadBlockTexels(t_texels);
+
+	EncodeAlphaBlock(texels, t_block);
+	EncodeColorBlock(texels, t_block + 8);
+}
+
+void tnt::graphics::EncodeBlockBC7(const std::uint8_t* t_texels, std::uint8_t* t_block)
+{
+	const BlockTexels texels = LoadBlockTexels(t_texels);
+
+	float weights[16];
+
+	for (std::uint32_t entry = 0; entry < 16; ++entry)
+	{
+		weights[entry] = BC7_WEIGHTS[entry] / 64.0f;
+	}
+
+	float endpoints[2][4];
+	FindAxisEndpoints(texels, 4, endpoints[0], endpoints[1]);
+
+	float best_error = std::numeric_limits<float>::max();
+	Bc7Endpoints best_endpoints = {};
+	std::uint8_t best_indices[BLOCK_TEXEL_COUNT] = {};
+
+	for (std::uint32_t pass = 0; pass <= ENDPOINT_REFINE_COUNT; ++pass)
+	{
+		std::uint8_t pass_indices[BLOCK_TEXEL_COUNT] = {};
+		float pass_error = std::numeric_limits<float>::max();
+
+		// Every combination of p-bits, they move an endpoint by one step in all four channels
+		for (std::uint32_t p_bits = 0; p_bits < 4; ++p_bits)
+		{
+			Bc7Endpoints candidate;
+			candidate.p_bits[0] = p_bits & 1;
+			candidate.p_bits[1] = p_bits >> 1;
+			QuantizeBc7Endpoint(endpoints[0], candidate.p_bits[0], candidate.colors[0]);
+			QuantizeBc7Endpoint(endpoints[1], candidate.p_bits[1], candidate.colors[1]);
+
+			std::uint32_t colors[16][4];
+			BuildBc7Palette(candidate, colors);
+
+			Palette palette;
+			palette.count = 16;
+
+			for (std::uint32_t entry = 0; entry < 16; ++entry)
+			{
+				for (std::uint32_t channel = 0; channel < 4; ++channel)
+				{
+					palette.colors[entry][channel] = static_cast<float>(colors[entry][channel]);
+				}
+			}
+
+			std::uint8_t indices[BLOCK_TEXEL_COUNT];
+			const float error = FindIndices(texels, palette, 0, 4, indices);
+
+			if (error < pass_error)
+			{
+				pass_error = error;
+				std::copy(indices, indices + BLOCK_TEXEL_COUNT, pass_indices);
+			}
+
+			if (error < best_error)
+			{
+				best_error = error;
+				best_endpoints = candidate;
+				std::copy(indices, indices + BLOCK_TEXEL_COUNT, best_indices);
+			}
+		}
+
+		if (pass_error == 0.0f || !RefitEndpoints(texels, 4, pass_indices, weights, endpoints[0], endpoints[1]))
+		{
+			break;
+		}
+	}
+
+	// The highest index bit of the first texel is implied to be zero, swapping the endpoints mirrors the indices
+	if (best_indices[0] >= 8)
+	{
+		std::swap(best_endpoints.colors[0], best_endpoints.colors[1]);
+		std::swap(best_endpoints.p_bits[0], best_endpoints.p_bits[1]);
+
+		for (std::uint8_t& index : best_indices)
+		{
+			index = static_cast<std::uint8_t>(15 - index);
+		}
+	}
+
+	memset(t_block, 0, 16);
+
+	BlockBitWriter writer(t_block);
+	writer.Write(1 << 6, 7);
+
+	for (std::uint32_t channel = 0; channel < 4; ++channel)
+	{
+		writer.Write(best_endpoints.colors[0][channel], 7);
+		writer.Write(best_endpoints.colors[1][channel], 7);
+	}
+
+	writer.Write(best_endpoints.p_bits[0], 1);
+	writer.Write(best_endpoints.p_bits[1], 1);
+
+	for (std::uint32_t texel = 0; texel < BLOCK_TEXEL_COUNT; ++texel)
+	{
+		writer.Write(best_indices[texel], (texel == 0) ? 3 : 4);
+	}
+}
+
+void tnt::graphics::DecodeBlockBC1(const std::uint8_t* t_block, std::uint8_t* t_texels)
+{
+	DecodeColorBlock(t_block, true, t_texels);
+}
+
+void tnt::graphics::DecodeBlockBC3(const std::uint8_t* t_block, std::uint8_t* t_texels)
+{
+	DecodeColorBlock(t_block + 8, false, t_texels);
+	DecodeAlphaBlock(t_block, t_texels);
+}
+
+void tnt::graphics::DecodeBlockBC7(const std::uint8_t* t_block, std::uint8_t* t_texels)
+{
+	BlockBitReader reader(t_block);
+
+	if (reader.Read(7) != (1 << 6))
+	{
+		for (std::uint32_t texel = 0; texel < BLOCK_TEXEL_COUNT; ++texel)
+		{
+			t_texels[texel * 4 + 0] = 255;
+			t_texels[texel * 4 + 1] = 0;
+			t_texels[texel * 4 + 2] = 255;
+			t_texels[texel * 4 + 3] = 255;
+		}
+
+		return;
+	}
+
+	Bc7Endpoints endpoints;
+
+	for (std::uint32_t channel = 0; channel < 4; ++channel)
+	{
+		endpoints.colors[0][channel] = reader.Read(7);
+		endpoints.colors[1][channel] = reader.Read(7);
+	}
+
+	endpoints.p_bits[0] = reader.Read(1);
+	endpoints.p_bits[1] = reader.Read(1);
+
+	std::uint32_t palette[16][4];
+	BuildBc7Palette(endpoints, palette);
+
+	for (std::uint32_t texel = 0; texel < BLOCK_TEXEL_COUNT; ++texel)
+	{
+		const std::uint32_t* color = palette[reader.Read((texel == 0) ? 3 : 4)];
+
+		for (std::uint32_t channel = 0; channel < 4; ++channel)
+		{
+			t_texels[texel * 4 + channel] = static_cast<std::uint8_t>(color[channel]);
+		}
+	}
+}
+
+tnt::graphics::BlockCompressor::BlockCompressor()
+	: m_is_initialized(false)
+{
+}
+
+tnt::graphics::BlockCompressor::~BlockCompressor()
+{
+}
+
+void tnt::graphics::BlockCompressor::Initialize(std::uint32_t t_thread_count)
+{
+	m_thread_pool.Initialize(t_thread_count);
+	m_is_initialized = true;
+}
+
+void tnt::graphics::BlockCompressor::Cleanup()
+{
+	m_thread_pool.Cleanup();
+	m_is_initialized = false;
+}
+
+void tnt::graphics::BlockCompressor::Encode(TextureFormat t_format, const MipLevel& t_source, std::uint8_t* t_destination, std::uint32_t t_destination_row_pitch)
+{
+	const std::uint32_t block_count_x = (t_source.width + BLOCK_COMPRESSION_BLOCK_SIZE - 1) / BLOCK_COMPRESSION_BLOCK_SIZE;
+	const std::uint32_t block_count_y = (t_source.height + BLOCK_COMPRESSION_BLOCK_SIZE - 1) / BLOCK_COMPRESSION_BLOCK_SIZE;
+	const std::uint32_t block_byte_count = GetFormatBlockByteCount(t_format);
+
+	if (!IsBlockCompressed(t_format))
+	{
+		throw std::runtime_error("Cannot encode blocks of an uncompressed format");
+	}
+
+	auto encode_block_row = [&](std::uint32_t t_block_y, std::uint32_t)
+	{
+		std::uint8_t texels[BLOCK_TEXEL_COUNT * 4];
+
+		for (std::uint32_t block_x = 0; block_x < block_count_x; ++block_x)
+		{
+			for (std::uint32_t y = 0; y < BLOCK_COMPRESSION_BLOCK_SIZE; ++y)
+			{
+				const std::uint32_t source_y = std::min(t_block_y * BLOCK_COMPRESSION_BLOCK_SIZE + y, t_source.height - 1);
+				const std::uint8_t* row = t_source.data + static_cast<size_t>(source_y) * t_source.row_pitch;
+
+				for (std::uint32_t x = 0; x < BLOCK_COMPRESSION_BLOCK_SIZE; ++x)
+				{
+					const std::uint32_t source_x = std::min(block_x * BLOCK_COMPRESSION_BLOCK_SIZE + x, t_source.width - 1);
+					memcpy(texels + (y * BLOCK_COMPRESSION_BLOCK_SIZE + x) * 4, row + static_cast<size_t>(source_x) * 4, 4);
+				}
+			}
+
+			std::uint8_t* block = t_destination + static_cast<size_t>(t_block_y) * t_destination_row_pitch + static_cast<size_t>(block_x) * block_byte_count;
+
+			switch (t_format)
+			{
+			case TextureFormat::BC1:
+				EncodeBlockBC1(texels, block);
+				break;
+
+			case TextureFormat::BC3:
+				EncodeBlockBC3(texels, block);
+				break;
+
+			case TextureFormat::BC7:
+				EncodeBlockBC7(texels, block);
+				break;
+
+			default:
+				break;
+			}
+		}
+	};
+
+	if (!m_is_initialized || block_count_y == 1)
+	{
+		for (std::uint32_t block_y = 0; block_y < block_count_y; ++block_y)
+		{
+			encode_block_row(block_y, 0);
+		}
+
+		return;
+	}
+
+	m_thread_pool.Run(block_count_y, encode_block_row);
+}
+
+void tnt::graphics::BlockCompressor::Decode(TextureFormat t_format, const std::uint8_t* t_source, std::uint32_t t_source_row_pitch, const MipLevel& t_destination)
+{
+	const std::uint32_t block_count_x = (t_destination.width + BLOCK_COMPRESSION_BLOCK_SIZE - 1) / BLOCK_COMPRESSION_BLOCK_SIZE;
+	const std::uint32_t block_count_y = (t_destination.height + BLOCK_COMPRESSION_BLOCK_SIZE - 1) / BLOCK_COMPRESSION_BLOCK_SIZE;
+	const std::uint32_t block_byte_count = GetFormatBlockByteCount(t_format);
+
+	if (!IsBlockCompressed(t_format))
+	{
+		throw std::runtime_error("Cannot decode blocks of an uncompressed format");
+	}
+
+	auto decode_block_row = [&](std::uint32_t t_block_y, std::uint32_t)
+	{
+		std::uint8_t texels[BLOCK_TEXEL_COUNT * 4];
+
+		for (std::uint32_t block_x = 0; block_x < block_count_x; ++block_x)
+		{
+			const std::uint8_t* block = t_source + static_cast<size_t>(t_block_y) * t_source_row_pitch + static_cast<size_t>(block_x) * block_byte_count;
+
+			switch (t_format)
+			{
+			case TextureFormat::BC1:
+				DecodeBlockBC1(block, texels);
+				break;
+
+			case TextureFormat::BC3:
+				DecodeBlockBC3(block, texels);
+				break;
+
+			case TextureFormat::BC7:
+				DecodeBlockBC7(block, texels);
+				break;
+
+			default:
+				break;
+			}
+
+			// Texels outside the mip were only there to fill the block
+			const std::uint32_t width = std::min(BLOCK_COMPRESSION_BLOCK_SIZE, t_destination.width - block_x * BLOCK_COMPRESSION_BLOCK_SIZE);
+			const std::uint32_t height = std::min(BLOCK_COMPRESSION_BLOCK_SIZE, t_destination.height - t_block_y * BLOCK_COMPRESSION_BLOCK_SIZE);
+
+			for (std::uint32_t y = 0; y < height; ++y)
+			{
+				std::uint8_t* row = t_destination.data + static_cast<size_t>(t_block_y * BLOCK_COMPRESSION_BLOCK_SIZE + y) * t_destination.row_pitch;
+				memcpy(row + static_cast<size_t>(block_x) * BLOCK_COMPRESSION_BLOCK_SIZE * 4, texels + y * BLOCK_COMPRESSION_BLOCK_SIZE * 4, width * 4);
+			}
+		}
+	};
+
+	if (!m_is_initialized || block_count_y == 1)
+	{
+		for (std::uint32_t block_y = 0; block_y < block_count_y; ++block_y)
+		{
+			decode_block_row(block_y, 0);
+		}
+
+		return;
+	}
+
+	m_thread_pool.Run(block_count_y, decode_block_row);
+}
+
+std::uint32_t tnt::graphics::BlockCompressor::GetThreadCount() const
+{
+	return m_is_initialized ? m_thread_pool.GetThreadCount() : 1;
+}
@@ -0,0 +1,139 @@
+#include "Renderer/CPU/AccumulationBuffer.hpp"
+
+#include <algorithm>
+
+namespace
+{
+	float GetLuminance(const tnt::graphics::cpu::Float4& t_color)
+	{
+		// Rec. 709 weights, alpha does not contribute
+		return t_color.x * 0.2126f + t_color.y * 0.7152f + t_color.z * 0.0722f;
+	}
+}
+
+tnt::graphics::cpu::AccumulationBuffer::AccumulationBuffer()
+	: m_width(0)
+	, m_height(0)
+{
+}
+
+tnt::graphics::cpu::AccumulationBuffer::~AccumulationBuffer()
+{
+}
+
+void tnt::graphics::cpu::AccumulationBuffer::Initialize(std::uint32_t t_width, std::uint32_t t_height)
+{
+	m_width = t_width;
+	m_height = t_height;
+	m_pixels.resize(static_cast<size_t>(t_width) * t_height);
+
+	Reset();
+}
+
+void tnt::graphics::cpu::AccumulationBuffer::SetSettings(const AccumulationSettings& t_settings)
+{
+	m_settings = t_settings;
+}
+
+const tnt::graphics::cpu::AccumulationSettings& tnt::graphics::cpu::AccumulationBuffer::GetSettings() const
+{
+	return m_settings;
+}
+
+void tnt::graphics::cpu::AccumulationBuffer::Reset()
+{
+	const Pixel empty_pixel = { { 0.0f, 0.0f, 0.0f, 0.0f }, 0.0f, 0.0f, 0, 0 };
+
+	std::fill(m_pixels.begin(), m_pixels.end(), empty_pixel);
+}
+
+tnt::graphics::cpu::Float4 tnt::graphics::cpu::AccumulationBuffer::AddSample(std::uint32_t t_x, std::uint32_t t_y, const Float4& t_color)
+{
+	Pixel& pixel = m_pixels[static_cast<size_t>(t_y) * m_width + t_x];
+
+	pixel.sample_count++;
+
+	const float weight = 1.0f / static_cast<float>(pixel.sample_count);
+	pixel.mean = pixel.mean + (t_color - pixel.mean) * weight;
+
+	const float luminance = GetLuminance(t_color);
+	const float delta = luminance - pixel.luminance_mean;
+	pixel.luminance_mean += delta * weight;
+	pixel.luminance_m2 += delta * (luminance - pixel.luminance_mean);
+
+	// The variance of the mean is the sample variance divided by the sample count
+	bool converged = false;
+
+	if (pixel.sample_count >= m_settings.min_sample_count && pixel.sample_count > 1)
+	{
+		const float sample_count = static_cast<float>(pixel.sample_count);
+		const float variance_of_mean = pixel.luminance_m2 / ((sample_count - 1.0f) * sample_count);
+
+		converged = variance_of_mean <= m_settings.error_threshold * m_settings.error_threshold;
+	}
+
+	if (m_settings.max_sample_count > 0 && pixel.sample_count >= m_settings.max_sample_count)
+	{
+		converged = true;
+	}
+
+	pixel.converged = converged ? 1 : 0;
+
+	return pixel.mean;
+}
+
+bool tnt::graphics::cpu::AccumulationBuffer::IsConverged(std::uint32_t t_x, std::uint32_t t_y) const
+{
+	return GetPixel(t_x, t_y).converged != 0;
+}
+
+std::uint32_t tnt::graphics::cpu::AccumulationBuffer::GetSampleCount(std::uint32_t t_x, std::uint32_t t_y) const
+{
+	return GetPixel(t_x, t_y).sample_count;
+}
+
+float tnt::graphics::cpu::AccumulationBuffer::GetVariance(std::uint32_t t_x, std::uint32_t t_y) const
+{
+	const Pixel& pixel = GetPixel(t_x, t_y);
+
+	return (pixel.sample_count > 1) ? pixel.luminance_m2 / static_cast<float>(pixel.sample_count - 1) : 0.0f;
+}
+
+std::uint32_t tnt::graphics::cpu::AccumulationBuffer::GetWidth() const
+{
+	return m_width;
+}
+
+std::uint32_t tnt::graphics::cpu::AccumulationBuffer::GetHeight() const
+{
+	return m_height;
+}
+
+std::uint32_t tnt::graphics::cpu::AccumulationBuffer::GetConvergedPixelCount() const
+{
+	std::uint32_t converged_pixel_count = 0;
+
+	for (const Pixel& pixel : m_pixels)
+	{
+		converged_pixel_count += pixel.converged;
+	}
+
+	return converged_pixel_count;
+}
+
+std::uint64_t tnt::graphics::cpu::AccumulationBuffer::GetTotalSampleCount() const
+{
+	std::uint64_t total_sample_count = 0;
+
+	for (const Pixel& pixel : m_pixels)
+	{
+		total_sample_count += pixel.sample_count;
+	}
+
+	return total_sample_count;
+}
+
+const tnt::graphics::cpu::AccumulationBuffer::Pixel& tnt::graphics::cpu::AccumulationBuffer::GetPixel(std::uint32_t t_x, std::uint32_t t_y) const
+{
+	return m_pixels[static_cast<size_t>(t_y) * m_width + t_x];
+}
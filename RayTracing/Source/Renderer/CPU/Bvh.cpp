@@ -0,0 +1,599 @@
+#include "Renderer/CPU/Bvh.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <thread>
+#include <utility>
+
+namespace
+{
+	using tnt::graphics::cpu::Float3;
+
+	// Fixed, so the way bins are merged never depends on the number of threads
+	const std::uint32_t BINNING_CHUNK_SIZE = 16384;
+
+	// Calls t_function(index) for every index in [0, t_count) on the pool, runs on the calling thread alone when
+	// there is a single thread or a single index, as for every node binned inside a subtree task
+	// Indices are handed out in order one at a time, so the biggest subtree tasks are started first
+	template<typename Function>
+	void ParallelFor(tnt::utility::ThreadPool& t_thread_pool, std::uint32_t t_count, std::uint32_t t_thread_count, const Function& t_function)
+	{
+		if (t_thread_count <= 1 || t_count <= 1)
+		{
+			for (std::uint32_t index = 0; index < t_count; ++index)
+			{
+				t_function(index);
+			}
+
+			return;
+		}
+
+		std::atomic<std::uint32_t> next_index(0);
+
+		t_thread_pool.Run(std::min(t_thread_pool.GetThreadCount(), t_count), [&](std::uint32_t, std::uint32_t)
+		{
+			for (std::uint32_t index = next_index++; index < t_count; index = next_index++)
+			{
+				t_function(index);
+			}
+		});
+	}
+
+	// Returns the entry distance, or infinity when the box is missed
+	float IntersectBounds(
+		const Float3& t_origin,
+		const Float3& t_inverse_direction,
+		float t_t_min,
+		float t_t_max,
+		const Float3& t_bounds_min,
+		const Float3& t_bounds_max)
+	{
+		float tx1 = (t_bounds_min.x - t_origin.x) * t_inverse_direction.x;
+		float tx2 = (t_bounds_max.x - t_origin.x) * t_inverse_direction.x;
+		float ty1 = (t_bounds_min.y - t_origin.y) * t_inverse_direction.y;
+		float ty2 = (t_bounds_max.y - t_origin.y) * t_inverse_direction.y;
+		float tz1 = (t_bounds_min.z - t_origin.z) * t_inverse_direction.z;
+		float tz2 = (t_bounds_max.z - t_origin.z) * t_inverse_direction.z;
+
+		float t_entry = std::max(std::max(std::min(tx1, tx2), std::min(ty1, ty2)), std::max(std::min(tz1, tz2), t_t_min));
+		float t_exit = std::min(std::min(std::max(tx1, tx2), std::max(ty1, ty2)), std::min(std::max(tz1, tz2), t_t_max));
+
+		return (t_entry <= t_exit) ? t_entry : std::numeric_limits<float>::infinity();
+	}
+}
+
+tnt::graphics::cpu::Bvh::Bvh()
+	: m_statistics({ 0.0, 0, 0, 0, 0, 0, 0 })
+{
+}
+
+tnt::graphics::cpu::Bvh::~Bvh()
+{
+}
+
+void tnt::graphics::cpu::Bvh::Build(const std::vector<Vertex>& t_vertices, const BvhBuildSettings& t_settings)
+{
+	auto start_time = std::chrono::high_resolution_clock::now();
+
+	m_settings = t_settings;
+	m_settings.bin_count = std::max(m_settings.bin_count, 2u);
+	m_settings.max_leaf_size = std::max(m_settings.max_leaf_size, 1u);
+	m_settings.subtree_task_size = std::max(m_settings.subtree_task_size, 1u);
+
+	if (m_settings.thread_count == 0)
+	{
+		m_settings.thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+
+	const std::uint32_t thread_count = m_settings.thread_count;
+
+	// The workers persist across builds, they are only recreated when the thread count changes
+	if (m_thread_pool.GetThreadCount() != thread_count)
+	{
+		m_thread_pool.Initialize(thread_count);
+	}
+	const std::uint32_t triangle_count = static_cast<std::uint32_t>(t_vertices.size() / 3);
+
+	m_triangles.resize(triangle_count);
+	m_triangle_indices.resize(triangle_count);
+	m_triangle_bounds.resize(triangle_count);
+	m_triangle_centroids.resize(triangle_count);
+
+	const std::uint32_t chunk_count = (triangle_count + BINNING_CHUNK_SIZE - 1) / BINNING_CHUNK_SIZE;
+
+	ParallelFor(m_thread_pool, chunk_count, thread_count, [&](std::uint32_t t_chunk)
+	{
+		const std::uint32_t end = std::min((t_chunk + 1) * BINNING_CHUNK_SIZE, triangle_count);
+
+		for (std::uint32_t triangle_index = t_chunk * BINNING_CHUNK_SIZE; triangle_index < end; ++triangle_index)
+		{
+			const Vertex* vertices = &t_vertices[triangle_index * 3];
+
+			BvhTriangle& triangle = m_triangles[triangle_index];
+			triangle.v0 = { vertices[0].position.x, vertices[0].position.y, vertices[0].position.z };
+			triangle.v1 = { vertices[1].position.x, vertices[1].position.y, vertices[1].position.z };
+			triangle.v2 = { vertices[2].position.x, vertices[2].position.y, vertices[2].position.z };
+
+			Aabb bounds = CreateEmptyAabb();
+			bounds.Grow(triangle.v0);
+			bounds.Grow(triangle.v1);
+			bounds.Grow(triangle.v2);
+
+			m_triangle_bounds[triangle_index] = bounds;
+			m_triangle_centroids[triangle_index] = (bounds.min + bounds.max) * 0.5f;
+			m_triangle_indices[triangle_index] = triangle_index;
+		}
+	});
+
+	// A binary tree with N leaves never has more than 2N - 1 nodes
+	m_nodes.clear();
+	m_nodes.reserve(std::max(triangle_count * 2, 1u));
+
+	BvhNode root = { {}, 0, {}, triangle_count };
+	UpdateNodeBounds(root);
+	m_nodes.push_back(root);
+
+	m_statistics = { 0.0, triangle_count, 1, 0, 0, thread_count, 0 };
+
+	// Top levels: split large nodes one at a time, binning is spread over all threads
+	std::vector<SubtreeTask> tasks;
+	std::vector<std::pair<std::uint32_t, std::uint32_t>> stack;
+	stack.push_back({ 0, 0 });
+
+	while (!stack.empty())
+	{
+		const std::uint32_t node_index = stack.back().first;
+		const std::uint32_t depth = stack.back().second;
+		stack.pop_back();
+
+		const BvhNode node = m_nodes[node_index];
+
+		if (node.triangle_count <= m_settings.subtree_task_size)
+		{
+			tasks.push_back({ node_index, depth, node, {}, 0, depth });
+			continue;
+		}
+
+		m_statistics.max_depth = std::max(m_statistics.max_depth, depth);
+
+		BvhNode left = {};
+		BvhNode right = {};
+
+		if (depth >= MAX_BVH_DEPTH || !SplitNode(node, thread_count, left, right))
+		{
+			++m_statistics.leaf_count;
+			continue;
+		}
+
+		const std::uint32_t left_index = static_cast<std::uint32_t>(m_nodes.size());
+		m_nodes.push_back(left);
+		m_nodes.push_back(right);
+
+		m_nodes[node_index].left_first = left_index;
+		m_nodes[node_index].triangle_count = 0;
+
+		stack.push_back({ left_index + 1, depth + 1 });
+		stack.push_back({ left_index, depth + 1 });
+	}
+
+	// Bottom levels: every subtree is built independently, the biggest ones are started first
+	std::vector<std::uint32_t> task_order(tasks.size());
+
+	for (std::uint32_t index = 0; index < task_order.size(); ++index)
+	{
+		task_order[index] = index;
+	}
+
+	std::stable_sort(task_order.begin(), task_order.end(), [&tasks](std::uint32_t t_a, std::uint32_t t_b)
+	{
+		return tasks[t_a].root.triangle_count > tasks[t_b].root.triangle_count;
+	});
+
+	ParallelFor(m_thread_pool, static_cast<std::uint32_t>(tasks.size()), thread_count, [&](std::uint32_t t_index)
+	{
+		BuildSubtree(tasks[task_order[t_index]]);
+	});
+
+	// Splice the subtrees in creation order, which makes the node layout independent of the scheduling
+	for (const SubtreeTask& task : tasks)
+	{
+		SpliceSubtree(task);
+	}
+
+	m_statistics.subtree_task_count = static_cast<std::uint32_t>(tasks.size());
+
+	// Store the triangles in leaf order, so a leaf reads one contiguous block of memory
+	std::vector<BvhTriangle> ordered_triangles(triangle_count);
+
+	for (std::uint32_t index = 0; index < triangle_count; ++index)
+	{
+		ordered_triangles[index] = m_triangles[m_triangle_indices[index]];
+	}
+
+	m_triangles.swap(ordered_triangles);
+	m_triangle_blocks.Build(m_triangles.data(), m_triangle_indices.data(), triangle_count);
+
+	m_triangle_bounds.clear();
+	m_triangle_bounds.shrink_to_fit();
+	m_triangle_centroids.clear();
+	m_triangle_centroids.shrink_to_fit();
+
+	auto end_time = std::chrono::high_resolution_clock::now();
+
+	m_statistics.node_count = static_cast<std::uint32_t>(m_nodes.size());
+	m_statistics.build_seconds = std::chrono::duration<double>(end_time - start_time).count();
+}
+
+bool tnt::graphics::cpu::Bvh::Intersect(const Ray& t_ray, Hit& t_hit) const
+{
+	if (m_nodes.empty() || m_triangles.empty())
+	{
+		return false;
+	}
+
+	const Float3 inverse_direction = ComputeInverseDirection(t_ray.direction);
+	const WatertightRay watertight_ray = CreateWatertightRay(t_ray);
+	const float infinity = std::numeric_limits<float>::infinity();
+
+	if (IntersectBounds(t_ray.origin, inverse_direction, t_ray.t_min, t_ray.t_max, m_nodes[0].bounds_min, m_nodes[0].bounds_max) == infinity)
+	{
+		return false;
+	}
+
+	bool found_hit = false;
+
+	// At most one far child per level above the current node
+	std::uint32_t stack[MAX_BVH_DEPTH];
+	std::uint32_t stack_size = 0;
+	std::uint32_t node_index = 0;
+
+	while (true)
+	{
+		const BvhNode& node = m_nodes[node_index];
+
+		if (node.triangle_count > 0)
+		{
+			found_hit |= m_triangle_blocks.Intersect(watertight_ray, node.left_first, node.triangle_count, t_hit);
+
+			if (stack_size == 0)
+			{
+				break;
+			}
+
+			node_index = stack[--stack_size];
+			continue;
+		}
+
+		// Visit the closest child first, the other one may be culled by the hit found in there
+		const float t_max = std::min(t_ray.t_max, t_hit.t);
+		std::uint32_t near_index = node.left_first;
+		std::uint32_t far_index = node.left_first + 1;
+		float near_distance = IntersectBounds(t_ray.origin, inverse_direction, t_ray.t_min, t_max, m_nodes[near_index].bounds_min, m_nodes[near_index].bounds_max);
+		float far_distance = IntersectBounds(t_ray.origin, inverse_direction, t_ray.t_min, t_max, m_nodes[far_index].bounds_min, m_nodes[far_index].bounds_max);
+
+		if (far_distance < near_distance)
+		{
+			std::swap(near_index, far_index);
+			std::swap(near_distance, far_distance);
+		}
+
+		if (near_distance == infinity)
+		{
+			if (stack_size == 0)
+			{
+				break;
+			}
+
+			node_index = stack[--stack_size];
+			continue;
+		}
+
+		node_index = near_index;
+
+		if (far_distance != infinity)
+		{
+			assert(stack_size < MAX_BVH_DEPTH);
+			stack[stack_size++] = far_index;
+		}
+	}
+
+	return found_hit;
+}
+
+const std::vector<tnt::graphics::cpu::BvhNode>& tnt::graphics::cpu::Bvh::GetNodes() const
+{
+	return m_nodes;
+}
+
+const std::vector<tnt::graphics::cpu::BvhTriangle>& tnt::graphics::cpu::Bvh::GetTriangles() const
+{
+	return m_triangles;
+}
+
+const std::vector<std::uint32_t>& tnt::graphics::cpu::Bvh::GetTriangleIndices() const
+{
+	return m_triangle_indices;
+}
+
+const tnt::graphics::cpu::TriangleBlocks<4>& tnt::graphics::cpu::Bvh::GetTriangleBlocks() const
+{
+	return m_triangle_blocks;
+}
+
+const tnt::graphics::cpu::BvhBuildStatistics& tnt::graphics::cpu::Bvh::GetBuildStatistics() const
+{
+	return m_statistics;
+}
+
+void tnt::graphics::cpu::Bvh::BuildSubtree(SubtreeTask& t_task)
+{
+	// Same algorithm as the top levels, single threaded and with indices local to the task
+	std::vector<std::pair<std::uint32_t, std::uint32_t>> stack;
+	stack.push_back({ INVALID_TRIANGLE_INDEX, t_task.depth });
+
+	while (!stack.empty())
+	{
+		const std::uint32_t node_index = stack.back().first;
+		const std::uint32_t depth = stack.back().second;
+		stack.pop_back();
+
+		BvhNode& node = (node_index == INVALID_TRIANGLE_INDEX) ? t_task.root : t_task.nodes[node_index];
+
+		t_task.max_depth = std::max(t_task.max_depth, depth);
+
+		BvhNode left = {};
+		BvhNode right = {};
+
+		if (depth >= MAX_BVH_DEPTH || !SplitNode(node, 1, left, right))
+		{
+			++t_task.leaf_count;
+			continue;
+		}
+
+		const std::uint32_t left_index = static_cast<std::uint32_t>(t_task.nodes.size());
+		node.left_first = left_index;
+		node.triangle_count = 0;
+
+		// Pushing may reallocate, the node reference is not used after this point
+		t_task.nodes.push_back(left);
+		t_task.nodes.push_back(right);
+
+		stack.push_back({ left_index + 1, depth + 1 });
+		stack.push_back({ left_index, depth + 1 });
+	}
+}
+
+void tnt::graphics::cpu::Bvh::SpliceSubtree(const SubtreeTask& t_task)
+{
+	const std::uint32_t base_index = static_cast<std::uint32_t>(m_nodes.size());
+
+	for (BvhNode node : t_task.nodes)
+	{
+		if (node.triangle_count == 0)
+		{
+			node.left_first += base_index;
+		}
+
+		m_nodes.push_back(node);
+	}
+
+	BvhNode root = t_task.root;
+
+	if (root.triangle_count == 0)
+	{
+		root.left_first += base_index;
+	}
+
+	m_nodes[t_task.root_index] = root;
+
+	m_statistics.leaf_count += t_task.leaf_count;
+	m_statistics.max_depth = std::max(m_statistics.max_depth, t_task.max_depth);
+}
+
+bool tnt::graphics::cpu::Bvh::SplitNode(const BvhNode& t_node, std::uint32_t t_thread_count, BvhNode& t_left, BvhNode& t_right)
+{
+	if (t_node.triangle_count <= 1)
+	{
+		return false;
+	}
+
+	const float leaf_cost = m_settings.intersection_cost * t_node.triangle_count;
+	SplitCandidate split = FindBestSplit(t_node, t_thread_count);
+
+	if (t_node.triangle_count <= m_settings.max_leaf_size && (!split.is_valid || split.cost >= leaf_cost))
+	{
+		return false;
+	}
+
+	std::uint32_t left_count = split.is_valid ? Partition(t_node, split) : 0;
+
+	// No usable plane (e.g. all centroids coincide), split oversized leaves at the object median instead
+	if (left_count == 0 || left_count == t_node.triangle_count)
+	{
+		left_count = t_node.triangle_count / 2;
+	}
+
+	t_left = { {}, t_node.left_first, {}, left_count };
+	t_right = { {}, t_node.left_first + left_count, {}, t_node.triangle_count - left_count };
+
+	UpdateNodeBounds(t_left);
+	UpdateNodeBounds(t_right);
+
+	return true;
+}
+
+void tnt::graphics::cpu::Bvh::UpdateNodeBounds(BvhNode& t_node) const
+{
+	Aabb bounds = CreateEmptyAabb();
+
+	for (std::uint32_t index = t_node.left_first; index < t_node.left_first + t_node.triangle_count; ++index)
+	{
+		bounds.Grow(m_triangle_bounds[m_triangle_indices[index]]);
+	}
+
+	t_node.bounds_min = bounds.min;
+	t_node.bounds_max = bounds.max;
+}
+
+tnt::graphics::cpu::Bvh::SplitCandidate tnt::graphics::cpu::Bvh::FindBestSplit(const BvhNode& t_node, std::uint32_t t_thread_count)
+{
+	struct Bin
+	{
+		Aabb bounds;
+		std::uint32_t count;
+	};
+
+	SplitCandidate best_split = { false, 0, 0, std::numeric_limits<float>::infinity(), 0.0f, 0.0f };
+
+	const std::uint32_t bin_count = m_settings.bin_count;
+	const std::uint32_t chunk_count = (t_node.triangle_count + BINNING_CHUNK_SIZE - 1) / BINNING_CHUNK_SIZE;
+
+	// Bins are placed over the centroid bounds, not the node bounds
+	std::vector<Aabb> chunk_centroid_bounds(chunk_count, CreateEmptyAabb());
+
+	ParallelFor(m_thread_pool, chunk_count, t_thread_count, [&](std::uint32_t t_chunk)
+	{
+		const std::uint32_t begin = t_node.left_first + t_chunk * BINNING_CHUNK_SIZE;
+		const std::uint32_t end = std::min(begin + BINNING_CHUNK_SIZE, t_node.left_first + t_node.triangle_count);
+
+		for (std::uint32_t index = begin; index < end; ++index)
+		{
+			chunk_centroid_bounds[t_chunk].Grow(m_triangle_centroids[m_triangle_indices[index]]);
+		}
+	});
+
+	Aabb centroid_bounds = CreateEmptyAabb();
+
+	for (const Aabb& bounds : chunk_centroid_bounds)
+	{
+		centroid_bounds.Grow(bounds);
+	}
+
+	SplitCandidate candidates[3] = {};
+
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		const float extent = centroid_bounds.max[axis] - centroid_bounds.min[axis];
+		candidates[axis] = { extent > 0.0f, axis, 0, 0.0f, centroid_bounds.min[axis], (extent > 0.0f) ? static_cast<float>(bin_count) / extent : 0.0f };
+	}
+
+	// Every chunk fills its own bins for all three axes, the chunks are merged in order afterwards
+	std::vector<Bin> chunk_bins(static_cast<size_t>(chunk_count) * 3 * bin_count, { CreateEmptyAabb(), 0 });
+
+	ParallelFor(m_thread_pool, chunk_count, t_thread_count, [&](std::uint32_t t_chunk)
+	{
+		const std::uint32_t begin = t_node.left_first + t_chunk * BINNING_CHUNK_SIZE;
+		const std::uint32_t end = std::min(begin + BINNING_CHUNK_SIZE, t_node.left_first + t_node.triangle_count);
+		Bin* bins = &chunk_bins[static_cast<size_t>(t_chunk) * 3 * bin_count];
+
+		for (std::uint32_t index = begin; index < end; ++index)
+		{
+			const std::uint32_t triangle_index = m_triangle_indices[index];
+
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				if (candidates[axis].is_valid)
+				{
+					Bin& bin = bins[axis * bin_count + GetBinIndex(candidates[axis], triangle_index)];
+					bin.bounds.Grow(m_triangle_bounds[triangle_index]);
+					++bin.count;
+				}
+			}
+		}
+	});
+
+	std::vector<Bin> bins(3 * bin_count, { CreateEmptyAabb(), 0 });
+
+	for (std::uint32_t chunk = 0; chunk < chunk_count; ++chunk)
+	{
+		for (std::uint32_t bin = 0; bin < 3 * bin_count; ++bin)
+		{
+			const Bin& chunk_bin = chunk_bins[static_cast<size_t>(chunk) * 3 * bin_count + bin];
+			bins[bin].bounds.Grow(chunk_bin.bounds);
+			bins[bin].count += chunk_bin.count;
+		}
+	}
+
+	std::vector<float> left_areas(bin_count - 1);
+	std::vector<std::uint32_t> left_counts(bin_count - 1);
+
+	Aabb node_bounds = { t_node.bounds_min, t_node.bounds_max };
+	const float node_area = node_bounds.GetSurfaceArea();
+
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		if (!candidates[axis].is_valid)
+		{
+			continue;
+		}
+
+		const Bin* axis_bins = &bins[axis * bin_count];
+
+		// Sweep from the left, then evaluate every plane while sweeping from the right
+		Aabb left_bounds = CreateEmptyAabb();
+		std::uint32_t left_count = 0;
+
+		for (std::uint32_t plane = 0; plane < bin_count - 1; ++plane)
+		{
+			left_bounds.Grow(axis_bins[plane].bounds);
+			left_count += axis_bins[plane].count;
+			left_areas[plane] = left_bounds.GetSurfaceArea();
+			left_counts[plane] = left_count;
+		}
+
+		Aabb right_bounds = CreateEmptyAabb();
+		std::uint32_t right_count = 0;
+
+		for (std::uint32_t plane = bin_count - 1; plane > 0; --plane)
+		{
+			right_bounds.Grow(axis_bins[plane].bounds);
+			right_count += axis_bins[plane].count;
+
+			if (left_counts[plane - 1] == 0 || right_count == 0)
+			{
+				continue;
+			}
+
+			const float cost = m_settings.traversal_cost + m_settings.intersection_cost *
+				(left_counts[plane - 1] * left_areas[plane - 1] + right_count * right_bounds.GetSurfaceArea()) / node_area;
+
+			if (cost < best_split.cost)
+			{
+				best_split = candidates[axis];
+				best_split.bin = plane;
+				best_split.cost = cost;
+			}
+		}
+	}
+
+	return best_split;
+}
+
+std::uint32_t tnt::graphics::cpu::Bvh::Partition(const BvhNode& t_node, const SplitCandidate& t_split)
+{
+	std::uint32_t left = t_node.left_first;
+	std::uint32_t right = t_node.left_first + t_node.triangle_count;
+
+	while (left < right)
+	{
+		if (GetBinIndex(t_split, m_triangle_indices[left]) < t_split.bin)
+		{
+			++left;
+		}
+		else
+		{
+			std::swap(m_triangle_indices[left], m_triangle_indices[--right]);
+		}
+	}
+
+	return left - t_node.left_first;
+}
+
+std::uint32_t tnt::graphics::cpu::Bvh::GetBinIndex(const SplitCandidate& t_split, std::uint32_t t_triangle_index) const
+{
+	const float position = m_triangle_centroids[t_triangle_index][t_split.axis];
+	const std::uint32_t bin = static_cast<std::uint32_t>((position - t_split.centroid_min) * t_split.bin_scale);
+
+	return std::min(bin, m_settings.bin_count - 1);
+}
@@ -0,0 +1,82 @@
+#include "Renderer/CPU/Framebuffer.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+	std::uint8_t ToUNorm8(float t_value)
+	{
+		float clamped = std::min(std::max(t_value, 0.0f), 1.0f);
+		return static_cast<std::uint8_t>(clamped * 255.0f + 0.5f);
+	}
+}
+
+tnt::graphics::cpu::Framebuffer::Framebuffer()
+	: m_width(0)
+	, m_height(0)
+{
+}
+
+tnt::graphics::cpu::Framebuffer::~Framebuffer()
+{
+}
+
+void tnt::graphics::cpu::Framebuffer::Initialize(std::uint32_t t_width, std::uint32_t t_height)
+{
+	m_width = t_width;
+	m_height = t_height;
+	m_pixels.assign(static_cast<size_t>(t_width) * t_height * 4, 0);
+}
+
+void tnt::graphics::cpu::Framebuffer::Clear(const Float4& t_color)
+{
+	for (std::uint32_t y = 0; y < m_height; ++y)
+	{
+		for (std::uint32_t x = 0; x < m_width; ++x)
+		{
+			SetPixel(x, y, t_color);
+		}
+	}
+}
+
+void tnt::graphics::cpu::Framebuffer::SetPixel(std::uint32_t t_x, std::uint32_t t_y, const Float4& t_color)
+{
+	std::uint8_t* pixel = &m_pixels[(static_cast<size_t>(t_y) * m_width + t_x) * 4];
+	pixel[0] = ToUNorm8(t_color.x);
+	pixel[1] = ToUNorm8(t_color.y);
+	pixel[2] = ToUNorm8(t_color.z);
+	pixel[3] = ToUNorm8(t_color.w);
+}
+
+void tnt::graphics::cpu::Framebuffer::SaveAsPPM(const std::string& t_path) const
+{
+	std::ofstream file(t_path, std::ios::binary);
+
+	if (!file)
+	{
+		throw std::runtime_error("Could not open " + t_path + " for writing");
+	}
+
+	file << "P6\n" << m_width << " " << m_height << "\n255\n";
+
+	for (size_t index = 0; index < m_pixels.size(); index += 4)
+	{
+		file.write(reinterpret_cast<const char*>(&m_pixels[index]), 3);
+	}
+}
+
+std::uint32_t tnt::graphics::cpu::Framebuffer::GetWidth() const
+{
+	return m_width;
+}
+
+std::uint32_t tnt::graphics::cpu::Framebuffer::GetHeight() const
+{
+	return m_height;
+}
+
+const std::uint8_t* tnt::graphics::cpu::Framebuffer::GetPixelData() const
+{
+	return m_pixels.data();
+}
@@ -0,0 +1,301 @@
+#include "Renderer/CPU/RayPacket.hpp"
+
+#include <cassert>
+
+namespace
+{
+	using tnt::graphics::cpu::Float3;
+	using tnt::graphics::cpu::RAY_PACKET_SIZE;
+
+	std::uint32_t GetOctant(const Float3& t_direction)
+	{
+		return ((t_direction.x < 0.0f) ? 1u : 0u) | ((t_direction.y < 0.0f) ? 2u : 0u) | ((t_direction.z < 0.0f) ? 4u : 0u);
+	}
+
+	// Conservative bounds of all ray origins and inverse directions in a packet
+	struct PacketFrustum
+	{
+		Float3 origin_min;
+		Float3 origin_max;
+		Float3 inverse_direction_min;
+		Float3 inverse_direction_max;
+		bool is_negative[3];
+		float t_min;
+	};
+
+	// Interval arithmetic: returns false only if no ray in the packet can intersect the bounds
+	bool FrustumIntersectsBounds(const PacketFrustum& t_frustum, const Float3& t_bounds_min, const Float3& t_bounds_max, float t_t_max)
+	{
+		float t_entry = t_frustum.t_min;
+		float t_exit = t_t_max;
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			// Rays moving in the negative direction enter through the max plane
+			const float entry_plane = t_frustum.is_negative[axis] ? t_bounds_max[axis] : t_bounds_min[axis];
+			const float exit_plane = t_frustum.is_negative[axis] ? t_bounds_min[axis] : t_bounds_max[axis];
+
+			const float entry_low = entry_plane - t_frustum.origin_max[axis];
+			const float entry_high = entry_plane - t_frustum.origin_min[axis];
+			const float exit_low = exit_plane - t_frustum.origin_max[axis];
+			const float exit_high = exit_plane - t_frustum.origin_min[axis];
+
+			const float inverse_low = t_frustum.inverse_direction_min[axis];
+			const float inverse_high = t_frustum.inverse_direction_max[axis];
+
+			// Smallest possible entry distance and largest possible exit distance of any ray on this axis
+			const float axis_entry = std::min(std::min(entry_low * inverse_low, entry_low * inverse_high), std::min(entry_high * inverse_low, entry_high * inverse_high));
+			const float axis_exit = std::max(std::max(exit_low * inverse_low, exit_low * inverse_high), std::max(exit_high * inverse_low, exit_high * inverse_high));
+
+			t_entry = std::max(t_entry, axis_entry);
+			t_exit = std::min(t_exit, axis_exit);
+		}
+
+		return t_entry <= t_exit;
+	}
+
+	bool RayIntersectsBounds(const Float3& t_origin, const Float3& t_inverse_direction, float t_t_min, float t_t_max, const Float3& t_bounds_min, const Float3& t_bounds_max)
+	{
+		float t_entry = t_t_min;
+		float t_exit = t_t_max;
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			const float t1 = (t_bounds_min[axis] - t_origin[axis]) * t_inverse_direction[axis];
+			const float t2 = (t_bounds_max[axis] - t_origin[axis]) * t_inverse_direction[axis];
+
+			t_entry = std::max(t_entry, std::min(t1, t2));
+			t_exit = std::min(t_exit, std::max(t1, t2));
+		}
+
+		return t_entry <= t_exit;
+	}
+}
+
+const char* tnt::graphics::cpu::GetTraversalModeName(TraversalMode t_mode)
+{
+	switch (t_mode)
+	{
+	case TraversalMode::SingleRay:
+		return "single";
+
+	case TraversalMode::Packet:
+		return "packet";
+
+	case TraversalMode::Stream:
+		return "stream";
+	}
+
+	return "unknown";
+}
+
+void tnt::graphics::cpu::IntersectPacket(const Bvh& t_bvh, const RayPacket& t_packet, Hit* t_hits)
+{
+	const std::vector<BvhNode>& nodes = t_bvh.GetNodes();
+	const TriangleBlocks<4>& triangle_blocks = t_bvh.GetTriangleBlocks();
+
+	if (t_packet.ray_count == 0 || nodes.empty() || triangle_blocks.GetBlocks().empty())
+	{
+		return;
+	}
+
+	const float infinity = std::numeric_limits<float>::infinity();
+	const std::uint32_t octant = GetOctant(t_packet.rays[0].direction);
+
+	PacketFrustum frustum = {};
+	frustum.origin_min = { infinity, infinity, infinity };
+	frustum.origin_max = { -infinity, -infinity, -infinity };
+	frustum.inverse_direction_min = frustum.origin_min;
+	frustum.inverse_direction_max = frustum.origin_max;
+	frustum.t_min = infinity;
+
+	Float3 inverse_directions[RAY_PACKET_SIZE];
+	WatertightRay watertight_rays[RAY_PACKET_SIZE];
+
+	for (std::uint32_t index = 0; index < t_packet.ray_count; ++index)
+	{
+		const Ray& ray = t_packet.rays[index];
+
+		// Interval arithmetic only holds when all rays move in the same direction on every axis
+		if (GetOctant(ray.direction) != octant)
+		{
+			for (std::uint32_t ray_index = 0; ray_index < t_packet.ray_count; ++ray_index)
+			{
+				t_bvh.Intersect(t_packet.rays[ray_index], t_hits[ray_index]);
+			}
+
+			return;
+		}
+
+		inverse_directions[index] = ComputeInverseDirection(ray.direction);
+		watertight_rays[index] = CreateWatertightRay(ray);
+
+		frustum.origin_min = Min(frustum.origin_min, ray.origin);
+		frustum.origin_max = Max(frustum.origin_max, ray.origin);
+		frustum.inverse_direction_min = Min(frustum.inverse_direction_min, inverse_directions[index]);
+		frustum.inverse_direction_max = Max(frustum.inverse_direction_max, inverse_directions[index]);
+		frustum.t_min = std::min(frustum.t_min, ray.t_min);
+	}
+
+	frustum.is_negative[0] = (octant & 1u) != 0;
+	frustum.is_negative[1] = (octant & 2u) != 0;
+	frustum.is_negative[2] = (octant & 4u) != 0;
+
+	// Farthest distance any ray in the packet still cares about, shrinks as hits are found
+	auto compute_packet_t_max = [&]()
+	{
+		float t_max = -infinity;
+
+		for (std::uint32_t index = 0; index < t_packet.ray_count; ++index)
+		{
+			t_max = std::max(t_max, std::min(t_packet.rays[index].t_max, t_hits[index].t));
+		}
+
+		return t_max;
+	};
+
+	float packet_t_max = compute_packet_t_max();
+
+	// Each stack entry remembers the first ray that was still active in its parent, rays before it already missed
+	struct StackEntry
+	{
+		std::uint32_t node_index;
+		std::uint32_t first_active;
+	};
+
+	// Both children are pushed, so one sibling per level plus the pair just pushed
+	StackEntry stack[MAX_BVH_DEPTH + 1];
+	std::uint32_t stack_size = 0;
+	stack[stack_size++] = { 0, 0 };
+
+	while (stack_size > 0)
+	{
+		const StackEntry entry = stack[--stack_size];
+		const BvhNode& node = nodes[entry.node_index];
+
+		if (!FrustumIntersectsBounds(frustum, node.bounds_min, node.bounds_max, packet_t_max))
+		{
+			continue;
+		}
+
+		// The frustum is conservative, find the first ray that really enters the node
+		std::uint32_t first_active = entry.first_active;
+
+		while (first_active < t_packet.ray_count)
+		{
+			const Ray& ray = t_packet.rays[first_active];
+
+			if (RayIntersectsBounds(ray.origin, inverse_directions[first_active], ray.t_min, std::min(ray.t_max, t_hits[first_active].t), node.bounds_min, node.bounds_max))
+			{
+				break;
+			}
+
+			++first_active;
+		}
+
+		if (first_active == t_packet.ray_count)
+		{
+			continue;
+		}
+
+		if (node.triangle_count > 0)
+		{
+			for (std::uint32_t index = first_active; index < t_packet.ray_count; ++index)
+			{
+				const Ray& ray = t_packet.rays[index];
+				Hit& hit = t_hits[index];
+
+				if (index != first_active && !RayIntersectsBounds(ray.origin, inverse_directions[index], ray.t_min, std::min(ray.t_max, hit.t), node.bounds_min, node.bounds_max))
+				{
+					continue;
+				}
+
+				triangle_blocks.Intersect(watertight_rays[index], node.left_first, node.triangle_count, hit);
+			}
+
+			packet_t_max = compute_packet_t_max();
+			continue;
+		}
+
+		// Front to back along the common direction of the packet, the near child is popped first
+		const BvhNode& left = nodes[node.left_first];
+		const BvhNode& right = nodes[node.left_first + 1];
+		const Float3 center_delta = (right.bounds_min + right.bounds_max) - (left.bounds_min + left.bounds_max);
+		const float right_is_farther = Dot(center_delta, t_packet.rays[0].direction);
+
+		assert(stack_size + 2 <= MAX_BVH_DEPTH + 1);
+
+		if (right_is_farther >= 0.0f)
+		{
+			stack[stack_size++] = { node.left_first + 1, first_active };
+			stack[stack_size++] = { node.left_first, first_active };
+		}
+		else
+		{
+			stack[stack_size++] = { node.left_first, first_active };
+			stack[stack_size++] = { node.left_first + 1, first_active };
+		}
+	}
+}
+
+void tnt::graphics::cpu::IntersectStream(const Bvh& t_bvh, const std::vector<Ray>& t_rays, std::vector<Hit>& t_hits)
+{
+	const std::uint32_t ray_count = static_cast<std::uint32_t>(t_rays.size());
+
+	t_hits.assign(ray_count, CreateEmptyHit());
+
+	// Counting sort by octant, stable so neighbouring rays stay together within an octant
+	std::uint32_t octant_offsets[9] = {};
+
+	for (const Ray& ray : t_rays)
+	{
+		++octant_offsets[GetOctant(ray.direction) + 1];
+	}
+
+	for (std::uint32_t octant = 0; octant < 8; ++octant)
+	{
+		octant_offsets[octant + 1] += octant_offsets[octant];
+	}
+
+	const std::uint32_t octant_ends[8] =
+	{
+		octant_offsets[1], octant_offsets[2], octant_offsets[3], octant_offsets[4],
+		octant_offsets[5], octant_offsets[6], octant_offsets[7], octant_offsets[8]
+	};
+
+	std::vector<std::uint32_t> sorted_indices(ray_count);
+
+	for (std::uint32_t index = 0; index < ray_count; ++index)
+	{
+		sorted_indices[octant_offsets[GetOctant(t_rays[index].direction)]++] = index;
+	}
+
+	// Packets never cross an octant boundary
+	std::uint32_t begin = 0;
+
+	for (std::uint32_t octant = 0; octant < 8; ++octant)
+	{
+		while (begin < octant_ends[octant])
+		{
+			RayPacket packet = {};
+			packet.ray_count = std::min(RAY_PACKET_SIZE, octant_ends[octant] - begin);
+
+			Hit hits[RAY_PACKET_SIZE];
+
+			for (std::uint32_t index = 0; index < packet.ray_count; ++index)
+			{
+				packet.rays[index] = t_rays[sorted_indices[begin + index]];
+				hits[index] = CreateEmptyHit();
+			}
+
+			IntersectPacket(t_bvh, packet, hits);
+
+			for (std::uint32_t index = 0; index < packet.ray_count; ++index)
+			{
+				t_hits[sorted_indices[begin + index]] = hits[index];
+			}
+
+			begin += packet.ray_count;
+		}
+	}
+}
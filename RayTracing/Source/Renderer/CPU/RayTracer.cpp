@@ -0,0 +1,542 @@
+#include "Renderer/CPU/RayTracer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace
+{
+	// Van der Corput sequence in the given base, the Halton sequence uses one prime base per dimension
+	float RadicalInverse(std::uint32_t t_index, std::uint32_t t_base)
+	{
+		const float inverse_base = 1.0f / static_cast<float>(t_base);
+
+		float result = 0.0f;
+		float digit_weight = inverse_base;
+
+		for (std::uint32_t index = t_index; index > 0; index /= t_base)
+		{
+			result += static_cast<float>(index % t_base) * digit_weight;
+			digit_weight *= inverse_base;
+		}
+
+		return result;
+	}
+}
+
+double tnt::graphics::cpu::RenderStatistics::GetRaysPerSecond() const
+{
+	return (render_seconds > 0.0) ? static_cast<double>(ray_count) / render_seconds : 0.0;
+}
+
+double tnt::graphics::cpu::RenderStatistics::GetRaysPerSecondPerCore() const
+{
+	return (thread_count > 0) ? GetRaysPerSecond() / thread_count : 0.0;
+}
+
+tnt::graphics::cpu::RayTracer::RayTracer()
+	: m_tile_size(32)
+	, m_clear_color({ 0.0f, 0.0f, 0.0f, 0.0f })
+	, m_traversal_kernel(TraversalKernel::Binary)
+	, m_traversal_mode(TraversalMode::SingleRay)
+	, m_pixel_size({ 0.0f, 0.0f })
+	, m_sample_offset({ 0.5f, 0.5f })
+	, m_accumulated_scene_data({})
+	, m_accumulation_valid(false)
+	, m_sample_index(0)
+	, m_statistics({ 0, 0.0, 0, 0, 0, 0, 0 })
+{
+}
+
+tnt::graphics::cpu::RayTracer::~RayTracer()
+{
+}
+
+void tnt::graphics::cpu::RayTracer::Initialize(std::uint32_t t_thread_count)
+{
+	m_thread_pool.Initialize(t_thread_count);
+}
+
+void tnt::graphics::cpu::RayTracer::Cleanup()
+{
+	m_thread_pool.Cleanup();
+}
+
+void tnt::graphics::cpu::RayTracer::SetScene(const std::vector<Vertex>& t_vertices, const BvhBuildSettings& t_bvh_settings)
+{
+	// The vertices are already in clip space with w = 1, exactly what the vertex shader expects
+	m_bvh.Build(t_vertices, t_bvh_settings);
+	m_accumulation_valid = false;
+
+	// Stale wide BVHs are rebuilt from the new binary BVH
+	m_wide_bvh_4 = WideBvh<4>();
+	m_wide_bvh_8 = WideBvh<8>();
+	SetTraversalKernel(m_traversal_kernel);
+
+	m_texcoords.clear();
+	m_texcoords.reserve(t_vertices.size());
+
+	for (const Vertex& vertex : t_vertices)
+	{
+		m_texcoords.push_back({ vertex.texcoord.x, vertex.texcoord.y });
+	}
+
+	// The projection is orthographic, so what ddx(uv) and ddy(uv) return on the GPU is constant per triangle
+	m_texture_gradients.clear();
+	m_texture_gradients.reserve(t_vertices.size() / 3);
+
+	for (size_t index = 0; index + 2 < t_vertices.size(); index += 3)
+	{
+		const Float2 edge_one = { t_vertices[index + 1].position.x - t_vertices[index].position.x, t_vertices[index + 1].position.y - t_vertices[index].position.y };
+		const Float2 edge_two = { t_vertices[index + 2].position.x - t_vertices[index].position.x, t_vertices[index + 2].position.y - t_vertices[index].position.y };
+		const Float2 delta_one = { m_texcoords[index + 1].x - m_texcoords[index].x, m_texcoords[index + 1].y - m_texcoords[index].y };
+		const Float2 delta_two = { m_texcoords[index + 2].x - m_texcoords[index].x, m_texcoords[index + 2].y - m_texcoords[index].y };
+
+		const float determinant = edge_one.x * edge_two.y - edge_one.y * edge_two.x;
+		const float inverse_determinant = (determinant != 0.0f) ? 1.0f / determinant : 0.0f;
+
+		TextureGradients gradients = {};
+		gradients.per_clip_x.x = (delta_one.x * edge_two.y - delta_two.x * edge_one.y) * inverse_determinant;
+		gradients.per_clip_x.y = (delta_one.y * edge_two.y - delta_two.y * edge_one.y) * inverse_determinant;
+		gradients.per_clip_y.x = (delta_two.x * edge_one.x - delta_one.x * edge_two.x) * inverse_determinant;
+		gradients.per_clip_y.y = (delta_two.y * edge_one.x - delta_one.y * edge_two.x) * inverse_determinant;
+
+		m_texture_gradients.push_back(gradients);
+	}
+}
+
+void tnt::graphics::cpu::RayTracer::LoadTexture(const std::string& t_path, std::uint32_t t_mip_count, TextureLayout t_layout, const MipGeneratorSettings& t_mip_settings, TextureFormat t_format)
+{
+	m_texture.LoadFromFile(t_path, t_mip_count, t_layout, t_mip_settings, t_format);
+	m_accumulation_valid = false;
+}
+
+void tnt::graphics::cpu::RayTracer::SetSampler(const SamplerDesc& t_desc)
+{
+	m_sampler.Initialize(t_desc);
+	m_accumulation_valid = false;
+}
+
+const tnt::graphics::cpu::SamplerDesc& tnt::graphics::cpu::RayTracer::GetSampler() const
+{
+	return m_sampler.GetDesc();
+}
+
+void tnt::graphics::cpu::RayTracer::SetClearColor(const Float4& t_clear_color)
+{
+	m_clear_color = t_clear_color;
+	m_accumulation_valid = false;
+}
+
+void tnt::graphics::cpu::RayTracer::SetTraversalKernel(TraversalKernel t_kernel)
+{
+	m_traversal_kernel = ResolveTraversalKernel(t_kernel);
+
+	if (m_traversal_kernel == TraversalKernel::Wide4Sse && m_wide_bvh_4.GetNodes().empty())
+	{
+		m_wide_bvh_4.Build(m_bvh);
+	}
+	else if (m_traversal_kernel == TraversalKernel::Wide8Avx2 && m_wide_bvh_8.GetNodes().empty())
+	{
+		m_wide_bvh_8.Build(m_bvh);
+	}
+}
+
+tnt::graphics::cpu::TraversalKernel tnt::graphics::cpu::RayTracer::GetTraversalKernel() const
+{
+	return m_traversal_kernel;
+}
+
+void tnt::graphics::cpu::RayTracer::SetTraversalMode(TraversalMode t_mode)
+{
+	m_traversal_mode = t_mode;
+}
+
+tnt::graphics::cpu::TraversalMode tnt::graphics::cpu::RayTracer::GetTraversalMode() const
+{
+	return m_traversal_mode;
+}
+
+void tnt::graphics::cpu::RayTracer::SetTileSize(std::uint32_t t_tile_size)
+{
+	m_tile_size = std::max(t_tile_size, 1u);
+}
+
+std::uint32_t tnt::graphics::cpu::RayTracer::GetTileSize() const
+{
+	return m_tile_size;
+}
+
+void tnt::graphics::cpu::RayTracer::SetAccumulation(const AccumulationSettings& t_settings)
+{
+	m_accumulation_buffer.SetSettings(t_settings);
+	m_accumulation_valid = false;
+}
+
+const tnt::graphics::cpu::AccumulationSettings& tnt::graphics::cpu::RayTracer::GetAccumulation() const
+{
+	return m_accumulation_buffer.GetSettings();
+}
+
+void tnt::graphics::cpu::RayTracer::ResetAccumulation()
+{
+	m_accumulation_valid = false;
+}
+
+const tnt::graphics::cpu::AccumulationBuffer& tnt::graphics::cpu::RayTracer::GetAccumulationBuffer() const
+{
+	return m_accumulation_buffer;
+}
+
+void tnt::graphics::cpu::RayTracer::Render(const SceneConstantBufferData& t_scene_data, Framebuffer& t_framebuffer)
+{
+	auto start_time = std::chrono::high_resolution_clock::now();
+
+	const std::uint32_t width = t_framebuffer.GetWidth();
+	const std::uint32_t height = t_framebuffer.GetHeight();
+	const std::uint32_t tile_count_x = (width + m_tile_size - 1) / m_tile_size;
+	const std::uint32_t tile_count_y = (height + m_tile_size - 1) / m_tile_size;
+
+	m_pixel_size = { 2.0f / static_cast<float>(width), 2.0f / static_cast<float>(height) };
+
+	BeginAccumulation(t_scene_data, width, height);
+
+	m_tile_statistics.resize(static_cast<size_t>(tile_count_x) * tile_count_y);
+
+	for (std::uint32_t tile_y = 0; tile_y < tile_count_y; ++tile_y)
+	{
+		for (std::uint32_t tile_x = 0; tile_x < tile_count_x; ++tile_x)
+		{
+			TileStatistics& tile = m_tile_statistics[tile_y * tile_count_x + tile_x];
+			tile.x = tile_x * m_tile_size;
+			tile.y = tile_y * m_tile_size;
+			tile.width = std::min(m_tile_size, width - tile.x);
+			tile.height = std::min(m_tile_size, height - tile.y);
+			tile.seconds = 0.0;
+			tile.worker_index = 0;
+			tile.ray_count = 0;
+		}
+	}
+
+	// Every task writes only its own tile statistics, framebuffer pixels and accumulated pixels
+	m_thread_pool.Run(static_cast<std::uint32_t>(m_tile_statistics.size()), [&](std::uint32_t t_tile_index, std::uint32_t t_worker_index)
+	{
+		TileStatistics& tile = m_tile_statistics[t_tile_index];
+		auto tile_start_time = std::chrono::high_resolution_clock::now();
+
+		RenderTile(tile, t_scene_data, t_framebuffer);
+
+		auto tile_end_time = std::chrono::high_resolution_clock::now();
+
+		tile.seconds = std::chrono::duration<double>(tile_end_time - tile_start_time).count();
+		tile.worker_index = t_worker_index;
+	});
+
+	auto end_time = std::chrono::high_resolution_clock::now();
+
+	m_statistics.ray_count = 0;
+
+	for (const TileStatistics& tile : m_tile_statistics)
+	{
+		m_statistics.ray_count += tile.ray_count;
+	}
+
+	m_statistics.render_seconds = std::chrono::duration<double>(end_time - start_time).count();
+	m_statistics.thread_count = m_thread_pool.GetThreadCount();
+	m_statistics.tile_count = static_cast<std::uint32_t>(m_tile_statistics.size());
+	m_statistics.steal_count = m_thread_pool.GetStealCount();
+	m_statistics.sample_index = 0;
+	m_statistics.converged_pixel_count = 0;
+
+	if (m_accumulation_buffer.GetSettings().enabled)
+	{
+		m_statistics.sample_index = m_sample_index++;
+		m_statistics.converged_pixel_count = m_accumulation_buffer.GetConvergedPixelCount();
+	}
+}
+
+const tnt::graphics::cpu::RenderStatistics& tnt::graphics::cpu::RayTracer::GetStatistics() const
+{
+	return m_statistics;
+}
+
+const std::vector<tnt::graphics::cpu::TileStatistics>& tnt::graphics::cpu::RayTracer::GetTileStatistics() const
+{
+	return m_tile_statistics;
+}
+
+const tnt::graphics::cpu::BvhBuildStatistics& tnt::graphics::cpu::RayTracer::GetBvhBuildStatistics() const
+{
+	return m_bvh.GetBuildStatistics();
+}
+
+void tnt::graphics::cpu::RayTracer::RenderTile(
+	TileStatistics& t_tile,
+	const SceneConstantBufferData& t_scene_data,
+	Framebuffer& t_framebuffer)
+{
+	const std::uint32_t width = t_framebuffer.GetWidth();
+	const std::uint32_t height = t_framebuffer.GetHeight();
+	const std::uint32_t end_x = t_tile.x + t_tile.width;
+	const std::uint32_t end_y = t_tile.y + t_tile.height;
+
+	if (m_traversal_mode == TraversalMode::Packet)
+	{
+		for (std::uint32_t y = t_tile.y; y < end_y; y += RAY_PACKET_HEIGHT)
+		{
+			for (std::uint32_t x = t_tile.x; x < end_x; x += RAY_PACKET_WIDTH)
+			{
+				t_tile.ray_count += RenderPacket(x, y, end_x, end_y, t_scene_data, t_framebuffer);
+			}
+		}
+
+		return;
+	}
+
+	if (m_traversal_mode == TraversalMode::Stream)
+	{
+		t_tile.ray_count += RenderStream(t_tile, t_scene_data, t_framebuffer);
+		return;
+	}
+
+	for (std::uint32_t y = t_tile.y; y < end_y; ++y)
+	{
+		for (std::uint32_t x = t_tile.x; x < end_x; ++x)
+		{
+			if (!NeedsSample(x, y))
+			{
+				continue;
+			}
+
+			Ray ray = CreatePrimaryRay(x, y, width, height, t_scene_data);
+			Hit hit = CreateEmptyHit();
+
+			IntersectScene(ray, hit);
+			StorePixel(x, y, ShadeOrClear(hit), t_framebuffer);
+
+			t_tile.ray_count++;
+		}
+	}
+}
+
+std::uint32_t tnt::graphics::cpu::RayTracer::RenderPacket(
+	std::uint32_t t_x,
+	std::uint32_t t_y,
+	std::uint32_t t_end_x,
+	std::uint32_t t_end_y,
+	const SceneConstantBufferData& t_scene_data,
+	Framebuffer& t_framebuffer)
+{
+	const std::uint32_t width = t_framebuffer.GetWidth();
+	const std::uint32_t height = t_framebuffer.GetHeight();
+
+	RayPacket packet = {};
+	Hit hits[RAY_PACKET_SIZE];
+	std::uint32_t pixels[RAY_PACKET_SIZE][2];
+
+	// Blocks on the right and bottom edge of a tile can be partially outside of it, converged pixels leave gaps
+	for (std::uint32_t y = t_y; y < std::min(t_y + RAY_PACKET_HEIGHT, t_end_y); ++y)
+	{
+		for (std::uint32_t x = t_x; x < std::min(t_x + RAY_PACKET_WIDTH, t_end_x); ++x)
+		{
+			if (!NeedsSample(x, y))
+			{
+				continue;
+			}
+
+			pixels[packet.ray_count][0] = x;
+			pixels[packet.ray_count][1] = y;
+			hits[packet.ray_count] = CreateEmptyHit();
+			packet.rays[packet.ray_count++] = CreatePrimaryRay(x, y, width, height, t_scene_data);
+		}
+	}
+
+	if (packet.ray_count == 0)
+	{
+		return 0;
+	}
+
+	IntersectPacket(m_bvh, packet, hits);
+
+	for (std::uint32_t index = 0; index < packet.ray_count; ++index)
+	{
+		StorePixel(pixels[index][0], pixels[index][1], ShadeOrClear(hits[index]), t_framebuffer);
+	}
+
+	return packet.ray_count;
+}
+
+std::uint32_t tnt::graphics::cpu::RayTracer::RenderStream(
+	const TileStatistics& t_tile,
+	const SceneConstantBufferData& t_scene_data,
+	Framebuffer& t_framebuffer)
+{
+	const std::uint32_t width = t_framebuffer.GetWidth();
+	const std::uint32_t height = t_framebuffer.GetHeight();
+	const std::uint32_t end_x = t_tile.x + t_tile.width;
+	const std::uint32_t end_y = t_tile.y + t_tile.height;
+
+	// Rays are generated in 4x4 blocks, so rays that end up in one packet are also close on screen
+	std::vector<Ray> rays;
+	std::vector<Hit> hits;
+	rays.reserve(static_cast<size_t>(t_tile.width) * t_tile.height);
+
+	for (std::uint32_t block_y = t_tile.y; block_y < end_y; block_y += RAY_PACKET_HEIGHT)
+	{
+		for (std::uint32_t block_x = t_tile.x; block_x < end_x; block_x += RAY_PACKET_WIDTH)
+		{
+			for (std::uint32_t y = block_y; y < std::min(block_y + RAY_PACKET_HEIGHT, end_y); ++y)
+			{
+				for (std::uint32_t x = block_x; x < std::min(block_x + RAY_PACKET_WIDTH, end_x); ++x)
+				{
+					if (NeedsSample(x, y))
+					{
+						rays.push_back(CreatePrimaryRay(x, y, width, height, t_scene_data));
+					}
+				}
+			}
+		}
+	}
+
+	if (rays.empty())
+	{
+		return 0;
+	}
+
+	IntersectStream(m_bvh, rays, hits);
+
+	// A pixel only changes its own convergence when it is stored, so this loop skips the same pixels as the first one
+	std::uint32_t ray_index = 0;
+
+	for (std::uint32_t block_y = t_tile.y; block_y < end_y; block_y += RAY_PACKET_HEIGHT)
+	{
+		for (std::uint32_t block_x = t_tile.x; block_x < end_x; block_x += RAY_PACKET_WIDTH)
+		{
+			for (std::uint32_t y = block_y; y < std::min(block_y + RAY_PACKET_HEIGHT, end_y); ++y)
+			{
+				for (std::uint32_t x = block_x; x < std::min(block_x + RAY_PACKET_WIDTH, end_x); ++x)
+				{
+					if (NeedsSample(x, y))
+					{
+						StorePixel(x, y, ShadeOrClear(hits[ray_index++]), t_framebuffer);
+					}
+				}
+			}
+		}
+	}
+
+	return ray_index;
+}
+
+void tnt::graphics::cpu::RayTracer::BeginAccumulation(const SceneConstantBufferData& t_scene_data, std::uint32_t t_width, std::uint32_t t_height)
+{
+	if (!m_accumulation_buffer.GetSettings().enabled)
+	{
+		m_sample_offset = { 0.5f, 0.5f };
+		return;
+	}
+
+	// The constant buffer is plain data, any changed byte moves the scene
+	const bool scene_data_changed = std::memcmp(&t_scene_data, &m_accumulated_scene_data, sizeof(SceneConstantBufferData)) != 0;
+	const bool size_changed = m_accumulation_buffer.GetWidth() != t_width || m_accumulation_buffer.GetHeight() != t_height;
+
+	if (!m_accumulation_valid || scene_data_changed || size_changed)
+	{
+		m_accumulation_buffer.Initialize(t_width, t_height);
+		m_accumulated_scene_data = t_scene_data;
+		m_accumulation_valid = true;
+		m_sample_index = 0;
+	}
+
+	// The first sample is the pixel center, so a single sample matches the rasterizer, the rest follow a Halton (2, 3) sequence
+	if (m_sample_index == 0)
+	{
+		m_sample_offset = { 0.5f, 0.5f };
+	}
+	else
+	{
+		m_sample_offset = { RadicalInverse(m_sample_index, 2), RadicalInverse(m_sample_index, 3) };
+	}
+}
+
+bool tnt::graphics::cpu::RayTracer::NeedsSample(std::uint32_t t_x, std::uint32_t t_y) const
+{
+	return !m_accumulation_buffer.GetSettings().enabled || !m_accumulation_buffer.IsConverged(t_x, t_y);
+}
+
+void tnt::graphics::cpu::RayTracer::StorePixel(std::uint32_t t_x, std::uint32_t t_y, const Float4& t_color, Framebuffer& t_framebuffer)
+{
+	if (m_accumulation_buffer.GetSettings().enabled)
+	{
+		t_framebuffer.SetPixel(t_x, t_y, m_accumulation_buffer.AddSample(t_x, t_y, t_color));
+		return;
+	}
+
+	t_framebuffer.SetPixel(t_x, t_y, t_color);
+}
+
+tnt::graphics::cpu::Ray tnt::graphics::cpu::RayTracer::CreatePrimaryRay(
+	std::uint32_t t_x,
+	std::uint32_t t_y,
+	std::uint32_t t_width,
+	std::uint32_t t_height,
+	const SceneConstantBufferData& t_scene_data) const
+{
+	// Sample positions in normalized device coordinates, y points up like in D3D
+	float ndc_x = ((static_cast<float>(t_x) + m_sample_offset.x) / static_cast<float>(t_width)) * 2.0f - 1.0f;
+	float ndc_y = 1.0f - ((static_cast<float>(t_y) + m_sample_offset.y) / static_cast<float>(t_height)) * 2.0f;
+
+	// Moving the ray by the inverse offset is the same as moving the triangle in the vertex shader
+	Ray ray = {};
+	ray.origin = { ndc_x - t_scene_data.positionOffset.x, ndc_y - t_scene_data.positionOffset.y, -1.0f };
+	ray.direction = { 0.0f, 0.0f, 1.0f };
+	ray.t_min = 0.0f;
+	ray.t_max = std::numeric_limits<float>::infinity();
+
+	return ray;
+}
+
+bool tnt::graphics::cpu::RayTracer::IntersectScene(const Ray& t_ray, Hit& t_hit) const
+{
+	switch (m_traversal_kernel)
+	{
+	case TraversalKernel::Wide4Sse:
+		return m_wide_bvh_4.Intersect(t_ray, t_hit);
+
+	case TraversalKernel::Wide8Avx2:
+		return m_wide_bvh_8.Intersect(t_ray, t_hit);
+
+	default:
+		return m_bvh.Intersect(t_ray, t_hit);
+	}
+}
+
+tnt::graphics::cpu::Float4 tnt::graphics::cpu::RayTracer::ShadeOrClear(const Hit& t_hit) const
+{
+	return (t_hit.triangle_index == INVALID_TRIANGLE_INDEX) ? m_clear_color : Shade(t_hit);
+}
+
+tnt::graphics::cpu::Float4 tnt::graphics::cpu::RayTracer::Shade(const Hit& t_hit) const
+{
+	const Float2* texcoords = &m_texcoords[t_hit.triangle_index * 3];
+	const float w = 1.0f - t_hit.u - t_hit.v;
+
+	Float2 uv = {};
+	uv.x = texcoords[0].x * w + texcoords[1].x * t_hit.u + texcoords[2].x * t_hit.v;
+	uv.y = texcoords[0].y * w + texcoords[1].y * t_hit.u + texcoords[2].y * t_hit.v;
+
+	// A single mip level needs no LOD, which saves the log2 on the common path
+	float lod = 0.0f;
+
+	if (m_texture.GetMipCount() > 1)
+	{
+		const TextureGradients& gradients = m_texture_gradients[t_hit.triangle_index];
+		const Float2 ddx = { gradients.per_clip_x.x * m_pixel_size.x, gradients.per_clip_x.y * m_pixel_size.x };
+		const Float2 ddy = { gradients.per_clip_y.x * m_pixel_size.y, gradients.per_clip_y.y * m_pixel_size.y };
+
+		lod = m_sampler.ComputeLod(m_texture, ddx, ddy);
+	}
+
+	// Same as the pixel shader, simply return the texture color
+	return m_sampler.Sample(m_texture, uv, lod);
+}
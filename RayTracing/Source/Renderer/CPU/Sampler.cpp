@@ -0,0 +1,316 @@
+#include "Renderer/CPU/Sampler.hpp"
+
+#include "Utility/CpuFeatures.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(TNT_X86)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	using tnt::graphics::cpu::Float4;
+	using tnt::graphics::cpu::TextureAddressMode;
+
+	// Hardware filters with 8 bits of sub-texel precision, the weights are snapped to match
+	const float SUBTEXEL_STEPS = 256.0f;
+
+	// std::floor is a library call without SSE4.1, the coordinates are small enough for an integer round trip
+	std::int32_t FloorToInt(float t_value)
+	{
+		const std::int32_t truncated = static_cast<std::int32_t>(t_value);
+
+		return (static_cast<float>(truncated) > t_value) ? truncated - 1 : truncated;
+	}
+
+	float Floor(float t_value)
+	{
+		// Floats this large have no fractional part left
+		return (std::fabs(t_value) < 8388608.0f) ? static_cast<float>(FloorToInt(t_value)) : t_value;
+	}
+
+	float SnapToSubtexel(float t_weight)
+	{
+		return static_cast<float>(FloorToInt(t_weight * SUBTEXEL_STEPS)) / SUBTEXEL_STEPS;
+	}
+
+	// Large coordinates are brought back into a range where float to int conversion is exact
+	float ReduceCoordinate(float t_coordinate, TextureAddressMode t_mode)
+	{
+		switch (t_mode)
+		{
+		case TextureAddressMode::Wrap:
+			return t_coordinate - Floor(t_coordinate);
+
+		case TextureAddressMode::Mirror:
+			return t_coordinate - Floor(t_coordinate * 0.5f) * 2.0f;
+
+		case TextureAddressMode::Clamp:
+		case TextureAddressMode::Border:
+			return std::min(std::max(t_coordinate, -1.0f), 2.0f);
+		}
+
+		return t_coordinate;
+	}
+
+	// Returns false when the texel lies in the border
+	bool ResolveTexelCoordinate(std::int32_t t_coordinate, std::uint32_t t_size, TextureAddressMode t_mode, std::uint32_t& t_resolved)
+	{
+		const std::int32_t size = static_cast<std::int32_t>(t_size);
+
+		switch (t_mode)
+		{
+		case TextureAddressMode::Wrap:
+			t_resolved = static_cast<std::uint32_t>(((t_coordinate % size) + size) % size);
+			return true;
+
+		case TextureAddressMode::Mirror:
+		{
+			const std::int32_t period = size * 2;
+			const std::int32_t coordinate = ((t_coordinate % period) + period) % period;
+
+			t_resolved = static_cast<std::uint32_t>((coordinate < size) ? coordinate : period - 1 - coordinate);
+			return true;
+		}
+
+		case TextureAddressMode::Clamp:
+			t_resolved = static_cast<std::uint32_t>(std::min(std::max(t_coordinate, 0), size - 1));
+			return true;
+
+		case TextureAddressMode::Border:
+			t_resolved = static_cast<std::uint32_t>(t_coordinate);
+			return t_coordinate >= 0 && t_coordinate < size;
+		}
+
+		return false;
+	}
+
+	Float4 UnpackTexel(std::uint32_t t_texel)
+	{
+		const float inverse_255 = 1.0f / 255.0f;
+
+		return
+		{
+			static_cast<float>(t_texel & 0xFF) * inverse_255,
+			static_cast<float>((t_texel >> 8) & 0xFF) * inverse_255,
+			static_cast<float>((t_texel >> 16) & 0xFF) * inverse_255,
+			static_cast<float>(t_texel >> 24) * inverse_255
+		};
+	}
+
+	Float4 Lerp(const Float4& t_a, const Float4& t_b, float t_weight)
+	{
+		return t_a + (t_b - t_a) * t_weight;
+	}
+
+	// Quads are ordered top left, top right, bottom left, bottom right
+	Float4 BlendQuad(const Float4* t_colors, float t_weight_x, float t_weight_y)
+	{
+		const Float4 top = Lerp(t_colors[0], t_colors[1], t_weight_x);
+		const Float4 bottom = Lerp(t_colors[2], t_colors[3], t_weight_x);
+
+		return Lerp(top, bottom, t_weight_y);
+	}
+
+#if defined(TNT_X86)
+	// SSE2 only, unpacks all four texels at once and blends them in one register per texel
+	Float4 BlendTexelQuad(const std::uint32_t* t_texels, float t_weight_x, float t_weight_y)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(t_texels));
+		const __m128i top_16 = _mm_unpacklo_epi8(packed, zero);
+		const __m128i bottom_16 = _mm_unpackhi_epi8(packed, zero);
+		const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+
+		const __m128 top_left = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(top_16, zero)), scale);
+		const __m128 top_right = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(top_16, zero)), scale);
+		const __m128 bottom_left = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(bottom_16, zero)), scale);
+		const __m128 bottom_right = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(bottom_16, zero)), scale);
+
+		const __m128 weight_x = _mm_set1_ps(t_weight_x);
+		const __m128 top = _mm_add_ps(top_left, _mm_mul_ps(_mm_sub_ps(top_right, top_left), weight_x));
+		const __m128 bottom = _mm_add_ps(bottom_left, _mm_mul_ps(_mm_sub_ps(bottom_right, bottom_left), weight_x));
+		const __m128 result = _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bottom, top), _mm_set1_ps(t_weight_y)));
+
+		Float4 color;
+		_mm_storeu_ps(&color.x, result);
+
+		return color;
+	}
+#else
+	Float4 BlendTexelQuad(const std::uint32_t* t_texels, float t_weight_x, float t_weight_y)
+	{
+		const Float4 colors[4] = { UnpackTexel(t_texels[0]), UnpackTexel(t_texels[1]), UnpackTexel(t_texels[2]), UnpackTexel(t_texels[3]) };
+
+		return BlendQuad(colors, t_weight_x, t_weight_y);
+	}
+#endif
+}
+
+const char* tnt::graphics::cpu::GetSamplerFilterName(SamplerFilter t_filter)
+{
+	switch (t_filter)
+	{
+	case SamplerFilter::Point:
+		return "point";
+
+	case SamplerFilter::Bilinear:
+		return "bilinear";
+
+	case SamplerFilter::Trilinear:
+		return "trilinear";
+	}
+
+	return "unknown";
+}
+
+const char* tnt::graphics::cpu::GetTextureAddressModeName(TextureAddressMode t_mode)
+{
+	switch (t_mode)
+	{
+	case TextureAddressMode::Wrap:
+		return "wrap";
+
+	case TextureAddressMode::Mirror:
+		return "mirror";
+
+	case TextureAddressMode::Clamp:
+		return "clamp";
+
+	case TextureAddressMode::Border:
+		return "border";
+	}
+
+	return "unknown";
+}
+
+tnt::graphics::cpu::Sampler::Sampler()
+{
+}
+
+tnt::graphics::cpu::Sampler::~Sampler()
+{
+}
+
+void tnt::graphics::cpu::Sampler::Initialize(const SamplerDesc& t_desc)
+{
+	m_desc = t_desc;
+}
+
+float tnt::graphics::cpu::Sampler::ComputeLod(const Texture& t_texture, const Float2& t_ddx, const Float2& t_ddy) const
+{
+	const float width = static_cast<float>(t_texture.GetWidth());
+	const float height = static_cast<float>(t_texture.GetHeight());
+
+	// Isotropic footprint, the longer of the two derivative vectors in texels
+	const float ddx_x = t_ddx.x * width;
+	const float ddx_y = t_ddx.y * height;
+	const float ddy_x = t_ddy.x * width;
+	const float ddy_y = t_ddy.y * height;
+	const float rho_squared = std::max(ddx_x * ddx_x + ddx_y * ddx_y, ddy_x * ddy_x + ddy_y * ddy_y);
+
+	// log2(sqrt(x)) == 0.5 * log2(x), a zero footprint gives -infinity which the clamp takes care of
+	const float lod = 0.5f * std::log2(rho_squared) + m_desc.mip_lod_bias;
+
+	return std::min(std::max(lod, m_desc.min_lod), m_desc.max_lod);
+}
+
+tnt::graphics::cpu::Float4 tnt::graphics::cpu::Sampler::Sample(const Texture& t_texture, const Float2& t_uv, float t_lod) const
+{
+	const std::uint32_t mip_count = t_texture.GetMipCount();
+
+	if (mip_count == 0)
+	{
+		return m_desc.border_color;
+	}
+
+	const float max_mip = static_cast<float>(mip_count - 1);
+	const float lod = std::min(std::max(t_lod, 0.0f), max_mip);
+
+	if (m_desc.filter != SamplerFilter::Trilinear)
+	{
+		// Nearest mip, halfway rounds up
+		return SampleMip(t_texture, static_cast<std::uint32_t>(lod + 0.5f), t_uv);
+	}
+
+	const std::uint32_t mip = static_cast<std::uint32_t>(lod);
+	const float mip_weight = SnapToSubtexel(lod - static_cast<float>(mip));
+	const Float4 color = SampleMip(t_texture, mip, t_uv);
+
+	if (mip_weight == 0.0f)
+	{
+		return color;
+	}
+
+	return Lerp(color, SampleMip(t_texture, mip + 1, t_uv), mip_weight);
+}
+
+const tnt::graphics::cpu::SamplerDesc& tnt::graphics::cpu::Sampler::GetDesc() const
+{
+	return m_desc;
+}
+
+tnt::graphics::cpu::Float4 tnt::graphics::cpu::Sampler::SampleMip(const Texture& t_texture, std::uint32_t t_mip, const Float2& t_uv) const
+{
+	const std::uint32_t width = t_texture.GetWidth(t_mip);
+	const std::uint32_t height = t_texture.GetHeight(t_mip);
+	const float u = ReduceCoordinate(t_uv.x, m_desc.address_u) * static_cast<float>(width);
+	const float v = ReduceCoordinate(t_uv.y, m_desc.address_v) * static_cast<float>(height);
+
+	if (m_desc.filter == SamplerFilter::Point)
+	{
+		const std::int32_t x = FloorToInt(u);
+		const std::int32_t y = FloorToInt(v);
+
+		// Inside the mip the address mode does not matter
+		if (static_cast<std::uint32_t>(x) < width && static_cast<std::uint32_t>(y) < height)
+		{
+			return UnpackTexel(t_texture.LoadTexel(t_mip, static_cast<std::uint32_t>(x), static_cast<std::uint32_t>(y)));
+		}
+
+		return LoadTexel(t_texture, t_mip, x, y);
+	}
+
+	// Texel centers are at half coordinates, the four nearest centers are blended
+	const float x = u - 0.5f;
+	const float y = v - 0.5f;
+	const std::int32_t texel_x = FloorToInt(x);
+	const std::int32_t texel_y = FloorToInt(y);
+	const float weight_x = SnapToSubtexel(x - static_cast<float>(texel_x));
+	const float weight_y = SnapToSubtexel(y - static_cast<float>(texel_y));
+
+	if (texel_x >= 0 && texel_y >= 0 && static_cast<std::uint32_t>(texel_x) + 1 < width && static_cast<std::uint32_t>(texel_y) + 1 < height)
+	{
+		std::uint32_t texels[4];
+		t_texture.LoadTexelQuad(t_mip, static_cast<std::uint32_t>(texel_x), static_cast<std::uint32_t>(texel_y), texels);
+
+		return BlendTexelQuad(texels, weight_x, weight_y);
+	}
+
+	// Near the edges every tap resolves its own address, and may end up in the border
+	const Float4 colors[4] =
+	{
+		LoadTexel(t_texture, t_mip, texel_x, texel_y),
+		LoadTexel(t_texture, t_mip, texel_x + 1, texel_y),
+		LoadTexel(t_texture, t_mip, texel_x, texel_y + 1),
+		LoadTexel(t_texture, t_mip, texel_x + 1, texel_y + 1)
+	};
+
+	return BlendQuad(colors, weight_x, weight_y);
+}
+
+tnt::graphics::cpu::Float4 tnt::graphics::cpu::Sampler::LoadTexel(const Texture& t_texture, std::uint32_t t_mip, std::int32_t t_x, std::int32_t t_y) const
+{
+	std::uint32_t x = 0;
+	std::uint32_t y = 0;
+
+	if (!ResolveTexelCoordinate(t_x, t_texture.GetWidth(t_mip), m_desc.address_u, x) ||
+		!ResolveTexelCoordinate(t_y, t_texture.GetHeight(t_mip), m_desc.address_v, y))
+	{
+		return m_desc.border_color;
+	}
+
+	return UnpackTexel(t_texture.LoadTexel(t_mip, x, y));
+}
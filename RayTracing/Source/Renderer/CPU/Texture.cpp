@@ -0,0 +1,356 @@
+#include "Renderer/CPU/Texture.hpp"
+
+#include "Utility/CpuFeatures.hpp"
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(TNT_X86)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	using namespace tnt::graphics::cpu;
+
+	std::uint32_t GetBlockSize(TextureLayout t_layout)
+	{
+		switch (t_layout)
+		{
+		case TextureLayout::Tiled:
+			return TEXTURE_TILE_SIZE;
+
+		case TextureLayout::Morton:
+			return TEXTURE_MORTON_BLOCK_SIZE;
+
+		default:
+			return 1;
+		}
+	}
+
+	// Spreads the low 5 bits of a coordinate over the even bits
+	std::uint32_t SpreadBits(std::uint32_t t_value)
+	{
+		std::uint32_t value = t_value & 0x1F;
+		value = (value | (value << 4)) & 0x10F;
+		value = (value | (value << 2)) & 0x333;
+		value = (value | (value << 1)) & 0x555;
+
+		return value;
+	}
+
+	std::uint32_t GetMortonIndex(std::uint32_t t_x, std::uint32_t t_y)
+	{
+		return SpreadBits(t_x) | (SpreadBits(t_y) << 1);
+	}
+
+	std::uint32_t PackTexel(const std::uint8_t* t_rgba)
+	{
+		return t_rgba[0] | (t_rgba[1] << 8) | (t_rgba[2] << 16) | (static_cast<std::uint32_t>(t_rgba[3]) << 24);
+	}
+}
+
+const char* tnt::graphics::cpu::GetTextureLayoutName(TextureLayout t_layout)
+{
+	switch (t_layout)
+	{
+	case TextureLayout::Linear:
+		return "linear";
+
+	case TextureLayout::Tiled:
+		return "tiled";
+
+	case TextureLayout::Morton:
+		return "morton";
+
+	default:
+		return "unknown";
+	}
+}
+
+tnt::graphics::cpu::Texture::Texture()
+	: m_layout(TextureLayout::Tiled)
+{
+}
+
+tnt::graphics::cpu::Texture::~Texture()
+{
+}
+
+void tnt::graphics::cpu::Texture::LoadFromFile(const std::string& t_path, std::uint32_t t_mip_count, TextureLayout t_layout, const MipGeneratorSettings& t_mip_settings, TextureFormat t_format)
+{
+	int width, height, channel_count;
+	unsigned char* image_data = stbi_load(t_path.c_str(), &width, &height, &channel_count, STBI_rgb_alpha);
+
+	if (image_data == nullptr)
+	{
+		throw std::runtime_error("Could not load texture " + t_path);
+	}
+
+	Initialize(static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height), image_data, t_mip_count, t_layout, t_mip_settings, t_format);
+
+	stbi_image_free(image_data);
+}
+
+void tnt::graphics::cpu::Texture::Initialize(std::uint32_t t_width, std::uint32_t t_height, const std::uint8_t* t_rgba_data, std::uint32_t t_mip_count, TextureLayout t_layout, const MipGeneratorSettings& t_mip_settings, TextureFormat t_format)
+{
+	m_layout = t_layout;
+	m_mips.clear();
+
+	const std::uint32_t block_size = GetBlockSize(t_layout);
+
+	// Same mip sizes as D3D12, every level halves and rounds down
+	std::uint32_t width = t_width;
+	std::uint32_t height = t_height;
+	size_t texel_count = 0;
+
+	while (width > 0 && height > 0)
+	{
+		TextureMip mip = {};
+		mip.width = width;
+		mip.height = height;
+		mip.block_count_x = (width + block_size - 1) / block_size;
+		mip.first_texel = texel_count;
+
+		const std::uint32_t block_count_y = (height + block_size - 1) / block_size;
+		texel_count += static_cast<size_t>(mip.block_count_x) * block_count_y * block_size * block_size;
+
+		m_mips.push_back(mip);
+
+		if ((width == 1 && height == 1) || m_mips.size() == t_mip_count)
+		{
+			break;
+		}
+
+		width = std::max(width / 2, 1u);
+		height = std::max(height / 2, 1u);
+	}
+
+	// Texels in the padding of partial blocks are never read
+	m_texels.assign(texel_count, 0);
+
+	const TextureFormat format = ResolveTextureFormat(t_format, t_width, t_height);
+
+	if (m_mips.size() == 1 && !IsBlockCompressed(format))
+	{
+		StoreMip(0, t_rgba_data, t_width * 4);
+		return;
+	}
+
+	// Every mip is built row major in one scratch chain, then stored in the texture layout
+	std::vector<MipLevel> levels(m_mips.size());
+	size_t scratch_size = 0;
+
+	for (const TextureMip& mip : m_mips)
+	{
+		scratch_size += static_cast<size_t>(mip.width) * mip.height * 4;
+	}
+
+	std::vector<std::uint8_t> scratch(scratch_size);
+	size_t scratch_offset = 0;
+
+	for (std::uint32_t level = 0; level < m_mips.size(); ++level)
+	{
+		MipLevel& mip_level = levels[level];
+		mip_level.data = scratch.data() + scratch_offset;
+		mip_level.width = m_mips[level].width;
+		mip_level.height = m_mips[level].height;
+		mip_level.row_pitch = mip_level.width * 4;
+
+		scratch_offset += static_cast<size_t>(mip_level.row_pitch) * mip_level.height;
+	}
+
+	std::copy(t_rgba_data, t_rgba_data + static_cast<size_t>(t_width) * t_height * 4, scratch.begin());
+
+	MipGenerator generator;
+	generator.GenerateChain(t_mip_settings, levels.data(), static_cast<std::uint32_t>(levels.size()));
+
+	// Every mip goes through the encoder and back, so the CPU renderer samples what the GPU would
+	if (IsBlockCompressed(format))
+	{
+		BlockCompressor compressor;
+		std::vector<std::uint8_t> blocks;
+
+		for (const MipLevel& mip_level : levels)
+		{
+			const std::uint32_t block_row_size = (mip_level.width + BLOCK_COMPRESSION_BLOCK_SIZE - 1) / BLOCK_COMPRESSION_BLOCK_SIZE * GetFormatBlockByteCount(format);
+			blocks.resize(static_cast<size_t>(block_row_size) * ((mip_level.height + BLOCK_COMPRESSION_BLOCK_SIZE - 1) / BLOCK_COMPRESSION_BLOCK_SIZE));
+
+			compressor.Encode(format, mip_level, blocks.data(), block_row_size);
+			compressor.Decode(format, blocks.data(), block_row_size, mip_level);
+		}
+	}
+
+	for (std::uint32_t level = 0; level < m_mips.size(); ++level)
+	{
+		StoreMip(level, levels[level].data, levels[level].row_pitch);
+	}
+}
+
+std::uint32_t tnt::graphics::cpu::Texture::LoadTexel(std::uint32_t t_mip, std::uint32_t t_x, std::uint32_t t_y) const
+{
+	return m_texels[GetTexelIndex(m_mips[t_mip], t_x, t_y)];
+}
+
+void tnt::graphics::cpu::Texture::LoadTexelQuad(std::uint32_t t_mip, std::uint32_t t_x, std::uint32_t t_y, std::uint32_t* t_texels) const
+{
+	const TextureMip& mip = m_mips[t_mip];
+
+	// Most quads are inside a single block, then the other three texels are at fixed offsets
+	if (m_layout == TextureLayout::Linear)
+	{
+		const std::uint32_t* texels = &m_texels[GetTexelIndex(mip, t_x, t_y)];
+
+		t_texels[0] = texels[0];
+		t_texels[1] = texels[1];
+		t_texels[2] = texels[mip.width];
+		t_texels[3] = texels[mip.width + 1];
+
+		return;
+	}
+
+	if (m_layout == TextureLayout::Tiled && (t_x % TEXTURE_TILE_SIZE) != TEXTURE_TILE_SIZE - 1 && (t_y % TEXTURE_TILE_SIZE) != TEXTURE_TILE_SIZE - 1)
+	{
+		const std::uint32_t* texels = &m_texels[GetTexelIndex(mip, t_x, t_y)];
+
+		t_texels[0] = texels[0];
+		t_texels[1] = texels[1];
+		t_texels[2] = texels[TEXTURE_TILE_SIZE];
+		t_texels[3] = texels[TEXTURE_TILE_SIZE + 1];
+
+		return;
+	}
+
+	// An even aligned quad is four consecutive texels in Z order
+	if (m_layout == TextureLayout::Morton && (t_x % 2) == 0 && (t_y % 2) == 0)
+	{
+		const std::uint32_t* texels = &m_texels[GetTexelIndex(mip, t_x, t_y)];
+
+		t_texels[0] = texels[0];
+		t_texels[1] = texels[1];
+		t_texels[2] = texels[2];
+		t_texels[3] = texels[3];
+
+		return;
+	}
+
+	t_texels[0] = m_texels[GetTexelIndex(mip, t_x, t_y)];
+	t_texels[1] = m_texels[GetTexelIndex(mip, t_x + 1, t_y)];
+	t_texels[2] = m_texels[GetTexelIndex(mip, t_x, t_y + 1)];
+	t_texels[3] = m_texels[GetTexelIndex(mip, t_x + 1, t_y + 1)];
+}
+
+tnt::graphics::cpu::TextureLayout tnt::graphics::cpu::Texture::GetLayout() const
+{
+	return m_layout;
+}
+
+std::uint32_t tnt::graphics::cpu::Texture::GetMipCount() const
+{
+	return static_cast<std::uint32_t>(m_mips.size());
+}
+
+std::uint32_t tnt::graphics::cpu::Texture::GetWidth(std::uint32_t t_mip) const
+{
+	return m_mips.empty() ? 0 : m_mips[t_mip].width;
+}
+
+std::uint32_t tnt::graphics::cpu::Texture::GetHeight(std::uint32_t t_mip) const
+{
+	return m_mips.empty() ? 0 : m_mips[t_mip].height;
+}
+
+void tnt::graphics::cpu::Texture::StoreMip(std::uint32_t t_level, const std::uint8_t* t_rgba_data, size_t t_row_pitch)
+{
+	const TextureMip& mip = m_mips[t_level];
+
+	// Whole 4x4 groups are converted with SSE2, the remaining edge texels one by one
+	std::uint32_t vector_width = 0;
+	std::uint32_t vector_height = 0;
+
+#if defined(TNT_X86)
+	vector_width = mip.width & ~(TEXTURE_TILE_SIZE - 1);
+	vector_height = mip.height & ~(TEXTURE_TILE_SIZE - 1);
+
+	for (std::uint32_t y = 0; y < vector_height; y += TEXTURE_TILE_SIZE)
+	{
+		for (std::uint32_t x = 0; x < vector_width; x += TEXTURE_TILE_SIZE)
+		{
+			// RGBA8 bytes already are packed texels with red in the lowest byte
+			const std::uint8_t* source = &t_rgba_data[y * t_row_pitch + static_cast<size_t>(x) * 4];
+
+			__m128i rows[4];
+
+			for (std::uint32_t row = 0; row < 4; ++row)
+			{
+				rows[row] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + row * t_row_pitch));
+			}
+
+			if (m_layout == TextureLayout::Linear)
+			{
+				for (std::uint32_t row = 0; row < 4; ++row)
+				{
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(&m_texels[GetTexelIndex(mip, x, y + row)]), rows[row]);
+				}
+
+				continue;
+			}
+
+			// A 4x4 group is 16 consecutive texels in both block layouts
+			__m128i* destination = reinterpret_cast<__m128i*>(&m_texels[GetTexelIndex(mip, x, y)]);
+
+			if (m_layout == TextureLayout::Tiled)
+			{
+				for (std::uint32_t row = 0; row < 4; ++row)
+				{
+					_mm_storeu_si128(destination + row, rows[row]);
+				}
+
+				continue;
+			}
+
+			// Z order visits the four 2x2 quads top left, top right, bottom left, bottom right
+			_mm_storeu_si128(destination + 0, _mm_unpacklo_epi64(rows[0], rows[1]));
+			_mm_storeu_si128(destination + 1, _mm_unpackhi_epi64(rows[0], rows[1]));
+			_mm_storeu_si128(destination + 2, _mm_unpacklo_epi64(rows[2], rows[3]));
+			_mm_storeu_si128(destination + 3, _mm_unpackhi_epi64(rows[2], rows[3]));
+		}
+	}
+#endif
+
+	for (std::uint32_t y = 0; y < mip.height; ++y)
+	{
+		const std::uint32_t first_x = (y < vector_height) ? vector_width : 0;
+
+		for (std::uint32_t x = first_x; x < mip.width; ++x)
+		{
+			m_texels[GetTexelIndex(mip, x, y)] = PackTexel(&t_rgba_data[y * t_row_pitch + static_cast<size_t>(x) * 4]);
+		}
+	}
+}
+
+size_t tnt::graphics::cpu::Texture::GetTexelIndex(const TextureMip& t_mip, std::uint32_t t_x, std::uint32_t t_y) const
+{
+	switch (m_layout)
+	{
+	case TextureLayout::Linear:
+		return t_mip.first_texel + static_cast<size_t>(t_y) * t_mip.block_count_x + t_x;
+
+	case TextureLayout::Morton:
+	{
+		const size_t block_index = static_cast<size_t>(t_y / TEXTURE_MORTON_BLOCK_SIZE) * t_mip.block_count_x + t_x / TEXTURE_MORTON_BLOCK_SIZE;
+
+		return t_mip.first_texel + block_index * TEXTURE_MORTON_BLOCK_SIZE * TEXTURE_MORTON_BLOCK_SIZE + GetMortonIndex(t_x, t_y);
+	}
+
+	default:
+	{
+		const size_t tile_index = static_cast<size_t>(t_y / TEXTURE_TILE_SIZE) * t_mip.block_count_x + t_x / TEXTURE_TILE_SIZE;
+		const std::uint32_t texel_in_tile = (t_y % TEXTURE_TILE_SIZE) * TEXTURE_TILE_SIZE + t_x % TEXTURE_TILE_SIZE;
+
+		return t_mip.first_texel + tile_index * TEXTURE_TILE_SIZE * TEXTURE_TILE_SIZE + texel_in_tile;
+	}
+	}
+}
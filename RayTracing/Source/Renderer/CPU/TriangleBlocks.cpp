@@ -0,0 +1,393 @@
+#include "Renderer/CPU/TriangleBlocks.hpp"
+
+#include "Renderer/CPU/Bvh.hpp"
+#include "Utility/CpuFeatures.hpp"
+
+#include <utility>
+
+#if defined(TNT_X86)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+	using tnt::graphics::cpu::Float3;
+	using tnt::graphics::cpu::TriangleBlock;
+	using tnt::graphics::cpu::WatertightRay;
+
+	const bool CPU_HAS_AVX = tnt::utility::GetCpuFeatures().avx;
+
+	// Results of one block, only lanes set in the returned mask are valid
+	template<std::uint32_t Width>
+	struct BlockHits
+	{
+		float distances[Width];
+		float weights_v1[Width];	// Edge functions, divided by the determinant only for the closest hit
+		float weights_v2[Width];
+		float determinants[Width];
+	};
+
+	// Portable fallback, also documents what the SIMD kernels compute
+	// The edge functions must not be contracted into FMAs, neighbouring triangles would no longer agree on the sign of a shared edge
+	template<std::uint32_t Width>
+	std::uint32_t IntersectBlockScalar(const TriangleBlock<Width>& t_block, const WatertightRay& t_ray, float t_t_max, BlockHits<Width>& t_hits)
+	{
+		const int kx = t_ray.axis_x;
+		const int ky = t_ray.axis_y;
+		const int kz = t_ray.axis_z;
+		const Float3& origin = t_ray.ray.origin;
+		const Float3& direction = t_ray.ray.direction;
+
+		std::uint32_t hit_mask = 0;
+
+		for (std::uint32_t lane = 0; lane < Width; ++lane)
+		{
+			// Vertices relative to the ray origin, in the permuted coordinate system
+			const float ax = t_block.v0[kx][lane] - origin[kx];
+			const float ay = t_block.v0[ky][lane] - origin[ky];
+			const float az = t_block.v0[kz][lane] - origin[kz];
+			const float bx = t_block.v1[kx][lane] - origin[kx];
+			const float by = t_block.v1[ky][lane] - origin[ky];
+			const float bz = t_block.v1[kz][lane] - origin[kz];
+			const float cx = t_block.v2[kx][lane] - origin[kx];
+			const float cy = t_block.v2[ky][lane] - origin[ky];
+			const float cz = t_block.v2[kz][lane] - origin[kz];
+
+			// Shear so the ray becomes the local z axis, the hit test is then a 2D point in triangle test at the origin
+			const float sheared_ax = ax - t_ray.shear_x * az;
+			const float sheared_ay = ay - t_ray.shear_y * az;
+			const float sheared_bx = bx - t_ray.shear_x * bz;
+			const float sheared_by = by - t_ray.shear_y * bz;
+			const float sheared_cx = cx - t_ray.shear_x * cz;
+			const float sheared_cy = cy - t_ray.shear_y * cz;
+
+			const float u = sheared_cx * sheared_by - sheared_cy * sheared_bx;
+			const float v = sheared_ax * sheared_cy - sheared_ay * sheared_cx;
+			const float w = sheared_bx * sheared_ay - sheared_by * sheared_ax;
+
+			// Points exactly on an edge count as inside, so a shared edge is never missed by both triangles
+			const bool is_outside = (std::min(u, std::min(v, w)) < 0.0f) && (std::max(u, std::max(v, w)) > 0.0f);
+			const float determinant = u + v + w;
+
+			const float plane_distance = t_block.normal[kx][lane] * ax + t_block.normal[ky][lane] * ay + t_block.normal[kz][lane] * az;
+			const float normal_dot_direction = t_block.normal[kx][lane] * direction[kx] + t_block.normal[ky][lane] * direction[ky] + t_block.normal[kz][lane] * direction[kz];
+			const float t = plane_distance / normal_dot_direction;
+
+			t_hits.distances[lane] = t;
+			t_hits.weights_v1[lane] = v;
+			t_hits.weights_v2[lane] = w;
+			t_hits.determinants[lane] = determinant;
+
+			// NaN distances of parallel rays fail every comparison
+			if (!is_outside && determinant != 0.0f && t >= t_ray.ray.t_min && t <= t_t_max)
+			{
+				hit_mask |= 1u << lane;
+			}
+		}
+
+		return hit_mask;
+	}
+
+#if defined(TNT_X86)
+	// SSE2 only, available on every x64 CPU
+	std::uint32_t IntersectBlockSse(const TriangleBlock<4>& t_block, const WatertightRay& t_ray, float t_t_max, BlockHits<4>& t_hits)
+	{
+		const int kx = t_ray.axis_x;
+		const int ky = t_ray.axis_y;
+		const int kz = t_ray.axis_z;
+		const Float3& origin = t_ray.ray.origin;
+		const Float3& direction = t_ray.ray.direction;
+
+		const __m128 origin_x = _mm_set1_ps(origin[kx]);
+		const __m128 origin_y = _mm_set1_ps(origin[ky]);
+		const __m128 origin_z = _mm_set1_ps(origin[kz]);
+		const __m128 shear_x = _mm_set1_ps(t_ray.shear_x);
+		const __m128 shear_y = _mm_set1_ps(t_ray.shear_y);
+
+		const __m128 ax = _mm_sub_ps(_mm_loadu_ps(t_block.v0[kx]), origin_x);
+		const __m128 ay = _mm_sub_ps(_mm_loadu_ps(t_block.v0[ky]), origin_y);
+		const __m128 az = _mm_sub_ps(_mm_loadu_ps(t_block.v0[kz]), origin_z);
+		const __m128 bx = _mm_sub_ps(_mm_loadu_ps(t_block.v1[kx]), origin_x);
+		const __m128 by = _mm_sub_ps(_mm_loadu_ps(t_block.v1[ky]), origin_y);
+		const __m128 bz = _mm_sub_ps(_mm_loadu_ps(t_block.v1[kz]), origin_z);
+		const __m128 cx = _mm_sub_ps(_mm_loadu_ps(t_block.v2[kx]), origin_x);
+		const __m128 cy = _mm_sub_ps(_mm_loadu_ps(t_block.v2[ky]), origin_y);
+		const __m128 cz = _mm_sub_ps(_mm_loadu_ps(t_block.v2[kz]), origin_z);
+
+		const __m128 sheared_ax = _mm_sub_ps(ax, _mm_mul_ps(shear_x, az));
+		const __m128 sheared_ay = _mm_sub_ps(ay, _mm_mul_ps(shear_y, az));
+		const __m128 sheared_bx = _mm_sub_ps(bx, _mm_mul_ps(shear_x, bz));
+		const __m128 sheared_by = _mm_sub_ps(by, _mm_mul_ps(shear_y, bz));
+		const __m128 sheared_cx = _mm_sub_ps(cx, _mm_mul_ps(shear_x, cz));
+		const __m128 sheared_cy = _mm_sub_ps(cy, _mm_mul_ps(shear_y, cz));
+
+		const __m128 u = _mm_sub_ps(_mm_mul_ps(sheared_cx, sheared_by), _mm_mul_ps(sheared_cy, sheared_bx));
+		const __m128 v = _mm_sub_ps(_mm_mul_ps(sheared_ax, sheared_cy), _mm_mul_ps(sheared_ay, sheared_cx));
+		const __m128 w = _mm_sub_ps(_mm_mul_ps(sheared_bx, sheared_ay), _mm_mul_ps(sheared_by, sheared_ax));
+
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 is_negative = _mm_cmplt_ps(_mm_min_ps(u, _mm_min_ps(v, w)), zero);
+		const __m128 is_positive = _mm_cmpgt_ps(_mm_max_ps(u, _mm_max_ps(v, w)), zero);
+		const __m128 determinant = _mm_add_ps(_mm_add_ps(u, v), w);
+
+		const __m128 normal_x = _mm_loadu_ps(t_block.normal[kx]);
+		const __m128 normal_y = _mm_loadu_ps(t_block.normal[ky]);
+		const __m128 normal_z = _mm_loadu_ps(t_block.normal[kz]);
+
+		const __m128 plane_distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(normal_x, ax), _mm_mul_ps(normal_y, ay)), _mm_mul_ps(normal_z, az));
+		const __m128 normal_dot_direction = _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(normal_x, _mm_set1_ps(direction[kx])), _mm_mul_ps(normal_y, _mm_set1_ps(direction[ky]))),
+			_mm_mul_ps(normal_z, _mm_set1_ps(direction[kz])));
+		const __m128 t = _mm_div_ps(plane_distance, normal_dot_direction);
+
+		_mm_storeu_ps(t_hits.distances, t);
+		_mm_storeu_ps(t_hits.weights_v1, v);
+		_mm_storeu_ps(t_hits.weights_v2, w);
+		_mm_storeu_ps(t_hits.determinants, determinant);
+
+		__m128 is_hit = _mm_andnot_ps(_mm_and_ps(is_negative, is_positive), _mm_cmpneq_ps(determinant, zero));
+		is_hit = _mm_and_ps(is_hit, _mm_cmpge_ps(t, _mm_set1_ps(t_ray.ray.t_min)));
+		is_hit = _mm_and_ps(is_hit, _mm_cmple_ps(t, _mm_set1_ps(t_t_max)));
+
+		return static_cast<std::uint32_t>(_mm_movemask_ps(is_hit));
+	}
+
+	// Plain AVX on purpose, without FMA in the target the compiler cannot fuse the edge functions
+	TNT_TARGET_AVX std::uint32_t IntersectBlockAvx(const TriangleBlock<8>& t_block, const WatertightRay& t_ray, float t_t_max, BlockHits<8>& t_hits)
+	{
+		const int kx = t_ray.axis_x;
+		const int ky = t_ray.axis_y;
+		const int kz = t_ray.axis_z;
+		const Float3& origin = t_ray.ray.origin;
+		const Float3& direction = t_ray.ray.direction;
+
+		const __m256 origin_x = _mm256_set1_ps(origin[kx]);
+		const __m256 origin_y = _mm256_set1_ps(origin[ky]);
+		const __m256 origin_z = _mm256_set1_ps(origin[kz]);
+		const __m256 shear_x = _mm256_set1_ps(t_ray.shear_x);
+		const __m256 shear_y = _mm256_set1_ps(t_ray.shear_y);
+
+		const __m256 ax = _mm256_sub_ps(_mm256_loadu_ps(t_block.v0[kx]), origin_x);
+		const __m256 ay = _mm256_sub_ps(_mm256_loadu_ps(t_block.v0[ky]), origin_y);
+		const __m256 az = _mm256_sub_ps(_mm256_loadu_ps(t_block.v0[kz]), origin_z);
+		const __m256 bx = _mm256_sub_ps(_mm256_loadu_ps(t_block.v1[kx]), origin_x);
+		const __m256 by = _mm256_sub_ps(_mm256_loadu_ps(t_block.v1[ky]), origin_y);
+		const __m256 bz = _mm256_sub_ps(_mm256_loadu_ps(t_block.v1[kz]), origin_z);
+		const __m256 cx = _mm256_sub_ps(_mm256_loadu_ps(t_block.v2[kx]), origin_x);
+		const __m256 cy = _mm256_sub_ps(_mm256_loadu_ps(t_block.v2[ky]), origin_y);
+		const __m256 cz = _mm256_sub_ps(_mm256_loadu_ps(t_block.v2[kz]), origin_z);
+
+		const __m256 sheared_ax = _mm256_sub_ps(ax, _mm256_mul_ps(shear_x, az));
+		const __m256 sheared_ay = _mm256_sub_ps(ay, _mm256_mul_ps(shear_y, az));
+		const __m256 sheared_bx = _mm256_sub_ps(bx, _mm256_mul_ps(shear_x, bz));
+		const __m256 sheared_by = _mm256_sub_ps(by, _mm256_mul_ps(shear_y, bz));
+		const __m256 sheared_cx = _mm256_sub_ps(cx, _mm256_mul_ps(shear_x, cz));
+		const __m256 sheared_cy = _mm256_sub_ps(cy, _mm256_mul_ps(shear_y, cz));
+
+		const __m256 u = _mm256_sub_ps(_mm256_mul_ps(sheared_cx, sheared_by), _mm256_mul_ps(sheared_cy, sheared_bx));
+		const __m256 v = _mm256_sub_ps(_mm256_mul_ps(sheared_ax, sheared_cy), _mm256_mul_ps(sheared_ay, sheared_cx));
+		const __m256 w = _mm256_sub_ps(_mm256_mul_ps(sheared_bx, sheared_ay), _mm256_mul_ps(sheared_by, sheared_ax));
+
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 is_negative = _mm256_cmp_ps(_mm256_min_ps(u, _mm256_min_ps(v, w)), zero, _CMP_LT_OQ);
+		const __m256 is_positive = _mm256_cmp_ps(_mm256_max_ps(u, _mm256_max_ps(v, w)), zero, _CMP_GT_OQ);
+		const __m256 determinant = _mm256_add_ps(_mm256_add_ps(u, v), w);
+
+		const __m256 normal_x = _mm256_loadu_ps(t_block.normal[kx]);
+		const __m256 normal_y = _mm256_loadu_ps(t_block.normal[ky]);
+		const __m256 normal_z = _mm256_loadu_ps(t_block.normal[kz]);
+
+		const __m256 plane_distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(normal_x, ax), _mm256_mul_ps(normal_y, ay)), _mm256_mul_ps(normal_z, az));
+		const __m256 normal_dot_direction = _mm256_add_ps(
+			_mm256_add_ps(_mm256_mul_ps(normal_x, _mm256_set1_ps(direction[kx])), _mm256_mul_ps(normal_y, _mm256_set1_ps(direction[ky]))),
+			_mm256_mul_ps(normal_z, _mm256_set1_ps(direction[kz])));
+		const __m256 t = _mm256_div_ps(plane_distance, normal_dot_direction);
+
+		_mm256_storeu_ps(t_hits.distances, t);
+		_mm256_storeu_ps(t_hits.weights_v1, v);
+		_mm256_storeu_ps(t_hits.weights_v2, w);
+		_mm256_storeu_ps(t_hits.determinants, determinant);
+
+		__m256 is_hit = _mm256_andnot_ps(_mm256_and_ps(is_negative, is_positive), _mm256_cmp_ps(determinant, zero, _CMP_NEQ_OQ));
+		is_hit = _mm256_and_ps(is_hit, _mm256_cmp_ps(t, _mm256_set1_ps(t_ray.ray.t_min), _CMP_GE_OQ));
+		is_hit = _mm256_and_ps(is_hit, _mm256_cmp_ps(t, _mm256_set1_ps(t_t_max), _CMP_LE_OQ));
+
+		return static_cast<std::uint32_t>(_mm256_movemask_ps(is_hit));
+	}
+#endif
+
+	std::uint32_t IntersectBlock(const TriangleBlock<4>& t_block, const WatertightRay& t_ray, float t_t_max, BlockHits<4>& t_hits)
+	{
+#if defined(TNT_X86)
+		return IntersectBlockSse(t_block, t_ray, t_t_max, t_hits);
+#else
+		return IntersectBlockScalar(t_block, t_ray, t_t_max, t_hits);
+#endif
+	}
+
+	std::uint32_t IntersectBlock(const TriangleBlock<8>& t_block, const WatertightRay& t_ray, float t_t_max, BlockHits<8>& t_hits)
+	{
+#if defined(TNT_X86)
+		if (CPU_HAS_AVX)
+		{
+			return IntersectBlockAvx(t_block, t_ray, t_t_max, t_hits);
+		}
+#endif
+
+		return IntersectBlockScalar(t_block, t_ray, t_t_max, t_hits);
+	}
+
+	// Lanes of block t_block_index that fall inside [t_first, t_end)
+	template<std::uint32_t Width>
+	std::uint32_t GetLaneMask(std::uint32_t t_block_index, std::uint32_t t_first, std::uint32_t t_end)
+	{
+		const std::uint32_t block_first = t_block_index * Width;
+		const std::uint32_t lane_begin = std::max(t_first, block_first) - block_first;
+		const std::uint32_t lane_end = std::min(t_end, block_first + Width) - block_first;
+
+		return ((1u << lane_end) - 1u) & ~((1u << lane_begin) - 1u);
+	}
+}
+
+tnt::graphics::cpu::WatertightRay tnt::graphics::cpu::CreateWatertightRay(const Ray& t_ray)
+{
+	WatertightRay watertight_ray = {};
+	watertight_ray.ray = t_ray;
+
+	const Float3& direction = t_ray.direction;
+	const float abs_x = std::fabs(direction.x);
+	const float abs_y = std::fabs(direction.y);
+	const float abs_z = std::fabs(direction.z);
+
+	int kz = 2;
+
+	if (abs_x > abs_y && abs_x > abs_z)
+	{
+		kz = 0;
+	}
+	else if (abs_y > abs_z)
+	{
+		kz = 1;
+	}
+
+	int kx = (kz + 1) % 3;
+	int ky = (kx + 1) % 3;
+
+	// Keeps the winding of the triangles the same after the permutation
+	if (direction[kz] < 0.0f)
+	{
+		std::swap(kx, ky);
+	}
+
+	watertight_ray.axis_x = kx;
+	watertight_ray.axis_y = ky;
+	watertight_ray.axis_z = kz;
+	watertight_ray.shear_x = direction[kx] / direction[kz];
+	watertight_ray.shear_y = direction[ky] / direction[kz];
+
+	return watertight_ray;
+}
+
+template<std::uint32_t Width>
+tnt::graphics::cpu::TriangleBlocks<Width>::TriangleBlocks()
+{
+}
+
+template<std::uint32_t Width>
+tnt::graphics::cpu::TriangleBlocks<Width>::~TriangleBlocks()
+{
+}
+
+template<std::uint32_t Width>
+void tnt::graphics::cpu::TriangleBlocks<Width>::Build(const BvhTriangle* t_triangles, const std::uint32_t* t_triangle_indices, std::uint32_t t_triangle_count)
+{
+	m_blocks.clear();
+	Append(t_triangles, t_triangle_indices, t_triangle_count);
+}
+
+template<std::uint32_t Width>
+std::uint32_t tnt::graphics::cpu::TriangleBlocks<Width>::Append(const BvhTriangle* t_triangles, const std::uint32_t* t_triangle_indices, std::uint32_t t_triangle_count)
+{
+	const std::uint32_t first_block = static_cast<std::uint32_t>(m_blocks.size());
+
+	// Unused lanes of the last block stay zero, lane masks keep them out of every test
+	m_blocks.resize(first_block + (t_triangle_count + Width - 1) / Width, TriangleBlock<Width>());
+
+	for (std::uint32_t index = 0; index < t_triangle_count; ++index)
+	{
+		TriangleBlock<Width>& block = m_blocks[first_block + index / Width];
+		const std::uint32_t lane = index % Width;
+		const BvhTriangle& triangle = t_triangles[index];
+		const Float3 normal = Cross(triangle.v1 - triangle.v0, triangle.v2 - triangle.v0);
+
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			block.v0[axis][lane] = triangle.v0[axis];
+			block.v1[axis][lane] = triangle.v1[axis];
+			block.v2[axis][lane] = triangle.v2[axis];
+			block.normal[axis][lane] = normal[axis];
+		}
+
+		block.triangle_indices[lane] = t_triangle_indices[index];
+	}
+
+	return first_block * Width;
+}
+
+template<std::uint32_t Width>
+bool tnt::graphics::cpu::TriangleBlocks<Width>::Intersect(const WatertightRay& t_ray, std::uint32_t t_first, std::uint32_t t_count, Hit& t_hit) const
+{
+	const std::uint32_t end = t_first + t_count;
+	bool found_hit = false;
+
+	for (std::uint32_t block_index = t_first / Width; block_index * Width < end; ++block_index)
+	{
+		const TriangleBlock<Width>& block = m_blocks[block_index];
+
+		BlockHits<Width> hits;
+		std::uint32_t hit_mask = IntersectBlock(block, t_ray, std::min(t_ray.ray.t_max, t_hit.t), hits);
+		hit_mask &= GetLaneMask<Width>(block_index, t_first, end);
+
+		// Triangles on both sides of a shared edge report the same distance, the lowest triangle index wins
+		// so the result does not depend on the order in which a traversal kernel visits the leaves
+		while (hit_mask != 0)
+		{
+			std::uint32_t lane = 0;
+
+			while ((hit_mask & (1u << lane)) == 0)
+			{
+				++lane;
+			}
+
+			hit_mask &= ~(1u << lane);
+
+			const bool is_closer = hits.distances[lane] < t_hit.t;
+			const bool wins_tie = hits.distances[lane] == t_hit.t && block.triangle_indices[lane] < t_hit.triangle_index;
+
+			if (!is_closer && !wins_tie)
+			{
+				continue;
+			}
+
+			const float inverse_determinant = 1.0f / hits.determinants[lane];
+
+			t_hit.t = hits.distances[lane];
+			t_hit.u = hits.weights_v1[lane] * inverse_determinant;
+			t_hit.v = hits.weights_v2[lane] * inverse_determinant;
+			t_hit.triangle_index = block.triangle_indices[lane];
+
+			found_hit = true;
+		}
+	}
+
+	return found_hit;
+}
+
+template<std::uint32_t Width>
+const std::vector<tnt::graphics::cpu::TriangleBlock<Width>>& tnt::graphics::cpu::TriangleBlocks<Width>::GetBlocks() const
+{
+	return m_blocks;
+}
+
+template class tnt::graphics::cpu::TriangleBlocks<4>;
+template class tnt::graphics::cpu::TriangleBlocks<8>;
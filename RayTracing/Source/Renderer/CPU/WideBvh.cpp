@@ -0,0 +1,489 @@
+#include "Renderer/CPU/WideBvh.hpp"
+
+#include "Utility/CpuFeatures.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+#if defined(TNT_X86)
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace
+{
+	using tnt::graphics::cpu::EMPTY_WIDE_BVH_CHILD;
+	using tnt::graphics::cpu::Float3;
+	using tnt::graphics::cpu::WideBvhNode;
+
+	// The 8-wide kernel computes the slab distances with fused multiply-subtract, so it needs FMA as well as AVX2
+	const bool CPU_HAS_AVX2 = tnt::utility::GetCpuFeatures().avx2 && tnt::utility::GetCpuFeatures().fma;
+
+	struct TraversalRay
+	{
+		Float3 origin;
+		Float3 inverse_direction;
+		float t_min;
+	};
+
+	struct StackEntry
+	{
+		std::uint32_t child;
+		std::uint32_t triangle_count;
+		float distance;
+	};
+
+	std::uint32_t FindFirstSet(std::uint32_t t_value)
+	{
+#if defined(_MSC_VER)
+		unsigned long index = 0;
+		_BitScanForward(&index, t_value);
+		return static_cast<std::uint32_t>(index);
+#else
+		return static_cast<std::uint32_t>(__builtin_ctz(t_value));
+#endif
+	}
+
+	// Portable fallback, also documents what the SIMD kernels compute
+	// Unused lanes have inverted bounds, which an infinite ray would still hit, so they are masked by their child
+	template<std::uint32_t Width>
+	std::uint32_t IntersectChildrenScalar(const WideBvhNode<Width>& t_node, const TraversalRay& t_ray, float t_t_max, float* t_distances)
+	{
+		std::uint32_t hit_mask = 0;
+
+		for (std::uint32_t lane = 0; lane < Width; ++lane)
+		{
+			float tx1 = (t_node.bounds_min_x[lane] - t_ray.origin.x) * t_ray.inverse_direction.x;
+			float tx2 = (t_node.bounds_max_x[lane] - t_ray.origin.x) * t_ray.inverse_direction.x;
+			float ty1 = (t_node.bounds_min_y[lane] - t_ray.origin.y) * t_ray.inverse_direction.y;
+			float ty2 = (t_node.bounds_max_y[lane] - t_ray.origin.y) * t_ray.inverse_direction.y;
+			float tz1 = (t_node.bounds_min_z[lane] - t_ray.origin.z) * t_ray.inverse_direction.z;
+			float tz2 = (t_node.bounds_max_z[lane] - t_ray.origin.z) * t_ray.inverse_direction.z;
+
+			float t_entry = std::max(std::max(std::min(tx1, tx2), std::min(ty1, ty2)), std::max(std::min(tz1, tz2), t_ray.t_min));
+			float t_exit = std::min(std::min(std::max(tx1, tx2), std::max(ty1, ty2)), std::min(std::max(tz1, tz2), t_t_max));
+
+			t_distances[lane] = t_entry;
+			hit_mask |= (t_entry <= t_exit && t_node.children[lane] != EMPTY_WIDE_BVH_CHILD) ? (1u << lane) : 0u;
+		}
+
+		return hit_mask;
+	}
+
+#if defined(TNT_X86)
+	// SSE2 only, available on every x64 CPU
+	std::uint32_t IntersectChildrenSse(const WideBvhNode<4>& t_node, const TraversalRay& t_ray, float t_t_max, float* t_distances)
+	{
+		const __m128 origin_x = _mm_set1_ps(t_ray.origin.x);
+		const __m128 origin_y = _mm_set1_ps(t_ray.origin.y);
+		const __m128 origin_z = _mm_set1_ps(t_ray.origin.z);
+		const __m128 inverse_x = _mm_set1_ps(t_ray.inverse_direction.x);
+		const __m128 inverse_y = _mm_set1_ps(t_ray.inverse_direction.y);
+		const __m128 inverse_z = _mm_set1_ps(t_ray.inverse_direction.z);
+
+		__m128 tx1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(t_node.bounds_min_x), origin_x), inverse_x);
+		__m128 tx2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(t_node.bounds_max_x), origin_x), inverse_x);
+		__m128 ty1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(t_node.bounds_min_y), origin_y), inverse_y);
+		__m128 ty2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(t_node.bounds_max_y), origin_y), inverse_y);
+		__m128 tz1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(t_node.bounds_min_z), origin_z), inverse_z);
+		__m128 tz2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(t_node.bounds_max_z), origin_z), inverse_z);
+
+		__m128 t_entry = _mm_max_ps(_mm_max_ps(_mm_min_ps(tx1, tx2), _mm_min_ps(ty1, ty2)), _mm_max_ps(_mm_min_ps(tz1, tz2), _mm_set1_ps(t_ray.t_min)));
+		__m128 t_exit = _mm_min_ps(_mm_min_ps(_mm_max_ps(tx1, tx2), _mm_max_ps(ty1, ty2)), _mm_min_ps(_mm_max_ps(tz1, tz2), _mm_set1_ps(t_t_max)));
+
+		_mm_storeu_ps(t_distances, t_entry);
+
+		const __m128i children = _mm_loadu_si128(reinterpret_cast<const __m128i*>(t_node.children));
+		const __m128 is_empty = _mm_castsi128_ps(_mm_cmpeq_epi32(children, _mm_set1_epi32(static_cast<int>(EMPTY_WIDE_BVH_CHILD))));
+
+		return static_cast<std::uint32_t>(_mm_movemask_ps(_mm_andnot_ps(is_empty, _mm_cmple_ps(t_entry, t_exit))));
+	}
+
+	TNT_TARGET_AVX2_FMA std::uint32_t IntersectChildrenAvx2(const WideBvhNode<8>& t_node, const TraversalRay& t_ray, float t_t_max, float* t_distances)
+	{
+		const __m256 origin_x = _mm256_set1_ps(t_ray.origin.x);
+		const __m256 origin_y = _mm256_set1_ps(t_ray.origin.y);
+		const __m256 origin_z = _mm256_set1_ps(t_ray.origin.z);
+		const __m256 inverse_x = _mm256_set1_ps(t_ray.inverse_direction.x);
+		const __m256 inverse_y = _mm256_set1_ps(t_ray.inverse_direction.y);
+		const __m256 inverse_z = _mm256_set1_ps(t_ray.inverse_direction.z);
+
+		// (bound - origin) * inverse == bound * inverse - origin * inverse, which maps onto one FMA
+		const __m256 scaled_origin_x = _mm256_mul_ps(origin_x, inverse_x);
+		const __m256 scaled_origin_y = _mm256_mul_ps(origin_y, inverse_y);
+		const __m256 scaled_origin_z = _mm256_mul_ps(origin_z, inverse_z);
+
+		__m256 tx1 = _mm256_fmsub_ps(_mm256_loadu_ps(t_node.bounds_min_x), inverse_x, scaled_origin_x);
+		__m256 tx2 = _mm256_fmsub_ps(_mm256_loadu_ps(t_node.bounds_max_x), inverse_x, scaled_origin_x);
+		__m256 ty1 = _mm256_fmsub_ps(_mm256_loadu_ps(t_node.bounds_min_y), inverse_y, scaled_origin_y);
+		__m256 ty2 = _mm256_fmsub_ps(_mm256_loadu_ps(t_node.bounds_max_y), inverse_y, scaled_origin_y);
+		__m256 tz1 = _mm256_fmsub_ps(_mm256_loadu_ps(t_node.bounds_min_z), inverse_z, scaled_origin_z);
+		__m256 tz2 = _mm256_fmsub_ps(_mm256_loadu_ps(t_node.bounds_max_z), inverse_z, scaled_origin_z);
+
+		__m256 t_entry = _mm256_max_ps(_mm256_max_ps(_mm256_min_ps(tx1, tx2), _mm256_min_ps(ty1, ty2)), _mm256_max_ps(_mm256_min_ps(tz1, tz2), _mm256_set1_ps(t_ray.t_min)));
+		__m256 t_exit = _mm256_min_ps(_mm256_min_ps(_mm256_max_ps(tx1, tx2), _mm256_max_ps(ty1, ty2)), _mm256_min_ps(_mm256_max_ps(tz1, tz2), _mm256_set1_ps(t_t_max)));
+
+		_mm256_storeu_ps(t_distances, t_entry);
+
+		const __m256i children = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(t_node.children));
+		const __m256 is_empty = _mm256_castsi256_ps(_mm256_cmpeq_epi32(children, _mm256_set1_epi32(static_cast<int>(EMPTY_WIDE_BVH_CHILD))));
+
+		return static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_andnot_ps(is_empty, _mm256_cmp_ps(t_entry, t_exit, _CMP_LE_OQ))));
+	}
+#endif
+
+	std::uint32_t IntersectChildren(const WideBvhNode<4>& t_node, const TraversalRay& t_ray, float t_t_max, float* t_distances)
+	{
+#if defined(TNT_X86)
+		return IntersectChildrenSse(t_node, t_ray, t_t_max, t_distances);
+#else
+		return IntersectChildrenScalar(t_node, t_ray, t_t_max, t_distances);
+#endif
+	}
+
+	std::uint32_t IntersectChildren(const WideBvhNode<8>& t_node, const TraversalRay& t_ray, float t_t_max, float* t_distances)
+	{
+#if defined(TNT_X86)
+		if (CPU_HAS_AVX2)
+		{
+			return IntersectChildrenAvx2(t_node, t_ray, t_t_max, t_distances);
+		}
+#endif
+
+		return IntersectChildrenScalar(t_node, t_ray, t_t_max, t_distances);
+	}
+}
+
+tnt::graphics::cpu::TraversalKernel tnt::graphics::cpu::ResolveTraversalKernel(TraversalKernel t_kernel)
+{
+	const bool has_avx2 = CPU_HAS_AVX2;
+
+	if (t_kernel == TraversalKernel::Automatic)
+	{
+		return has_avx2 ? TraversalKernel::Wide8Avx2 : TraversalKernel::Wide4Sse;
+	}
+
+	if (t_kernel == TraversalKernel::Wide8Avx2 && !has_avx2)
+	{
+		return TraversalKernel::Wide4Sse;
+	}
+
+	return t_kernel;
+}
+
+const char* tnt::graphics::cpu::GetTraversalKernelName(TraversalKernel t_kernel)
+{
+	switch (t_kernel)
+	{
+	case TraversalKernel::Automatic:
+		return "automatic";
+
+	case TraversalKernel::Binary:
+		return "binary";
+
+	case TraversalKernel::Wide4Sse:
+		return "wide4-sse";
+
+	case TraversalKernel::Wide8Avx2:
+		return "wide8-avx2";
+	}
+
+	return "unknown";
+}
+
+template<std::uint32_t Width>
+tnt::graphics::cpu::WideBvh<Width>::WideBvh()
+	: m_bvh(nullptr)
+{
+}
+
+template<std::uint32_t Width>
+tnt::graphics::cpu::WideBvh<Width>::~WideBvh()
+{
+}
+
+template<std::uint32_t Width>
+void tnt::graphics::cpu::WideBvh<Width>::Build(const Bvh& t_bvh)
+{
+	m_bvh = &t_bvh;
+	m_nodes.clear();
+	m_triangle_blocks = TriangleBlocks<Width>();
+
+	if (t_bvh.GetNodes().empty())
+	{
+		return;
+	}
+
+	m_subtree_triangle_counts.assign(t_bvh.GetNodes().size(), 0);
+	CountTriangles(0);
+
+	// Every wide node replaces at least one binary interior node
+	m_nodes.reserve(t_bvh.GetNodes().size() / 2 + 1);
+	m_nodes.push_back({});
+
+	CollapseNode(0, 0);
+
+	m_subtree_triangle_counts.clear();
+	m_subtree_triangle_counts.shrink_to_fit();
+	m_leaf_triangles.clear();
+	m_leaf_triangles.shrink_to_fit();
+	m_leaf_triangle_indices.clear();
+	m_leaf_triangle_indices.shrink_to_fit();
+	m_bvh = nullptr;
+}
+
+template<std::uint32_t Width>
+bool tnt::graphics::cpu::WideBvh<Width>::Intersect(const Ray& t_ray, Hit& t_hit) const
+{
+	if (m_nodes.empty())
+	{
+		return false;
+	}
+
+	TraversalRay traversal_ray = { t_ray.origin, ComputeInverseDirection(t_ray.direction), t_ray.t_min };
+	const WatertightRay watertight_ray = CreateWatertightRay(t_ray);
+
+	bool found_hit = false;
+
+	// Worst case every level pushes all but one child
+	// Each wide child is at least one binary level deeper, so there are at most MAX_BVH_DEPTH levels
+	StackEntry stack[MAX_BVH_DEPTH * (Width - 1)];
+	std::uint32_t stack_size = 0;
+	StackEntry entry = { 0, 0, t_ray.t_min };
+
+	while (true)
+	{
+		const float t_max = std::min(t_ray.t_max, t_hit.t);
+
+		if (entry.triangle_count > 0)
+		{
+			found_hit |= m_triangle_blocks.Intersect(watertight_ray, entry.child, entry.triangle_count, t_hit);
+		}
+		else
+		{
+			const WideBvhNode<Width>& node = m_nodes[entry.child];
+
+			float distances[Width];
+			std::uint32_t hit_mask = IntersectChildren(node, traversal_ray, t_max, distances);
+
+			// The nearest child is visited next without going through the stack, which is the only child most of the time
+			if (hit_mask != 0)
+			{
+				std::uint32_t lane = FindFirstSet(hit_mask);
+				hit_mask &= hit_mask - 1;
+
+				entry = { node.children[lane], node.triangle_counts[lane], distances[lane] };
+
+				// The others are pushed far to near behind the ones already on the stack, so the nearest one is popped first
+				const std::uint32_t stack_begin = stack_size;
+
+				while (hit_mask != 0)
+				{
+					lane = FindFirstSet(hit_mask);
+					hit_mask &= hit_mask - 1;
+
+					StackEntry hit = { node.children[lane], node.triangle_counts[lane], distances[lane] };
+
+					if (hit.distance < entry.distance)
+					{
+						std::swap(hit, entry);
+					}
+
+					assert(stack_size < MAX_BVH_DEPTH * (Width - 1));
+					std::uint32_t position = stack_size++;
+
+					while (position > stack_begin && stack[position - 1].distance < hit.distance)
+					{
+						stack[position] = stack[position - 1];
+						--position;
+					}
+
+					stack[position] = hit;
+				}
+
+				continue;
+			}
+		}
+
+		// A closer hit may have been found since an entry was pushed
+		do
+		{
+			if (stack_size == 0)
+			{
+				return found_hit;
+			}
+
+			entry = stack[--stack_size];
+		}
+		while (entry.distance > std::min(t_ray.t_max, t_hit.t));
+	}
+}
+
+template<std::uint32_t Width>
+const std::vector<tnt::graphics::cpu::WideBvhNode<Width>>& tnt::graphics::cpu::WideBvh<Width>::GetNodes() const
+{
+	return m_nodes;
+}
+
+template<std::uint32_t Width>
+void tnt::graphics::cpu::WideBvh<Width>::CollapseNode(std::uint32_t t_wide_node_index, std::uint32_t t_binary_node_index)
+{
+	const std::vector<BvhNode>& binary_nodes = m_bvh->GetNodes();
+
+	// Keep opening the interior child with the largest surface area until the node is full
+	std::uint32_t children[Width];
+	std::uint32_t child_count = 0;
+
+	if (IsLeaf(t_binary_node_index))
+	{
+		// Only happens for a root that is a leaf
+		children[child_count++] = t_binary_node_index;
+	}
+	else
+	{
+		children[child_count++] = binary_nodes[t_binary_node_index].left_first;
+		children[child_count++] = binary_nodes[t_binary_node_index].left_first + 1;
+	}
+
+	while (child_count < Width)
+	{
+		float largest_area = -1.0f;
+		std::uint32_t largest_child = Width;
+
+		for (std::uint32_t index = 0; index < child_count; ++index)
+		{
+			const BvhNode& node = binary_nodes[children[index]];
+
+			if (IsLeaf(children[index]))
+			{
+				continue;
+			}
+
+			const Aabb bounds = { node.bounds_min, node.bounds_max };
+			const float area = bounds.GetSurfaceArea();
+
+			if (area > largest_area)
+			{
+				largest_area = area;
+				largest_child = index;
+			}
+		}
+
+		if (largest_child == Width)
+		{
+			break;
+		}
+
+		const std::uint32_t left_index = binary_nodes[children[largest_child]].left_first;
+		children[largest_child] = left_index;
+		children[child_count++] = left_index + 1;
+	}
+
+	const float infinity = std::numeric_limits<float>::infinity();
+
+	for (std::uint32_t lane = 0; lane < Width; ++lane)
+	{
+		WideBvhNode<Width>& wide_node = m_nodes[t_wide_node_index];
+
+		if (lane >= child_count)
+		{
+			// Unused lane, traversal skips it based on the empty child marker
+			wide_node.bounds_min_x[lane] = infinity;
+			wide_node.bounds_min_y[lane] = infinity;
+			wide_node.bounds_min_z[lane] = infinity;
+			wide_node.bounds_max_x[lane] = -infinity;
+			wide_node.bounds_max_y[lane] = -infinity;
+			wide_node.bounds_max_z[lane] = -infinity;
+			wide_node.children[lane] = EMPTY_WIDE_BVH_CHILD;
+			wide_node.triangle_counts[lane] = 0;
+			continue;
+		}
+
+		const BvhNode& child = binary_nodes[children[lane]];
+
+		wide_node.bounds_min_x[lane] = child.bounds_min.x;
+		wide_node.bounds_min_y[lane] = child.bounds_min.y;
+		wide_node.bounds_min_z[lane] = child.bounds_min.z;
+		wide_node.bounds_max_x[lane] = child.bounds_max.x;
+		wide_node.bounds_max_y[lane] = child.bounds_max.y;
+		wide_node.bounds_max_z[lane] = child.bounds_max.z;
+
+		if (IsLeaf(children[lane]))
+		{
+			m_leaf_triangles.clear();
+			m_leaf_triangle_indices.clear();
+			GatherTriangles(children[lane]);
+
+			wide_node.children[lane] = m_triangle_blocks.Append(m_leaf_triangles.data(), m_leaf_triangle_indices.data(), static_cast<std::uint32_t>(m_leaf_triangles.size()));
+			wide_node.triangle_counts[lane] = static_cast<std::uint32_t>(m_leaf_triangles.size());
+		}
+		else
+		{
+			const std::uint32_t child_wide_index = static_cast<std::uint32_t>(m_nodes.size());
+			m_nodes.push_back({});
+
+			// The push may have moved the node, write through the index again
+			m_nodes[t_wide_node_index].children[lane] = child_wide_index;
+			m_nodes[t_wide_node_index].triangle_counts[lane] = 0;
+		}
+	}
+
+	// Children are collapsed only once all of them have a slot, so siblings end up next to each other in memory
+	for (std::uint32_t lane = 0; lane < child_count; ++lane)
+	{
+		if (!IsLeaf(children[lane]))
+		{
+			CollapseNode(m_nodes[t_wide_node_index].children[lane], children[lane]);
+		}
+	}
+}
+
+template<std::uint32_t Width>
+std::uint32_t tnt::graphics::cpu::WideBvh<Width>::CountTriangles(std::uint32_t t_binary_node_index)
+{
+	const BvhNode& node = m_bvh->GetNodes()[t_binary_node_index];
+
+	if (node.triangle_count > 0)
+	{
+		m_subtree_triangle_counts[t_binary_node_index] = node.triangle_count;
+	}
+	else
+	{
+		m_subtree_triangle_counts[t_binary_node_index] = CountTriangles(node.left_first) + CountTriangles(node.left_first + 1);
+	}
+
+	return m_subtree_triangle_counts[t_binary_node_index];
+}
+
+template<std::uint32_t Width>
+void tnt::graphics::cpu::WideBvh<Width>::GatherTriangles(std::uint32_t t_binary_node_index)
+{
+	const BvhNode& node = m_bvh->GetNodes()[t_binary_node_index];
+
+	if (node.triangle_count == 0)
+	{
+		GatherTriangles(node.left_first);
+		GatherTriangles(node.left_first + 1);
+		return;
+	}
+
+	for (std::uint32_t index = node.left_first; index < node.left_first + node.triangle_count; ++index)
+	{
+		m_leaf_triangles.push_back(m_bvh->GetTriangles()[index]);
+		m_leaf_triangle_indices.push_back(m_bvh->GetTriangleIndices()[index]);
+	}
+}
+
+template<std::uint32_t Width>
+bool tnt::graphics::cpu::WideBvh<Width>::IsLeaf(std::uint32_t t_binary_node_index) const
+{
+	// Binary leaves stay leaves even when they hold more than Width triangles, they then span several blocks
+	return m_bvh->GetNodes()[t_binary_node_index].triangle_count > 0 || m_subtree_triangle_counts[t_binary_node_index] <= Width;
+}
+
+template class tnt::graphics::cpu::WideBvh<4>;
+template class tnt::graphics::cpu::WideBvh<8>;
@@ -0,0 +1,837 @@
+#include "Renderer/MipGenerator.hpp"
+
+#include "Utility/CpuFeatures.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#if defined(TNT_X86)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+	using namespace tnt::graphics;
+
+	// Destination rows per thread pool task
+	const std::uint32_t MIP_BAND_HEIGHT = 16;
+
+	// Three destination texels either side of the center, which is six source texels
+	const std::uint32_t KAISER_TAP_COUNT = 12;
+	const std::uint32_t KAISER_RADIUS = KAISER_TAP_COUNT / 2;
+	const double KAISER_WIDTH = 3.0;
+	const double KAISER_ALPHA = 4.0;
+
+	// Buckets of 1/16 of a linear unit, narrower than the gap between any two sRGB thresholds
+	const float SRGB_BUCKETS_PER_UNIT = 16.0f;
+	const std::uint32_t SRGB_BUCKET_COUNT = 255 * 16 + 1;
+
+	// Values are kept in 0-255 units, so linear channels need no scaling on the way in or out
+	struct FilterTables
+	{
+		float to_float[2][256];		// Indexed by the sRGB flag
+		float srgb_thresholds[256];	// Linear value halfway between two sRGB codes, the last entry never matches
+		std::uint8_t srgb_buckets[SRGB_BUCKET_COUNT + 3];	// sRGB code at the start of every bucket, padded for 32 bit gathers
+		float kaiser_weights[KAISER_TAP_COUNT];
+	};
+
+	double SrgbToLinear(double t_value)
+	{
+		return (t_value <= 0.04045) ? t_value / 12.92 : std::pow((t_value + 0.055) / 1.055, 2.4);
+	}
+
+	// Zeroth order modified Bessel function of the first kind, the series converges long before 32 terms
+	double BesselI0(double t_x)
+	{
+		double sum = 1.0;
+		double term = 1.0;
+
+		for (int k = 1; k < 32; ++k)
+		{
+			const double factor = t_x / (2.0 * k);
+			term *= factor * factor;
+			sum += term;
+		}
+
+		return sum;
+	}
+
+	double Sinc(double t_x)
+	{
+		if (std::abs(t_x) < 1e-9)
+		{
+			return 1.0;
+		}
+
+		const double pi_x = 3.14159265358979323846 * t_x;
+
+		return std::sin(pi_x) / pi_x;
+	}
+
+	FilterTables BuildFilterTables()
+	{
+		FilterTables tables = {};
+
+		for (std::uint32_t code = 0; code < 256; ++code)
+		{
+			tables.to_float[0][code] = static_cast<float>(code);
+			tables.to_float[1][code] = static_cast<float>(255.0 * SrgbToLinear(code / 255.0));
+			tables.srgb_thresholds[code] = (code < 255) ? static_cast<float>(255.0 * SrgbToLinear((code + 0.5) / 255.0)) : std::numeric_limits<float>::max();
+		}
+
+		for (std::uint32_t bucket = 0; bucket < SRGB_BUCKET_COUNT; ++bucket)
+		{
+			const float value = bucket / SRGB_BUCKETS_PER_UNIT;
+			std::uint32_t code = 0;
+
+			while (tables.srgb_thresholds[code] <= value)
+			{
+				++code;
+			}
+
+			tables.srgb_buckets[bucket] = static_cast<std::uint8_t>(code);
+		}
+
+		// Every destination texel sits between two source texels, so all of them share one kernel
+		double weights[KAISER_TAP_COUNT];
+		double weight_sum = 0.0;
+
+		for (std::uint32_t tap = 0; tap < KAISER_TAP_COUNT; ++tap)
+		{
+			const double distance = (static_cast<double>(tap) - KAISER_RADIUS + 0.5) / 2.0;
+			const double window = BesselI0(KAISER_ALPHA * std::sqrt(1.0 - (distance / KAISER_WIDTH) * (distance / KAISER_WIDTH))) / BesselI0(KAISER_ALPHA);
+
+			weights[tap] = Sinc(distance) * window;
+			weight_sum += weights[tap];
+		}
+
+		for (std::uint32_t tap = 0; tap < KAISER_TAP_COUNT; ++tap)
+		{
+			tables.kaiser_weights[tap] = static_cast<float>(weights[tap] / weight_sum);
+		}
+
+		return tables;
+	}
+
+	const FilterTables& GetFilterTables()
+	{
+		static const FilterTables tables = BuildFilterTables();
+
+		return tables;
+	}
+
+	// Number of thresholds at or below the value, a bucket holds at most one threshold so one compare corrects its code
+	std::uint8_t EncodeSrgb(float t_value, const FilterTables& t_tables)
+	{
+		const float value = std::min(std::max(t_value, 0.0f), 255.0f);
+		const std::uint32_t code = t_tables.srgb_buckets[static_cast<std::uint32_t>(value * SRGB_BUCKETS_PER_UNIT)];
+
+		return static_cast<std::uint8_t>(code + (t_tables.srgb_thresholds[code] <= value ? 1 : 0));
+	}
+
+	std::uint8_t EncodeLinear(float t_value)
+	{
+		return static_cast<std::uint8_t>(std::min(std::max(t_value, 0.0f), 255.0f) + 0.5f);
+	}
+
+	void DecodeRow(const std::uint8_t* t_row, std::uint32_t t_width, bool t_srgb, float* t_values)
+	{
+		const FilterTables& tables = GetFilterTables();
+		const float* color_table = tables.to_float[t_srgb ? 1 : 0];
+
+		for (std::uint32_t x = 0; x < t_width; ++x)
+		{
+			t_values[x * 4 + 0] = color_table[t_row[x * 4 + 0]];
+			t_values[x * 4 + 1] = color_table[t_row[x * 4 + 1]];
+			t_values[x * 4 + 2] = color_table[t_row[x * 4 + 2]];
+			t_values[x * 4 + 3] = tables.to_float[0][t_row[x * 4 + 3]];
+		}
+	}
+
+	void EncodeRowScalar(const float* t_values, std::uint32_t t_first_x, std::uint32_t t_width, bool t_srgb, std::uint8_t* t_row)
+	{
+		const FilterTables& tables = GetFilterTables();
+
+		for (std::uint32_t x = t_first_x; x < t_width; ++x)
+		{
+			for (std::uint32_t channel = 0; channel < 3; ++channel)
+			{
+				const float value = t_values[x * 4 + channel];
+				t_row[x * 4 + channel] = t_srgb ? EncodeSrgb(value, tables) : EncodeLinear(value);
+			}
+
+			t_row[x * 4 + 3] = EncodeLinear(t_values[x * 4 + 3]);
+		}
+	}
+
+	// Odd sizes drop the last row or column of the source, the clamp only matters for sources one texel wide
+	void BoxLinearRowScalar(const std::uint8_t* t_row0, const std::uint8_t* t_row1, std::uint32_t t_source_width, std::uint32_t t_first_x, std::uint32_t t_width, std::uint8_t* t_row)
+	{
+		for (std::uint32_t x = t_first_x; x < t_width; ++x)
+		{
+			const std::uint32_t x0 = std::min(x * 2, t_source_width - 1) * 4;
+			const std::uint32_t x1 = std::min(x * 2 + 1, t_source_width - 1) * 4;
+
+			for (std::uint32_t channel = 0; channel < 4; ++channel)
+			{
+				const std::uint32_t sum = 2 + t_row0[x0 + channel] + t_row0[x1 + channel] + t_row1[x0 + channel] + t_row1[x1 + channel];
+				t_row[x * 4 + channel] = static_cast<std::uint8_t>(sum / 4);
+			}
+		}
+	}
+
+	void BoxFloatRowScalar(const float* t_row0, const float* t_row1, std::uint32_t t_source_width, std::uint32_t t_first_x, std::uint32_t t_width, float* t_row)
+	{
+		for (std::uint32_t x = t_first_x; x < t_width; ++x)
+		{
+			const std::uint32_t x0 = std::min(x * 2, t_source_width - 1) * 4;
+			const std::uint32_t x1 = std::min(x * 2 + 1, t_source_width - 1) * 4;
+
+			// Same order of additions as the SIMD kernels
+			for (std::uint32_t channel = 0; channel < 4; ++channel)
+			{
+				t_row[x * 4 + channel] = ((t_row0[x0 + channel] + t_row1[x0 + channel]) + (t_row0[x1 + channel] + t_row1[x1 + channel])) * 0.25f;
+			}
+		}
+	}
+
+	// The padded row holds source texel i at index i + KAISER_RADIUS, edge texels are repeated into the padding
+	void KaiserRowScalar(const float* t_padded_row, std::uint32_t t_first_x, std::uint32_t t_width, float* t_row)
+	{
+		const float* weights = GetFilterTables().kaiser_weights;
+
+		for (std::uint32_t x = t_first_x; x < t_width; ++x)
+		{
+			const float* source = t_padded_row + (x * 2 + 1) * 4;
+
+			for (std::uint32_t channel = 0; channel < 4; ++channel)
+			{
+				float sum = 0.0f;
+
+				for (std::uint32_t tap = 0; tap < KAISER_TAP_COUNT; ++tap)
+				{
+					sum += source[tap * 4 + channel] * weights[tap];
+				}
+
+				t_row[x * 4 + channel] = sum;
+			}
+		}
+	}
+
+	void KaiserColumnScalar(const float* const* t_rows, std::uint32_t t_first_value, std::uint32_t t_value_count, float* t_row)
+	{
+		const float* weights = GetFilterTables().kaiser_weights;
+
+		for (std::uint32_t index = t_first_value; index < t_value_count; ++index)
+		{
+			float sum = 0.0f;
+
+			for (std::uint32_t tap = 0; tap < KAISER_TAP_COUNT; ++tap)
+			{
+				sum += t_rows[tap][index] * weights[tap];
+			}
+
+			t_row[index] = sum;
+		}
+	}
+
+#if defined(TNT_X86)
+	// Four source texels of two rows give two destination texels as 16 bit channels
+	__m128i BoxTexelPairSse2(__m128i t_row0, __m128i t_row1)
+	{
+		const __m128i zero = _mm_setzero_si128();
+
+		const __m128i sum01 = _mm_add_epi16(_mm_unpacklo_epi8(t_row0, zero), _mm_unpacklo_epi8(t_row1, zero));
+		const __m128i sum23 = _mm_add_epi16(_mm_unpackhi_epi8(t_row0, zero), _mm_unpackhi_epi8(t_row1, zero));
+		const __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(sum01, sum23), _mm_unpackhi_epi64(sum01, sum23));
+
+		return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(2)), 2);
+	}
+
+	// Returns the first destination texel left for the scalar loop
+	std::uint32_t BoxLinearRowSse2(const std::uint8_t* t_row0, const std::uint8_t* t_row1, std::uint32_t t_width, std::uint8_t* t_row)
+	{
+		std::uint32_t x = 0;
+
+		for (; x + 4 <= t_width; x += 4)
+		{
+			const __m128i* source0 = reinterpret_cast<const __m128i*>(t_row0 + x * 8);
+			const __m128i* source1 = reinterpret_cast<const __m128i*>(t_row1 + x * 8);
+
+			const __m128i low = BoxTexelPairSse2(_mm_loadu_si128(source0), _mm_loadu_si128(source1));
+			const __m128i high = BoxTexelPairSse2(_mm_loadu_si128(source0 + 1), _mm_loadu_si128(source1 + 1));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(t_row + x * 4), _mm_packus_epi16(low, high));
+		}
+
+		return x;
+	}
+
+	std::uint32_t BoxFloatRowSse2(const float* t_row0, const float* t_row1, std::uint32_t t_width, float* t_row)
+	{
+		const __m128 quarter = _mm_set1_ps(0.25f);
+
+		for (std::uint32_t x = 0; x < t_width; ++x)
+		{
+			const __m128 left = _mm_add_ps(_mm_loadu_ps(t_row0 + x * 8), _mm_loadu_ps(t_row1 + x * 8));
+			const __m128 right = _mm_add_ps(_mm_loadu_ps(t_row0 + x * 8 + 4), _mm_loadu_ps(t_row1 + x * 8 + 4));
+
+			_mm_storeu_ps(t_row + x * 4, _mm_mul_ps(_mm_add_ps(left, right), quarter));
+		}
+
+		return t_width;
+	}
+
+	// One texel per register, the four channels are filtered together
+	std::uint32_t KaiserRowSse2(const float* t_padded_row, std::uint32_t t_width, float* t_row)
+	{
+		const float* weights = GetFilterTables().kaiser_weights;
+
+		for (std::uint32_t x = 0; x < t_width; ++x)
+		{
+			const float* source = t_padded_row + (x * 2 + 1) * 4;
+			__m128 sum = _mm_setzero_ps();
+
+			for (std::uint32_t tap = 0; tap < KAISER_TAP_COUNT; ++tap)
+			{
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(source + tap * 4), _mm_set1_ps(weights[tap])));
+			}
+
+			_mm_storeu_ps(t_row + x * 4, sum);
+		}
+
+		return t_width;
+	}
+
+	std::uint32_t KaiserColumnSse2(const float* const* t_rows, std::uint32_t t_value_count, float* t_row)
+	{
+		const float* weights = GetFilterTables().kaiser_weights;
+		std::uint32_t index = 0;
+
+		for (; index + 4 <= t_value_count; index += 4)
+		{
+			__m128 sum = _mm_setzero_ps();
+
+			for (std::uint32_t tap = 0; tap < KAISER_TAP_COUNT; ++tap)
+			{
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(t_rows[tap] + index), _mm_set1_ps(weights[tap])));
+			}
+
+			_mm_storeu_ps(t_row + index, sum);
+		}
+
+		return index;
+	}
+
+	// Only linear values are converted here, sRGB needs the table search of the scalar or AVX2 encoder
+	std::uint32_t EncodeLinearRowSse2(const float* t_values, std::uint32_t t_width, std::uint8_t* t_row)
+	{
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 maximum = _mm_set1_ps(255.0f);
+		const __m128 half = _mm_set1_ps(0.5f);
+
+		std::uint32_t x = 0;
+
+		for (; x + 4 <= t_width; x += 4)
+		{
+			__m128i texels[4];
+
+			for (std::uint32_t texel = 0; texel < 4; ++texel)
+			{
+				const __m128 value = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(t_values + (x + texel) * 4), zero), maximum);
+				texels[texel] = _mm_cvttps_epi32(_mm_add_ps(value, half));
+			}
+
+			const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(texels[0], texels[1]), _mm_packs_epi32(texels[2], texels[3]));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(t_row + x * 4), packed);
+		}
+
+		return x;
+	}
+
+	TNT_TARGET_AVX2 std::uint32_t BoxLinearRowAvx2(const std::uint8_t* t_row0, const std::uint8_t* t_row1, std::uint32_t t_width, std::uint8_t* t_row)
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i two = _mm256_set1_epi16(2);
+
+		std::uint32_t x = 0;
+
+		for (; x + 8 <= t_width; x += 8)
+		{
+			const __m256i* source0 = reinterpret_cast<const __m256i*>(t_row0 + x * 8);
+			const __m256i* source1 = reinterpret_cast<const __m256i*>(t_row1 + x * 8);
+
+			__m256i halves[2];
+
+			// Same steps as the SSE2 kernel inside each 128 bit lane
+			for (std::uint32_t half = 0; half < 2; ++half)
+			{
+				const __m256i row0 = _mm256_loadu_si256(source0 + half);
+				const __m256i row1 = _mm256_loadu_si256(source1 + half);
+
+				const __m256i sum01 = _mm256_add_epi16(_mm256_unpacklo_epi8(row0, zero), _mm256_unpacklo_epi8(row1, zero));
+				const __m256i sum23 = _mm256_add_epi16(_mm256_unpackhi_epi8(row0, zero), _mm256_unpackhi_epi8(row1, zero));
+				const __m256i sum = _mm256_add_epi16(_mm256_unpacklo_epi64(sum01, sum23), _mm256_unpackhi_epi64(sum01, sum23));
+
+				halves[half] = _mm256_srli_epi16(_mm256_add_epi16(sum, two), 2);
+			}
+
+			// Packing works per lane, which leaves the texel pairs in the order 0 2 1 3
+			const __m256i packed = _mm256_packus_epi16(halves[0], halves[1]);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(t_row + x * 4), _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+		}
+
+		return x;
+	}
+
+	TNT_TARGET_AVX2 std::uint32_t BoxFloatRowAvx2(const float* t_row0, const float* t_row1, std::uint32_t t_width, float* t_row)
+	{
+		const __m256 quarter = _mm256_set1_ps(0.25f);
+
+		std::uint32_t x = 0;
+
+		for (; x + 2 <= t_width; x += 2)
+		{
+			// Vertical sums of source texels 2x, 2x + 1 and 2x + 2, 2x + 3
+			const __m256 first = _mm256_add_ps(_mm256_loadu_ps(t_row0 + x * 8), _mm256_loadu_ps(t_row1 + x * 8));
+			const __m256 second = _mm256_add_ps(_mm256_loadu_ps(t_row0 + x * 8 + 8), _mm256_loadu_ps(t_row1 + x * 8 + 8));
+
+			const __m256 left = _mm256_permute2f128_ps(first, second, 0x20);
+			const __m256 right = _mm256_permute2f128_ps(first, second, 0x31);
+
+			_mm256_storeu_ps(t_row + x * 4, _mm256_mul_ps(_mm256_add_ps(left, right), quarter));
+		}
+
+		return x;
+	}
+
+	// Two destination texels per register, their source texels are eight floats apart
+	TNT_TARGET_AVX2 std::uint32_t KaiserRowAvx2(const float* t_padded_row, std::uint32_t t_width, float* t_row)
+	{
+		const float* weights = GetFilterTables().kaiser_weights;
+
+		std::uint32_t x = 0;
+
+		for (; x + 2 <= t_width; x += 2)
+		{
+			const float* source = t_padded_row + (x * 2 + 1) * 4;
+			__m256 sum = _mm256_setzero_ps();
+
+			for (std::uint32_t tap = 0; tap < KAISER_TAP_COUNT; ++tap)
+			{
+				const __m256 texels = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(source + tap * 4)), _mm_loadu_ps(source + tap * 4 + 8), 1);
+				sum = _mm256_add_ps(sum, _mm256_mul_ps(texels, _mm256_set1_ps(weights[tap])));
+			}
+
+			_mm256_storeu_ps(t_row + x * 4, sum);
+		}
+
+		return x;
+	}
+
+	TNT_TARGET_AVX2 std::uint32_t KaiserColumnAvx2(const float* const* t_rows, std::uint32_t t_value_count, float* t_row)
+	{
+		const float* weights = GetFilterTables().kaiser_weights;
+
+		std::uint32_t index = 0;
+
+		for (; index + 8 <= t_value_count; index += 8)
+		{
+			__m256 sum = _mm256_setzero_ps();
+
+			for (std::uint32_t tap = 0; tap < KAISER_TAP_COUNT; ++tap)
+			{
+				sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(t_rows[tap] + index), _mm256_set1_ps(weights[tap])));
+			}
+
+			_mm256_storeu_ps(t_row + index, sum);
+		}
+
+		return index;
+	}
+
+	// Two texels per register, the sRGB lookup gathers buckets and thresholds for all eight channels at once
+	TNT_TARGET_AVX2 std::uint32_t EncodeRowAvx2(const float* t_values, std::uint32_t t_width, bool t_srgb, std::uint8_t* t_row)
+	{
+		const FilterTables& tables = GetFilterTables();
+
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 maximum = _mm256_set1_ps(255.0f);
+		const __m256 half = _mm256_set1_ps(0.5f);
+
+		std::uint32_t x = 0;
+
+		for (; x + 2 <= t_width; x += 2)
+		{
+			const __m256 values = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(t_values + x * 4), zero), maximum);
+			__m256i codes = _mm256_cvttps_epi32(_mm256_add_ps(values, half));
+
+			if (t_srgb)
+			{
+				const __m256i buckets = _mm256_cvttps_epi32(_mm256_mul_ps(values, _mm256_set1_ps(SRGB_BUCKETS_PER_UNIT)));
+				__m256i srgb_codes = _mm256_and_si256(_mm256_i32gather_epi32(reinterpret_cast<const int*>(tables.srgb_buckets), buckets, 1), _mm256_set1_epi32(0xFF));
+
+				// Compare results are all ones, subtracting them adds one
+				const __m256 thresholds = _mm256_i32gather_ps(tables.srgb_thresholds, srgb_codes, 4);
+				srgb_codes = _mm256_sub_epi32(srgb_codes, _mm256_castps_si256(_mm256_cmp_ps(thresholds, values, _CMP_LE_OQ)));
+
+				// Alpha stays linear
+				codes = _mm256_blend_epi32(srgb_codes, codes, 0x88);
+			}
+
+			const __m256i words = _mm256_packus_epi32(codes, codes);
+			const __m256i bytes = _mm256_packus_epi16(words, words);
+
+			const int first = _mm_cvtsi128_si32(_mm256_castsi256_si128(bytes));
+			const int second = _mm_cvtsi128_si32(_mm256_extracti128_si256(bytes, 1));
+
+			std::copy(reinterpret_cast<const std::uint8_t*>(&first), reinterpret_cast<const std::uint8_t*>(&first) + 4, t_row + x * 4);
+			std::copy(reinterpret_cast<const std::uint8_t*>(&second), reinterpret_cast<const std::uint8_t*>(&second) + 4, t_row + x * 4 + 4);
+		}
+
+		return x;
+	}
+#endif
+
+	std::uint32_t BoxLinearRow(MipKernel t_kernel, const std::uint8_t* t_row0, const std::uint8_t* t_row1, std::uint32_t t_source_width, std::uint32_t t_width, std::uint8_t* t_row)
+	{
+		// Sources one texel wide need the clamp of the scalar loop
+		if (t_source_width < 2)
+		{
+			return 0;
+		}
+
+#if defined(TNT_X86)
+		switch (t_kernel)
+		{
+		case MipKernel::Avx2:
+			return BoxLinearRowAvx2(t_row0, t_row1, t_width, t_row);
+
+		case MipKernel::Sse2:
+			return BoxLinearRowSse2(t_row0, t_row1, t_width, t_row);
+
+		default:
+			break;
+		}
+#endif
+
+		return 0;
+	}
+
+	std::uint32_t BoxFloatRow(MipKernel t_kernel, const float* t_row0, const float* t_row1, std::uint32_t t_source_width, std::uint32_t t_width, float* t_row)
+	{
+		if (t_source_width < 2)
+		{
+			return 0;
+		}
+
+#if defined(TNT_X86)
+		switch (t_kernel)
+		{
+		case MipKernel::Avx2:
+			return BoxFloatRowAvx2(t_row0, t_row1, t_width, t_row);
+
+		case MipKernel::Sse2:
+			return BoxFloatRowSse2(t_row0, t_row1, t_width, t_row);
+
+		default:
+			break;
+		}
+#endif
+
+		return 0;
+	}
+
+	std::uint32_t KaiserRow(MipKernel t_kernel, const float* t_padded_row, std::uint32_t t_width, float* t_row)
+	{
+#if defined(TNT_X86)
+		switch (t_kernel)
+		{
+		case MipKernel::Avx2:
+			return KaiserRowAvx2(t_padded_row, t_width, t_row);
+
+		case MipKernel::Sse2:
+			return KaiserRowSse2(t_padded_row, t_width, t_row);
+
+		default:
+			break;
+		}
+#endif
+
+		return 0;
+	}
+
+	std::uint32_t KaiserColumn(MipKernel t_kernel, const float* const* t_rows, std::uint32_t t_value_count, float* t_row)
+	{
+#if defined(TNT_X86)
+		switch (t_kernel)
+		{
+		case MipKernel::Avx2:
+			return KaiserColumnAvx2(t_rows, t_value_count, t_row);
+
+		case MipKernel::Sse2:
+			return KaiserColumnSse2(t_rows, t_value_count, t_row);
+
+		default:
+			break;
+		}
+#endif
+
+		return 0;
+	}
+
+	std::uint32_t EncodeRow(MipKernel t_kernel, const float* t_values, std::uint32_t t_width, bool t_srgb, std::uint8_t* t_row)
+	{
+#if defined(TNT_X86)
+		switch (t_kernel)
+		{
+		case MipKernel::Avx2:
+			return EncodeRowAvx2(t_values, t_width, t_srgb, t_row);
+
+		case MipKernel::Sse2:
+			return t_srgb ? 0 : EncodeLinearRowSse2(t_values, t_width, t_row);
+
+		default:
+			break;
+		}
+#endif
+
+		return 0;
+	}
+
+	std::uint8_t* GetRow(const MipLevel& t_level, std::uint32_t t_y)
+	{
+		return t_level.data + static_cast<size_t>(t_y) * t_level.row_pitch;
+	}
+
+	void GenerateBoxLinearBand(MipKernel t_kernel, const MipLevel& t_source, const MipLevel& t_destination, std::uint32_t t_first_y, std::uint32_t t_end_y)
+	{
+		for (std::uint32_t y = t_first_y; y < t_end_y; ++y)
+		{
+			const std::uint8_t* row0 = GetRow(t_source, std::min(y * 2, t_source.height - 1));
+			const std::uint8_t* row1 = GetRow(t_source, std::min(y * 2 + 1, t_source.height - 1));
+			std::uint8_t* row = GetRow(t_destination, y);
+
+			const std::uint32_t first_x = BoxLinearRow(t_kernel, row0, row1, t_source.width, t_destination.width, row);
+			BoxLinearRowScalar(row0, row1, t_source.width, first_x, t_destination.width, row);
+		}
+	}
+
+	void GenerateBoxFloatBand(MipKernel t_kernel, bool t_srgb, const MipLevel& t_source, const MipLevel& t_destination, std::uint32_t t_first_y, std::uint32_t t_end_y, std::vector<float>& t_scratch)
+	{
+		const size_t source_row_size = static_cast<size_t>(t_source.width) * 4;
+		const size_t row_size = static_cast<size_t>(t_destination.width) * 4;
+
+		t_scratch.resize(source_row_size * 2 + row_size);
+
+		float* source_row0 = t_scratch.data();
+		float* source_row1 = source_row0 + source_row_size;
+		float* filtered_row = source_row1 + source_row_size;
+
+		for (std::uint32_t y = t_first_y; y < t_end_y; ++y)
+		{
+			DecodeRow(GetRow(t_source, std::min(y * 2, t_source.height - 1)), t_source.width, t_srgb, source_row0);
+			DecodeRow(GetRow(t_source, std::min(y * 2 + 1, t_source.height - 1)), t_source.width, t_srgb, source_row1);
+
+			const std::uint32_t first_x = BoxFloatRow(t_kernel, source_row0, source_row1, t_source.width, t_destination.width, filtered_row);
+			BoxFloatRowScalar(source_row0, source_row1, t_source.width, first_x, t_destination.width, filtered_row);
+
+			std::uint8_t* row = GetRow(t_destination, y);
+			const std::uint32_t first_encoded_x = EncodeRow(t_kernel, filtered_row, t_destination.width, t_srgb, row);
+			EncodeRowScalar(filtered_row, first_encoded_x, t_destination.width, t_srgb, row);
+		}
+	}
+
+	// Filters the source rows of the band horizontally first, then every destination row is a weighted sum of 12 of them
+	void GenerateKaiserBand(MipKernel t_kernel, bool t_srgb, const MipLevel& t_source, const MipLevel& t_destination, std::uint32_t t_first_y, std::uint32_t t_end_y, std::vector<float>& t_scratch)
+	{
+		const size_t padded_row_size = static_cast<size_t>(t_source.width + KAISER_RADIUS * 2) * 4;
+		const std::uint32_t value_count = t_destination.width * 4;
+
+		// Source rows 2y - 5 to 2y + 6 feed destination row y
+		const std::int64_t first_source_y = static_cast<std::int64_t>(t_first_y) * 2 - (KAISER_RADIUS - 1);
+		const std::uint32_t source_row_count = (t_end_y - t_first_y) * 2 + KAISER_TAP_COUNT - 2;
+
+		t_scratch.resize(padded_row_size + static_cast<size_t>(source_row_count + 1) * value_count);
+
+		float* padded_row = t_scratch.data();
+		float* filtered_rows = padded_row + padded_row_size;
+		float* column_row = filtered_rows + static_cast<size_t>(source_row_count) * value_count;
+
+		for (std::uint32_t row_index = 0; row_index < source_row_count; ++row_index)
+		{
+			const std::int64_t source_y = std::min(std::max<std::int64_t>(first_source_y + row_index, 0), static_cast<std::int64_t>(t_source.height) - 1);
+
+			DecodeRow(GetRow(t_source, static_cast<std::uint32_t>(source_y)), t_source.width, t_srgb, padded_row + KAISER_RADIUS * 4);
+
+			for (std::uint32_t pad = 0; pad < KAISER_RADIUS; ++pad)
+			{
+				std::copy(padded_row + KAISER_RADIUS * 4, padded_row + KAISER_RADIUS * 4 + 4, padded_row + pad * 4);
+				std::copy(padded_row + padded_row_size - (KAISER_RADIUS + 1) * 4, padded_row + padded_row_size - KAISER_RADIUS * 4, padded_row + padded_row_size - (pad + 1) * 4);
+			}
+
+			float* filtered_row = filtered_rows + static_cast<size_t>(row_index) * value_count;
+
+			const std::uint32_t first_x = KaiserRow(t_kernel, padded_row, t_destination.width, filtered_row);
+			KaiserRowScalar(padded_row, first_x, t_destination.width, filtered_row);
+		}
+
+		for (std::uint32_t y = t_first_y; y < t_end_y; ++y)
+		{
+			const float* rows[KAISER_TAP_COUNT];
+
+			for (std::uint32_t tap = 0; tap < KAISER_TAP_COUNT; ++tap)
+			{
+				rows[tap] = filtered_rows + static_cast<size_t>((y - t_first_y) * 2 + tap) * value_count;
+			}
+
+			const std::uint32_t first_value = KaiserColumn(t_kernel, rows, value_count, column_row);
+			KaiserColumnScalar(rows, first_value, value_count, column_row);
+
+			std::uint8_t* row = GetRow(t_destination, y);
+			const std::uint32_t first_encoded_x = EncodeRow(t_kernel, column_row, t_destination.width, t_srgb, row);
+			EncodeRowScalar(column_row, first_encoded_x, t_destination.width, t_srgb, row);
+		}
+	}
+}
+
+tnt::graphics::MipKernel tnt::graphics::ResolveMipKernel(MipKernel t_kernel)
+{
+#if defined(TNT_X86)
+	const bool has_avx2 = utility::GetCpuFeatures().avx2;
+
+	if (t_kernel == MipKernel::Automatic)
+	{
+		return has_avx2 ? MipKernel::Avx2 : MipKernel::Sse2;
+	}
+
+	if (t_kernel == MipKernel::Avx2 && !has_avx2)
+	{
+		return MipKernel::Sse2;
+	}
+
+	return t_kernel;
+#else
+	return MipKernel::Scalar;
+#endif
+}
+
+const char* tnt::graphics::GetMipFilterName(MipFilter t_filter)
+{
+	switch (t_filter)
+	{
+	case MipFilter::Box:
+		return "box";
+
+	case MipFilter::Kaiser:
+		return "kaiser";
+	}
+
+	return "unknown";
+}
+
+const char* tnt::graphics::GetMipKernelName(MipKernel t_kernel)
+{
+	switch (t_kernel)
+	{
+	case MipKernel::Automatic:
+		return "automatic";
+
+	case MipKernel::Scalar:
+		return "scalar";
+
+	case MipKernel::Sse2:
+		return "sse2";
+
+	case MipKernel::Avx2:
+		return "avx2";
+	}
+
+	return "unknown";
+}
+
+tnt::graphics::MipGenerator::MipGenerator()
+	: m_is_initialized(false)
+	, m_scratch(1)
+{
+}
+
+tnt::graphics::MipGenerator::~MipGenerator()
+{
+}
+
+void tnt::graphics::MipGenerator::Initialize(std::uint32_t t_thread_count)
+{
+	m_thread_pool.Initialize(t_thread_count);
+	m_is_initialized = true;
+
+	m_scratch.clear();
+	m_scratch.resize(m_thread_pool.GetThreadCount());
+}
+
+void tnt::graphics::MipGenerator::Cleanup()
+{
+	m_thread_pool.Cleanup();
+	m_is_initialized = false;
+
+	m_scratch.clear();
+	m_scratch.resize(1);
+}
+
+void tnt::graphics::MipGenerator::GenerateChain(const MipGeneratorSettings& t_settings, const MipLevel* t_levels, std::uint32_t t_level_count)
+{
+	for (std::uint32_t level = 1; level < t_level_count; ++level)
+	{
+		GenerateMip(t_settings, t_levels[level - 1], t_levels[level]);
+	}
+}
+
+void tnt::graphics::MipGenerator::GenerateMip(const MipGeneratorSettings& t_settings, const MipLevel& t_source, const MipLevel& t_destination)
+{
+	if (t_destination.width != std::max(t_source.width / 2, 1u) || t_destination.height != std::max(t_source.height / 2, 1u))
+	{
+		throw std::runtime_error("Mip level is not half the size of the level above it");
+	}
+
+	const MipKernel kernel = ResolveMipKernel(t_settings.kernel);
+	const std::uint32_t band_count = (t_destination.height + MIP_BAND_HEIGHT - 1) / MIP_BAND_HEIGHT;
+
+	auto generate_band = [&](std::uint32_t t_band_index, std::uint32_t t_worker_index)
+	{
+		const std::uint32_t first_y = t_band_index * MIP_BAND_HEIGHT;
+		const std::uint32_t end_y = std::min(first_y + MIP_BAND_HEIGHT, t_destination.height);
+
+		if (t_settings.filter == MipFilter::Kaiser)
+		{
+			GenerateKaiserBand(kernel, t_settings.srgb, t_source, t_destination, first_y, end_y, m_scratch[t_worker_index]);
+		}
+		else if (t_settings.srgb)
+		{
+			GenerateBoxFloatBand(kernel, true, t_source, t_destination, first_y, end_y, m_scratch[t_worker_index]);
+		}
+		else
+		{
+			GenerateBoxLinearBand(kernel, t_source, t_destination, first_y, end_y);
+		}
+	};
+
+	// Small mips are not worth waking the workers for
+	if (!m_is_initialized || band_count == 1)
+	{
+		for (std::uint32_t band_index = 0; band_index < band_count; ++band_index)
+		{
+			generate_band(band_index, 0);
+		}
+
+		return;
+	}
+
+	m_thread_pool.Run(band_count, generate_band);
+}
+
+std::uint32_t tnt::graphics::MipGenerator::GetThreadCount() const
+{
+	return m_is_initialized ? m_thread_pool.GetThreadCount() : 1;
+}
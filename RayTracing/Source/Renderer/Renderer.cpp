@@ -8,10 +8,83 @@ tnt::graphics::Renderer::~Renderer()
 {
 }
 
-void tnt::graphics::Renderer::Initialize()
+void tnt::graphics::Renderer::Initialize(
+	const RendererSettings& t_settings,
+	const std::vector<Vertex>& t_vertices,
+	const std::string& t_texture_path)
 {
+	m_framebuffer.Initialize(t_settings.width, t_settings.height);
+
+	m_ray_tracer.Initialize(t_settings.thread_count);
+	m_ray_tracer.SetTraversalKernel(t_settings.traversal_kernel);
+	m_ray_tracer.SetTraversalMode(t_settings.traversal_mode);
+	m_ray_tracer.SetTileSize(t_settings.tile_size);
+	m_ray_tracer.SetAccumulation(t_settings.accumulation);
+	m_ray_tracer.SetScene(t_vertices, t_settings.bvh_build_settings);
+	m_ray_tracer.LoadTexture(t_texture_path, t_settings.texture_mip_count, t_settings.texture_layout, t_settings.texture_mip_settings, t_settings.texture_format);
+	m_ray_tracer.SetSampler(t_settings.sampler);
+
+	// Same clear color as the D3D12 back buffer
+	m_ray_tracer.SetClearColor({ 0.392f, 0.584f, 0.929f, 0.0f });
 }
 
 void tnt::graphics::Renderer::Cleanup()
 {
+	m_ray_tracer.Cleanup();
+	m_framebuffer.Initialize(0, 0);
+}
+
+void tnt::graphics::Renderer::Render(const SceneConstantBufferData& t_scene_data)
+{
+	m_ray_tracer.Render(t_scene_data, m_framebuffer);
+}
+
+void tnt::graphics::Renderer::ResetAccumulation()
+{
+	m_ray_tracer.ResetAccumulation();
+}
+
+void tnt::graphics::Renderer::SetTraversalKernel(cpu::TraversalKernel t_kernel)
+{
+	m_ray_tracer.SetTraversalKernel(t_kernel);
+}
+
+tnt::graphics::cpu::TraversalKernel tnt::graphics::Renderer::GetTraversalKernel() const
+{
+	return m_ray_tracer.GetTraversalKernel();
+}
+
+void tnt::graphics::Renderer::SetTraversalMode(cpu::TraversalMode t_mode)
+{
+	m_ray_tracer.SetTraversalMode(t_mode);
+}
+
+tnt::graphics::cpu::TraversalMode tnt::graphics::Renderer::GetTraversalMode() const
+{
+	return m_ray_tracer.GetTraversalMode();
+}
+
+const tnt::graphics::cpu::Framebuffer& tnt::graphics::Renderer::GetFramebuffer() const
+{
+	return m_framebuffer;
+}
+
+const tnt::graphics::cpu::AccumulationBuffer& tnt::graphics::Renderer::GetAccumulationBuffer() const
+{
+	return m_ray_tracer.GetAccumulationBuffer();
+}
+
+const tnt::graphics::cpu::RenderStatistics& tnt::graphics::Renderer::GetStatistics() const
+{
+	return m_ray_tracer.GetStatistics();
+}
+
+const std::vector<tnt::graphics::cpu::TileStatistics>& tnt::graphics::Renderer::GetTileStatistics() const
+{
+	return m_ray_tracer.GetTileStatistics();
+}
+
+const tnt::graphics::cpu::BvhBuildStatistics& tnt::graphics::Renderer::GetBvhBuildStatistics() const
+{
+	return m_ray_tracer.GetBvhBuildStatistics();
 }
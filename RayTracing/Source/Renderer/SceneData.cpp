@@ -0,0 +1,172 @@
+#include "Renderer/SceneData.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <unordered_map>
+
+namespace
+{
+	// Units of the viewport per second, the triangle used to move 0.0075 per paint at 60 Hz
+	const float SCROLL_SPEED = 0.45f;
+	const float OFFSET_BOUNDS = 1.5f;
+}
+
+std::vector<tnt::graphics::Vertex> tnt::graphics::CreateTriangleScene()
+{
+	std::vector<Vertex> vertices =
+	{
+		{ {  0.0f,  0.5f, 0.0f, 1.0f }, { 0.5f, 0.0f } },
+		{ {  0.5f, -0.5f, 0.0f, 1.0f }, { 1.0f, 1.0f } },
+		{ { -0.5f, -0.5f, 0.0f, 1.0f }, { 0.0f, 1.0f } }
+	};
+
+	return vertices;
+}
+
+std::vector<tnt::graphics::Vertex> tnt::graphics::CreateTessellatedTriangleScene(std::uint32_t t_subdivisions)
+{
+	const std::vector<Vertex> corners = CreateTriangleScene();
+	const float step = 1.0f / static_cast<float>(t_subdivisions);
+
+	// Barycentric interpolation between the three corners of the original triangle
+	auto interpolate = [&corners](float t_b1, float t_b2)
+	{
+		const float b0 = 1.0f - t_b1 - t_b2;
+
+		Vertex vertex = {};
+		vertex.position.x = corners[0].position.x * b0 + corners[1].position.x * t_b1 + corners[2].position.x * t_b2;
+		vertex.position.y = corners[0].position.y * b0 + corners[1].position.y * t_b1 + corners[2].position.y * t_b2;
+		vertex.position.z = corners[0].position.z * b0 + corners[1].position.z * t_b1 + corners[2].position.z * t_b2;
+		vertex.position.w = 1.0f;
+		vertex.texcoord.x = corners[0].texcoord.x * b0 + corners[1].texcoord.x * t_b1 + corners[2].texcoord.x * t_b2;
+		vertex.texcoord.y = corners[0].texcoord.y * b0 + corners[1].texcoord.y * t_b1 + corners[2].texcoord.y * t_b2;
+
+		return vertex;
+	};
+
+	std::vector<Vertex> vertices;
+	vertices.reserve(static_cast<size_t>(t_subdivisions) * t_subdivisions * 3);
+
+	for (std::uint32_t row = 0; row < t_subdivisions; ++row)
+	{
+		for (std::uint32_t column = 0; column < t_subdivisions - row; ++column)
+		{
+			// Grid coordinates are always computed the same way, so shared vertices are bit identical
+			const float b1 = column * step;
+			const float b2 = row * step;
+			const float next_b1 = (column + 1) * step;
+			const float next_b2 = (row + 1) * step;
+
+			// Upright triangle, same winding as the original one
+			vertices.push_back(interpolate(b1, b2));
+			vertices.push_back(interpolate(next_b1, b2));
+			vertices.push_back(interpolate(b1, next_b2));
+
+			// Every upright triangle except the last one in a row has an inverted neighbour
+			if (column + 1 < t_subdivisions - row)
+			{
+				vertices.push_back(interpolate(next_b1, b2));
+				vertices.push_back(interpolate(next_b1, next_b2));
+				vertices.push_back(interpolate(b1, next_b2));
+			}
+		}
+	}
+
+	return vertices;
+}
+
+void tnt::graphics::IndexVertices(const std::vector<Vertex>& t_vertices, std::vector<Vertex>& t_unique_vertices, std::vector<std::uint32_t>& t_indices)
+{
+	// FNV-1a over the bytes of the vertex, equality is checked on the same bytes
+	struct VertexHash
+	{
+		size_t operator()(const Vertex& t_vertex) const
+		{
+			const std::uint8_t* bytes = reinterpret_cast<const std::uint8_t*>(&t_vertex);
+			std::uint64_t hash = 0xCBF29CE484222325;
+
+			for (size_t index = 0; index < sizeof(Vertex); ++index)
+			{
+				hash ^= bytes[index];
+				hash *= 0x100000001B3;
+			}
+
+			return static_cast<size_t>(hash);
+		}
+	};
+
+	struct VertexEqual
+	{
+		bool operator()(const Vertex& t_first, const Vertex& t_second) const
+		{
+			return memcmp(&t_first, &t_second, sizeof(Vertex)) == 0;
+		}
+	};
+
+	std::unordered_map<Vertex, std::uint32_t, VertexHash, VertexEqual> vertex_indices;
+	vertex_indices.reserve(t_vertices.size());
+
+	t_unique_vertices.clear();
+	t_indices.clear();
+	t_indices.reserve(t_vertices.size());
+
+	for (const Vertex& vertex : t_vertices)
+	{
+		auto result = vertex_indices.emplace(vertex, static_cast<std::uint32_t>(t_unique_vertices.size()));
+
+		if (result.second)
+		{
+			t_unique_vertices.push_back(vertex);
+		}
+
+		t_indices.push_back(result.first->second);
+	}
+}
+
+void tnt::graphics::AdvanceScene(SceneConstantBufferData& t_scene_data, float t_step)
+{
+	t_scene_data.positionOffset.x += SCROLL_SPEED * t_step;
+
+	if (t_scene_data.positionOffset.x > OFFSET_BOUNDS)
+	{
+		t_scene_data.positionOffset.x = -OFFSET_BOUNDS;
+	}
+}
+
+tnt::graphics::SceneConstantBufferData tnt::graphics::InterpolateScene(
+	const SceneConstantBufferData& t_previous,
+	const SceneConstantBufferData& t_current,
+	float t_alpha)
+{
+	// Blending across the wrap would sweep the triangle back over the whole viewport, it comes in from past the left edge instead
+	float previous_x = t_previous.positionOffset.x;
+
+	if (t_current.positionOffset.x < previous_x)
+	{
+		previous_x -= 2.0f * OFFSET_BOUNDS;
+	}
+
+	SceneConstantBufferData scene_data = t_current;
+	scene_data.positionOffset.x = previous_x + (t_current.positionOffset.x - previous_x) * t_alpha;
+	scene_data.positionOffset.y = t_previous.positionOffset.y + (t_current.positionOffset.y - t_previous.positionOffset.y) * t_alpha;
+
+	return scene_data;
+}
+
+tnt::graphics::SceneConstantBufferData tnt::graphics::SimulateScene(
+	utility::FixedTimestep& t_timestep,
+	double t_time,
+	SceneConstantBufferData& t_previous,
+	SceneConstantBufferData& t_current)
+{
+	const std::uint32_t step_count = t_timestep.Advance(t_time);
+	const float step = static_cast<float>(t_timestep.GetStep());
+
+	for (std::uint32_t index = 0; index < step_count; ++index)
+	{
+		t_previous = t_current;
+		AdvanceScene(t_current, step);
+	}
+
+	return InterpolateScene(t_previous, t_current, static_cast<float>(t_timestep.GetAlpha()));
+}
@@ -0,0 +1,334 @@
+#include "Renderer/TextureCache.hpp"
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#if defined(_WIN32)
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace
+{
+	void MakeDirectory(const std::string& t_path)
+	{
+#if defined(_WIN32)
+		_mkdir(t_path.c_str());
+#else
+		mkdir(t_path.c_str(), 0755);
+#endif
+	}
+}
+
+std::string tnt::graphics::GetTemporaryCacheDirectory(const std::string& t_name)
+{
+#if defined(_WIN32)
+	// _dupenv_s instead of getenv, which MSVC flags as unsafe
+	char* temporary_directory = nullptr;
+	std::size_t length = 0;
+	_dupenv_s(&temporary_directory, &length, "TEMP");
+
+	std::string directory = (temporary_directory != nullptr) ? temporary_directory : ".";
+	std::free(temporary_directory);
+#else
+	const char* temporary_directory = std::getenv("TMPDIR");
+	std::string directory = (temporary_directory != nullptr && temporary_directory[0] != '\0') ? temporary_directory : "/tmp";
+#endif
+
+	while (directory.size() > 1 && (directory.back() == '/' || directory.back() == '\\'))
+	{
+		directory.pop_back();
+	}
+
+	return directory + "/" + t_name;
+}
+
+std::uint64_t tnt::graphics::HashTextureSource(const std::uint8_t* t_data, std::uint64_t t_size)
+{
+	std::uint64_t hash = 0xCBF29CE484222325;
+
+	for (std::uint64_t index = 0; index < t_size; ++index)
+	{
+		hash ^= t_data[index];
+		hash *= 0x100000001B3;
+	}
+
+	return hash;
+}
+
+std::uint32_t tnt::graphics::ComputeCachedMipFootprints(
+	TextureFormat t_format,
+	std::uint32_t t_width,
+	std::uint32_t t_height,
+	std::uint32_t t_mip_count,
+	SubresourceFootprint* t_footprints,
+	std::uint64_t& t_data_size)
+{
+	const std::uint32_t mip_count = (t_mip_count == 0) ? GetFullMipCount(t_width, t_height) : t_mip_count;
+
+	return ComputeSubresourceFootprints(t_format, t_width, t_height, std::min(mip_count, TEXTURE_CACHE_MAX_MIP_COUNT), 1, t_footprints, t_data_size);
+}
+
+tnt::graphics::CachedTexture::CachedTexture()
+	: m_header(nullptr)
+{
+}
+
+tnt::graphics::CachedTexture::~CachedTexture()
+{
+}
+
+bool tnt::graphics::CachedTexture::Open(const std::string& t_path)
+{
+	Close();
+
+	if (!m_file.Open(t_path) || m_file.GetSize() < sizeof(TextureCacheHeader))
+	{
+		m_file.Close();
+		return false;
+	}
+
+	const TextureCacheHeader* header = reinterpret_cast<const TextureCacheHeader*>(m_file.GetData());
+
+	if (header->magic != TEXTURE_CACHE_MAGIC
+		|| header->version != TEXTURE_CACHE_VERSION
+		|| header->mip_count == 0
+		|| header->mip_count > TEXTURE_CACHE_MAX_MIP_COUNT
+		|| m_file.GetSize() < sizeof(TextureCacheHeader) + header->data_size)
+	{
+		m_file.Close();
+		return false;
+	}
+
+	m_header = header;
+
+	return true;
+}
+
+void tnt::graphics::CachedTexture::Close()
+{
+	m_file.Close();
+	m_header = nullptr;
+}
+
+const tnt::graphics::TextureCacheHeader& tnt::graphics::CachedTexture::GetHeader() const
+{
+	return *m_header;
+}
+
+const std::uint8_t* tnt::graphics::CachedTexture::GetData() const
+{
+	return m_file.GetData() + sizeof(TextureCacheHeader);
+}
+
+tnt::graphics::TextureCache::TextureCache()
+	: m_mip_count(0)
+	, m_format(TextureFormat::RGBA8)
+	, m_hit_count(0)
+	, m_miss_count(0)
+{
+}
+
+tnt::graphics::TextureCache::~TextureCache()
+{
+}
+
+void tnt::graphics::TextureCache::Initialize(
+	const std::string& t_directory,
+	std::uint32_t t_mip_count,
+	const MipGeneratorSettings& t_mip_settings,
+	TextureFormat t_format)
+{
+	m_directory = t_directory;
+	m_mip_count = t_mip_count;
+	m_mip_settings = t_mip_settings;
+	m_format = t_format;
+	m_hit_count = 0;
+	m_miss_count = 0;
+
+	m_mip_generator.Initialize();
+	m_block_compressor.Initialize();
+
+	MakeDirectory(m_directory);
+}
+
+void tnt::graphics::TextureCache::Load(const std::string& t_source_path, CachedTexture& t_texture)
+{
+	utility::MappedFile source;
+
+	if (!source.Open(t_source_path))
+	{
+		throw std::runtime_error("Could not read texture " + t_source_path);
+	}
+
+	const std::uint64_t source_hash = HashTextureSource(source.GetData(), source.GetSize());
+	const std::string cache_path = GetCachePath(source_hash);
+
+	// A file cooked with other settings is replaced, a hash collision is caught by the stored hash
+	if (t_texture.Open(cache_path))
+	{
+		const TextureCacheHeader& header = t_texture.GetHeader();
+
+		const TextureFormat format = ResolveTextureFormat(m_format, header.width, header.height);
+
+		SubresourceFootprint footprints[TEXTURE_CACHE_MAX_MIP_COUNT];
+		std::uint64_t data_size = 0;
+		const std::uint32_t mip_count = ComputeCachedMipFootprints(format, header.width, header.height, m_mip_count, footprints, data_size);
+
+		const bool same_mips = header.mip_filter == m_mip_settings.filter && (header.is_srgb != 0) == m_mip_settings.srgb;
+
+		if (header.source_hash == source_hash && header.format == format && header.mip_count == mip_count && header.data_size == data_size && same_mips)
+		{
+			++m_hit_count;
+			return;
+		}
+
+		t_texture.Close();
+	}
+
+	++m_miss_count;
+	CookSource(t_source_path, source, source_hash);
+
+	if (!t_texture.Open(cache_path))
+	{
+		throw std::runtime_error("Could not open cooked texture " + cache_path);
+	}
+}
+
+std::string tnt::graphics::TextureCache::Cook(const std::string& t_source_path)
+{
+	utility::MappedFile source;
+
+	if (!source.Open(t_source_path))
+	{
+		throw std::runtime_error("Could not read texture " + t_source_path);
+	}
+
+	return CookSource(t_source_path, source, HashTextureSource(source.GetData(), source.GetSize()));
+}
+
+std::string tnt::graphics::TextureCache::GetCachePath(std::uint64_t t_source_hash) const
+{
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx.tex", static_cast<unsigned long long>(t_source_hash));
+
+	return m_directory + "/" + name;
+}
+
+std::uint32_t tnt::graphics::TextureCache::GetHitCount() const
+{
+	return m_hit_count;
+}
+
+std::uint32_t tnt::graphics::TextureCache::GetMissCount() const
+{
+	return m_miss_count;
+}
+
+std::string tnt::graphics::TextureCache::CookSource(const std::string& t_source_path, const utility::MappedFile& t_source, std::uint64_t t_source_hash)
+{
+	if (t_source.GetSize() > static_cast<std::uint64_t>(INT_MAX))
+	{
+		throw std::runtime_error("Texture " + t_source_path + " is too large to decode");
+	}
+
+	int width = 0;
+	int height = 0;
+	int channel_count = 0;
+	std::uint8_t* rgba = stbi_load_from_memory(t_source.GetData(), static_cast<int>(t_source.GetSize()), &width, &height, &channel_count, STBI_rgb_alpha);
+
+	if (rgba == nullptr)
+	{
+		throw std::runtime_error("Could not decode texture " + t_source_path);
+	}
+
+	TextureCacheHeader header = {};
+	header.magic = TEXTURE_CACHE_MAGIC;
+	header.version = TEXTURE_CACHE_VERSION;
+	header.source_hash = t_source_hash;
+	header.width = static_cast<std::uint32_t>(width);
+	header.height = static_cast<std::uint32_t>(height);
+	header.format = ResolveTextureFormat(m_format, header.width, header.height);
+	header.mip_count = ComputeCachedMipFootprints(header.format, header.width, header.height, m_mip_count, header.mips, header.data_size);
+	header.mip_filter = m_mip_settings.filter;
+	header.is_srgb = m_mip_settings.srgb ? 1 : 0;
+
+	// Mips are generated in RGBA8 footprints first, block compressed formats are encoded from those
+	SubresourceFootprint rgba_mips[TEXTURE_CACHE_MAX_MIP_COUNT];
+	std::uint64_t rgba_data_size = 0;
+	ComputeCachedMipFootprints(TextureFormat::RGBA8, header.width, header.height, header.mip_count, rgba_mips, rgba_data_size);
+
+	// Padding between rows and mips is zeroed so identical sources always give identical files
+	std::vector<std::uint8_t> rgba_data(static_cast<size_t>(rgba_data_size), 0);
+
+	CopySubresource(TextureFormat::RGBA8, rgba, static_cast<size_t>(header.width) * 4, rgba_mips[0], rgba_data.data());
+
+	stbi_image_free(rgba);
+
+	MipLevel levels[TEXTURE_CACHE_MAX_MIP_COUNT];
+
+	for (std::uint32_t mip = 0; mip < header.mip_count; ++mip)
+	{
+		levels[mip].data = &rgba_data[static_cast<size_t>(rgba_mips[mip].offset)];
+		levels[mip].width = rgba_mips[mip].width;
+		levels[mip].height = rgba_mips[mip].height;
+		levels[mip].row_pitch = rgba_mips[mip].row_pitch;
+	}
+
+	m_mip_generator.GenerateChain(m_mip_settings, levels, header.mip_count);
+
+	std::vector<std::uint8_t> data;
+
+	if (IsBlockCompressed(header.format))
+	{
+		data.assign(static_cast<size_t>(header.data_size), 0);
+
+		for (std::uint32_t mip = 0; mip < header.mip_count; ++mip)
+		{
+			m_block_compressor.Encode(header.format, levels[mip], &data[static_cast<size_t>(header.mips[mip].offset)], header.mips[mip].row_pitch);
+		}
+	}
+	else
+	{
+		data.swap(rgba_data);
+	}
+
+	// Written next to the final file first, a reader never maps a half written cache file
+	const std::string cache_path = GetCachePath(t_source_hash);
+	const std::string temporary_path = cache_path + ".tmp";
+
+	{
+		std::ofstream file(temporary_path, std::ios::binary);
+
+		if (!file)
+		{
+			throw std::runtime_error("Could not open " + temporary_path + " for writing");
+		}
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+		if (!file)
+		{
+			throw std::runtime_error("Could not write " + temporary_path);
+		}
+	}
+
+	std::remove(cache_path.c_str());
+
+	if (std::rename(temporary_path.c_str(), cache_path.c_str()) != 0)
+	{
+		throw std::runtime_error("Could not move " + temporary_path + " to " + cache_path);
+	}
+
+	return cache_path;
+}
@@ -0,0 +1,159 @@
+#include "Renderer/TextureFootprint.hpp"
+
+#include "Utility/CpuFeatures.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(TNT_X86)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	std::uint64_t AlignUp(std::uint64_t t_value, std::uint64_t t_alignment)
+	{
+		return (t_value + t_alignment - 1) / t_alignment * t_alignment;
+	}
+
+#if defined(TNT_X86)
+	// Four cache line halves per iteration, the tail that is not a multiple of 16 bytes goes through memcpy
+	void StreamRow(const std::uint8_t* t_source, std::uint8_t* t_destination, size_t t_size)
+	{
+		size_t offset = 0;
+
+		for (; offset + 64 <= t_size; offset += 64)
+		{
+			const __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(t_source + offset));
+			const __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(t_source + offset + 16));
+			const __m128i third = _mm_loadu_si128(reinterpret_cast<const __m128i*>(t_source + offset + 32));
+			const __m128i fourth = _mm_loadu_si128(reinterpret_cast<const __m128i*>(t_source + offset + 48));
+
+			_mm_stream_si128(reinterpret_cast<__m128i*>(t_destination + offset), first);
+			_mm_stream_si128(reinterpret_cast<__m128i*>(t_destination + offset + 16), second);
+			_mm_stream_si128(reinterpret_cast<__m128i*>(t_destination + offset + 32), third);
+			_mm_stream_si128(reinterpret_cast<__m128i*>(t_destination + offset + 48), fourth);
+		}
+
+		for (; offset + 16 <= t_size; offset += 16)
+		{
+			_mm_stream_si128(reinterpret_cast<__m128i*>(t_destination + offset), _mm_loadu_si128(reinterpret_cast<const __m128i*>(t_source + offset)));
+		}
+
+		memcpy(t_destination + offset, t_source + offset, t_size - offset);
+	}
+#endif
+}
+
+std::uint32_t tnt::graphics::GetFullMipCount(std::uint32_t t_width, std::uint32_t t_height)
+{
+	std::uint32_t mip_count = 0;
+
+	for (std::uint32_t size = std::max(t_width, t_height); size > 0; size >>= 1)
+	{
+		++mip_count;
+	}
+
+	return mip_count;
+}
+
+std::uint32_t tnt::graphics::GetRowSize(TextureFormat t_format, std::uint32_t t_width)
+{
+	const std::uint32_t block_size = GetFormatBlockSize(t_format);
+
+	return (t_width + block_size - 1) / block_size * GetFormatBlockByteCount(t_format);
+}
+
+std::uint32_t tnt::graphics::ComputeSubresourceFootprints(
+	TextureFormat t_format,
+	std::uint32_t t_width,
+	std::uint32_t t_height,
+	std::uint32_t t_mip_count,
+	std::uint32_t t_array_size,
+	SubresourceFootprint* t_footprints,
+	std::uint64_t& t_total_size)
+{
+	const std::uint32_t full_mip_count = GetFullMipCount(t_width, t_height);
+	const std::uint32_t mip_count = (t_mip_count == 0) ? full_mip_count : std::min(t_mip_count, full_mip_count);
+	const std::uint32_t block_size = GetFormatBlockSize(t_format);
+
+	std::uint64_t offset = 0;
+	t_total_size = 0;
+
+	for (std::uint32_t slice = 0; slice < t_array_size; ++slice)
+	{
+		std::uint32_t width = t_width;
+		std::uint32_t height = t_height;
+
+		for (std::uint32_t mip = 0; mip < mip_count; ++mip)
+		{
+			const std::uint64_t row_size = GetRowSize(t_format, width);
+
+			SubresourceFootprint& footprint = t_footprints[slice * mip_count + mip];
+			footprint.offset = AlignUp(offset, TEXTURE_PLACEMENT_ALIGNMENT);
+			footprint.width = width;
+			footprint.height = height;
+			footprint.row_pitch = static_cast<std::uint32_t>(AlignUp(row_size, TEXTURE_ROW_PITCH_ALIGNMENT));
+			footprint.row_count = (height + block_size - 1) / block_size;
+
+			offset = footprint.offset + static_cast<std::uint64_t>(footprint.row_pitch) * (footprint.row_count - 1) + row_size;
+			t_total_size = offset;
+
+			width = std::max(width / 2, 1u);
+			height = std::max(height / 2, 1u);
+		}
+	}
+
+	return mip_count;
+}
+
+void tnt::graphics::CopyRows(
+	const std::uint8_t* t_source,
+	size_t t_source_row_pitch,
+	std::uint8_t* t_destination,
+	size_t t_destination_row_pitch,
+	size_t t_row_size,
+	std::uint32_t t_row_count,
+	size_t t_streaming_min_size)
+{
+	size_t row_size = t_row_size;
+	std::uint32_t row_count = t_row_count;
+
+	if (t_source_row_pitch == t_row_size && t_destination_row_pitch == t_row_size)
+	{
+		row_size *= row_count;
+		row_count = 1;
+	}
+
+#if defined(TNT_X86)
+	const bool is_aligned = reinterpret_cast<std::uintptr_t>(t_destination) % 16 == 0 && t_destination_row_pitch % 16 == 0;
+	const bool is_large = static_cast<std::uint64_t>(t_row_size) * t_row_count >= t_streaming_min_size;
+
+	if (is_aligned && is_large)
+	{
+		for (std::uint32_t row = 0; row < row_count; ++row)
+		{
+			StreamRow(t_source + row * t_source_row_pitch, t_destination + row * t_destination_row_pitch, row_size);
+		}
+
+		// Streaming stores are weakly ordered, the copy has to be visible before the command list is submitted
+		_mm_sfence();
+		return;
+	}
+#endif
+
+	for (std::uint32_t row = 0; row < row_count; ++row)
+	{
+		memcpy(t_destination + row * t_destination_row_pitch, t_source + row * t_source_row_pitch, row_size);
+	}
+}
+
+void tnt::graphics::CopySubresource(
+	TextureFormat t_format,
+	const std::uint8_t* t_source,
+	size_t t_source_row_pitch,
+	const SubresourceFootprint& t_footprint,
+	std::uint8_t* t_destination)
+{
+	CopyRows(t_source, t_source_row_pitch, t_destination + t_footprint.offset, t_footprint.row_pitch, GetRowSize(t_format, t_footprint.width), t_footprint.row_count);
+}
@@ -0,0 +1,82 @@
+#include "Utility/CpuFeatures.hpp"
+
+#if defined(TNT_X86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace
+{
+	tnt::utility::CpuFeatures QueryCpuFeatures()
+	{
+		tnt::utility::CpuFeatures features = { false, false, false, false };
+
+#if defined(TNT_X86)
+		unsigned int leaf_one[4] = {};
+		unsigned int leaf_seven[4] = {};
+
+#if defined(_MSC_VER)
+		int registers[4] = {};
+		__cpuid(registers, 0);
+		const int highest_leaf = registers[0];
+
+		__cpuid(registers, 1);
+		for (int index = 0; index < 4; ++index)
+		{
+			leaf_one[index] = static_cast<unsigned int>(registers[index]);
+		}
+
+		if (highest_leaf >= 7)
+		{
+			__cpuidex(registers, 7, 0);
+			for (int index = 0; index < 4; ++index)
+			{
+				leaf_seven[index] = static_cast<unsigned int>(registers[index]);
+			}
+		}
+#else
+		const unsigned int highest_leaf = __get_cpuid_max(0, nullptr);
+
+		__get_cpuid(1, &leaf_one[0], &leaf_one[1], &leaf_one[2], &leaf_one[3]);
+
+		if (highest_leaf >= 7)
+		{
+			__cpuid_count(7, 0, leaf_seven[0], leaf_seven[1], leaf_seven[2], leaf_seven[3]);
+		}
+#endif
+
+		const bool has_osxsave = (leaf_one[2] & (1u << 27)) != 0;
+		bool os_saves_ymm = false;
+
+		if (has_osxsave)
+		{
+			// XCR0 bits 1 and 2: the OS preserves the SSE and AVX state on context switches
+#if defined(_MSC_VER)
+			const unsigned long long xcr0 = _xgetbv(0);
+#else
+			unsigned int eax = 0;
+			unsigned int edx = 0;
+			__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+			const unsigned long long xcr0 = (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+			os_saves_ymm = (xcr0 & 0x6) == 0x6;
+		}
+
+		features.sse41 = (leaf_one[2] & (1u << 19)) != 0;
+		features.avx = os_saves_ymm && (leaf_one[2] & (1u << 28)) != 0;
+		features.fma = features.avx && (leaf_one[2] & (1u << 12)) != 0;
+		features.avx2 = features.avx && (leaf_seven[1] & (1u << 5)) != 0;
+#endif
+
+		return features;
+	}
+}
+
+const tnt::utility::CpuFeatures& tnt::utility::GetCpuFeatures()
+{
+	static const CpuFeatures features = QueryCpuFeatures();
+	return features;
+}
@@ -0,0 +1,153 @@
+#include "Utility/DescriptorTableCache.hpp"
+
+tnt::utility::DescriptorTableCache::DescriptorTableCache()
+	: m_descriptor_size(0)
+	, m_pending_count(0)
+{
+}
+
+tnt::utility::DescriptorTableCache::~DescriptorTableCache()
+{
+}
+
+void tnt::utility::DescriptorTableCache::Initialize(std::uint64_t t_capacity, std::uint64_t t_descriptor_size)
+{
+	m_ring.Initialize(t_capacity);
+	m_descriptor_size = t_descriptor_size;
+
+	m_tables.clear();
+	m_table_sources.clear();
+	ClearPending();
+}
+
+std::uint64_t tnt::utility::DescriptorTableCache::Allocate(const std::uint64_t* t_sources, std::uint32_t t_count)
+{
+	const std::uint64_t hash = HashSources(t_sources, t_count);
+	auto table = m_tables.find(hash);
+
+	if (table != m_tables.end() && HasSources(table->second, t_sources, t_count))
+	{
+		return table->second.offset;
+	}
+
+	const std::uint64_t offset = m_ring.Allocate(t_count, 1);
+
+	if (offset == INVALID_RING_OFFSET)
+	{
+		return INVALID_RING_OFFSET;
+	}
+
+	for (std::uint32_t index = 0; index < t_count; ++index)
+	{
+		AddCopy(offset + index, t_sources[index]);
+	}
+
+	// A hash collision replaces the older table, it stays valid but is copied again when it comes back
+	m_tables[hash] = { offset, static_cast<std::uint32_t>(m_table_sources.size()), t_count };
+	m_table_sources.insert(m_table_sources.end(), t_sources, t_sources + t_count);
+
+	return offset;
+}
+
+const std::vector<tnt::utility::DescriptorRange>& tnt::utility::DescriptorTableCache::GetDestinationRanges() const
+{
+	return m_destination_ranges;
+}
+
+const std::vector<tnt::utility::DescriptorRange>& tnt::utility::DescriptorTableCache::GetSourceRanges() const
+{
+	return m_source_ranges;
+}
+
+std::uint32_t tnt::utility::DescriptorTableCache::GetPendingCount() const
+{
+	return m_pending_count;
+}
+
+void tnt::utility::DescriptorTableCache::ClearPending()
+{
+	m_destination_ranges.clear();
+	m_source_ranges.clear();
+	m_pending_count = 0;
+}
+
+void tnt::utility::DescriptorTableCache::FinishFrame(std::uint64_t t_fence_value)
+{
+	m_ring.FinishFrame(t_fence_value);
+
+	// The next frame cannot point at these tables, their descriptors are freed with this frame
+	m_tables.clear();
+	m_table_sources.clear();
+}
+
+void tnt::utility::DescriptorTableCache::Retire(std::uint64_t t_completed_fence_value)
+{
+	m_ring.Retire(t_completed_fence_value);
+}
+
+std::uint64_t tnt::utility::DescriptorTableCache::GetCapacity() const
+{
+	return m_ring.GetCapacity();
+}
+
+std::uint64_t tnt::utility::DescriptorTableCache::GetUsedCount() const
+{
+	return m_ring.GetUsedSize();
+}
+
+std::uint64_t tnt::utility::DescriptorTableCache::HashSources(const std::uint64_t* t_sources, std::uint32_t t_count) const
+{
+	// FNV-1a over the handle values, the count is mixed in so a table and its prefix hash differently
+	std::uint64_t hash = 0xCBF29CE484222325;
+
+	hash = (hash ^ t_count) * 0x100000001B3;
+
+	for (std::uint32_t index = 0; index < t_count; ++index)
+	{
+		hash = (hash ^ t_sources[index]) * 0x100000001B3;
+	}
+
+	return hash;
+}
+
+bool tnt::utility::DescriptorTableCache::HasSources(const Table& t_table, const std::uint64_t* t_sources, std::uint32_t t_count) const
+{
+	if (t_table.count != t_count)
+	{
+		return false;
+	}
+
+	for (std::uint32_t index = 0; index < t_count; ++index)
+	{
+		if (m_table_sources[t_table.first_source + index] != t_sources[index])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void tnt::utility::DescriptorTableCache::AddCopy(std::uint64_t t_destination, std::uint64_t t_source)
+{
+	// Tables follow each other in the ring, so a frame usually ends up with a single destination range
+	if (!m_destination_ranges.empty() && m_destination_ranges.back().start + m_destination_ranges.back().count == t_destination)
+	{
+		m_destination_ranges.back().count++;
+	}
+	else
+	{
+		m_destination_ranges.push_back({ t_destination, 1 });
+	}
+
+	if (!m_source_ranges.empty() && m_source_ranges.back().start + m_source_ranges.back().count * m_descriptor_size == t_source)
+	{
+		m_source_ranges.back().count++;
+	}
+	else
+	{
+		m_source_ranges.push_back({ t_source, 1 });
+	}
+
+	m_pending_count++;
+}
@@ -0,0 +1,97 @@
+#include "Utility/FixedTimestep.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+tnt::utility::FixedTimestep::FixedTimestep()
+	: m_step(0.0)
+	, m_max_steps_per_frame(0)
+	, m_started(false)
+	, m_last_time(0.0)
+	, m_accumulated_time(0.0)
+	, m_dropped_time(0.0)
+	, m_step_count(0)
+	, m_frame_count(0)
+{
+}
+
+tnt::utility::FixedTimestep::~FixedTimestep()
+{
+}
+
+void tnt::utility::FixedTimestep::Initialize(double t_step, std::uint32_t t_max_steps_per_frame)
+{
+	if (!(t_step > 0.0))
+	{
+		throw std::runtime_error("Simulation step has to be longer than zero");
+	}
+
+	m_step = t_step;
+	m_max_steps_per_frame = std::max<std::uint32_t>(t_max_steps_per_frame, 1);
+
+	m_started = false;
+	m_last_time = 0.0;
+	m_accumulated_time = 0.0;
+	m_dropped_time = 0.0;
+	m_step_count = 0;
+	m_frame_count = 0;
+}
+
+std::uint32_t tnt::utility::FixedTimestep::Advance(double t_time)
+{
+	m_frame_count++;
+
+	if (!m_started)
+	{
+		m_started = true;
+		m_last_time = t_time;
+
+		return 0;
+	}
+
+	// A clock that goes backwards is treated as no time passing
+	m_accumulated_time += std::max(t_time - m_last_time, 0.0);
+	m_last_time = t_time;
+
+	const std::uint64_t whole_step_count = static_cast<std::uint64_t>(std::floor(m_accumulated_time / m_step));
+	const std::uint64_t step_count = std::min<std::uint64_t>(whole_step_count, m_max_steps_per_frame);
+
+	m_dropped_time += (whole_step_count - step_count) * m_step;
+
+	// Rounding can leave a hair below zero or up to a whole step, the latter is run next frame
+	m_accumulated_time = std::max(m_accumulated_time - whole_step_count * m_step, 0.0);
+	m_step_count += step_count;
+
+	return static_cast<std::uint32_t>(step_count);
+}
+
+double tnt::utility::FixedTimestep::GetAlpha() const
+{
+	return std::min(m_accumulated_time / m_step, 1.0);
+}
+
+double tnt::utility::FixedTimestep::GetStep() const
+{
+	return m_step;
+}
+
+double tnt::utility::FixedTimestep::GetSimulationTime() const
+{
+	return m_step_count * m_step;
+}
+
+std::uint64_t tnt::utility::FixedTimestep::GetStepCount() const
+{
+	return m_step_count;
+}
+
+std::uint64_t tnt::utility::FixedTimestep::GetFrameCount() const
+{
+	return m_frame_count;
+}
+
+double tnt::utility::FixedTimestep::GetDroppedTime() const
+{
+	return m_dropped_time;
+}
@@ -0,0 +1,201 @@
+#include "Utility/FramePacer.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+	// Frames that are still being recorded or have not been submitted cannot complete yet
+	const std::uint64_t UNSUBMITTED_FENCE_VALUE = 0xFFFFFFFFFFFFFFFF;
+}
+
+tnt::utility::FramePacer::FramePacer()
+	: m_frames_in_flight(0)
+	, m_timeline_length(0)
+	, m_frame_count(0)
+	, m_wait_value(0)
+	, m_last_signaled_value(0)
+	, m_completed_value(0)
+	, m_fence_stall_count(0)
+	, m_fence_stall_time(0.0)
+	, m_incomplete_count(0)
+{
+}
+
+tnt::utility::FramePacer::~FramePacer()
+{
+}
+
+void tnt::utility::FramePacer::Initialize(std::uint32_t t_frames_in_flight, std::uint32_t t_timeline_length)
+{
+	if (t_frames_in_flight == 0)
+	{
+		throw std::runtime_error("At least one frame has to be in flight");
+	}
+
+	m_frames_in_flight = t_frames_in_flight;
+	m_timeline_length = std::max<std::uint32_t>(t_timeline_length, 1);
+	m_slot_fence_values.assign(t_frames_in_flight, 0);
+
+	m_frame_count = 0;
+	m_wait_value = 0;
+	m_last_signaled_value = 0;
+	m_completed_value = 0;
+	m_fence_stall_count = 0;
+	m_fence_stall_time = 0.0;
+
+	m_timeline.clear();
+	m_incomplete_count = 0;
+}
+
+void tnt::utility::FramePacer::BeginFrame(double t_time)
+{
+	if (m_timeline.size() == m_timeline_length)
+	{
+		m_timeline.pop_front();
+		m_incomplete_count = std::min(m_incomplete_count, m_timeline.size());
+	}
+
+	m_timeline.push_back({ m_frame_count, UNSUBMITTED_FENCE_VALUE, t_time, t_time, t_time, -1.0, -1.0 });
+	m_incomplete_count++;
+}
+
+std::uint64_t tnt::utility::FramePacer::EndLatencyWait(std::uint64_t t_completed_fence_value, double t_time)
+{
+	UpdateCompletedValue(t_completed_fence_value, t_time);
+	m_timeline.back().latency_wait_end_time = t_time;
+
+	// The slot was last used N frames ago, everything after that may still be queued
+	const std::uint64_t slot_fence_value = m_slot_fence_values[GetFrameSlot()];
+	m_wait_value = (slot_fence_value > m_completed_value) ? slot_fence_value : 0;
+
+	return m_wait_value;
+}
+
+void tnt::utility::FramePacer::BeginRecording(std::uint64_t t_completed_fence_value, double t_time)
+{
+	UpdateCompletedValue(t_completed_fence_value, t_time);
+
+	if (m_completed_value < m_wait_value)
+	{
+		throw std::runtime_error("Frame started recording before the frame it replaces completed");
+	}
+
+	FrameTiming& timing = m_timeline.back();
+	timing.record_time = t_time;
+
+	if (m_wait_value != 0)
+	{
+		m_fence_stall_count++;
+		m_fence_stall_time += t_time - timing.latency_wait_end_time;
+	}
+}
+
+std::uint64_t tnt::utility::FramePacer::EndFrame(double t_time)
+{
+	const std::uint64_t fence_value = ++m_last_signaled_value;
+
+	m_slot_fence_values[GetFrameSlot()] = fence_value;
+	m_frame_count++;
+	m_wait_value = 0;
+
+	FrameTiming& timing = m_timeline.back();
+	timing.fence_value = fence_value;
+	timing.submit_time = t_time;
+
+	return fence_value;
+}
+
+std::uint64_t tnt::utility::FramePacer::Flush()
+{
+	return ++m_last_signaled_value;
+}
+
+void tnt::utility::FramePacer::UpdateCompletedValue(std::uint64_t t_completed_fence_value, double t_time)
+{
+	m_completed_value = std::max(m_completed_value, t_completed_fence_value);
+
+	// Frames complete in submission order, so the incomplete ones are always the newest
+	while (m_incomplete_count > 0)
+	{
+		FrameTiming& timing = m_timeline[m_timeline.size() - m_incomplete_count];
+
+		if (timing.fence_value > m_completed_value)
+		{
+			break;
+		}
+
+		timing.complete_time = t_time;
+		m_incomplete_count--;
+	}
+}
+
+std::uint32_t tnt::utility::FramePacer::GetFrameSlot() const
+{
+	return static_cast<std::uint32_t>(m_frame_count % m_frames_in_flight);
+}
+
+std::uint32_t tnt::utility::FramePacer::GetFramesInFlight() const
+{
+	return m_frames_in_flight;
+}
+
+std::uint64_t tnt::utility::FramePacer::GetFrameCount() const
+{
+	return m_frame_count;
+}
+
+std::uint64_t tnt::utility::FramePacer::GetLastSignaledValue() const
+{
+	return m_last_signaled_value;
+}
+
+std::uint64_t tnt::utility::FramePacer::GetFenceStallCount() const
+{
+	return m_fence_stall_count;
+}
+
+double tnt::utility::FramePacer::GetFenceStallTime() const
+{
+	return m_fence_stall_time;
+}
+
+const std::deque<tnt::utility::FrameTiming>& tnt::utility::FramePacer::GetTimeline() const
+{
+	return m_timeline;
+}
+
+void tnt::utility::FramePacer::WriteTimeline(std::ostream& t_stream) const
+{
+	t_stream << "frame,fence_value,begin_ms,latency_wait_ms,fence_wait_ms,record_ms,submit_to_complete_ms\n";
+
+	if (m_timeline.empty())
+	{
+		return;
+	}
+
+	const double start_time = m_timeline.front().begin_time;
+
+	for (const FrameTiming& timing : m_timeline)
+	{
+		// Frames still being recorded have no submit time yet
+		if (timing.submit_time < 0.0)
+		{
+			continue;
+		}
+
+		t_stream << timing.frame << "," << timing.fence_value << ",";
+		t_stream << (timing.begin_time - start_time) * 1000.0 << ",";
+		t_stream << (timing.latency_wait_end_time - timing.begin_time) * 1000.0 << ",";
+		t_stream << (timing.record_time - timing.latency_wait_end_time) * 1000.0 << ",";
+		t_stream << (timing.submit_time - timing.record_time) * 1000.0 << ",";
+
+		// Submit to the first time the fence was seen at the frame's value, empty while the frame is in flight
+		if (timing.complete_time >= 0.0)
+		{
+			t_stream << (timing.complete_time - timing.submit_time) * 1000.0;
+		}
+
+		t_stream << "\n";
+	}
+}
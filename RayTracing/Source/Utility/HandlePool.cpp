@@ -0,0 +1,124 @@
+#include "Utility/HandlePool.hpp"
+
+#include <stdexcept>
+
+tnt::utility::HandlePool::HandlePool()
+	: m_allocated_count(0)
+{
+}
+
+tnt::utility::HandlePool::~HandlePool()
+{
+}
+
+void tnt::utility::HandlePool::Initialize(std::uint32_t t_capacity)
+{
+	if (t_capacity > MAX_HANDLE_POOL_CAPACITY)
+	{
+		throw std::runtime_error("Handle pool capacity does not fit in the index bits");
+	}
+
+	m_generations.assign(t_capacity, 1);
+	m_is_allocated.assign(t_capacity, false);
+
+	m_free_indices.clear();
+
+	for (std::uint32_t index = 0; index < t_capacity; ++index)
+	{
+		m_free_indices.push_back(index);
+	}
+
+	m_freed_indices.clear();
+	m_pending_frees.clear();
+	m_allocated_count = 0;
+}
+
+std::uint32_t tnt::utility::HandlePool::Allocate()
+{
+	if (m_free_indices.empty())
+	{
+		return INVALID_POOL_HANDLE;
+	}
+
+	const std::uint32_t index = m_free_indices.front();
+	m_free_indices.pop_front();
+
+	m_is_allocated[index] = true;
+	m_allocated_count++;
+
+	return (m_generations[index] << HANDLE_INDEX_BITS) | index;
+}
+
+void tnt::utility::HandlePool::Free(std::uint32_t t_handle)
+{
+	if (!IsValid(t_handle))
+	{
+		throw std::runtime_error("Freeing a handle that is not allocated");
+	}
+
+	const std::uint32_t index = t_handle & HANDLE_INDEX_MASK;
+
+	// The next generation is handed out with the slot, zero is skipped so no handle is ever INVALID_POOL_HANDLE
+	m_generations[index] = (m_generations[index] == HANDLE_GENERATION_MASK) ? 1 : m_generations[index] + 1;
+
+	m_is_allocated[index] = false;
+	m_allocated_count--;
+
+	m_freed_indices.push_back(index);
+}
+
+bool tnt::utility::HandlePool::IsValid(std::uint32_t t_handle) const
+{
+	const std::uint32_t index = t_handle & HANDLE_INDEX_MASK;
+
+	return index < m_generations.size() && m_is_allocated[index] && m_generations[index] == (t_handle >> HANDLE_INDEX_BITS);
+}
+
+std::uint32_t tnt::utility::HandlePool::GetIndex(std::uint32_t t_handle) const
+{
+	if (!IsValid(t_handle))
+	{
+		throw std::runtime_error("Using a handle that was freed or never allocated");
+	}
+
+	return t_handle & HANDLE_INDEX_MASK;
+}
+
+void tnt::utility::HandlePool::FinishFrame(std::uint64_t t_fence_value)
+{
+	for (std::uint32_t index : m_freed_indices)
+	{
+		m_pending_frees.push_back({ index, t_fence_value });
+	}
+
+	m_freed_indices.clear();
+}
+
+void tnt::utility::HandlePool::Retire(std::uint64_t t_completed_fence_value, std::vector<std::uint32_t>* t_retired_indices)
+{
+	while (!m_pending_frees.empty() && m_pending_frees.front().fence_value <= t_completed_fence_value)
+	{
+		if (t_retired_indices != nullptr)
+		{
+			t_retired_indices->push_back(m_pending_frees.front().index);
+		}
+
+		m_free_indices.push_back(m_pending_frees.front().index);
+		m_pending_frees.pop_front();
+	}
+}
+
+std::uint32_t tnt::utility::HandlePool::GetCapacity() const
+{
+	return static_cast<std::uint32_t>(m_generations.size());
+}
+
+std::uint32_t tnt::utility::HandlePool::GetAllocatedCount() const
+{
+	return m_allocated_count;
+}
+
+std::uint32_t tnt::utility::HandlePool::GetPendingFreeCount() const
+{
+	return static_cast<std::uint32_t>(m_freed_indices.size() + m_pending_frees.size());
+}
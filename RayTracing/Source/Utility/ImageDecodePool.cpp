@@ -0,0 +1,270 @@
+#include "Utility/ImageDecodePool.hpp"
+
+#include "Utility/MappedFile.hpp"
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <climits>
+
+tnt::utility::ImageDecodePool::ImageDecodePool()
+	: m_memory_budget(DEFAULT_DECODE_MEMORY_BUDGET)
+	, m_pending_count(0)
+	, m_memory_in_flight(0)
+	, m_peak_memory_in_flight(0)
+	, m_is_stopping(false)
+{
+}
+
+tnt::utility::ImageDecodePool::~ImageDecodePool()
+{
+	Cleanup();
+}
+
+void tnt::utility::ImageDecodePool::Initialize(std::uint32_t t_thread_count, std::uint64_t t_memory_budget)
+{
+	Cleanup();
+
+	if (t_thread_count == 0)
+	{
+		t_thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+
+	m_memory_budget = t_memory_budget;
+	m_pending_count = 0;
+	m_memory_in_flight = 0;
+	m_peak_memory_in_flight = 0;
+	m_is_stopping = false;
+
+	for (std::uint32_t index = 0; index < t_thread_count; ++index)
+	{
+		m_workers.emplace_back(&ImageDecodePool::WorkerLoop, this);
+	}
+}
+
+void tnt::utility::ImageDecodePool::Cleanup()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_is_stopping = true;
+	}
+
+	m_request_condition.notify_all();
+	m_memory_condition.notify_all();
+
+	for (std::thread& worker : m_workers)
+	{
+		worker.join();
+	}
+
+	m_workers.clear();
+
+	for (DecodedImage& image : m_results)
+	{
+		stbi_image_free(image.rgba);
+	}
+
+	m_requests.clear();
+	m_results.clear();
+	m_pending_count = 0;
+}
+
+void tnt::utility::ImageDecodePool::Request(const std::string& t_path, std::uint64_t t_tag)
+{
+	DecodeRequest request;
+	request.path = t_path;
+	request.tag = t_tag;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_requests.push_back(request);
+		++m_pending_count;
+	}
+
+	m_request_condition.notify_one();
+}
+
+bool tnt::utility::ImageDecodePool::TryPop(DecodedImage& t_image)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_results.empty())
+	{
+		return false;
+	}
+
+	t_image = m_results.front();
+	m_results.pop_front();
+	--m_pending_count;
+
+	return true;
+}
+
+bool tnt::utility::ImageDecodePool::WaitAndPop(DecodedImage& t_image)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	if (m_pending_count == 0)
+	{
+		return false;
+	}
+
+	m_result_condition.wait(lock, [this]()
+	{
+		return !m_results.empty();
+	});
+
+	t_image = m_results.front();
+	m_results.pop_front();
+	--m_pending_count;
+
+	return true;
+}
+
+void tnt::utility::ImageDecodePool::Free(DecodedImage& t_image)
+{
+	const std::uint64_t decoded_size = (t_image.rgba != nullptr) ? static_cast<std::uint64_t>(t_image.width) * t_image.height * STBI_rgb_alpha : 0;
+
+	stbi_image_free(t_image.rgba);
+	t_image.rgba = nullptr;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		ReleaseMemory(decoded_size);
+	}
+
+	m_memory_condition.notify_all();
+}
+
+std::uint32_t tnt::utility::ImageDecodePool::GetPendingCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_pending_count;
+}
+
+std::uint32_t tnt::utility::ImageDecodePool::GetThreadCount() const
+{
+	return static_cast<std::uint32_t>(m_workers.size());
+}
+
+std::uint64_t tnt::utility::ImageDecodePool::GetMemoryInFlight() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_memory_in_flight;
+}
+
+std::uint64_t tnt::utility::ImageDecodePool::GetPeakMemoryInFlight() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_peak_memory_in_flight;
+}
+
+void tnt::utility::ImageDecodePool::WorkerLoop()
+{
+	for (;;)
+	{
+		DecodeRequest request;
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_request_condition.wait(lock, [this]()
+			{
+				return m_is_stopping || !m_requests.empty();
+			});
+
+			if (m_is_stopping)
+			{
+				return;
+			}
+
+			request = m_requests.front();
+			m_requests.pop_front();
+		}
+
+		DecodedImage image;
+		Decode(request, image);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_results.push_back(image);
+		}
+
+		m_result_condition.notify_all();
+	}
+}
+
+void tnt::utility::ImageDecodePool::Decode(const DecodeRequest& t_request, DecodedImage& t_image)
+{
+	t_image.path = t_request.path;
+	t_image.tag = t_request.tag;
+	t_image.width = 0;
+	t_image.height = 0;
+	t_image.rgba = nullptr;
+	t_image.encoded_size = 0;
+
+	MappedFile file;
+
+	if (!file.Open(t_request.path) || file.GetSize() > static_cast<std::uint64_t>(INT_MAX))
+	{
+		return;
+	}
+
+	const int encoded_size = static_cast<int>(file.GetSize());
+	t_image.encoded_size = file.GetSize();
+
+	// Only the header is parsed here, which gives the decoded size before any memory is committed
+	int width = 0;
+	int height = 0;
+	int channel_count = 0;
+
+	if (!stbi_info_from_memory(file.GetData(), encoded_size, &width, &height, &channel_count))
+	{
+		return;
+	}
+
+	const std::uint64_t decoded_size = static_cast<std::uint64_t>(width) * height * STBI_rgb_alpha;
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		AcquireMemory(lock, t_image.encoded_size + decoded_size);
+
+		if (m_is_stopping)
+		{
+			ReleaseMemory(t_image.encoded_size + decoded_size);
+			return;
+		}
+	}
+
+	t_image.rgba = stbi_load_from_memory(file.GetData(), encoded_size, &width, &height, &channel_count, STBI_rgb_alpha);
+	t_image.width = static_cast<std::uint32_t>(width);
+	t_image.height = static_cast<std::uint32_t>(height);
+
+	file.Close();
+
+	// The mapped file no longer counts, the pixels do until the image is freed
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		ReleaseMemory((t_image.rgba != nullptr) ? t_image.encoded_size : t_image.encoded_size + decoded_size);
+	}
+
+	m_memory_condition.notify_all();
+}
+
+void tnt::utility::ImageDecodePool::AcquireMemory(std::unique_lock<std::mutex>& t_lock, std::uint64_t t_size)
+{
+	m_memory_condition.wait(t_lock, [this, t_size]()
+	{
+		return m_is_stopping || m_memory_in_flight == 0 || m_memory_in_flight + t_size <= m_memory_budget;
+	});
+
+	m_memory_in_flight += t_size;
+	m_peak_memory_in_flight = std::max(m_peak_memory_in_flight, m_memory_in_flight);
+}
+
+void tnt::utility::ImageDecodePool::ReleaseMemory(std::uint64_t t_size)
+{
+	m_memory_in_flight -= t_size;
+}
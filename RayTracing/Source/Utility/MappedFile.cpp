@@ -0,0 +1,145 @@
+#include "Utility/MappedFile.hpp"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+tnt::utility::MappedFile::MappedFile()
+	: m_data(nullptr)
+	, m_size(0)
+#if defined(_WIN32)
+	, m_file(INVALID_HANDLE_VALUE)
+	, m_mapping(nullptr)
+#else
+	, m_file(-1)
+#endif
+{
+}
+
+tnt::utility::MappedFile::~MappedFile()
+{
+	Close();
+}
+
+#if defined(_WIN32)
+bool tnt::utility::MappedFile::Open(const std::string& t_path)
+{
+	Close();
+
+	m_file = CreateFileA(t_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+	LARGE_INTEGER size = {};
+
+	if (m_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+	{
+		Close();
+		return false;
+	}
+
+	m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if (m_mapping == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	m_data = static_cast<const std::uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+
+	if (m_data == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	m_size = static_cast<std::uint64_t>(size.QuadPart);
+
+	return true;
+}
+
+void tnt::utility::MappedFile::Close()
+{
+	if (m_data != nullptr)
+	{
+		UnmapViewOfFile(m_data);
+	}
+
+	if (m_mapping != nullptr)
+	{
+		CloseHandle(m_mapping);
+	}
+
+	if (m_file != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_file);
+	}
+
+	m_data = nullptr;
+	m_size = 0;
+	m_file = INVALID_HANDLE_VALUE;
+	m_mapping = nullptr;
+}
+#else
+bool tnt::utility::MappedFile::Open(const std::string& t_path)
+{
+	Close();
+
+	m_file = open(t_path.c_str(), O_RDONLY);
+
+	struct stat file_stat = {};
+
+	if (m_file < 0 || fstat(m_file, &file_stat) != 0 || file_stat.st_size == 0)
+	{
+		Close();
+		return false;
+	}
+
+	void* data = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, m_file, 0);
+
+	if (data == MAP_FAILED)
+	{
+		Close();
+		return false;
+	}
+
+	// Decoders read the file front to back exactly once
+	madvise(data, static_cast<size_t>(file_stat.st_size), MADV_SEQUENTIAL);
+
+	m_data = static_cast<const std::uint8_t*>(data);
+	m_size = static_cast<std::uint64_t>(file_stat.st_size);
+
+	return true;
+}
+
+void tnt::utility::MappedFile::Close()
+{
+	if (m_data != nullptr)
+	{
+		munmap(const_cast<std::uint8_t*>(m_data), static_cast<size_t>(m_size));
+	}
+
+	if (m_file >= 0)
+	{
+		close(m_file);
+	}
+
+	m_data = nullptr;
+	m_size = 0;
+	m_file = -1;
+}
+#endif
+
+const std::uint8_t* tnt::utility::MappedFile::GetData() const
+{
+	return m_data;
+}
+
+std::uint64_t tnt::utility::MappedFile::GetSize() const
+{
+	return m_size;
+}
@@ -0,0 +1,412 @@
+#include "Utility/ResourceStateTracker.hpp"
+
+#include <stdexcept>
+
+namespace
+{
+	const std::uint32_t NO_PENDING_BARRIER = 0xFFFFFFFF;
+}
+
+tnt::utility::ResourceStateRegistry::ResourceStateRegistry()
+{
+}
+
+tnt::utility::ResourceStateRegistry::~ResourceStateRegistry()
+{
+}
+
+std::uint32_t tnt::utility::ResourceStateRegistry::Register(std::uint32_t t_subresource_count, std::uint32_t t_initial_state, bool t_is_promotable)
+{
+	std::uint32_t resource = static_cast<std::uint32_t>(m_states.size());
+
+	if (m_unused_ids.empty())
+	{
+		m_states.emplace_back();
+		m_promotable.push_back(false);
+	}
+	else
+	{
+		resource = m_unused_ids.back();
+		m_unused_ids.pop_back();
+	}
+
+	m_states[resource].assign(t_subresource_count, t_initial_state);
+	m_promotable[resource] = t_is_promotable;
+
+	if (t_is_promotable && t_initial_state != COMMON_RESOURCE_STATE)
+	{
+		m_promoted_resources.push_back(resource);
+	}
+
+	return resource;
+}
+
+void tnt::utility::ResourceStateRegistry::Unregister(std::uint32_t t_resource)
+{
+	m_states[t_resource].clear();
+	m_promotable[t_resource] = false;
+	m_unused_ids.push_back(t_resource);
+}
+
+std::uint32_t tnt::utility::ResourceStateRegistry::GetState(std::uint32_t t_resource, std::uint32_t t_subresource) const
+{
+	return m_states[t_resource][t_subresource];
+}
+
+void tnt::utility::ResourceStateRegistry::SetState(std::uint32_t t_resource, std::uint32_t t_subresource, std::uint32_t t_state)
+{
+	std::uint32_t& state = m_states[t_resource][t_subresource];
+
+	// Remembered once per decay, when the first of its subresources leaves the common state
+	if (m_promotable[t_resource] && state == COMMON_RESOURCE_STATE && t_state != COMMON_RESOURCE_STATE)
+	{
+		m_promoted_resources.push_back(t_resource);
+	}
+
+	state = t_state;
+}
+
+bool tnt::utility::ResourceStateRegistry::IsPromotable(std::uint32_t t_resource) const
+{
+	return m_promotable[t_resource];
+}
+
+void tnt::utility::ResourceStateRegistry::DecayPromotedStates()
+{
+	for (std::uint32_t resource : m_promoted_resources)
+	{
+		// Unregistered since, its id may already belong to a resource that does not decay
+		if (m_promotable[resource])
+		{
+			m_states[resource].assign(m_states[resource].size(), COMMON_RESOURCE_STATE);
+		}
+	}
+
+	m_promoted_resources.clear();
+}
+
+std::uint32_t tnt::utility::ResourceStateRegistry::GetSubresourceCount(std::uint32_t t_resource) const
+{
+	return static_cast<std::uint32_t>(m_states[t_resource].size());
+}
+
+std::uint32_t tnt::utility::ResourceStateRegistry::GetIdRange() const
+{
+	return static_cast<std::uint32_t>(m_states.size());
+}
+
+tnt::utility::ResourceStateTracker::ResourceStateTracker()
+	: m_registry(nullptr)
+	, m_read_only_states(0)
+	, m_generation(1)
+	, m_flush_count(0)
+{
+}
+
+tnt::utility::ResourceStateTracker::~ResourceStateTracker()
+{
+}
+
+void tnt::utility::ResourceStateTracker::Initialize(const ResourceStateRegistry* t_registry, std::uint32_t t_read_only_states)
+{
+	m_registry = t_registry;
+	m_read_only_states = t_read_only_states;
+
+	Reset();
+}
+
+void tnt::utility::ResourceStateTracker::Reset()
+{
+	++m_generation;
+
+	m_touched_resources.clear();
+	m_pending_barriers.clear();
+}
+
+void tnt::utility::ResourceStateTracker::Transition(std::uint32_t t_resource, std::uint32_t t_state, std::uint32_t t_subresource)
+{
+	Apply(t_resource, t_state, t_subresource, BarrierSplit::None);
+}
+
+void tnt::utility::ResourceStateTracker::BeginTransition(std::uint32_t t_resource, std::uint32_t t_state, std::uint32_t t_subresource)
+{
+	Apply(t_resource, t_state, t_subresource, BarrierSplit::Begin);
+}
+
+void tnt::utility::ResourceStateTracker::FlushBarriers(std::vector<StateTransition>& t_barriers)
+{
+	for (const StateTransition& barrier : m_pending_barriers)
+	{
+		// Cancelled barriers are left in place so the indices of the others stay valid
+		if (barrier.split != BarrierSplit::None || barrier.state_before != barrier.state_after)
+		{
+			t_barriers.push_back(barrier);
+		}
+	}
+
+	// Only resources with a waiting barrier can point at one
+	for (const StateTransition& barrier : m_pending_barriers)
+	{
+		TrackedResource& tracked = m_resources[barrier.resource];
+		tracked.pending_barriers.assign(tracked.pending_barriers.size(), NO_PENDING_BARRIER);
+	}
+
+	m_pending_barriers.clear();
+	++m_flush_count;
+}
+
+void tnt::utility::ResourceStateTracker::FinishRecording(std::vector<StateTransition>& t_barriers)
+{
+	for (std::uint32_t resource : m_touched_resources)
+	{
+		TrackedResource& tracked = m_resources[resource];
+
+		for (std::uint32_t index = 0; index < tracked.split_states.size(); ++index)
+		{
+			if (tracked.split_states[index] == UNKNOWN_RESOURCE_STATE)
+			{
+				continue;
+			}
+
+			// Ending the split is a transition to the state it was started for
+			ApplySubresource(tracked, resource, index, tracked.split_subresources[index], tracked.split_states[index], BarrierSplit::None);
+		}
+	}
+
+	FlushBarriers(t_barriers);
+}
+
+void tnt::utility::ResourceStateTracker::Resolve(ResourceStateRegistry& t_registry, std::vector<StateTransition>& t_barriers)
+{
+	for (std::uint32_t resource : m_touched_resources)
+	{
+		const TrackedResource& tracked = m_resources[resource];
+		const std::uint32_t subresource_count = static_cast<std::uint32_t>(tracked.first_states.size());
+
+		// One barrier covers the whole resource when every subresource makes the same change
+		bool is_uniform = true;
+
+		for (std::uint32_t index = 1; index < subresource_count && is_uniform; ++index)
+		{
+			is_uniform = tracked.first_states[index] == tracked.first_states[0] && t_registry.GetState(resource, index) == t_registry.GetState(resource, 0);
+		}
+
+		for (std::uint32_t index = 0; index < subresource_count; ++index)
+		{
+			const std::uint32_t first_state = tracked.first_states[index];
+			const std::uint32_t global_state = t_registry.GetState(resource, index);
+
+			// Out of the common state the first use promotes it implicitly
+			const bool is_promoted = tracked.is_promotable && global_state == COMMON_RESOURCE_STATE;
+
+			// Recorded barriers start from the exact first state, so combined read states still need a barrier here
+			if (first_state != UNKNOWN_RESOURCE_STATE && first_state != global_state && !is_promoted && (!is_uniform || index == 0))
+			{
+				t_barriers.push_back({ resource, is_uniform ? ALL_SUBRESOURCES : index, global_state, first_state, BarrierSplit::None });
+			}
+
+			if (tracked.current_states[index] != UNKNOWN_RESOURCE_STATE)
+			{
+				t_registry.SetState(resource, index, tracked.current_states[index]);
+			}
+		}
+	}
+}
+
+std::uint32_t tnt::utility::ResourceStateTracker::GetState(std::uint32_t t_resource, std::uint32_t t_subresource) const
+{
+	if (t_resource >= m_resources.size() || m_resources[t_resource].generation != m_generation)
+	{
+		return UNKNOWN_RESOURCE_STATE;
+	}
+
+	return m_resources[t_resource].current_states[t_subresource];
+}
+
+tnt::utility::ResourceStateTracker::TrackedResource& tnt::utility::ResourceStateTracker::Track(std::uint32_t t_resource)
+{
+	if (t_resource >= m_resources.size())
+	{
+		m_resources.resize(m_registry->GetIdRange());
+	}
+
+	TrackedResource& tracked = m_resources[t_resource];
+
+	if (tracked.generation != m_generation)
+	{
+		const std::uint32_t subresource_count = m_registry->GetSubresourceCount(t_resource);
+
+		tracked.first_states.assign(subresource_count, UNKNOWN_RESOURCE_STATE);
+		tracked.current_states.assign(subresource_count, UNKNOWN_RESOURCE_STATE);
+		tracked.split_states.assign(subresource_count, UNKNOWN_RESOURCE_STATE);
+		tracked.split_subresources.assign(subresource_count, ALL_SUBRESOURCES);
+		tracked.pending_barriers.assign(subresource_count, NO_PENDING_BARRIER);
+		tracked.first_flushes.assign(subresource_count, 0);
+		tracked.generation = m_generation;
+		tracked.is_promotable = m_registry->IsPromotable(t_resource);
+
+		m_touched_resources.push_back(t_resource);
+	}
+
+	return tracked;
+}
+
+void tnt::utility::ResourceStateTracker::Apply(std::uint32_t t_resource, std::uint32_t t_state, std::uint32_t t_subresource, BarrierSplit t_split)
+{
+	TrackedResource& tracked = Track(t_resource);
+	const std::uint32_t subresource_count = static_cast<std::uint32_t>(tracked.current_states.size());
+
+	if (t_subresource != ALL_SUBRESOURCES)
+	{
+		if (t_subresource >= subresource_count)
+		{
+			throw std::runtime_error("Subresource index is out of range");
+		}
+
+		ApplySubresource(tracked, t_resource, t_subresource, t_subresource, t_state, t_split);
+		return;
+	}
+
+	// A resource whose subresources all agree is handled as a whole, so it costs a single barrier
+	if (IsUniform(tracked))
+	{
+		ApplySubresource(tracked, t_resource, 0, ALL_SUBRESOURCES, t_state, t_split);
+
+		for (std::uint32_t index = 1; index < subresource_count; ++index)
+		{
+			tracked.first_states[index] = tracked.first_states[0];
+			tracked.current_states[index] = tracked.current_states[0];
+			tracked.split_states[index] = tracked.split_states[0];
+			tracked.split_subresources[index] = tracked.split_subresources[0];
+			tracked.pending_barriers[index] = tracked.pending_barriers[0];
+			tracked.first_flushes[index] = tracked.first_flushes[0];
+		}
+
+		return;
+	}
+
+	for (std::uint32_t index = 0; index < subresource_count; ++index)
+	{
+		ApplySubresource(tracked, t_resource, index, index, t_state, t_split);
+	}
+}
+
+void tnt::utility::ResourceStateTracker::ApplySubresource(
+	TrackedResource& t_tracked,
+	std::uint32_t t_resource,
+	std::uint32_t t_index,
+	std::uint32_t t_subresource,
+	std::uint32_t t_state,
+	BarrierSplit t_split)
+{
+	// An open split barrier is ended first, with the same subresource it was started for
+	if (t_tracked.split_states[t_index] != UNKNOWN_RESOURCE_STATE)
+	{
+		const std::uint32_t split_subresource = t_tracked.split_subresources[t_index];
+		const std::uint32_t split_state = t_tracked.split_states[t_index];
+
+		PushBarrier(t_tracked, t_index, { t_resource, split_subresource, t_tracked.current_states[t_index], split_state, BarrierSplit::End });
+
+		// A split over the whole resource ends for every subresource at once
+		const std::uint32_t first_index = (split_subresource == ALL_SUBRESOURCES) ? 0 : t_index;
+		const std::uint32_t end_index = (split_subresource == ALL_SUBRESOURCES) ? static_cast<std::uint32_t>(t_tracked.split_states.size()) : t_index + 1;
+
+		for (std::uint32_t index = first_index; index < end_index; ++index)
+		{
+			t_tracked.current_states[index] = split_state;
+			t_tracked.split_states[index] = UNKNOWN_RESOURCE_STATE;
+			t_tracked.split_subresources[index] = ALL_SUBRESOURCES;
+			t_tracked.pending_barriers[index] = NO_PENDING_BARRIER;
+		}
+	}
+
+	const std::uint32_t current_state = t_tracked.current_states[t_index];
+
+	// First use in this list, the state it has to be in is resolved on submit
+	if (current_state == UNKNOWN_RESOURCE_STATE)
+	{
+		t_tracked.first_states[t_index] = t_state;
+		t_tracked.current_states[t_index] = t_state;
+		t_tracked.first_flushes[t_index] = m_flush_count;
+		return;
+	}
+
+	if (IsSatisfied(current_state, t_state))
+	{
+		return;
+	}
+
+	// A promoted subresource is never in a first state nothing used, a barrier out of it would not find it there
+	if (t_tracked.is_promotable && current_state == t_tracked.first_states[t_index] && t_tracked.first_flushes[t_index] == m_flush_count)
+	{
+		t_tracked.first_states[t_index] = t_state;
+		t_tracked.current_states[t_index] = t_state;
+		return;
+	}
+
+	if (t_split == BarrierSplit::Begin)
+	{
+		PushBarrier(t_tracked, t_index, { t_resource, t_subresource, current_state, t_state, BarrierSplit::Begin });
+
+		t_tracked.split_states[t_index] = t_state;
+		t_tracked.split_subresources[t_index] = t_subresource;
+		t_tracked.pending_barriers[t_index] = NO_PENDING_BARRIER;
+		return;
+	}
+
+	// The waiting barrier that moved the subresource here is retargeted, A to B followed by B to C becomes A to C
+	const std::uint32_t pending_index = t_tracked.pending_barriers[t_index];
+
+	if (pending_index != NO_PENDING_BARRIER)
+	{
+		StateTransition& pending = m_pending_barriers[pending_index];
+
+		if (pending.subresource == t_subresource && pending.split == BarrierSplit::None && pending.state_after == current_state)
+		{
+			pending.state_after = t_state;
+			t_tracked.current_states[t_index] = t_state;
+			return;
+		}
+	}
+
+	PushBarrier(t_tracked, t_index, { t_resource, t_subresource, current_state, t_state, BarrierSplit::None });
+	t_tracked.current_states[t_index] = t_state;
+}
+
+void tnt::utility::ResourceStateTracker::PushBarrier(TrackedResource& t_tracked, std::uint32_t t_index, const StateTransition& t_barrier)
+{
+	t_tracked.pending_barriers[t_index] = static_cast<std::uint32_t>(m_pending_barriers.size());
+	m_pending_barriers.push_back(t_barrier);
+}
+
+bool tnt::utility::ResourceStateTracker::IsUniform(const TrackedResource& t_tracked) const
+{
+	for (size_t index = 1; index < t_tracked.current_states.size(); ++index)
+	{
+		if (t_tracked.first_states[index] != t_tracked.first_states[0]
+			|| t_tracked.current_states[index] != t_tracked.current_states[0]
+			|| t_tracked.split_states[index] != t_tracked.split_states[0]
+			|| t_tracked.split_subresources[index] != t_tracked.split_subresources[0]
+			|| t_tracked.pending_barriers[index] != t_tracked.pending_barriers[0]
+			|| t_tracked.first_flushes[index] != t_tracked.first_flushes[0])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool tnt::utility::ResourceStateTracker::IsSatisfied(std::uint32_t t_current_state, std::uint32_t t_state) const
+{
+	if (t_current_state == t_state)
+	{
+		return true;
+	}
+
+	// Zero is the common state, it is not a read only state even though it has no bits set
+	const bool is_read_only = t_state != 0 && (t_state & ~m_read_only_states) == 0;
+	const bool is_current_read_only = t_current_state != 0 && (t_current_state & ~m_read_only_states) == 0;
+
+	return is_read_only && is_current_read_only && (t_current_state & t_state) == t_state;
+}
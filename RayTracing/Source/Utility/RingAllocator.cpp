@@ -0,0 +1,97 @@
+#include "Utility/RingAllocator.hpp"
+
+namespace
+{
+	std::uint64_t AlignUp(std::uint64_t t_value, std::uint64_t t_alignment)
+	{
+		return (t_alignment > 1) ? (t_value + t_alignment - 1) / t_alignment * t_alignment : t_value;
+	}
+}
+
+tnt::utility::RingAllocator::RingAllocator()
+	: m_capacity(0)
+	, m_head(0)
+	, m_used_size(0)
+	, m_frame_size(0)
+{
+}
+
+tnt::utility::RingAllocator::~RingAllocator()
+{
+}
+
+void tnt::utility::RingAllocator::Initialize(std::uint64_t t_capacity)
+{
+	m_capacity = t_capacity;
+	m_head = 0;
+	m_used_size = 0;
+	m_frame_size = 0;
+	m_frames.clear();
+}
+
+std::uint64_t tnt::utility::RingAllocator::Allocate(std::uint64_t t_size, std::uint64_t t_alignment)
+{
+	if (t_size == 0 || t_size > m_capacity)
+	{
+		return INVALID_RING_OFFSET;
+	}
+
+	// An empty ring starts over at the beginning, which keeps large allocations from failing on a badly placed head
+	if (m_used_size == 0)
+	{
+		m_head = 0;
+	}
+
+	std::uint64_t offset = AlignUp(m_head, t_alignment);
+
+	// The rest of the ring is skipped when the allocation would not fit before the end
+	if (offset + t_size > m_capacity)
+	{
+		offset = 0;
+	}
+
+	// The skipped and padding bytes are part of the frame, so they are released together with it
+	const std::uint64_t consumed_size = (offset >= m_head) ? offset + t_size - m_head : m_capacity - m_head + t_size;
+
+	if (m_used_size + consumed_size > m_capacity)
+	{
+		return INVALID_RING_OFFSET;
+	}
+
+	m_head = offset + t_size;
+	m_used_size += consumed_size;
+	m_frame_size += consumed_size;
+
+	return offset;
+}
+
+void tnt::utility::RingAllocator::FinishFrame(std::uint64_t t_fence_value)
+{
+	// Frames retire in submission order, so the oldest frame always sits right behind the live region
+	m_frames.push_back({ t_fence_value, m_frame_size });
+	m_frame_size = 0;
+}
+
+void tnt::utility::RingAllocator::Retire(std::uint64_t t_completed_fence_value)
+{
+	while (!m_frames.empty() && m_frames.front().fence_value <= t_completed_fence_value)
+	{
+		m_used_size -= m_frames.front().size;
+		m_frames.pop_front();
+	}
+}
+
+std::uint64_t tnt::utility::RingAllocator::GetCapacity() const
+{
+	return m_capacity;
+}
+
+std::uint64_t tnt::utility::RingAllocator::GetUsedSize() const
+{
+	return m_used_size;
+}
+
+std::uint32_t tnt::utility::RingAllocator::GetFrameCount() const
+{
+	return static_cast<std::uint32_t>(m_frames.size());
+}
@@ -0,0 +1,190 @@
+#include "Utility/ThreadPool.hpp"
+
+#include <algorithm>
+
+tnt::utility::ThreadPool::ThreadPool()
+	: m_thread_count(1)
+	, m_batch_index(0)
+	, m_is_stopping(false)
+	, m_task(nullptr)
+	, m_remaining_task_count(0)
+	, m_steal_count(0)
+{
+}
+
+tnt::utility::ThreadPool::~ThreadPool()
+{
+	Cleanup();
+}
+
+void tnt::utility::ThreadPool::Initialize(std::uint32_t t_thread_count)
+{
+	Cleanup();
+
+	m_thread_count = t_thread_count;
+
+	if (m_thread_count == 0)
+	{
+		m_thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+
+	m_queues.clear();
+
+	for (std::uint32_t index = 0; index < m_thread_count; ++index)
+	{
+		m_queues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue()));
+	}
+
+	m_is_stopping = false;
+
+	// Worker zero is the thread that calls Run
+	for (std::uint32_t index = 1; index < m_thread_count; ++index)
+	{
+		m_workers.emplace_back(&ThreadPool::WorkerLoop, this, index);
+	}
+}
+
+void tnt::utility::ThreadPool::Cleanup()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_wake_mutex);
+		m_is_stopping = true;
+	}
+
+	m_wake_condition.notify_all();
+
+	for (std::thread& worker : m_workers)
+	{
+		worker.join();
+	}
+
+	m_workers.clear();
+}
+
+void tnt::utility::ThreadPool::Run(std::uint32_t t_task_count, const ThreadPoolTask& t_task)
+{
+	if (t_task_count == 0)
+	{
+		return;
+	}
+
+	// Must be visible before any task can be popped, the queue mutexes publish it to the workers
+	m_task = &t_task;
+	m_steal_count = 0;
+	m_remaining_task_count = t_task_count;
+
+	// Contiguous ranges keep neighbouring tiles on one worker until someone runs out of work
+	for (std::uint32_t worker_index = 0; worker_index < m_thread_count; ++worker_index)
+	{
+		const std::uint32_t first = static_cast<std::uint32_t>(static_cast<std::uint64_t>(t_task_count) * worker_index / m_thread_count);
+		const std::uint32_t end = static_cast<std::uint32_t>(static_cast<std::uint64_t>(t_task_count) * (worker_index + 1) / m_thread_count);
+
+		WorkQueue& queue = *m_queues[worker_index];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+
+		for (std::uint32_t task_index = first; task_index < end; ++task_index)
+		{
+			queue.tasks.push_back(task_index);
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_wake_mutex);
+		++m_batch_index;
+	}
+
+	m_wake_condition.notify_all();
+
+	RunTasks(0);
+
+	std::unique_lock<std::mutex> lock(m_done_mutex);
+	m_done_condition.wait(lock, [this]() { return m_remaining_task_count.load() == 0; });
+}
+
+std::uint32_t tnt::utility::ThreadPool::GetThreadCount() const
+{
+	return m_thread_count;
+}
+
+std::uint32_t tnt::utility::ThreadPool::GetStealCount() const
+{
+	return m_steal_count.load();
+}
+
+void tnt::utility::ThreadPool::WorkerLoop(std::uint32_t t_worker_index)
+{
+	std::uint64_t last_batch_index = 0;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_wake_mutex);
+			m_wake_condition.wait(lock, [&]() { return m_is_stopping || m_batch_index != last_batch_index; });
+
+			if (m_is_stopping)
+			{
+				return;
+			}
+
+			last_batch_index = m_batch_index;
+		}
+
+		RunTasks(t_worker_index);
+	}
+}
+
+void tnt::utility::ThreadPool::RunTasks(std::uint32_t t_worker_index)
+{
+	std::uint32_t task_index = 0;
+
+	while (PopTask(t_worker_index, task_index) || StealTask(t_worker_index, task_index))
+	{
+		(*m_task)(task_index, t_worker_index);
+
+		if (m_remaining_task_count.fetch_sub(1) == 1)
+		{
+			// Taking the lock makes sure the caller is either waiting or has not checked the count yet
+			std::lock_guard<std::mutex> lock(m_done_mutex);
+			m_done_condition.notify_one();
+		}
+	}
+}
+
+bool tnt::utility::ThreadPool::PopTask(std::uint32_t t_worker_index, std::uint32_t& t_task_index)
+{
+	WorkQueue& queue = *m_queues[t_worker_index];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+
+	if (queue.tasks.empty())
+	{
+		return false;
+	}
+
+	t_task_index = queue.tasks.front();
+	queue.tasks.pop_front();
+
+	return true;
+}
+
+bool tnt::utility::ThreadPool::StealTask(std::uint32_t t_worker_index, std::uint32_t& t_task_index)
+{
+	// Start at the next worker so thieves spread out over the victims
+	for (std::uint32_t offset = 1; offset < m_thread_count; ++offset)
+	{
+		WorkQueue& queue = *m_queues[(t_worker_index + offset) % m_thread_count];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+
+		if (!queue.tasks.empty())
+		{
+			// The back is farthest away from where the owner is working
+			t_task_index = queue.tasks.back();
+			queue.tasks.pop_back();
+
+			++m_steal_count;
+
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,404 @@
+#include "Utility/TlsfAllocator.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace
+{
+	const std::uint32_t SECOND_LEVEL_LOG2 = 4;
+
+	std::uint32_t FindLastSet(std::uint64_t t_value)
+	{
+#if defined(_MSC_VER)
+		unsigned long index = 0;
+		_BitScanReverse64(&index, t_value);
+		return static_cast<std::uint32_t>(index);
+#else
+		return 63 - static_cast<std::uint32_t>(__builtin_clzll(t_value));
+#endif
+	}
+
+	std::uint32_t FindFirstSet(std::uint64_t t_value)
+	{
+#if defined(_MSC_VER)
+		unsigned long index = 0;
+		_BitScanForward64(&index, t_value);
+		return static_cast<std::uint32_t>(index);
+#else
+		return static_cast<std::uint32_t>(__builtin_ctzll(t_value));
+#endif
+	}
+
+	std::uint64_t AlignUp(std::uint64_t t_value, std::uint64_t t_alignment)
+	{
+		return (t_value + t_alignment - 1) & ~(t_alignment - 1);
+	}
+
+	// Below this every second level class holds exactly one size, above it classes double per first level
+	std::uint32_t GetLinearLimitLog2(std::uint32_t t_granularity_log2)
+	{
+		return t_granularity_log2 + SECOND_LEVEL_LOG2;
+	}
+
+	void MapSize(std::uint64_t t_size, std::uint32_t t_granularity_log2, std::uint32_t& t_first_level, std::uint32_t& t_second_level)
+	{
+		const std::uint32_t linear_limit_log2 = GetLinearLimitLog2(t_granularity_log2);
+
+		if (t_size < (1ull << linear_limit_log2))
+		{
+			t_first_level = 0;
+			t_second_level = static_cast<std::uint32_t>(t_size >> t_granularity_log2);
+			return;
+		}
+
+		const std::uint32_t size_log2 = FindLastSet(t_size);
+
+		t_first_level = size_log2 - linear_limit_log2 + 1;
+		t_second_level = static_cast<std::uint32_t>(t_size >> (size_log2 - SECOND_LEVEL_LOG2)) & (tnt::utility::TLSF_SECOND_LEVEL_COUNT - 1);
+	}
+
+	// Rounds up to the start of the next size class, so any block in the class of the result is large enough
+	std::uint64_t RoundUpToSizeClass(std::uint64_t t_size, std::uint32_t t_granularity_log2)
+	{
+		if (t_size < (1ull << GetLinearLimitLog2(t_granularity_log2)))
+		{
+			return t_size;
+		}
+
+		const std::uint64_t class_step = 1ull << (FindLastSet(t_size) - SECOND_LEVEL_LOG2);
+
+		return (t_size + class_step - 1) & ~(class_step - 1);
+	}
+}
+
+tnt::utility::TlsfAllocator::TlsfAllocator()
+	: m_capacity(0)
+	, m_granularity(0)
+	, m_granularity_log2(0)
+	, m_free_size(0)
+	, m_allocation_count(0)
+	, m_first_level_bitmap(0)
+{
+}
+
+tnt::utility::TlsfAllocator::~TlsfAllocator()
+{
+}
+
+void tnt::utility::TlsfAllocator::Initialize(std::uint64_t t_capacity, std::uint64_t t_granularity)
+{
+	if (t_granularity == 0 || (t_granularity & (t_granularity - 1)) != 0)
+	{
+		throw std::runtime_error("TLSF granularity has to be a power of two");
+	}
+
+	m_granularity = t_granularity;
+	m_granularity_log2 = FindLastSet(t_granularity);
+	m_capacity = t_capacity & ~(t_granularity - 1);
+
+	// The largest block has to map to a first level class
+	if (m_capacity > 0 && FindLastSet(m_capacity) >= GetLinearLimitLog2(m_granularity_log2) + TLSF_FIRST_LEVEL_COUNT - 1)
+	{
+		throw std::runtime_error("TLSF capacity is too large for the granularity");
+	}
+
+	m_free_size = m_capacity;
+	m_allocation_count = 0;
+
+	m_blocks.clear();
+	m_unused_blocks.clear();
+
+	m_first_level_bitmap = 0;
+	std::fill(&m_second_level_bitmaps[0], &m_second_level_bitmaps[0] + TLSF_FIRST_LEVEL_COUNT, 0u);
+	std::fill(&m_free_lists[0][0], &m_free_lists[0][0] + TLSF_FIRST_LEVEL_COUNT * TLSF_SECOND_LEVEL_COUNT, INVALID_TLSF_HANDLE);
+
+	if (m_capacity > 0)
+	{
+		InsertFreeBlock(CreateBlock(0, m_capacity));
+	}
+}
+
+std::uint32_t tnt::utility::TlsfAllocator::Allocate(std::uint64_t t_size, std::uint64_t t_alignment)
+{
+	const std::uint64_t alignment = std::max(t_alignment, m_granularity);
+	const std::uint64_t size = AlignUp(std::max<std::uint64_t>(t_size, 1), m_granularity);
+
+	if (size > m_free_size)
+	{
+		return INVALID_TLSF_HANDLE;
+	}
+
+	// Any free block that can hold the worst case padding fits, whatever its offset
+	std::uint32_t block_index = FindFreeBlock(size + alignment - m_granularity);
+
+	if (block_index == INVALID_TLSF_HANDLE)
+	{
+		return INVALID_TLSF_HANDLE;
+	}
+
+	RemoveFreeBlock(block_index);
+
+	// Padding in front becomes a free block of its own, its physical neighbour before it is always in use
+	const std::uint64_t padding = AlignUp(m_blocks[block_index].offset, alignment) - m_blocks[block_index].offset;
+
+	if (padding > 0)
+	{
+		const std::uint32_t padding_index = block_index;
+		block_index = SplitBlock(padding_index, padding);
+
+		InsertFreeBlock(padding_index);
+	}
+
+	if (m_blocks[block_index].size > size)
+	{
+		InsertFreeBlock(SplitBlock(block_index, size));
+	}
+
+	m_blocks[block_index].is_free = false;
+	m_free_size -= m_blocks[block_index].size;
+	m_allocation_count++;
+
+	return block_index;
+}
+
+void tnt::utility::TlsfAllocator::Free(std::uint32_t t_handle)
+{
+	if (t_handle >= m_blocks.size() || m_blocks[t_handle].is_free)
+	{
+		throw std::runtime_error("Freeing a TLSF block that is not allocated");
+	}
+
+	std::uint32_t block_index = t_handle;
+
+	m_blocks[block_index].is_free = true;
+	m_free_size += m_blocks[block_index].size;
+	m_allocation_count--;
+
+	// Free neighbours are merged right away, so two free blocks are never next to each other
+	const std::uint32_t previous_index = m_blocks[block_index].previous_physical;
+
+	if (previous_index != INVALID_TLSF_HANDLE && m_blocks[previous_index].is_free)
+	{
+		RemoveFreeBlock(previous_index);
+
+		m_blocks[previous_index].size += m_blocks[block_index].size;
+		m_blocks[previous_index].next_physical = m_blocks[block_index].next_physical;
+
+		if (m_blocks[block_index].next_physical != INVALID_TLSF_HANDLE)
+		{
+			m_blocks[m_blocks[block_index].next_physical].previous_physical = previous_index;
+		}
+
+		DestroyBlock(block_index);
+		block_index = previous_index;
+	}
+
+	const std::uint32_t next_index = m_blocks[block_index].next_physical;
+
+	if (next_index != INVALID_TLSF_HANDLE && m_blocks[next_index].is_free)
+	{
+		RemoveFreeBlock(next_index);
+
+		m_blocks[block_index].size += m_blocks[next_index].size;
+		m_blocks[block_index].next_physical = m_blocks[next_index].next_physical;
+
+		if (m_blocks[next_index].next_physical != INVALID_TLSF_HANDLE)
+		{
+			m_blocks[m_blocks[next_index].next_physical].previous_physical = block_index;
+		}
+
+		DestroyBlock(next_index);
+	}
+
+	InsertFreeBlock(block_index);
+}
+
+std::uint64_t tnt::utility::TlsfAllocator::GetOffset(std::uint32_t t_handle) const
+{
+	return m_blocks[t_handle].offset;
+}
+
+std::uint64_t tnt::utility::TlsfAllocator::GetSize(std::uint32_t t_handle) const
+{
+	return m_blocks[t_handle].size;
+}
+
+std::uint64_t tnt::utility::TlsfAllocator::GetCapacity() const
+{
+	return m_capacity;
+}
+
+std::uint64_t tnt::utility::TlsfAllocator::GetFreeSize() const
+{
+	return m_free_size;
+}
+
+std::uint32_t tnt::utility::TlsfAllocator::GetAllocationCount() const
+{
+	return m_allocation_count;
+}
+
+std::uint64_t tnt::utility::TlsfAllocator::GetLargestFreeBlockSize() const
+{
+	if (m_first_level_bitmap == 0)
+	{
+		return 0;
+	}
+
+	// The largest block is in the highest non-empty class, but a class holds a range of sizes
+	const std::uint32_t first_level = FindLastSet(m_first_level_bitmap);
+	const std::uint32_t second_level = FindLastSet(m_second_level_bitmaps[first_level]);
+
+	std::uint64_t largest_size = 0;
+
+	for (std::uint32_t block_index = m_free_lists[first_level][second_level]; block_index != INVALID_TLSF_HANDLE; block_index = m_blocks[block_index].next_free)
+	{
+		largest_size = std::max(largest_size, m_blocks[block_index].size);
+	}
+
+	return largest_size;
+}
+
+std::uint32_t tnt::utility::TlsfAllocator::CreateBlock(std::uint64_t t_offset, std::uint64_t t_size)
+{
+	Block block = {};
+	block.offset = t_offset;
+	block.size = t_size;
+	block.previous_physical = INVALID_TLSF_HANDLE;
+	block.next_physical = INVALID_TLSF_HANDLE;
+	block.previous_free = INVALID_TLSF_HANDLE;
+	block.next_free = INVALID_TLSF_HANDLE;
+	block.is_free = true;
+
+	if (!m_unused_blocks.empty())
+	{
+		const std::uint32_t block_index = m_unused_blocks.back();
+		m_unused_blocks.pop_back();
+
+		m_blocks[block_index] = block;
+		return block_index;
+	}
+
+	m_blocks.push_back(block);
+	return static_cast<std::uint32_t>(m_blocks.size() - 1);
+}
+
+void tnt::utility::TlsfAllocator::DestroyBlock(std::uint32_t t_block_index)
+{
+	// Marked free so freeing a merged block again is caught, at least until the node is reused
+	m_blocks[t_block_index].is_free = true;
+	m_unused_blocks.push_back(t_block_index);
+}
+
+void tnt::utility::TlsfAllocator::InsertFreeBlock(std::uint32_t t_block_index)
+{
+	Block& block = m_blocks[t_block_index];
+
+	std::uint32_t first_level = 0;
+	std::uint32_t second_level = 0;
+	MapSize(block.size, m_granularity_log2, first_level, second_level);
+
+	const std::uint32_t head_index = m_free_lists[first_level][second_level];
+
+	block.is_free = true;
+	block.previous_free = INVALID_TLSF_HANDLE;
+	block.next_free = head_index;
+
+	if (head_index != INVALID_TLSF_HANDLE)
+	{
+		m_blocks[head_index].previous_free = t_block_index;
+	}
+
+	m_free_lists[first_level][second_level] = t_block_index;
+	m_first_level_bitmap |= 1ull << first_level;
+	m_second_level_bitmaps[first_level] |= 1u << second_level;
+}
+
+void tnt::utility::TlsfAllocator::RemoveFreeBlock(std::uint32_t t_block_index)
+{
+	const Block& block = m_blocks[t_block_index];
+
+	std::uint32_t first_level = 0;
+	std::uint32_t second_level = 0;
+	MapSize(block.size, m_granularity_log2, first_level, second_level);
+
+	if (block.previous_free != INVALID_TLSF_HANDLE)
+	{
+		m_blocks[block.previous_free].next_free = block.next_free;
+	}
+	else
+	{
+		m_free_lists[first_level][second_level] = block.next_free;
+	}
+
+	if (block.next_free != INVALID_TLSF_HANDLE)
+	{
+		m_blocks[block.next_free].previous_free = block.previous_free;
+	}
+
+	if (m_free_lists[first_level][second_level] == INVALID_TLSF_HANDLE)
+	{
+		m_second_level_bitmaps[first_level] &= ~(1u << second_level);
+
+		if (m_second_level_bitmaps[first_level] == 0)
+		{
+			m_first_level_bitmap &= ~(1ull << first_level);
+		}
+	}
+}
+
+std::uint32_t tnt::utility::TlsfAllocator::FindFreeBlock(std::uint64_t t_size) const
+{
+	std::uint32_t first_level = 0;
+	std::uint32_t second_level = 0;
+	MapSize(RoundUpToSizeClass(t_size, m_granularity_log2), m_granularity_log2, first_level, second_level);
+
+	if (first_level >= TLSF_FIRST_LEVEL_COUNT)
+	{
+		return INVALID_TLSF_HANDLE;
+	}
+
+	// A larger class in the same first level, otherwise the smallest class of a larger first level
+	std::uint32_t second_level_map = m_second_level_bitmaps[first_level] & (~0u << second_level);
+
+	if (second_level_map == 0)
+	{
+		const std::uint64_t first_level_map = (first_level + 1 < 64) ? m_first_level_bitmap & (~0ull << (first_level + 1)) : 0;
+
+		if (first_level_map == 0)
+		{
+			return INVALID_TLSF_HANDLE;
+		}
+
+		first_level = FindFirstSet(first_level_map);
+		second_level_map = m_second_level_bitmaps[first_level];
+	}
+
+	return m_free_lists[first_level][FindFirstSet(second_level_map)];
+}
+
+std::uint32_t tnt::utility::TlsfAllocator::SplitBlock(std::uint32_t t_block_index, std::uint64_t t_size)
+{
+	const std::uint32_t remainder_index = CreateBlock(m_blocks[t_block_index].offset + t_size, m_blocks[t_block_index].size - t_size);
+
+	// CreateBlock may grow the vector, so the block is only looked up afterwards
+	Block& block = m_blocks[t_block_index];
+	Block& remainder = m_blocks[remainder_index];
+
+	remainder.previous_physical = t_block_index;
+	remainder.next_physical = block.next_physical;
+
+	if (block.next_physical != INVALID_TLSF_HANDLE)
+	{
+		m_blocks[block.next_physical].previous_physical = remainder_index;
+	}
+
+	block.size = t_size;
+	block.next_physical = remainder_index;
+
+	return remainder_index;
+}
@@ -0,0 +1,146 @@
+#include "Wrapper/DX12/BindlessTable.hpp"
+
+#include <stdexcept>
+
+tnt::wrapper::dx12::BindlessTable::BindlessTable()
+	: m_device(nullptr)
+	, m_heap(nullptr)
+	, m_staging_heap(nullptr)
+	, m_range({})
+	, m_staging_range({})
+{
+	m_range.handle = utility::INVALID_TLSF_HANDLE;
+	m_staging_range.handle = utility::INVALID_TLSF_HANDLE;
+}
+
+tnt::wrapper::dx12::BindlessTable::~BindlessTable()
+{
+	Cleanup();
+}
+
+void tnt::wrapper::dx12::BindlessTable::Initialize(ID3D12Device* t_device, DescriptorHeap* t_heap, DescriptorHeap* t_staging_heap, UINT t_capacity)
+{
+	// Copies can only read from heaps that are not shader visible
+	if (t_staging_heap->IsShaderVisible())
+	{
+		throw std::runtime_error("Bindless staging heap cannot be shader visible");
+	}
+
+	m_device = t_device;
+	m_heap = t_heap;
+	m_staging_heap = t_staging_heap;
+	m_range = t_heap->Allocate(t_capacity);
+	m_staging_range = t_staging_heap->Allocate(t_capacity);
+
+	m_handles.Initialize(t_capacity);
+
+	for (UINT index = 0; index < t_capacity; ++index)
+	{
+		CreateNullView(index);
+	}
+
+	CopyToTable(0, t_capacity);
+}
+
+void tnt::wrapper::dx12::BindlessTable::Cleanup()
+{
+	if (m_heap != nullptr)
+	{
+		m_heap->Free(m_range);
+		m_staging_heap->Free(m_staging_range);
+	}
+
+	m_device = nullptr;
+	m_heap = nullptr;
+	m_staging_heap = nullptr;
+}
+
+tnt::wrapper::dx12::BindlessHandle tnt::wrapper::dx12::BindlessTable::CreateShaderResourceView(ID3D12Resource* t_resource, const D3D12_SHADER_RESOURCE_VIEW_DESC& t_desc)
+{
+	const BindlessHandle handle = m_handles.Allocate();
+
+	if (handle == INVALID_BINDLESS_HANDLE)
+	{
+		throw std::runtime_error("Bindless table is full");
+	}
+
+	const UINT index = m_handles.GetIndex(handle);
+
+	m_device->CreateShaderResourceView(t_resource, &t_desc, m_staging_heap->GetCpuHandle(m_staging_range, index));
+	CopyToTable(index, 1);
+
+	return handle;
+}
+
+void tnt::wrapper::dx12::BindlessTable::Free(BindlessHandle t_handle)
+{
+	m_handles.Free(t_handle);
+}
+
+bool tnt::wrapper::dx12::BindlessTable::IsValid(BindlessHandle t_handle) const
+{
+	return m_handles.IsValid(t_handle);
+}
+
+UINT tnt::wrapper::dx12::BindlessTable::GetIndex(BindlessHandle t_handle) const
+{
+	return m_handles.GetIndex(t_handle);
+}
+
+void tnt::wrapper::dx12::BindlessTable::FinishFrame(UINT64 t_fence_value)
+{
+	m_handles.FinishFrame(t_fence_value);
+}
+
+void tnt::wrapper::dx12::BindlessTable::Retire(UINT64 t_completed_fence_value)
+{
+	m_retired_indices.clear();
+	m_handles.Retire(t_completed_fence_value, &m_retired_indices);
+
+	// Nothing samples the slot any more, a null view keeps the table valid once the freed resource is released
+	for (std::uint32_t index : m_retired_indices)
+	{
+		CreateNullView(index);
+		CopyToTable(index, 1);
+	}
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE tnt::wrapper::dx12::BindlessTable::GetGpuHandle() const
+{
+	return m_range.gpu_handle;
+}
+
+D3D12_CPU_DESCRIPTOR_HANDLE tnt::wrapper::dx12::BindlessTable::GetStagingHandle(BindlessHandle t_handle) const
+{
+	return m_staging_heap->GetCpuHandle(m_staging_range, m_handles.GetIndex(t_handle));
+}
+
+UINT tnt::wrapper::dx12::BindlessTable::GetCapacity() const
+{
+	return m_handles.GetCapacity();
+}
+
+UINT tnt::wrapper::dx12::BindlessTable::GetAllocatedCount() const
+{
+	return m_handles.GetAllocatedCount();
+}
+
+void tnt::wrapper::dx12::BindlessTable::CreateNullView(UINT t_index)
+{
+	D3D12_SHADER_RESOURCE_VIEW_DESC null_desc = {};
+	null_desc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	null_desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	null_desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+	null_desc.Texture2D.MipLevels = 1;
+
+	m_device->CreateShaderResourceView(nullptr, &null_desc, m_staging_heap->GetCpuHandle(m_staging_range, t_index));
+}
+
+void tnt::wrapper::dx12::BindlessTable::CopyToTable(UINT t_index, UINT t_count)
+{
+	m_device->CopyDescriptorsSimple(
+		t_count,
+		m_heap->GetCpuHandle(m_range, t_index),
+		m_staging_heap->GetCpuHandle(m_staging_range, t_index),
+		m_heap->GetHeapType());
+}
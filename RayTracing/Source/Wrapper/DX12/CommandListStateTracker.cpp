@@ -0,0 +1,178 @@
+#include "Wrapper/DX12/CommandListStateTracker.hpp"
+
+#include <d3dx12.h>
+
+namespace
+{
+	// These combine with each other, a resource can be an index buffer and a shader resource at the same time
+	const D3D12_RESOURCE_STATES READ_ONLY_STATES = D3D12_RESOURCE_STATE_GENERIC_READ | D3D12_RESOURCE_STATE_DEPTH_READ;
+
+	D3D12_RESOURCE_BARRIER_FLAGS GetBarrierFlags(tnt::utility::BarrierSplit t_split)
+	{
+		switch (t_split)
+		{
+		case tnt::utility::BarrierSplit::Begin:
+			return D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY;
+
+		case tnt::utility::BarrierSplit::End:
+			return D3D12_RESOURCE_BARRIER_FLAG_END_ONLY;
+
+		default:
+			return D3D12_RESOURCE_BARRIER_FLAG_NONE;
+		}
+	}
+}
+
+tnt::wrapper::dx12::TrackedResources::TrackedResources()
+{
+}
+
+tnt::wrapper::dx12::TrackedResources::~TrackedResources()
+{
+}
+
+UINT tnt::wrapper::dx12::TrackedResources::Register(ID3D12Resource* t_resource, D3D12_RESOURCE_STATES t_initial_state)
+{
+	const D3D12_RESOURCE_DESC desc = t_resource->GetDesc();
+	const bool is_buffer = desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER;
+	const UINT subresource_count = is_buffer ? 1 : desc.MipLevels * desc.DepthOrArraySize;
+	const bool is_promotable = is_buffer || (desc.Flags & D3D12_RESOURCE_FLAG_ALLOW_SIMULTANEOUS_ACCESS) != 0;
+
+	const UINT resource = m_registry.Register(subresource_count, static_cast<std::uint32_t>(t_initial_state), is_promotable);
+
+	if (resource >= m_resources.size())
+	{
+		m_resources.resize(resource + 1, nullptr);
+	}
+
+	m_resources[resource] = t_resource;
+
+	return resource;
+}
+
+void tnt::wrapper::dx12::TrackedResources::Unregister(UINT t_resource)
+{
+	m_registry.Unregister(t_resource);
+	m_resources[t_resource] = nullptr;
+}
+
+void tnt::wrapper::dx12::TrackedResources::DecayPromotedStates()
+{
+	m_registry.DecayPromotedStates();
+}
+
+ID3D12Resource* tnt::wrapper::dx12::TrackedResources::GetResourcePointer(UINT t_resource) const
+{
+	return m_resources[t_resource];
+}
+
+D3D12_RESOURCE_STATES tnt::wrapper::dx12::TrackedResources::GetState(UINT t_resource, UINT t_subresource) const
+{
+	return static_cast<D3D12_RESOURCE_STATES>(m_registry.GetState(t_resource, t_subresource));
+}
+
+tnt::utility::ResourceStateRegistry& tnt::wrapper::dx12::TrackedResources::GetRegistry()
+{
+	return m_registry;
+}
+
+tnt::wrapper::dx12::CommandListStateTracker::CommandListStateTracker()
+	: m_resources(nullptr)
+	, m_barrier_count(0)
+	, m_barrier_call_count(0)
+{
+}
+
+tnt::wrapper::dx12::CommandListStateTracker::~CommandListStateTracker()
+{
+}
+
+void tnt::wrapper::dx12::CommandListStateTracker::Initialize(TrackedResources* t_resources)
+{
+	m_resources = t_resources;
+	m_tracker.Initialize(&m_resources->GetRegistry(), static_cast<std::uint32_t>(READ_ONLY_STATES));
+
+	Reset();
+}
+
+void tnt::wrapper::dx12::CommandListStateTracker::Reset()
+{
+	m_tracker.Reset();
+
+	m_barrier_count = 0;
+	m_barrier_call_count = 0;
+}
+
+void tnt::wrapper::dx12::CommandListStateTracker::Transition(UINT t_resource, D3D12_RESOURCE_STATES t_state, UINT t_subresource)
+{
+	m_tracker.Transition(t_resource, static_cast<std::uint32_t>(t_state), t_subresource);
+}
+
+void tnt::wrapper::dx12::CommandListStateTracker::BeginTransition(UINT t_resource, D3D12_RESOURCE_STATES t_state, UINT t_subresource)
+{
+	m_tracker.BeginTransition(t_resource, static_cast<std::uint32_t>(t_state), t_subresource);
+}
+
+void tnt::wrapper::dx12::CommandListStateTracker::FlushBarriers(ID3D12GraphicsCommandList* t_command_list)
+{
+	m_tracker.FlushBarriers(m_transitions);
+	RecordBarriers(t_command_list);
+}
+
+void tnt::wrapper::dx12::CommandListStateTracker::FinishRecording(ID3D12GraphicsCommandList* t_command_list)
+{
+	m_tracker.FinishRecording(m_transitions);
+	RecordBarriers(t_command_list);
+}
+
+bool tnt::wrapper::dx12::CommandListStateTracker::Resolve(ID3D12GraphicsCommandList* t_fixup_command_list)
+{
+	m_tracker.Resolve(m_resources->GetRegistry(), m_transitions);
+
+	if (m_transitions.empty())
+	{
+		return false;
+	}
+
+	RecordBarriers(t_fixup_command_list);
+
+	return true;
+}
+
+UINT tnt::wrapper::dx12::CommandListStateTracker::GetBarrierCount() const
+{
+	return m_barrier_count;
+}
+
+UINT tnt::wrapper::dx12::CommandListStateTracker::GetBarrierCallCount() const
+{
+	return m_barrier_call_count;
+}
+
+void tnt::wrapper::dx12::CommandListStateTracker::RecordBarriers(ID3D12GraphicsCommandList* t_command_list)
+{
+	if (m_transitions.empty())
+	{
+		return;
+	}
+
+	m_barriers.clear();
+
+	for (const utility::StateTransition& transition : m_transitions)
+	{
+		m_barriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(
+			m_resources->GetResourcePointer(transition.resource),
+			static_cast<D3D12_RESOURCE_STATES>(transition.state_before),
+			static_cast<D3D12_RESOURCE_STATES>(transition.state_after),
+			transition.subresource,
+			GetBarrierFlags(transition.split)
+		));
+	}
+
+	t_command_list->ResourceBarrier(static_cast<UINT>(m_barriers.size()), m_barriers.data());
+
+	m_barrier_count += static_cast<UINT>(m_barriers.size());
+	++m_barrier_call_count;
+
+	m_transitions.clear();
+}
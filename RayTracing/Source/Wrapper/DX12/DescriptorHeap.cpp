@@ -2,7 +2,14 @@
 
 #include "Utility/CheckHResult.hpp"
 
+#include <stdexcept>
+
 tnt::wrapper::dx12::DescriptorHeap::DescriptorHeap()
+	: m_cpu_start({ 0 })
+	, m_gpu_start({ 0 })
+	, m_descriptor_size(0)
+	, m_descriptor_count(0)
+	, m_heap_type(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV)
 {
 }
 
@@ -19,6 +26,67 @@ void tnt::wrapper::dx12::DescriptorHeap::Initialize(
 	D3D12_DESCRIPTOR_HEAP_DESC descriptor_heap_description = CreateDescriptorHeapDescription(t_descriptor_count, t_heap_type, t_flags);
 
 	ThrowIfFailed(t_device->CreateDescriptorHeap(&descriptor_heap_description, IID_PPV_ARGS(&m_descriptor_heap)));
+
+	m_cpu_start = m_descriptor_heap->GetCPUDescriptorHandleForHeapStart();
+	m_gpu_start = { 0 };
+
+	// Only shader visible heaps have a GPU address
+	if ((t_flags & D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE) != 0)
+	{
+		m_gpu_start = m_descriptor_heap->GetGPUDescriptorHandleForHeapStart();
+	}
+
+	m_descriptor_size = t_device->GetDescriptorHandleIncrementSize(t_heap_type);
+	m_descriptor_count = t_descriptor_count;
+	m_heap_type = t_heap_type;
+	m_allocator.Initialize(t_descriptor_count, 1);
+}
+
+tnt::wrapper::dx12::DescriptorAllocation tnt::wrapper::dx12::DescriptorHeap::Allocate(UINT t_count)
+{
+	const std::uint32_t handle = m_allocator.Allocate(t_count, 1);
+
+	if (handle == utility::INVALID_TLSF_HANDLE)
+	{
+		throw std::runtime_error("Descriptor heap is full");
+	}
+
+	DescriptorAllocation allocation = {};
+	allocation.index = static_cast<UINT>(m_allocator.GetOffset(handle));
+	allocation.count = t_count;
+	allocation.handle = handle;
+	allocation.cpu_handle = GetCpuHandle(allocation, 0);
+	allocation.gpu_handle = GetGpuHandle(allocation, 0);
+
+	return allocation;
+}
+
+void tnt::wrapper::dx12::DescriptorHeap::Free(DescriptorAllocation& t_allocation)
+{
+	if (t_allocation.handle == utility::INVALID_TLSF_HANDLE)
+	{
+		return;
+	}
+
+	m_allocator.Free(t_allocation.handle);
+
+	t_allocation = {};
+	t_allocation.handle = utility::INVALID_TLSF_HANDLE;
+}
+
+D3D12_CPU_DESCRIPTOR_HANDLE tnt::wrapper::dx12::DescriptorHeap::GetCpuHandle(const DescriptorAllocation& t_allocation, UINT t_offset) const
+{
+	return { m_cpu_start.ptr + static_cast<SIZE_T>(t_allocation.index + t_offset) * m_descriptor_size };
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE tnt::wrapper::dx12::DescriptorHeap::GetGpuHandle(const DescriptorAllocation& t_allocation, UINT t_offset) const
+{
+	if (m_gpu_start.ptr == 0)
+	{
+		return { 0 };
+	}
+
+	return { m_gpu_start.ptr + static_cast<UINT64>(t_allocation.index + t_offset) * m_descriptor_size };
 }
 
 ID3D12DescriptorHeap * const tnt::wrapper::dx12::DescriptorHeap::GetDescriptorHeapPointer() const
@@ -26,6 +94,31 @@ ID3D12DescriptorHeap * const tnt::wrapper::dx12::DescriptorHeap::GetDescriptorHe
 	return m_descriptor_heap.Get();
 }
 
+UINT tnt::wrapper::dx12::DescriptorHeap::GetDescriptorSize() const
+{
+	return m_descriptor_size;
+}
+
+UINT tnt::wrapper::dx12::DescriptorHeap::GetDescriptorCount() const
+{
+	return m_descriptor_count;
+}
+
+UINT tnt::wrapper::dx12::DescriptorHeap::GetFreeCount() const
+{
+	return static_cast<UINT>(m_allocator.GetFreeSize());
+}
+
+D3D12_DESCRIPTOR_HEAP_TYPE tnt::wrapper::dx12::DescriptorHeap::GetHeapType() const
+{
+	return m_heap_type;
+}
+
+bool tnt::wrapper::dx12::DescriptorHeap::IsShaderVisible() const
+{
+	return m_gpu_start.ptr != 0;
+}
+
 D3D12_DESCRIPTOR_HEAP_DESC tnt::wrapper::dx12::DescriptorHeap::CreateDescriptorHeapDescription(
 	UINT t_descriptor_count,
 	D3D12_DESCRIPTOR_HEAP_TYPE t_heap_type,
@@ -0,0 +1,117 @@
+#include "Wrapper/DX12/DescriptorTableRing.hpp"
+
+#include <stdexcept>
+
+tnt::wrapper::dx12::DescriptorTableRing::DescriptorTableRing()
+	: m_device(nullptr)
+	, m_heap(nullptr)
+	, m_range({})
+{
+	m_range.handle = utility::INVALID_TLSF_HANDLE;
+}
+
+tnt::wrapper::dx12::DescriptorTableRing::~DescriptorTableRing()
+{
+	Cleanup();
+}
+
+void tnt::wrapper::dx12::DescriptorTableRing::Initialize(ID3D12Device* t_device, DescriptorHeap* t_heap, UINT t_capacity, UINT t_staging_descriptor_size)
+{
+	if (!t_heap->IsShaderVisible())
+	{
+		throw std::runtime_error("Descriptor tables have to be placed in a shader visible heap");
+	}
+
+	m_device = t_device;
+	m_heap = t_heap;
+	m_range = t_heap->Allocate(t_capacity);
+
+	m_tables.Initialize(t_capacity, t_staging_descriptor_size);
+}
+
+void tnt::wrapper::dx12::DescriptorTableRing::Cleanup()
+{
+	if (m_heap != nullptr)
+	{
+		m_heap->Free(m_range);
+	}
+
+	m_device = nullptr;
+	m_heap = nullptr;
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE tnt::wrapper::dx12::DescriptorTableRing::AllocateTable(const D3D12_CPU_DESCRIPTOR_HANDLE* t_sources, UINT t_count)
+{
+	m_source_values.resize(t_count);
+
+	for (UINT index = 0; index < t_count; ++index)
+	{
+		m_source_values[index] = t_sources[index].ptr;
+	}
+
+	const std::uint64_t offset = m_tables.Allocate(m_source_values.data(), t_count);
+
+	if (offset == utility::INVALID_RING_OFFSET)
+	{
+		throw std::runtime_error("Descriptor table ring is full");
+	}
+
+	return m_heap->GetGpuHandle(m_range, static_cast<UINT>(offset));
+}
+
+void tnt::wrapper::dx12::DescriptorTableRing::FlushCopies()
+{
+	if (m_tables.GetPendingCount() == 0)
+	{
+		return;
+	}
+
+	m_destination_starts.clear();
+	m_destination_sizes.clear();
+	m_source_starts.clear();
+	m_source_sizes.clear();
+
+	for (const utility::DescriptorRange& range : m_tables.GetDestinationRanges())
+	{
+		m_destination_starts.push_back(m_heap->GetCpuHandle(m_range, static_cast<UINT>(range.start)));
+		m_destination_sizes.push_back(range.count);
+	}
+
+	for (const utility::DescriptorRange& range : m_tables.GetSourceRanges())
+	{
+		m_source_starts.push_back({ static_cast<SIZE_T>(range.start) });
+		m_source_sizes.push_back(range.count);
+	}
+
+	// Source and destination ranges do not have to line up, the descriptors are copied in order across both lists
+	m_device->CopyDescriptors(
+		static_cast<UINT>(m_destination_starts.size()),
+		m_destination_starts.data(),
+		m_destination_sizes.data(),
+		static_cast<UINT>(m_source_starts.size()),
+		m_source_starts.data(),
+		m_source_sizes.data(),
+		m_heap->GetHeapType());
+
+	m_tables.ClearPending();
+}
+
+void tnt::wrapper::dx12::DescriptorTableRing::FinishFrame(UINT64 t_fence_value)
+{
+	m_tables.FinishFrame(t_fence_value);
+}
+
+void tnt::wrapper::dx12::DescriptorTableRing::Retire(UINT64 t_completed_fence_value)
+{
+	m_tables.Retire(t_completed_fence_value);
+}
+
+UINT tnt::wrapper::dx12::DescriptorTableRing::GetCapacity() const
+{
+	return static_cast<UINT>(m_tables.GetCapacity());
+}
+
+UINT tnt::wrapper::dx12::DescriptorTableRing::GetUsedCount() const
+{
+	return static_cast<UINT>(m_tables.GetUsedCount());
+}
@@ -0,0 +1,136 @@
+#include "Wrapper/DX12/FrameSynchronizer.hpp"
+
+#include "Utility/CheckHResult.hpp"
+
+tnt::wrapper::dx12::FrameSynchronizer::FrameSynchronizer()
+	: m_command_queue(nullptr)
+	, m_fence_event(nullptr)
+	, m_frame_latency_waitable(nullptr)
+{
+}
+
+tnt::wrapper::dx12::FrameSynchronizer::~FrameSynchronizer()
+{
+	Cleanup();
+}
+
+void tnt::wrapper::dx12::FrameSynchronizer::Initialize(
+	ID3D12Device* t_device,
+	ID3D12CommandQueue* t_command_queue,
+	IDXGISwapChain2* t_swap_chain,
+	UINT t_frames_in_flight,
+	UINT t_timeline_length)
+{
+	m_command_queue = t_command_queue;
+	m_pacer.Initialize(t_frames_in_flight, t_timeline_length);
+	m_start_time = std::chrono::steady_clock::now();
+
+	ThrowIfFailed(t_device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence)));
+
+	m_fence_event = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+
+	if (m_fence_event == nullptr)
+	{
+		ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+	}
+
+	if (t_swap_chain != nullptr)
+	{
+		// The waitable is signaled once per frame the swap chain can take, the same latency as the frames in flight
+		ThrowIfFailed(t_swap_chain->SetMaximumFrameLatency(t_frames_in_flight));
+		m_frame_latency_waitable = t_swap_chain->GetFrameLatencyWaitableObject();
+	}
+}
+
+void tnt::wrapper::dx12::FrameSynchronizer::Cleanup()
+{
+	if (m_fence_event == nullptr)
+	{
+		return;
+	}
+
+	Flush();
+
+	CloseHandle(m_fence_event);
+	m_fence_event = nullptr;
+
+	if (m_frame_latency_waitable != nullptr)
+	{
+		CloseHandle(m_frame_latency_waitable);
+		m_frame_latency_waitable = nullptr;
+	}
+}
+
+void tnt::wrapper::dx12::FrameSynchronizer::BeginFrame()
+{
+	m_pacer.BeginFrame(GetTime());
+
+	if (m_frame_latency_waitable != nullptr)
+	{
+		WaitForSingleObjectEx(m_frame_latency_waitable, INFINITE, FALSE);
+	}
+
+	const UINT64 wait_value = m_pacer.EndLatencyWait(m_fence->GetCompletedValue(), GetTime());
+
+	// Zero when the frame that last used the slot is already done, which is the common case with more than one frame in flight
+	if (wait_value != 0)
+	{
+		WaitForFenceValue(wait_value);
+	}
+
+	m_pacer.BeginRecording(m_fence->GetCompletedValue(), GetTime());
+}
+
+UINT64 tnt::wrapper::dx12::FrameSynchronizer::EndFrame()
+{
+	const UINT64 fence_value = m_pacer.EndFrame(GetTime());
+
+	ThrowIfFailed(m_command_queue->Signal(m_fence.Get(), fence_value));
+
+	return fence_value;
+}
+
+UINT64 tnt::wrapper::dx12::FrameSynchronizer::Flush()
+{
+	const UINT64 fence_value = m_pacer.Flush();
+
+	ThrowIfFailed(m_command_queue->Signal(m_fence.Get(), fence_value));
+	WaitForFenceValue(fence_value);
+
+	m_pacer.UpdateCompletedValue(fence_value, GetTime());
+
+	return fence_value;
+}
+
+UINT64 tnt::wrapper::dx12::FrameSynchronizer::GetCompletedValue()
+{
+	const UINT64 completed_fence_value = m_fence->GetCompletedValue();
+
+	m_pacer.UpdateCompletedValue(completed_fence_value, GetTime());
+
+	return completed_fence_value;
+}
+
+UINT tnt::wrapper::dx12::FrameSynchronizer::GetFrameSlot() const
+{
+	return m_pacer.GetFrameSlot();
+}
+
+const tnt::utility::FramePacer& tnt::wrapper::dx12::FrameSynchronizer::GetPacer() const
+{
+	return m_pacer;
+}
+
+void tnt::wrapper::dx12::FrameSynchronizer::WaitForFenceValue(UINT64 t_fence_value)
+{
+	if (m_fence->GetCompletedValue() < t_fence_value)
+	{
+		ThrowIfFailed(m_fence->SetEventOnCompletion(t_fence_value, m_fence_event));
+		WaitForSingleObjectEx(m_fence_event, INFINITE, FALSE);
+	}
+}
+
+double tnt::wrapper::dx12::FrameSynchronizer::GetTime() const
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start_time).count();
+}
@@ -0,0 +1,144 @@
+#include "Wrapper/DX12/HeapAllocator.hpp"
+
+#include "Utility/CheckHResult.hpp"
+
+#include <d3dx12.h>
+
+#include <stdexcept>
+
+namespace
+{
+	UINT64 AlignUp(UINT64 t_value, UINT64 t_alignment)
+	{
+		return (t_value + t_alignment - 1) & ~(t_alignment - 1);
+	}
+
+	// Only textures that are not render targets or depth stencils may use the small placement alignment
+	bool CanUseSmallAlignment(const D3D12_RESOURCE_DESC& t_desc)
+	{
+		const D3D12_RESOURCE_FLAGS target_flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+
+		return t_desc.Dimension != D3D12_RESOURCE_DIMENSION_BUFFER && (t_desc.Flags & target_flags) == 0 && t_desc.SampleDesc.Count == 1;
+	}
+}
+
+tnt::wrapper::dx12::HeapAllocator::HeapAllocator()
+	: m_device(nullptr)
+	, m_heap_type(D3D12_HEAP_TYPE_DEFAULT)
+	, m_heap_flags(D3D12_HEAP_FLAG_NONE)
+	, m_heap_size(0)
+{
+}
+
+tnt::wrapper::dx12::HeapAllocator::~HeapAllocator()
+{
+}
+
+void tnt::wrapper::dx12::HeapAllocator::Initialize(ID3D12Device* t_device, D3D12_HEAP_TYPE t_heap_type, D3D12_HEAP_FLAGS t_heap_flags, UINT64 t_heap_size)
+{
+	m_device = t_device;
+	m_heap_type = t_heap_type;
+	m_heap_flags = t_heap_flags;
+	m_heap_size = AlignUp(t_heap_size, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+
+	m_heaps.clear();
+}
+
+tnt::wrapper::dx12::HeapAllocation tnt::wrapper::dx12::HeapAllocator::CreateResource(
+	const D3D12_RESOURCE_DESC& t_desc,
+	D3D12_RESOURCE_STATES t_initial_state,
+	const D3D12_CLEAR_VALUE* t_clear_value,
+	REFIID t_riid,
+	void** t_resource)
+{
+	D3D12_RESOURCE_DESC desc = t_desc;
+	D3D12_RESOURCE_ALLOCATION_INFO allocation_info = {};
+
+	// The device reports the default alignment instead when the texture is too large for 4 KB placement
+	if (CanUseSmallAlignment(desc))
+	{
+		desc.Alignment = D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT;
+		allocation_info = m_device->GetResourceAllocationInfo(0, 1, &desc);
+
+		if (allocation_info.Alignment != D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT)
+		{
+			desc.Alignment = 0;
+		}
+	}
+
+	if (desc.Alignment == 0)
+	{
+		allocation_info = m_device->GetResourceAllocationInfo(0, 1, &desc);
+	}
+
+	HeapAllocation allocation = { 0, utility::INVALID_TLSF_HANDLE };
+
+	for (UINT heap_index = 0; heap_index < m_heaps.size() && allocation.handle == utility::INVALID_TLSF_HANDLE; ++heap_index)
+	{
+		allocation.heap_index = heap_index;
+		allocation.handle = m_heaps[heap_index].allocator.Allocate(allocation_info.SizeInBytes, allocation_info.Alignment);
+	}
+
+	if (allocation.handle == utility::INVALID_TLSF_HANDLE)
+	{
+		const UINT64 dedicated_size = AlignUp(allocation_info.SizeInBytes, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+
+		allocation.heap_index = CreateHeap(dedicated_size > m_heap_size ? dedicated_size : m_heap_size);
+		allocation.handle = m_heaps[allocation.heap_index].allocator.Allocate(allocation_info.SizeInBytes, allocation_info.Alignment);
+
+		if (allocation.handle == utility::INVALID_TLSF_HANDLE)
+		{
+			throw std::runtime_error("Resource does not fit in a new heap");
+		}
+	}
+
+	Heap& heap = m_heaps[allocation.heap_index];
+
+	ThrowIfFailed(m_device->CreatePlacedResource(
+		heap.heap.Get(),
+		heap.allocator.GetOffset(allocation.handle),
+		&desc,
+		t_initial_state,
+		t_clear_value,
+		t_riid,
+		t_resource
+	));
+
+	return allocation;
+}
+
+void tnt::wrapper::dx12::HeapAllocator::Free(const HeapAllocation& t_allocation)
+{
+	m_heaps[t_allocation.heap_index].allocator.Free(t_allocation.handle);
+}
+
+UINT tnt::wrapper::dx12::HeapAllocator::GetHeapCount() const
+{
+	return static_cast<UINT>(m_heaps.size());
+}
+
+UINT64 tnt::wrapper::dx12::HeapAllocator::GetAllocatedSize() const
+{
+	UINT64 allocated_size = 0;
+
+	for (const Heap& heap : m_heaps)
+	{
+		allocated_size += heap.allocator.GetCapacity() - heap.allocator.GetFreeSize();
+	}
+
+	return allocated_size;
+}
+
+UINT tnt::wrapper::dx12::HeapAllocator::CreateHeap(UINT64 t_size)
+{
+	// Heaps that hold MSAA resources would need the 4 MB alignment, this allocator never places any
+	CD3DX12_HEAP_DESC heap_desc(t_size, m_heap_type, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT, m_heap_flags);
+
+	Heap heap;
+	ThrowIfFailed(m_device->CreateHeap(&heap_desc, IID_PPV_ARGS(&heap.heap)));
+	heap.allocator.Initialize(t_size);
+
+	m_heaps.push_back(heap);
+
+	return static_cast<UINT>(m_heaps.size() - 1);
+}
@@ -0,0 +1,403 @@
+#include "Wrapper/DX12/MeshBufferManager.hpp"
+
+#include "Renderer/TextureFootprint.hpp"
+#include "Utility/CheckHResult.hpp"
+
+#include <d3dx12.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+	// Every range starts on an allocator block, so the streaming stores into the staging ring stay aligned
+	const UINT64 MESH_STAGING_ALIGNMENT = 256;
+
+	// Sixteen bit indices halve the index fetch bandwidth, the vertex count decides whether they are enough
+	const UINT MAX_16_BIT_INDEXED_VERTEX_COUNT = 65536;
+}
+
+tnt::wrapper::dx12::MeshBufferManager::MeshBufferManager()
+	: m_buffer_heap_allocator(nullptr)
+	, m_tracked_resources(nullptr)
+	, m_vertex_buffer_id(0)
+	, m_index_buffer_id(0)
+{
+}
+
+tnt::wrapper::dx12::MeshBufferManager::~MeshBufferManager()
+{
+	Cleanup();
+}
+
+void tnt::wrapper::dx12::MeshBufferManager::Initialize(
+	ID3D12Device* t_device,
+	HeapAllocator* t_buffer_heap_allocator,
+	TrackedResources* t_tracked_resources,
+	UINT64 t_vertex_buffer_size,
+	UINT64 t_index_buffer_size,
+	UINT64 t_staging_ring_size)
+{
+	m_buffer_heap_allocator = t_buffer_heap_allocator;
+	m_tracked_resources = t_tracked_resources;
+
+	// Buffers start out in the common state, every command list promotes them to the state it first uses them in
+	m_vertex_allocation = m_buffer_heap_allocator->CreateResource(
+		CD3DX12_RESOURCE_DESC::Buffer(t_vertex_buffer_size),
+		D3D12_RESOURCE_STATE_COMMON,
+		nullptr,
+		IID_PPV_ARGS(&m_vertex_buffer)
+	);
+
+	m_index_allocation = m_buffer_heap_allocator->CreateResource(
+		CD3DX12_RESOURCE_DESC::Buffer(t_index_buffer_size),
+		D3D12_RESOURCE_STATE_COMMON,
+		nullptr,
+		IID_PPV_ARGS(&m_index_buffer)
+	);
+
+	m_vertex_buffer_id = m_tracked_resources->Register(m_vertex_buffer.Get(), D3D12_RESOURCE_STATE_COMMON);
+	m_index_buffer_id = m_tracked_resources->Register(m_index_buffer.Get(), D3D12_RESOURCE_STATE_COMMON);
+
+	m_vertex_allocator.Initialize(t_vertex_buffer_size);
+	m_index_allocator.Initialize(t_index_buffer_size);
+
+	m_staging_ring.Initialize(t_device, t_staging_ring_size);
+}
+
+void tnt::wrapper::dx12::MeshBufferManager::Cleanup()
+{
+	if (m_buffer_heap_allocator == nullptr)
+	{
+		return;
+	}
+
+	// The caller has to wait for the GPU first, like for every other resource
+	m_tracked_resources->Unregister(m_vertex_buffer_id);
+	m_tracked_resources->Unregister(m_index_buffer_id);
+
+	m_vertex_buffer.Reset();
+	m_index_buffer.Reset();
+	m_buffer_heap_allocator->Free(m_vertex_allocation);
+	m_buffer_heap_allocator->Free(m_index_allocation);
+	m_buffer_heap_allocator = nullptr;
+
+	m_meshes.clear();
+	m_unused_meshes.clear();
+	m_waiting_meshes.clear();
+	m_recorded_meshes.clear();
+	m_uploading_meshes.clear();
+	m_removed_meshes.clear();
+	m_pending_frees.clear();
+}
+
+tnt::wrapper::dx12::MeshHandle tnt::wrapper::dx12::MeshBufferManager::AddMesh(
+	const void* t_vertices,
+	UINT t_vertex_count,
+	UINT t_vertex_stride,
+	const std::uint32_t* t_indices,
+	UINT t_index_count)
+{
+	if (t_vertex_count == 0 || t_index_count == 0)
+	{
+		throw std::runtime_error("Meshes need at least one vertex and one index");
+	}
+
+	const bool is_16_bit = t_vertex_count <= MAX_16_BIT_INDEXED_VERTEX_COUNT;
+	const UINT vertex_size = t_vertex_count * t_vertex_stride;
+	const UINT index_size = t_index_count * static_cast<UINT>(is_16_bit ? sizeof(std::uint16_t) : sizeof(std::uint32_t));
+
+	const std::uint32_t vertex_handle = m_vertex_allocator.Allocate(vertex_size);
+
+	if (vertex_handle == utility::INVALID_TLSF_HANDLE)
+	{
+		throw std::runtime_error("Mesh vertex buffer is full");
+	}
+
+	const std::uint32_t index_handle = m_index_allocator.Allocate(index_size);
+
+	if (index_handle == utility::INVALID_TLSF_HANDLE)
+	{
+		m_vertex_allocator.Free(vertex_handle);
+		throw std::runtime_error("Mesh index buffer is full");
+	}
+
+	// A mesh is staged as a whole, one that can never fit would hold back every mesh behind it
+	if (m_vertex_allocator.GetSize(vertex_handle) + m_index_allocator.GetSize(index_handle) > m_staging_ring.GetAllocator().GetCapacity())
+	{
+		m_vertex_allocator.Free(vertex_handle);
+		m_index_allocator.Free(index_handle);
+		throw std::runtime_error("Mesh does not fit in the mesh staging ring");
+	}
+
+	MeshHandle handle = static_cast<MeshHandle>(m_meshes.size());
+
+	if (m_unused_meshes.empty())
+	{
+		m_meshes.emplace_back();
+	}
+	else
+	{
+		handle = m_unused_meshes.back();
+		m_unused_meshes.pop_back();
+	}
+
+	Mesh& mesh = m_meshes[handle];
+	mesh.state = MeshState::Waiting;
+	mesh.fence_value = 0;
+	mesh.vertex_handle = vertex_handle;
+	mesh.index_handle = index_handle;
+	mesh.vertex_size = vertex_size;
+	mesh.vertex_stride = t_vertex_stride;
+	mesh.index_size = index_size;
+	mesh.index_count = t_index_count;
+	mesh.index_format = is_16_bit ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+
+	mesh.data.resize(static_cast<size_t>(vertex_size) + index_size);
+	memcpy(mesh.data.data(), t_vertices, vertex_size);
+
+	if (is_16_bit)
+	{
+		std::uint16_t* indices = reinterpret_cast<std::uint16_t*>(mesh.data.data() + vertex_size);
+
+		for (UINT index = 0; index < t_index_count; ++index)
+		{
+			indices[index] = static_cast<std::uint16_t>(t_indices[index]);
+		}
+	}
+	else
+	{
+		memcpy(mesh.data.data() + vertex_size, t_indices, index_size);
+	}
+
+	m_waiting_meshes.push_back(handle);
+
+	return handle;
+}
+
+void tnt::wrapper::dx12::MeshBufferManager::RemoveMesh(MeshHandle t_mesh)
+{
+	Mesh& mesh = m_meshes[t_mesh];
+
+	if (mesh.state == MeshState::Free)
+	{
+		return;
+	}
+
+	// No copy was recorded yet, so the GPU has never seen the ranges
+	if (mesh.state == MeshState::Waiting)
+	{
+		m_waiting_meshes.erase(std::find(m_waiting_meshes.begin(), m_waiting_meshes.end(), t_mesh));
+		m_vertex_allocator.Free(mesh.vertex_handle);
+		m_index_allocator.Free(mesh.index_handle);
+	}
+	else
+	{
+		m_removed_meshes.push_back({ mesh.vertex_handle, mesh.index_handle, 0 });
+	}
+
+	mesh.state = MeshState::Free;
+	mesh.data.clear();
+	mesh.data.shrink_to_fit();
+
+	m_unused_meshes.push_back(t_mesh);
+}
+
+void tnt::wrapper::dx12::MeshBufferManager::RecordUploads(ID3D12GraphicsCommandList* t_command_list, CommandListStateTracker& t_state_tracker)
+{
+	if (m_waiting_meshes.empty())
+	{
+		return;
+	}
+
+	// Vertices of the whole batch come first in the staging allocation, the indices follow them
+	size_t batch_count = m_waiting_meshes.size();
+	UINT64 vertex_staging_size = 0;
+	UINT64 index_staging_size = 0;
+
+	for (size_t index = 0; index < batch_count; ++index)
+	{
+		const Mesh& mesh = m_meshes[m_waiting_meshes[index]];
+		vertex_staging_size += m_vertex_allocator.GetSize(mesh.vertex_handle);
+		index_staging_size += m_index_allocator.GetSize(mesh.index_handle);
+	}
+
+	UploadAllocation staging = {};
+
+	// A batch that does not fit is halved until it does, the rest waits for frames in flight to retire
+	while (!m_staging_ring.TryAllocate(vertex_staging_size + index_staging_size, MESH_STAGING_ALIGNMENT, staging))
+	{
+		if (batch_count == 1)
+		{
+			return;
+		}
+
+		for (size_t index = batch_count / 2; index < batch_count; ++index)
+		{
+			const Mesh& mesh = m_meshes[m_waiting_meshes[index]];
+			vertex_staging_size -= m_vertex_allocator.GetSize(mesh.vertex_handle);
+			index_staging_size -= m_index_allocator.GetSize(mesh.index_handle);
+		}
+
+		batch_count /= 2;
+	}
+
+	std::uint8_t* destination = static_cast<std::uint8_t*>(staging.cpu_address);
+	UINT64 vertex_cursor = 0;
+	UINT64 index_cursor = vertex_staging_size;
+
+	m_vertex_copies.clear();
+	m_index_copies.clear();
+
+	for (size_t index = 0; index < batch_count; ++index)
+	{
+		const MeshHandle handle = m_waiting_meshes.front();
+		m_waiting_meshes.pop_front();
+
+		Mesh& mesh = m_meshes[handle];
+
+		// The upload ring is write combined, the padding after each range is left as it is
+		graphics::CopyRows(mesh.data.data(), 0, destination + vertex_cursor, 0, mesh.vertex_size, 1);
+		graphics::CopyRows(mesh.data.data() + mesh.vertex_size, 0, destination + index_cursor, 0, mesh.index_size, 1);
+
+		AppendCopy(m_vertex_copies, m_vertex_allocator.GetOffset(mesh.vertex_handle), m_vertex_allocator.GetSize(mesh.vertex_handle), vertex_cursor);
+		AppendCopy(m_index_copies, m_index_allocator.GetOffset(mesh.index_handle), m_index_allocator.GetSize(mesh.index_handle), index_cursor);
+
+		mesh.state = MeshState::Recorded;
+		mesh.data.clear();
+		mesh.data.shrink_to_fit();
+
+		m_recorded_meshes.push_back(handle);
+	}
+
+	// A list that starts with an upload promotes the buffers to the copy destination state, only the way back needs a barrier
+	t_state_tracker.Transition(m_vertex_buffer_id, D3D12_RESOURCE_STATE_COPY_DEST);
+	t_state_tracker.Transition(m_index_buffer_id, D3D12_RESOURCE_STATE_COPY_DEST);
+	t_state_tracker.FlushBarriers(t_command_list);
+
+	for (const BufferCopy& copy : m_vertex_copies)
+	{
+		t_command_list->CopyBufferRegion(m_vertex_buffer.Get(), copy.destination_offset, m_staging_ring.GetResourcePointer(), staging.offset + copy.source_offset, copy.size);
+	}
+
+	for (const BufferCopy& copy : m_index_copies)
+	{
+		t_command_list->CopyBufferRegion(m_index_buffer.Get(), copy.destination_offset, m_staging_ring.GetResourcePointer(), staging.offset + copy.source_offset, copy.size);
+	}
+
+	// Left waiting, so they go out together with the barriers the draws need
+	PrepareForDraw(t_state_tracker);
+}
+
+void tnt::wrapper::dx12::MeshBufferManager::PrepareForDraw(CommandListStateTracker& t_state_tracker)
+{
+	t_state_tracker.Transition(m_vertex_buffer_id, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
+	t_state_tracker.Transition(m_index_buffer_id, D3D12_RESOURCE_STATE_INDEX_BUFFER);
+}
+
+void tnt::wrapper::dx12::MeshBufferManager::FinishFrame(UINT64 t_fence_value)
+{
+	m_staging_ring.FinishFrame(t_fence_value);
+
+	for (MeshHandle handle : m_recorded_meshes)
+	{
+		Mesh& mesh = m_meshes[handle];
+
+		// Meshes removed in the same frame are already free
+		if (mesh.state == MeshState::Recorded)
+		{
+			mesh.state = MeshState::Uploading;
+			mesh.fence_value = t_fence_value;
+			m_uploading_meshes.push_back(handle);
+		}
+	}
+
+	for (PendingFree& pending_free : m_removed_meshes)
+	{
+		pending_free.fence_value = t_fence_value;
+		m_pending_frees.push_back(pending_free);
+	}
+
+	m_recorded_meshes.clear();
+	m_removed_meshes.clear();
+}
+
+void tnt::wrapper::dx12::MeshBufferManager::Retire(UINT64 t_completed_fence_value)
+{
+	m_staging_ring.Retire(t_completed_fence_value);
+
+	while (!m_uploading_meshes.empty() && m_meshes[m_uploading_meshes.front()].fence_value <= t_completed_fence_value)
+	{
+		Mesh& mesh = m_meshes[m_uploading_meshes.front()];
+
+		// The handle may have been removed and reused since, only the upload it is waiting for counts
+		if (mesh.state == MeshState::Uploading)
+		{
+			mesh.state = MeshState::Resident;
+		}
+
+		m_uploading_meshes.pop_front();
+	}
+
+	while (!m_pending_frees.empty() && m_pending_frees.front().fence_value <= t_completed_fence_value)
+	{
+		m_vertex_allocator.Free(m_pending_frees.front().vertex_handle);
+		m_index_allocator.Free(m_pending_frees.front().index_handle);
+		m_pending_frees.pop_front();
+	}
+}
+
+bool tnt::wrapper::dx12::MeshBufferManager::IsResident(MeshHandle t_mesh) const
+{
+	return t_mesh < m_meshes.size() && m_meshes[t_mesh].state == MeshState::Resident;
+}
+
+UINT tnt::wrapper::dx12::MeshBufferManager::GetPendingCount() const
+{
+	return static_cast<UINT>(m_waiting_meshes.size() + m_recorded_meshes.size() + m_uploading_meshes.size());
+}
+
+D3D12_VERTEX_BUFFER_VIEW tnt::wrapper::dx12::MeshBufferManager::GetVertexBufferView(MeshHandle t_mesh) const
+{
+	const Mesh& mesh = m_meshes[t_mesh];
+
+	D3D12_VERTEX_BUFFER_VIEW view = {};
+	view.BufferLocation = m_vertex_buffer->GetGPUVirtualAddress() + m_vertex_allocator.GetOffset(mesh.vertex_handle);
+	view.StrideInBytes = mesh.vertex_stride;
+	view.SizeInBytes = mesh.vertex_size;
+
+	return view;
+}
+
+D3D12_INDEX_BUFFER_VIEW tnt::wrapper::dx12::MeshBufferManager::GetIndexBufferView(MeshHandle t_mesh) const
+{
+	const Mesh& mesh = m_meshes[t_mesh];
+
+	D3D12_INDEX_BUFFER_VIEW view = {};
+	view.BufferLocation = m_index_buffer->GetGPUVirtualAddress() + m_index_allocator.GetOffset(mesh.index_handle);
+	view.Format = mesh.index_format;
+	view.SizeInBytes = mesh.index_size;
+
+	return view;
+}
+
+UINT tnt::wrapper::dx12::MeshBufferManager::GetIndexCount(MeshHandle t_mesh) const
+{
+	return m_meshes[t_mesh].index_count;
+}
+
+void tnt::wrapper::dx12::MeshBufferManager::AppendCopy(std::vector<BufferCopy>& t_copies, UINT64 t_destination_offset, UINT64 t_range_size, UINT64& t_staging_size)
+{
+	// The range ends where its allocator block ends, so extending a copy over the padding never touches another mesh
+	if (!t_copies.empty() && t_copies.back().destination_offset + t_copies.back().size == t_destination_offset)
+	{
+		t_copies.back().size += t_range_size;
+	}
+	else
+	{
+		t_copies.push_back({ t_staging_size, t_destination_offset, t_range_size });
+	}
+
+	t_staging_size += t_range_size;
+}
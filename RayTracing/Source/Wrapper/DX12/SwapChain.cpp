@@ -21,7 +21,8 @@ void tnt::wrapper::dx12::SwapChain::Initialize(
 	BOOL t_allow_alt_enter,
 	UINT t_number_of_back_buffers,
 	DXGI_FORMAT t_format,
-	DXGI_SWAP_EFFECT t_swap_effect)
+	DXGI_SWAP_EFFECT t_swap_effect,
+	UINT t_flags)
 {
 	m_back_buffer_count = t_number_of_back_buffers;
 
@@ -31,7 +32,8 @@ void tnt::wrapper::dx12::SwapChain::Initialize(
 		t_height,
 		t_format,
 		t_swap_effect,
-		t_sampler_description);
+		t_sampler_description,
+		t_flags);
 
 	Microsoft::WRL::ComPtr<IDXGISwapChain1> swap_chain_one;
 	ThrowIfFailed(t_factory->CreateSwapChainForHwnd(
@@ -71,7 +73,8 @@ DXGI_SWAP_CHAIN_DESC1 tnt::wrapper::dx12::SwapChain::CreateSwapChainDescription(
 	UINT t_height,
 	DXGI_FORMAT t_format,
 	DXGI_SWAP_EFFECT t_swap_effect,
-	const DXGI_SAMPLE_DESC& t_sampler_description)
+	const DXGI_SAMPLE_DESC& t_sampler_description,
+	UINT t_flags)
 {
 	DXGI_SWAP_CHAIN_DESC1 swap_chain_description = {};
 	swap_chain_description.BufferCount = t_number_of_buffers;
@@ -81,6 +84,7 @@ DXGI_SWAP_CHAIN_DESC1 tnt::wrapper::dx12::SwapChain::CreateSwapChainDescription(
 	swap_chain_description.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
 	swap_chain_description.SwapEffect = t_swap_effect;
 	swap_chain_description.SampleDesc = t_sampler_description;
+	swap_chain_description.Flags = t_flags;
 
 	return swap_chain_description;
 }
@@ -0,0 +1,428 @@
+#include "Wrapper/DX12/TextureStreamer.hpp"
+
+#include "Utility/CheckHResult.hpp"
+
+#include <d3dx12.h>
+
+#include <stdexcept>
+
+namespace
+{
+	// Submissions that may be in flight on the copy queue before Update stops recording new copies
+	const UINT COPY_COMMAND_ALLOCATOR_COUNT = 3;
+
+	DXGI_FORMAT GetDxgiFormat(tnt::graphics::TextureFormat t_format)
+	{
+		switch (t_format)
+		{
+		case tnt::graphics::TextureFormat::BC1:
+			return DXGI_FORMAT_BC1_UNORM;
+
+		case tnt::graphics::TextureFormat::BC3:
+			return DXGI_FORMAT_BC3_UNORM;
+
+		case tnt::graphics::TextureFormat::BC7:
+			return DXGI_FORMAT_BC7_UNORM;
+
+		default:
+			return DXGI_FORMAT_R8G8B8A8_UNORM;
+		}
+	}
+
+	// Block compressed footprints cover whole blocks, the texture itself keeps the mip size
+	D3D12_PLACED_SUBRESOURCE_FOOTPRINT GetPlacedFootprint(const tnt::graphics::SubresourceFootprint& t_footprint, tnt::graphics::TextureFormat t_format, UINT64 t_base_offset)
+	{
+		const UINT block_size = tnt::graphics::GetFormatBlockSize(t_format);
+
+		D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint = {};
+		footprint.Offset = t_base_offset + t_footprint.offset;
+		footprint.Footprint.Format = GetDxgiFormat(t_format);
+		footprint.Footprint.Width = (t_footprint.width + block_size - 1) / block_size * block_size;
+		footprint.Footprint.Height = (t_footprint.height + block_size - 1) / block_size * block_size;
+		footprint.Footprint.Depth = 1;
+		footprint.Footprint.RowPitch = t_footprint.row_pitch;
+
+		return footprint;
+	}
+}
+
+tnt::wrapper::dx12::TextureStreamer::TextureStreamer()
+	: m_device(nullptr)
+	, m_texture_heap_allocator(nullptr)
+	, m_texture_cache(nullptr)
+	, m_is_recording(false)
+	, m_command_allocator_index(0)
+	, m_fence_event(nullptr)
+	, m_next_fence_value(1)
+	, m_next_request_tag(0)
+{
+}
+
+tnt::wrapper::dx12::TextureStreamer::~TextureStreamer()
+{
+	Cleanup();
+}
+
+void tnt::wrapper::dx12::TextureStreamer::Initialize(
+	ID3D12Device* t_device,
+	HeapAllocator* t_texture_heap_allocator,
+	UINT64 t_upload_ring_size,
+	UINT64 t_decode_memory_budget,
+	UINT t_decode_thread_count)
+{
+	m_device = t_device;
+	m_texture_heap_allocator = t_texture_heap_allocator;
+
+	D3D12_COMMAND_QUEUE_DESC queue_desc = {};
+	queue_desc.Type = D3D12_COMMAND_LIST_TYPE_COPY;
+	queue_desc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+
+	ThrowIfFailed(m_device->CreateCommandQueue(&queue_desc, IID_PPV_ARGS(&m_copy_queue)));
+
+	m_command_allocators.resize(COPY_COMMAND_ALLOCATOR_COUNT);
+	m_command_allocator_fence_values.assign(COPY_COMMAND_ALLOCATOR_COUNT, 0);
+
+	for (Microsoft::WRL::ComPtr<ID3D12CommandAllocator>& command_allocator : m_command_allocators)
+	{
+		ThrowIfFailed(m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COPY, IID_PPV_ARGS(&command_allocator)));
+	}
+
+	// Command lists are created in the recording state
+	ThrowIfFailed(m_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_COPY, m_command_allocators[0].Get(), nullptr, IID_PPV_ARGS(&m_command_list)));
+	ThrowIfFailed(m_command_list->Close());
+
+	ThrowIfFailed(m_device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence)));
+	m_next_fence_value = 1;
+
+	m_fence_event = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+
+	if (m_fence_event == nullptr)
+	{
+		ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+	}
+
+	m_upload_ring.Initialize(m_device, t_upload_ring_size);
+
+	m_decode_pool.Initialize(t_decode_thread_count, t_decode_memory_budget);
+	m_mip_generator.Initialize(t_decode_thread_count);
+}
+
+void tnt::wrapper::dx12::TextureStreamer::Cleanup()
+{
+	m_decode_pool.Cleanup();
+	m_mip_generator.Cleanup();
+
+	if (m_fence_event == nullptr)
+	{
+		return;
+	}
+
+	// Copies still in flight write to memory that is about to be released
+	if (m_fence->GetCompletedValue() < m_next_fence_value - 1)
+	{
+		ThrowIfFailed(m_fence->SetEventOnCompletion(m_next_fence_value - 1, m_fence_event));
+		WaitForSingleObjectEx(m_fence_event, INFINITE, FALSE);
+	}
+
+	for (PendingCopy& copy : m_pending_copies)
+	{
+		copy.texture.resource.Reset();
+		m_texture_heap_allocator->Free(copy.texture.allocation);
+	}
+
+	for (ReadyImage& ready_image : m_ready_images)
+	{
+		if (ready_image.cached_texture == nullptr)
+		{
+			m_decode_pool.Free(ready_image.image);
+		}
+	}
+
+	m_pending_copies.clear();
+	m_ready_images.clear();
+	m_callbacks.clear();
+
+	CloseHandle(m_fence_event);
+	m_fence_event = nullptr;
+}
+
+void tnt::wrapper::dx12::TextureStreamer::SetTextureCache(graphics::TextureCache* t_texture_cache)
+{
+	m_texture_cache = t_texture_cache;
+}
+
+void tnt::wrapper::dx12::TextureStreamer::SetMipSettings(const graphics::MipGeneratorSettings& t_settings)
+{
+	m_mip_settings = t_settings;
+}
+
+void tnt::wrapper::dx12::TextureStreamer::RequestTexture(const std::string& t_path, const TextureReadyCallback& t_callback)
+{
+	if (m_texture_cache != nullptr)
+	{
+		ReadyImage ready_image = {};
+		ready_image.image.path = t_path;
+		ready_image.cached_texture = std::make_shared<graphics::CachedTexture>();
+		ready_image.callback = t_callback;
+
+		// Mapping a cooked texture costs no more than hashing the source, so it skips the decode pool
+		m_texture_cache->Load(t_path, *ready_image.cached_texture);
+		m_ready_images.push_back(ready_image);
+
+		return;
+	}
+
+	const std::uint64_t tag = m_next_request_tag++;
+
+	m_callbacks[tag] = t_callback;
+	m_decode_pool.Request(t_path, tag);
+}
+
+void tnt::wrapper::dx12::TextureStreamer::Update()
+{
+	RunCompletedCallbacks();
+
+	utility::DecodedImage image;
+
+	while (m_decode_pool.TryPop(image))
+	{
+		PushReadyImage(image);
+	}
+
+	// Images keep their order, one that does not fit yet holds back the ones behind it
+	while (!m_ready_images.empty() && RecordCopy(m_ready_images.front()))
+	{
+		if (m_ready_images.front().cached_texture == nullptr)
+		{
+			m_decode_pool.Free(m_ready_images.front().image);
+		}
+
+		m_ready_images.pop_front();
+	}
+
+	Submit();
+}
+
+void tnt::wrapper::dx12::TextureStreamer::Flush()
+{
+	for (;;)
+	{
+		Update();
+
+		if (!m_pending_copies.empty())
+		{
+			ThrowIfFailed(m_fence->SetEventOnCompletion(m_pending_copies.front().fence_value, m_fence_event));
+			WaitForSingleObjectEx(m_fence_event, INFINITE, FALSE);
+			continue;
+		}
+
+		// Nothing is waiting on the copy queue, so the next image has to come from the decode pool
+		utility::DecodedImage image;
+
+		if (!m_decode_pool.WaitAndPop(image))
+		{
+			return;
+		}
+
+		PushReadyImage(image);
+	}
+}
+
+UINT tnt::wrapper::dx12::TextureStreamer::GetPendingCount() const
+{
+	return static_cast<UINT>(m_decode_pool.GetPendingCount() + m_ready_images.size() + m_pending_copies.size());
+}
+
+ID3D12CommandQueue* const tnt::wrapper::dx12::TextureStreamer::GetCopyQueuePointer() const
+{
+	return m_copy_queue.Get();
+}
+
+bool tnt::wrapper::dx12::TextureStreamer::RecordCopy(const ReadyImage& t_ready_image)
+{
+	const utility::DecodedImage& image = t_ready_image.image;
+	const graphics::CachedTexture* cached_texture = t_ready_image.cached_texture.get();
+
+	if (cached_texture == nullptr && image.rgba == nullptr)
+	{
+		throw std::runtime_error("Could not decode texture " + image.path);
+	}
+
+	const UINT width = (cached_texture != nullptr) ? cached_texture->GetHeader().width : image.width;
+	const UINT height = (cached_texture != nullptr) ? cached_texture->GetHeader().height : image.height;
+	graphics::TextureFormat format = graphics::TextureFormat::RGBA8;
+	std::uint32_t requested_mip_count = graphics::GetFullMipCount(width, height);
+
+	if (cached_texture != nullptr)
+	{
+		requested_mip_count = cached_texture->GetHeader().mip_count;
+		format = cached_texture->GetHeader().format;
+	}
+
+	// Same layout GetCopyableFootprints reports, computed without a round trip through the device
+	graphics::SubresourceFootprint footprints[graphics::TEXTURE_CACHE_MAX_MIP_COUNT] = {};
+	std::uint64_t staging_size = 0;
+	const UINT16 mip_count = static_cast<UINT16>(graphics::ComputeSubresourceFootprints(
+		format,
+		width,
+		height,
+		(requested_mip_count < graphics::TEXTURE_CACHE_MAX_MIP_COUNT) ? requested_mip_count : graphics::TEXTURE_CACHE_MAX_MIP_COUNT,
+		1,
+		footprints,
+		staging_size));
+
+	const D3D12_RESOURCE_DESC texture_desc = CD3DX12_RESOURCE_DESC::Tex2D(GetDxgiFormat(format), width, height, 1, mip_count);
+
+	// A cache file from an older layout would copy garbage, it has to be cooked again
+	if (cached_texture != nullptr)
+	{
+		const graphics::TextureCacheHeader& header = cached_texture->GetHeader();
+		bool is_matching = header.data_size == staging_size && header.mip_count == mip_count;
+
+		for (UINT mip = 0; mip < mip_count; ++mip)
+		{
+			is_matching = is_matching
+				&& footprints[mip].offset == header.mips[mip].offset
+				&& footprints[mip].row_pitch == header.mips[mip].row_pitch
+				&& footprints[mip].row_count == header.mips[mip].row_count;
+		}
+
+		if (!is_matching)
+		{
+			throw std::runtime_error("Cached texture " + image.path + " does not match the copy footprints of its format");
+		}
+	}
+
+	if (staging_size > m_upload_ring.GetAllocator().GetCapacity())
+	{
+		throw std::runtime_error("Texture " + image.path + " does not fit in the streaming upload ring");
+	}
+
+	// The command allocator is only reused once the copies recorded with it have completed
+	if (!m_is_recording && m_fence->GetCompletedValue() < m_command_allocator_fence_values[m_command_allocator_index])
+	{
+		return false;
+	}
+
+	UploadAllocation staging = {};
+
+	if (!m_upload_ring.TryAllocate(staging_size, graphics::TEXTURE_PLACEMENT_ALIGNMENT, staging))
+	{
+		return false;
+	}
+
+	if (!m_is_recording)
+	{
+		ThrowIfFailed(m_command_allocators[m_command_allocator_index]->Reset());
+		ThrowIfFailed(m_command_list->Reset(m_command_allocators[m_command_allocator_index].Get(), nullptr));
+		m_is_recording = true;
+	}
+
+	std::uint8_t* destination = static_cast<std::uint8_t*>(staging.cpu_address);
+
+	if (cached_texture != nullptr)
+	{
+		// Already in the copy layout, the whole chain goes over in one block
+		graphics::CopyRows(cached_texture->GetData(), 0, destination, 0, static_cast<size_t>(staging_size), 1);
+	}
+	else
+	{
+		// Lower mips are built in the copy layout, the top mip is read straight from the decoded image
+		m_mip_scratch.resize(static_cast<size_t>(staging_size));
+
+		graphics::MipLevel levels[graphics::TEXTURE_CACHE_MAX_MIP_COUNT];
+
+		for (UINT mip = 0; mip < mip_count; ++mip)
+		{
+			levels[mip].data = (mip == 0) ? image.rgba : m_mip_scratch.data() + footprints[mip].offset;
+			levels[mip].width = footprints[mip].width;
+			levels[mip].height = footprints[mip].height;
+			levels[mip].row_pitch = (mip == 0) ? image.width * 4 : footprints[mip].row_pitch;
+		}
+
+		m_mip_generator.GenerateChain(m_mip_settings, levels, mip_count);
+
+		// Rows in the upload buffer are padded to the pitch the copy engine expects
+		graphics::CopySubresource(format, levels[0].data, levels[0].row_pitch, footprints[0], destination);
+
+		if (mip_count > 1)
+		{
+			const size_t lower_mip_size = static_cast<size_t>(staging_size - footprints[1].offset);
+			graphics::CopyRows(m_mip_scratch.data() + footprints[1].offset, 0, destination + footprints[1].offset, 0, lower_mip_size, 1);
+		}
+	}
+
+	PendingCopy copy;
+	copy.texture.path = image.path;
+	copy.callback = t_ready_image.callback;
+	copy.fence_value = m_next_fence_value;
+
+	// Placed in the common state, the copy queue promotes it to a copy destination and it decays back once the copy is done
+	copy.texture.allocation = m_texture_heap_allocator->CreateResource(
+		texture_desc,
+		D3D12_RESOURCE_STATE_COMMON,
+		nullptr,
+		IID_PPV_ARGS(&copy.texture.resource)
+	);
+
+	for (UINT mip = 0; mip < mip_count; ++mip)
+	{
+		const D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint = GetPlacedFootprint(footprints[mip], format, staging.offset);
+
+		CD3DX12_TEXTURE_COPY_LOCATION destination_location(copy.texture.resource.Get(), mip);
+		CD3DX12_TEXTURE_COPY_LOCATION source_location(m_upload_ring.GetResourcePointer(), footprint);
+		m_command_list->CopyTextureRegion(&destination_location, 0, 0, 0, &source_location, nullptr);
+	}
+
+	m_pending_copies.push_back(copy);
+
+	return true;
+}
+
+void tnt::wrapper::dx12::TextureStreamer::Submit()
+{
+	if (!m_is_recording)
+	{
+		return;
+	}
+
+	ThrowIfFailed(m_command_list->Close());
+
+	ID3D12CommandList* command_lists[] = { m_command_list.Get() };
+	m_copy_queue->ExecuteCommandLists(_countof(command_lists), command_lists);
+	ThrowIfFailed(m_copy_queue->Signal(m_fence.Get(), m_next_fence_value));
+
+	// The staging memory of this batch is released together with its fence value
+	m_upload_ring.FinishFrame(m_next_fence_value);
+	m_command_allocator_fence_values[m_command_allocator_index] = m_next_fence_value;
+
+	m_command_allocator_index = (m_command_allocator_index + 1) % COPY_COMMAND_ALLOCATOR_COUNT;
+	++m_next_fence_value;
+	m_is_recording = false;
+}
+
+void tnt::wrapper::dx12::TextureStreamer::PushReadyImage(const utility::DecodedImage& t_image)
+{
+	ReadyImage ready_image;
+	ready_image.image = t_image;
+	ready_image.callback = m_callbacks[t_image.tag];
+
+	m_callbacks.erase(t_image.tag);
+	m_ready_images.push_back(ready_image);
+}
+
+void tnt::wrapper::dx12::TextureStreamer::RunCompletedCallbacks()
+{
+	const UINT64 completed_fence_value = m_fence->GetCompletedValue();
+
+	m_upload_ring.Retire(completed_fence_value);
+
+	// Popped before the callback runs, so a callback may request more textures
+	while (!m_pending_copies.empty() && m_pending_copies.front().fence_value <= completed_fence_value)
+	{
+		PendingCopy copy = m_pending_copies.front();
+		m_pending_copies.pop_front();
+
+		copy.callback(copy.texture);
+	}
+}
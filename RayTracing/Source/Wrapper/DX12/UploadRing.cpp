@@ -0,0 +1,84 @@
+#include "Wrapper/DX12/UploadRing.hpp"
+
+#include "Utility/CheckHResult.hpp"
+
+#include <d3dx12.h>
+
+#include <stdexcept>
+
+tnt::wrapper::dx12::UploadRing::UploadRing()
+	: m_cpu_address(nullptr)
+	, m_gpu_address(0)
+{
+}
+
+tnt::wrapper::dx12::UploadRing::~UploadRing()
+{
+}
+
+void tnt::wrapper::dx12::UploadRing::Initialize(ID3D12Device* t_device, UINT64 t_size)
+{
+	ThrowIfFailed(t_device->CreateCommittedResource(
+		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+		D3D12_HEAP_FLAG_NONE,
+		&CD3DX12_RESOURCE_DESC::Buffer(t_size),
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,
+		IID_PPV_ARGS(&m_buffer)
+	));
+
+	// Upload heaps may stay mapped for the lifetime of the resource, the CPU never reads from it
+	CD3DX12_RANGE read_range(0, 0);
+	ThrowIfFailed(m_buffer->Map(0, &read_range, reinterpret_cast<void**>(&m_cpu_address)));
+
+	m_gpu_address = m_buffer->GetGPUVirtualAddress();
+	m_allocator.Initialize(t_size);
+}
+
+tnt::wrapper::dx12::UploadAllocation tnt::wrapper::dx12::UploadRing::Allocate(UINT64 t_size, UINT64 t_alignment)
+{
+	UploadAllocation allocation = {};
+
+	if (!TryAllocate(t_size, t_alignment, allocation))
+	{
+		throw std::runtime_error("Upload ring is full, it needs to hold every frame in flight");
+	}
+
+	return allocation;
+}
+
+bool tnt::wrapper::dx12::UploadRing::TryAllocate(UINT64 t_size, UINT64 t_alignment, UploadAllocation& t_allocation)
+{
+	const UINT64 offset = m_allocator.Allocate(t_size, t_alignment);
+
+	if (offset == utility::INVALID_RING_OFFSET)
+	{
+		return false;
+	}
+
+	t_allocation.cpu_address = m_cpu_address + offset;
+	t_allocation.gpu_address = m_gpu_address + offset;
+	t_allocation.offset = offset;
+
+	return true;
+}
+
+void tnt::wrapper::dx12::UploadRing::FinishFrame(UINT64 t_fence_value)
+{
+	m_allocator.FinishFrame(t_fence_value);
+}
+
+void tnt::wrapper::dx12::UploadRing::Retire(UINT64 t_completed_fence_value)
+{
+	m_allocator.Retire(t_completed_fence_value);
+}
+
+ID3D12Resource* const tnt::wrapper::dx12::UploadRing::GetResourcePointer() const
+{
+	return m_buffer.Get();
+}
+
+const tnt::utility::RingAllocator& tnt::wrapper::dx12::UploadRing::GetAllocator() const
+{
+	return m_allocator;
+}